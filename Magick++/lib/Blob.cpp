@@ -18,6 +18,14 @@
 // Implementation of Magick::Blob
 //
 
+// Release a reference to a blob reference, deleting the blob reference
+// and its associated data once the last reference is released.
+static void releaseBlobRef ( Magick::BlobRef *blobRef_ )
+{
+  if ( blobRef_ && ( blobRef_->_refCount.decrement() == 0 ) )
+    delete blobRef_;
+}
+
 // Default constructor
 Magick::Blob::Blob ( void )
   : _blobRef(new Magick::BlobRef( 0, 0 ))
@@ -34,26 +42,16 @@ Magick::Blob::Blob ( const void* data_, size_t length_ )
 Magick::Blob::Blob ( const Magick::Blob& blob_ )
   : _blobRef(blob_._blobRef)
 {
-  // Increase reference count
-  Lock lock( &_blobRef->_mutexLock );
-  ++_blobRef->_refCount;
+  // Increase reference count (the reference is null if the blob has
+  // been moved from)
+  if ( _blobRef )
+    _blobRef->_refCount.increment();
 }
 
 // Destructor (reference counted)
 Magick::Blob::~Blob ()
 {
-  bool doDelete = false;
-  {
-    Lock lock( &_blobRef->_mutexLock );
-    if ( --_blobRef->_refCount == 0 )
-      doDelete = true;
-  }
-
-  if ( doDelete )
-    {
-      // Delete old blob reference with associated data
-      delete _blobRef;
-    }
+  releaseBlobRef( _blobRef );
   _blobRef=0;
 }
 
@@ -62,20 +60,9 @@ Magick::Blob& Magick::Blob::operator= ( const Magick::Blob& blob_ )
 {
   if(this != &blob_)
     {
-      {
-        Lock lock( &blob_._blobRef->_mutexLock );
-        ++blob_._blobRef->_refCount;
-      }
-      bool doDelete = false;
-      {
-        Lock lock( &_blobRef->_mutexLock );
-        if ( --_blobRef->_refCount == 0 )
-          doDelete = true;
-      }
-      if ( doDelete )
-        {
-          delete _blobRef;
-        }
+      if ( blob_._blobRef )
+        blob_._blobRef->_refCount.increment();
+      releaseBlobRef( _blobRef );
       _blobRef = blob_._blobRef;
     }
   return *this;
@@ -116,19 +103,9 @@ std::string Magick::Blob::base64 ( void )
 // Any existing data in the object is deallocated.
 void Magick::Blob::update ( const void* data_, size_t length_ )
 {
-  bool doDelete = false;
-  {
-    Lock lock( &_blobRef->_mutexLock );
-    if ( --_blobRef->_refCount == 0 )
-      doDelete = true;
-  }
-  if ( doDelete )
-    {
-      // Delete old blob reference with associated data
-      delete _blobRef;
-    }
-
-  _blobRef = new Magick::BlobRef( data_, length_ );
+  Magick::BlobRef *blobRef = new Magick::BlobRef( data_, length_ );
+  releaseBlobRef( _blobRef );
+  _blobRef = blobRef;
 }
 
 // Update object contents, using supplied pointer directly (no copy)
@@ -138,18 +115,19 @@ void Magick::Blob::update ( const void* data_, size_t length_ )
 void Magick::Blob::updateNoCopy ( void* data_, size_t length_,
                                   Magick::Blob::Allocator allocator_  )
 {
-  bool doDelete = false;
-  {
-    Lock lock( &_blobRef->_mutexLock );
-    if ( --_blobRef->_refCount == 0 )
-      doDelete = true;
-  }
-  if ( doDelete )
+  if ( _blobRef && ( _blobRef->_refCount.count() == 1 ) )
+    {
+      // Sole owner of the blob reference, so release the old data and
+      // re-use the reference.
+      Magick::BlobRef old( 0, 0 );
+      old._data = _blobRef->_data;
+      old._allocator = _blobRef->_allocator;
+    }
+  else
     {
-      // Delete old blob reference with associated data
-      delete _blobRef;
+      releaseBlobRef( _blobRef );
+      _blobRef = new Magick::BlobRef( 0, 0 );
     }
-  _blobRef = new Magick::BlobRef( 0, 0 );
   _blobRef->_data   = data_;
   _blobRef->_length = length_;
   _blobRef->_allocator = allocator_;
@@ -158,12 +136,12 @@ void Magick::Blob::updateNoCopy ( void* data_, size_t length_,
 // Obtain pointer to data
 const void* Magick::Blob::data( void ) const
 {
-  return _blobRef->_data;
+  return _blobRef ? _blobRef->_data : 0;
 }
 
 // Obtain data length
 size_t Magick::Blob::length( void ) const
 {
-  return _blobRef->_length;
+  return _blobRef ? _blobRef->_length : 0;
 }
 
@@ -24,8 +24,7 @@ Magick::BlobRef::BlobRef ( const void* data_,
   : _data(0),
     _length(length_),
     _allocator(Magick::Blob::NewAllocator),
-    _refCount(1),
-    _mutexLock()
+    _refCount()
 {
   if( data_ )
     {
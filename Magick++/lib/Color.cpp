@@ -188,6 +188,7 @@ Magick::Color& Magick::Color::operator = ( const Magick::Color& color_ )
   if ( this != &color_ )
     {
       // Copy pixel value
+      allocPixel();
       *_pixel = *color_._pixel;
 
       // Validity
@@ -202,6 +203,7 @@ Magick::Color& Magick::Color::operator = ( const Magick::Color& color_ )
 // Set color via X11 color specification string
 const Magick::Color& Magick::Color::operator = ( const std::string &x11color_ )
 {
+  allocPixel();
   initPixel();
   PixelPacket target_color;
   ExceptionInfo exception;
@@ -254,6 +256,7 @@ Magick::Color::operator std::string() const
 // Set color via ImageMagick PixelPacket
 const Magick::Color& Magick::Color::operator= ( const MagickLib::PixelPacket &color_ )
 {
+  allocPixel();
   *_pixel = color_;
   if ( color_.opacity != OpaqueOpacity )
     _pixelType = RGBAPixel;
@@ -284,14 +284,8 @@ Magick::Image::Image( void )
 /* virtual */
 Magick::Image::~Image()
 {
-  bool doDelete = false;
-  {
-    Lock lock( &_imgRef->_mutexLock );
-    if ( --_imgRef->_refCount == 0 )
-      doDelete = true;
-  }
-
-  if ( doDelete )
+  // The reference is null if the image has been moved from
+  if ( _imgRef && ( _imgRef->_refCount.decrement() == 0 ) )
     {
       delete _imgRef;
     }
@@ -3428,7 +3422,7 @@ unsigned int Magick::Image::scene ( void ) const
 
 std::string Magick::Image::signature ( const bool force_ ) const
 {
-  Lock lock( &_imgRef->_mutexLock );
+  Lock lock( &( _imgRef ? _imgRef : emptyImageRef() )->_mutexLock );
 
   // Re-calculate image signature if necessary
   if ( (force_) ||
@@ -3755,10 +3749,9 @@ double Magick::Image::yResolution ( void ) const
 Magick::Image::Image( const Image & image_ )
   : _imgRef(image_._imgRef)
 {
-  Lock lock( &_imgRef->_mutexLock );
-
   // Increase reference count
-  ++_imgRef->_refCount;
+  if ( _imgRef )
+    _imgRef->_refCount.increment();
 }
 
 // Assignment operator
@@ -3766,19 +3759,10 @@ Magick::Image& Magick::Image::operator=( const Magick::Image &image_ )
 {
   if( this != &image_ )
     {
-      {
-        Lock lock( &image_._imgRef->_mutexLock );
-        ++image_._imgRef->_refCount;
-      }
-
-      bool doDelete = false;
-      {
-        Lock lock( &_imgRef->_mutexLock );
-        if ( --_imgRef->_refCount == 0 )
-          doDelete = true;
-      }
+      if ( image_._imgRef )
+        image_._imgRef->_refCount.increment();
 
-      if ( doDelete )
+      if ( _imgRef && ( _imgRef->_refCount.decrement() == 0 ) )
         {
           // Delete old image reference with associated image and options.
           delete _imgRef;
@@ -3942,44 +3926,57 @@ Magick::Image::Image ( MagickLib::Image* image_ )
 {
 }
 
+// Get the image reference shared by moved-from images.  A moved-from
+// image holds a null reference so that moving does not allocate.  It
+// reads this empty image, and allocates its own image once modified.
+Magick::ImageRef* Magick::Image::emptyImageRef( void )
+{
+  static ImageRef *emptyRef = new ImageRef;
+  return emptyRef;
+}
+
 // Get Magick::Options*
 Magick::Options* Magick::Image::options( void )
 {
+  if ( !_imgRef )
+    _imgRef = new ImageRef;
   return _imgRef->options();
 }
 const Magick::Options* Magick::Image::constOptions( void ) const
 {
-  return _imgRef->options();
+  return ( _imgRef ? _imgRef : emptyImageRef() )->options();
 }
 
 // Get MagickLib::Image*
 MagickLib::Image*& Magick::Image::image( void )
 {
+  if ( !_imgRef )
+    _imgRef = new ImageRef;
   return _imgRef->image();
 }
 const MagickLib::Image* Magick::Image::constImage( void ) const
 {
-  return _imgRef->image();
+  return ( _imgRef ? _imgRef : emptyImageRef() )->image();
 }
 
 // Get ImageInfo *
 MagickLib::ImageInfo* Magick::Image::imageInfo( void )
 {
-  return _imgRef->options()->imageInfo();
+  return options()->imageInfo();
 }
 const MagickLib::ImageInfo * Magick::Image::constImageInfo( void ) const
 {
-  return _imgRef->options()->imageInfo();
+  return ( _imgRef ? _imgRef : emptyImageRef() )->options()->imageInfo();
 }
 
 // Get QuantizeInfo *
 MagickLib::QuantizeInfo* Magick::Image::quantizeInfo( void )
 {
-  return _imgRef->options()->quantizeInfo();
+  return options()->quantizeInfo();
 }
 const MagickLib::QuantizeInfo * Magick::Image::constQuantizeInfo( void ) const
 {
-  return _imgRef->options()->quantizeInfo();
+  return ( _imgRef ? _imgRef : emptyImageRef() )->options()->quantizeInfo();
 }
 
 //
@@ -3995,22 +3992,20 @@ MagickLib::Image * Magick::Image::replaceImage
   else
     image = AllocateImage(constImageInfo());
 
-  {
-    Lock lock( &_imgRef->_mutexLock );
-
-    if ( _imgRef->_refCount == 1 )
-      {
-        // We own the image, just replace it, and de-register
-        _imgRef->id( -1 );
-        _imgRef->image(image);
-      }
-    else
-      {
-        // We don't own the image, dereference and replace with copy
-        --_imgRef->_refCount;
-        _imgRef = new ImageRef( image, constOptions() );
-      }
-  }
+  if ( _imgRef && ( _imgRef->_refCount.count() == 1 ) )
+    {
+      // We own the image, just replace it, and de-register
+      _imgRef->id( -1 );
+      _imgRef->image(image);
+    }
+  else
+    {
+      // We don't own the image, dereference and replace with copy
+      ImageRef* imgRef = new ImageRef( image, constOptions() );
+      if ( _imgRef && ( _imgRef->_refCount.decrement() == 0 ) )
+        delete _imgRef;
+      _imgRef = imgRef;
+    }
 
   return _imgRef->_image;
 }
@@ -4021,15 +4016,19 @@ MagickLib::Image * Magick::Image::replaceImage
 //
 void Magick::Image::modifyImage( void )
 {
-  {
-    Lock lock( &_imgRef->_mutexLock );
-    if ( _imgRef->_refCount == 1 )
-      {
-        // De-register image and return
-        _imgRef->id( -1 );
-        return;
-      }
-  }
+  if ( !_imgRef )
+    {
+      // Moved-from image, so allocate a new empty image
+      _imgRef = new ImageRef;
+      return;
+    }
+
+  if ( _imgRef->_refCount.count() == 1 )
+    {
+      // De-register image and return
+      _imgRef->id( -1 );
+      return;
+    }
 
   ExceptionInfo exceptionInfo;
   GetExceptionInfo( &exceptionInfo );
@@ -4056,6 +4055,8 @@ void Magick::Image::throwImageException( void ) const
 // Register image with image registry or obtain registration id
 long Magick::Image::registerId( void )
 {
+  if ( !_imgRef )
+    _imgRef = new ImageRef;
   Lock lock( &_imgRef->_mutexLock );
   if( _imgRef->id() < 0 )
     {
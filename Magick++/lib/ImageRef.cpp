@@ -19,7 +19,7 @@ Magick::ImageRef::ImageRef ( MagickLib::Image * image_ )
   : _image(image_),
     _options(new Options),
     _id(-1),
-    _refCount(1),
+    _refCount(),
     _mutexLock()
 {
 }
@@ -31,7 +31,7 @@ Magick::ImageRef::ImageRef ( MagickLib::Image * image_,
   : _image(image_),
     _options(0),
     _id(-1),
-    _refCount(1),
+    _refCount(),
     _mutexLock()
 {
   _options = new Options( *options_ );
@@ -42,7 +42,7 @@ Magick::ImageRef::ImageRef ( void )
   : _image(0),
     _options(new Options),
     _id(-1),
-    _refCount(1),
+    _refCount(),
     _mutexLock()
 {
   // Allocate default image
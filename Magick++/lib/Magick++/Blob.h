@@ -10,6 +10,9 @@
 
 #include "Magick++/Include.h"
 #include <string>
+#if defined(MagickCplusPlusRvalueReferences)
+#include <utility>
+#endif
 
 namespace Magick
 {
@@ -42,6 +45,16 @@ namespace Magick
     // Assignment operator (reference counted)
     Blob&         operator= ( const Blob& blob_ );
 
+#if defined(MagickCplusPlusRvalueReferences)
+    // Move constructor.  The data is transferred without updating the
+    // reference count, and the moved-from object is left empty.
+    Blob ( Blob&& blob_ ) noexcept;
+
+    // Move assignment operator.  The contents are exchanged so that
+    // the moved-from object releases the previous contents.
+    Blob&         operator= ( Blob&& blob_ ) noexcept;
+#endif
+
     // Update object contents from Base64-encoded string representation.
     void          base64 ( const std::string base64_ );
     // Return Base64-encoded string representation.
@@ -79,4 +92,24 @@ namespace Magick
 
 } // namespace Magick
 
+//
+// Inlines
+//
+
+#if defined(MagickCplusPlusRvalueReferences)
+// Move constructor
+inline Magick::Blob::Blob ( Magick::Blob&& blob_ ) noexcept
+  : _blobRef( blob_._blobRef )
+{
+  blob_._blobRef = 0;
+}
+
+// Move assignment operator
+inline Magick::Blob& Magick::Blob::operator= ( Magick::Blob&& blob_ ) noexcept
+{
+  std::swap( _blobRef, blob_._blobRef );
+  return *this;
+}
+#endif
+
 #endif // Magick_BlobRef_header
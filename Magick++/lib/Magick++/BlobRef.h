@@ -37,8 +37,7 @@ namespace Magick
     void *          _data;      // Blob data
     size_t          _length;    // Blob length
     Blob::Allocator _allocator; // Memory allocation system in use
-    int             _refCount;  // Reference count
-    MutexLock       _mutexLock; // Mutex lock
+    ReferenceCount  _refCount;  // Reference count
   };
 
 } // namespace Magick
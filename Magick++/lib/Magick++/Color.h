@@ -9,6 +9,9 @@
 
 #include "Magick++/Include.h"
 #include <string>
+#if defined(MagickCplusPlusRvalueReferences)
+#include <utility>
+#endif
 
 namespace Magick
 {
@@ -39,6 +42,12 @@ namespace Magick
     Color ( void );
     virtual        ~Color ( void );
     Color ( const Color & color_ );
+#if defined(MagickCplusPlusRvalueReferences)
+    // Move constructor.  An allocated pixel is transferred rather than
+    // copied.  The moved-from object may only be assigned to or
+    // destroyed.
+    Color ( Color && color_ );
+#endif
 
     // Red color (range 0 to MaxRGB)
     void           redQuantum ( Quantum red_ );
@@ -71,6 +80,10 @@ namespace Magick
 
     // Assignment operator
     Color& operator= ( const Color& color_ );
+#if defined(MagickCplusPlusRvalueReferences)
+    // Move assignment operator
+    Color& operator= ( Color&& color_ );
+#endif
 
     // Return X11 color specification string
     /* virtual */ operator std::string() const;
@@ -156,6 +169,9 @@ namespace Magick
     // Common initializer for PixelPacket representation
     void initPixel();
 
+    // Allocate pixel if it was transferred by a move
+    void allocPixel();
+
     // Set true if we allocated pixel
     bool                        _pixelOwn;
 
@@ -323,6 +339,56 @@ inline void Magick::Color::initPixel()
   _pixel->opacity = TransparentOpacity;
 }
 
+// Allocate pixel if it was transferred by a move
+inline void Magick::Color::allocPixel()
+{
+  if ( !_pixel )
+    {
+      _pixel = new PixelPacket;
+      _pixelOwn = true;
+    }
+}
+
+#if defined(MagickCplusPlusRvalueReferences)
+// Move constructor
+inline Magick::Color::Color ( Magick::Color && color_ )
+  : _pixel(color_._pixel),
+    _pixelOwn(color_._pixelOwn),
+    _isValid(color_._isValid),
+    _pixelType(color_._pixelType)
+{
+  if ( _pixelOwn )
+    {
+      color_._pixel = 0;
+      color_._pixelOwn = false;
+    }
+  else
+    {
+      // Pixel belongs to an image, so make a copy
+      _pixel = new PixelPacket;
+      _pixelOwn = true;
+      *_pixel = *color_._pixel;
+    }
+}
+
+// Move assignment operator
+inline Magick::Color& Magick::Color::operator= ( Magick::Color&& color_ )
+{
+  if ( _pixelOwn && color_._pixelOwn )
+    {
+      std::swap( _pixel, color_._pixel );
+      _isValid = color_._isValid;
+      _pixelType = color_._pixelType;
+    }
+  else
+    {
+      // Write through to a pixel which belongs to an image
+      *this = static_cast<const Color&>( color_ );
+    }
+  return *this;
+}
+#endif
+
 inline void Magick::Color::redQuantum ( Magick::Quantum red_ )
 {
   _pixel->red = red_;
@@ -161,6 +161,23 @@ namespace Magick
     // Assignment operator
     Drawable& operator= (const Drawable& original_ );
 
+#if defined(MagickCplusPlusRvalueReferences)
+    // Move constructor.  The contained object is transferred rather
+    // than copied.
+    Drawable ( Drawable&& original_ ) noexcept
+      : dp(original_.dp)
+      {
+        original_.dp = 0;
+      }
+
+    // Move assignment operator
+    Drawable& operator= ( Drawable&& original_ ) noexcept
+      {
+        std::swap( dp, original_.dp );
+        return *this;
+      }
+#endif
+
     // Operator to invoke contained object
     void operator()( MagickLib::DrawContext context_ ) const;
 
@@ -103,6 +103,17 @@ namespace Magick
     // Assignment operator
     Image& operator= ( const Image &image_ );
 
+#if defined(MagickCplusPlusRvalueReferences)
+    // Move constructor.  The image is transferred without updating
+    // the reference count.  The moved-from object is left empty and
+    // only allocates a new image if it is modified.
+    Image ( Image && image_ ) noexcept;
+
+    // Move assignment operator.  The images are exchanged so that the
+    // moved-from object releases the previous image.
+    Image& operator= ( Image &&image_ ) noexcept;
+#endif
+
     //////////////////////////////////////////////////////////////////////
     //
     // Image operations
@@ -1341,6 +1352,9 @@ namespace Magick
 
     void            throwImageException( MagickLib::ExceptionInfo &exception_ ) const;
 
+    // Image reference used to read a moved-from image
+    static ImageRef * emptyImageRef( void );
+
     ImageRef *      _imgRef;
   };
 
@@ -1350,6 +1364,22 @@ namespace Magick
 // Inlines
 //
 
+#if defined(MagickCplusPlusRvalueReferences)
+// Move constructor
+inline Magick::Image::Image ( Magick::Image && image_ ) noexcept
+  : _imgRef( image_._imgRef )
+{
+  image_._imgRef = 0;
+}
+
+// Move assignment operator
+inline Magick::Image& Magick::Image::operator= ( Magick::Image &&image_ ) noexcept
+{
+  std::swap( _imgRef, image_._imgRef );
+  return *this;
+}
+#endif
+
 
 //
 // Image
@@ -49,7 +49,7 @@ namespace Magick
     MagickLib::Image *   _image;    // ImageMagick Image
     Options *            _options;  // User-specified options
     long                 _id;       // Registry ID (-1 if not registered)
-    int                  _refCount; // Reference count
+    ReferenceCount       _refCount; // Reference count
     MutexLock            _mutexLock;// Mutex lock
   };
 
@@ -203,6 +203,27 @@ namespace MagickLib
 #  pragma warning(disable : 4996) /* function deprecation warnings */
 #endif
 
+//
+// Enable move constructors and move assignment operators if the
+// compiler supports C++11 rvalue references.  These are implemented
+// inline so that they do not alter the library ABI.
+//
+#if !defined(MagickCplusPlusRvalueReferences)
+#  if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#    define MagickCplusPlusRvalueReferences 1
+#  endif
+#endif
+
+//
+// C++11 std::exception_ptr allows an exception thrown by a worker
+// thread to be re-thrown by the calling thread.
+//
+#if !defined(MagickCplusPlusExceptionPtr)
+#  if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1600))
+#    define MagickCplusPlusExceptionPtr 1
+#  endif
+#endif
+
 #if defined(MAGICK_IMPLEMENTATION)
 namespace MagickLib
 {
@@ -783,6 +804,7 @@ namespace Magick
   using MagickLib::CloneImageInfo;
   using MagickLib::CloneQuantizeInfo;
   using MagickLib::CloseCacheView;
+  using MagickLib::ClosePixelRowIterator;
   using MagickLib::CoderError;
   using MagickLib::CoderFatalError;
   using MagickLib::CoderWarning;
@@ -952,6 +974,7 @@ namespace Magick
   using MagickLib::GetMagickRegistry;
   using MagickLib::GetNumberColors;
   using MagickLib::GetPageGeometry;
+  using MagickLib::GetPixelRowIteratorStatus;
   using MagickLib::GetQuantizeInfo;
   using MagickLib::GetTypeMetrics;
   using MagickLib::GlobExpression;
@@ -1004,12 +1027,14 @@ namespace Magick
   using MagickLib::MontageInfo;
   using MagickLib::MotionBlurImage;
   using MagickLib::NegateImage;
+  using MagickLib::NextPixelRowIteratorRow;
   using MagickLib::NoValue;
   using MagickLib::NoiseType;
   using MagickLib::NormalizeImage;
   using MagickLib::OilPaintImage;
   using MagickLib::OpaqueImage;
   using MagickLib::OpenCacheView;
+  using MagickLib::OpenPixelRowIterator;
   using MagickLib::OptionError;
   using MagickLib::OptionFatalError;
   using MagickLib::OptionWarning;
@@ -1065,6 +1090,7 @@ namespace Magick
   using MagickLib::SetMagickRegistry;
   using MagickLib::SetMagickResourceLimit;
   using MagickLib::SetMagickResourceLimit;
+  using MagickLib::SetPixelRowIteratorRegion;
   using MagickLib::ShadeImage;
   using MagickLib::SharpenImage;
   using MagickLib::SharpenImageChannel;
@@ -1082,6 +1108,7 @@ namespace Magick
   using MagickLib::SyncCacheViewPixels;
   using MagickLib::SyncImage;
   using MagickLib::SyncImagePixels;
+  using MagickLib::SyncPixelRowIteratorRow;
   using MagickLib::TextureImage;
   using MagickLib::ThresholdImage;
   using MagickLib::ThrowException;
@@ -94,6 +94,95 @@ namespace Magick
 
   }; // class Pixels
 
+  // Typed row iterator over regions of an image.  Rows are returned
+  // as arrays of samples ordered according to a map (e.g. "RGB") as
+  // used by Image::write(), which is parsed only once, when the
+  // iterator is constructed.  Where the map and storage type match the
+  // pixel cache layout, rows are returned directly from the pixel
+  // cache, in which case successive pixels are stride() samples apart.
+  class MagickDLLDecl PixelRows
+  {
+  public:
+
+    // Construct row iterator using specified image, map and storage
+    // type.  If writable_ is true, the image is made unique and rows
+    // may be modified and transferred back to the image via sync.
+    PixelRows( Magick::Image &image_, const std::string &map_,
+               const StorageType type_, const bool writable_ = false );
+
+    // Destroy row iterator
+    ~PixelRows( void );
+
+    // Select the region whose rows are returned by next, starting
+    // with its top row.
+    void region ( const int x_, const int y_,
+                  const unsigned int columns_, const unsigned int rows_ );
+
+    // Return the samples of the next row of the region, or 0 after
+    // the last row.  The row remains valid until next or region is
+    // invoked again.
+    void* next ( void );
+
+    // Transfer the row most recently returned by next to the image.
+    void sync ( void );
+
+    // Distance between successive pixels in a row, in samples
+    unsigned int stride ( void ) const;
+
+    // Number of samples per pixel named by the map
+    unsigned int channels ( void ) const;
+
+  private:
+
+    // Copying and assigning PixelRows is not supported.
+    PixelRows( const PixelRows& pixelRows_ );
+    const PixelRows& operator=( const PixelRows& pixelRows_ );
+
+    Magick::Image                _image;    // Image reference
+    MagickLib::PixelRowIterator* _iterator; // Row iterator handle
+    unsigned int                 _channels; // Samples per pixel in map
+
+  }; // class PixelRows
+
+  // Storage type corresponding to a sample type
+  template <class T> struct PixelRowStorage;
+  template <> struct PixelRowStorage<unsigned char>
+  { static StorageType type ( void ) { return MagickLib::CharPixel; } };
+  template <> struct PixelRowStorage<unsigned short>
+  { static StorageType type ( void ) { return MagickLib::ShortPixel; } };
+  template <> struct PixelRowStorage<unsigned int>
+  { static StorageType type ( void ) { return MagickLib::IntegerPixel; } };
+  template <> struct PixelRowStorage<unsigned long>
+  { static StorageType type ( void ) { return MagickLib::LongPixel; } };
+  template <> struct PixelRowStorage<float>
+  { static StorageType type ( void ) { return MagickLib::FloatPixel; } };
+  template <> struct PixelRowStorage<double>
+  { static StorageType type ( void ) { return MagickLib::DoublePixel; } };
+
+  // Row iterator returning samples of type T (unsigned char,
+  // unsigned short, unsigned int, unsigned long, float, or double).
+  template <class T>
+  class TypedPixelRows : public PixelRows
+  {
+  public:
+    TypedPixelRows( Magick::Image &image_, const std::string &map_,
+                    const bool writable_ = false )
+      : PixelRows( image_, map_, PixelRowStorage<T>::type(), writable_ )
+      {
+      }
+
+    // Return the samples of the next row of the region, or 0 after
+    // the last row.
+    T* next ( void )
+      {
+        return static_cast<T*>( PixelRows::next() );
+      }
+  };
+
+  typedef TypedPixelRows<unsigned char>  PixelRows8;
+  typedef TypedPixelRows<unsigned short> PixelRows16;
+  typedef TypedPixelRows<float>          PixelRowsFloat;
+
 } // Magick namespace
 
 //
@@ -124,4 +213,16 @@ inline unsigned int Magick::Pixels::rows ( void ) const
   return _rows;
 }
 
+// Distance between successive pixels in a row, in samples
+inline unsigned int Magick::PixelRows::stride ( void ) const
+{
+  return MagickLib::GetPixelRowIteratorStride( _iterator );
+}
+
+// Number of samples per pixel named by the map
+inline unsigned int Magick::PixelRows::channels ( void ) const
+{
+  return _channels;
+}
+
 #endif // Magick_Pixels_header
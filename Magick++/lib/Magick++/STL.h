@@ -15,6 +15,7 @@
 #include <iterator>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "Magick++/CoderInfo.h"
 #include "Magick++/Drawable.h"
@@ -2440,6 +2441,379 @@ namespace Magick
     throwException( exceptionInfo, first_->quiet() );
   }
 
+  //////////////////////////////////////////////////////////
+  //
+  // Parallel algorithms
+  //
+  //////////////////////////////////////////////////////////
+
+  // The parallel algorithms process each image (or each file or BLOB)
+  // in a range independently, using a pool of threads.  The number of
+  // threads used is limited to threads_ if it is non-zero, and is
+  // otherwise set by the "threads" resource limit.  Decoders and
+  // encoders which are not thread safe are serialized by the library.
+  //
+  // For example, to read a GIF animation, sharpen each frame using all
+  // available processors, and write it back out:
+  //
+  // list<image> images;
+  // readImages( &images, "animation.gif" );
+  // forEachImageParallel( images.begin(), images.end(), sharpenImage() );
+  // writeImages( images.begin(), images.end(), "animation.gif" );
+
+  // Exceptions thrown while processing items in parallel.  Only the
+  // exception for the first item in the range is re-thrown.  Without
+  // std::exception_ptr, it is re-thrown as Magick::Error.
+  class ParallelTaskErrors
+  {
+  public:
+    ParallelTaskErrors ( const size_t count_ )
+      : _errors( count_ )
+#if !defined(MagickCplusPlusExceptionPtr)
+      , _failed( count_, false )
+#endif
+      {
+      }
+
+    // Record the exception being handled for item index_
+    void record ( const size_t index_, const std::exception *error_ )
+      {
+#if defined(MagickCplusPlusExceptionPtr)
+        (void) error_;
+        _errors[index_] = std::current_exception();
+#else
+        _errors[index_] = error_ ? error_->what() : "Unknown exception";
+        _failed[index_] = true;
+#endif
+      }
+
+    // Re-throw the first recorded exception
+    void rethrow ( void ) const
+      {
+        for ( size_t i = 0; i < _errors.size(); ++i )
+          {
+#if defined(MagickCplusPlusExceptionPtr)
+            if ( _errors[i] )
+              std::rethrow_exception( _errors[i] );
+#else
+            if ( _failed[i] )
+              throw Error( _errors[i] );
+#endif
+          }
+      }
+
+  private:
+#if defined(MagickCplusPlusExceptionPtr)
+    std::vector<std::exception_ptr> _errors;
+#else
+    std::vector<std::string>        _errors;
+    std::vector<bool>               _failed;
+#endif
+  };
+
+  // Apply function object to each image in a range in parallel.  The
+  // function object is shared by all threads, so it must be safe to
+  // invoke concurrently.  If the function throws for an image, the
+  // first exception in range order is re-thrown once all started
+  // images are finished.  Every image before the first failed image
+  // has been processed, but images after it may not have been.
+  template <class InputIterator, class Function>
+  class ForEachImageParallelTask
+  {
+  public:
+    ForEachImageParallelTask ( InputIterator first_,
+                               InputIterator last_,
+                               const Function &function_ )
+      : _images(),
+        _function( function_ ),
+        _errors( static_cast<size_t>( std::distance( first_, last_ ) ) )
+      {
+        for ( InputIterator iter = first_; iter != last_; ++iter )
+          _images.push_back( &(*iter) );
+      }
+
+    static MagickPassFail
+    callBack ( void *mutable_data_, const void *,
+               const unsigned long task_, MagickLib::ExceptionInfo * )
+      {
+        ForEachImageParallelTask *task =
+          static_cast<ForEachImageParallelTask *>( mutable_data_ );
+        try
+          {
+            task->_function( *task->_images[task_] );
+          }
+        catch ( std::exception &error_ )
+          {
+            task->_errors.record( task_, &error_ );
+            return MagickFail;
+          }
+        catch ( ... )
+          {
+            task->_errors.record( task_, 0 );
+            return MagickFail;
+          }
+        return MagickPass;
+      }
+
+    std::vector<Image *> _images;
+    const Function       _function;
+    ParallelTaskErrors   _errors;
+  };
+
+  template <class InputIterator, class Function>
+  void forEachImageParallel( InputIterator first_,
+                             InputIterator last_,
+                             Function function_,
+                             const unsigned int threads_ = 0 ) {
+    ForEachImageParallelTask<InputIterator, Function>
+      task( first_, last_, function_ );
+
+    MagickLib::ExceptionInfo exceptionInfo;
+    MagickLib::GetExceptionInfo( &exceptionInfo );
+    (void) MagickLib::ExecuteParallelTasks( &task.callBack, threads_, 0,
+                                            &task, 0, task._images.size(),
+                                            &exceptionInfo );
+    try
+      {
+        task._errors.rethrow();
+      }
+    catch ( ... )
+      {
+        MagickLib::DestroyExceptionInfo( &exceptionInfo );
+        throw;
+      }
+    throwException( exceptionInfo );
+  }
+
+  // Read an image list from a file or BLOB (implementation helpers for
+  // readImagesParallel).
+  inline MagickLib::Image* readImageList( MagickLib::ImageInfo *imageInfo_,
+                                          const std::string &imageSpec_,
+                                          MagickLib::ExceptionInfo *exception_ ) {
+    imageSpec_.copy( imageInfo_->filename, MaxTextExtent-1 );
+    imageInfo_->filename[ imageSpec_.length() ] = 0;
+    return MagickLib::ReadImage( imageInfo_, exception_ );
+  }
+  inline MagickLib::Image* readImageList( MagickLib::ImageInfo *imageInfo_,
+                                          const Blob &blob_,
+                                          MagickLib::ExceptionInfo *exception_ ) {
+    return MagickLib::BlobToImage( imageInfo_, blob_.data(),
+                                   blob_.length(), exception_ );
+  }
+
+  // Read each file or BLOB in a range in parallel.
+  template <class InputIterator>
+  class ReadImagesParallelTask
+  {
+  public:
+    ReadImagesParallelTask ( InputIterator first_,
+                             InputIterator last_,
+                             const MagickLib::ImageInfo *imageInfo_ )
+      : _sources(),
+        _images(),
+        _imageInfo( imageInfo_ )
+      {
+        for ( InputIterator iter = first_; iter != last_; ++iter )
+          _sources.push_back( iter );
+        _images.resize( _sources.size(), 0 );
+      }
+
+    static MagickPassFail
+    callBack ( void *mutable_data_, const void *,
+               const unsigned long task_,
+               MagickLib::ExceptionInfo *exception_ )
+      {
+        ReadImagesParallelTask *task =
+          static_cast<ReadImagesParallelTask *>( mutable_data_ );
+        MagickLib::ImageInfo *imageInfo =
+          MagickLib::CloneImageInfo( task->_imageInfo );
+        task->_images[task_] =
+          readImageList( imageInfo, *task->_sources[task_], exception_ );
+        MagickLib::DestroyImageInfo( imageInfo );
+        return task->_images[task_] != 0 ? MagickPass :
+          MagickFail;
+      }
+
+    std::vector<InputIterator>      _sources;
+    std::vector<MagickLib::Image *> _images;
+    const MagickLib::ImageInfo     *_imageInfo;
+  };
+
+  template <class Container, class InputIterator>
+  void readImagesParallel( Container *sequence_,
+                           InputIterator first_,
+                           InputIterator last_,
+                           const MagickLib::ImageInfo *imageInfo_,
+                           const unsigned int threads_ ) {
+    ReadImagesParallelTask<InputIterator> task( first_, last_, imageInfo_ );
+
+    MagickLib::ExceptionInfo exceptionInfo;
+    MagickLib::GetExceptionInfo( &exceptionInfo );
+    (void) MagickLib::ExecuteParallelTasks( &task.callBack, threads_, 0,
+                                            &task, 0, task._images.size(),
+                                            &exceptionInfo );
+    for ( size_t i = 0; i < task._images.size(); ++i )
+      insertImages( sequence_, task._images[i] );
+    throwException( exceptionInfo );
+  }
+
+  // Read images from a range of files (std::string) or BLOBs
+  // (Magick::Blob) in parallel, appending them to the container in
+  // the order of the range.
+  template <class Container, class InputIterator>
+  void readImagesParallel( Container *sequence_,
+                           InputIterator first_,
+                           InputIterator last_,
+                           const unsigned int threads_ = 0 ) {
+    readImagesParallel( sequence_, first_, last_,
+                        static_cast<const MagickLib::ImageInfo *>( 0 ),
+                        threads_ );
+  }
+
+  // As above, but reading with the options (e.g. size, density,
+  // subImage, or subRange) of options_.
+  template <class Container, class InputIterator>
+  void readImagesParallel( Container *sequence_,
+                           InputIterator first_,
+                           InputIterator last_,
+                           const Image &options_,
+                           const unsigned int threads_ = 0 ) {
+    readImagesParallel( sequence_, first_, last_,
+                        options_.constImageInfo(), threads_ );
+  }
+
+  // Write each image in a range in parallel to a file or BLOB.
+  class WriteImagesParallelTask
+  {
+  public:
+    WriteImagesParallelTask ( void )
+      : _images(),
+        _imageInfos(),
+        _fileNames(),
+        _data(),
+        _lengths()
+      {
+      }
+
+    static MagickPassFail
+    callBack ( void *mutable_data_, const void *,
+               const unsigned long task_,
+               MagickLib::ExceptionInfo *exception_ )
+      {
+        WriteImagesParallelTask *task =
+          static_cast<WriteImagesParallelTask *>( mutable_data_ );
+        MagickLib::ImageInfo *imageInfo =
+          MagickLib::CloneImageInfo( task->_imageInfos[task_] );
+        MagickLib::Image *image = task->_images[task_];
+        MagickPassFail status = MagickPass;
+        imageInfo->adjoin = MagickFalse;
+        if ( task->_fileNames.empty() )
+          {
+            size_t length = 2048; // Efficient size for small images
+            task->_data[task_] = MagickLib::ImageToBlob( imageInfo, image,
+                                                         &length,
+                                                         exception_ );
+            task->_lengths[task_] = length;
+            if ( task->_data[task_] == 0 )
+              status = MagickFail;
+          }
+        else
+          {
+            task->_fileNames[task_].copy( imageInfo->filename,
+                                          MaxTextExtent-1 );
+            imageInfo->filename[ task->_fileNames[task_].length() ] = 0;
+            task->_fileNames[task_].copy( image->filename,
+                                          MaxTextExtent-1 );
+            image->filename[ task->_fileNames[task_].length() ] = 0;
+            status = MagickLib::WriteImage( imageInfo, image );
+            if ( status == MagickFail )
+              MagickLib::CopyException( exception_, &image->exception );
+          }
+        MagickLib::DestroyImageInfo( imageInfo );
+        return status;
+      }
+
+    std::vector<MagickLib::Image *>           _images;
+    std::vector<const MagickLib::ImageInfo *> _imageInfos;
+    std::vector<std::string>                  _fileNames;
+    std::vector<void *>                       _data;
+    std::vector<size_t>                       _lengths;
+  };
+
+  template <class InputIterator>
+  void addWriteImagesParallelTasks( WriteImagesParallelTask *task_,
+                                    InputIterator first_,
+                                    InputIterator last_ ) {
+    for ( InputIterator iter = first_; iter != last_; ++iter )
+      {
+        // Obtain an unshared image since it is updated while writing
+        iter->modifyImage();
+        task_->_images.push_back( iter->image() );
+        task_->_imageInfos.push_back( iter->constImageInfo() );
+      }
+  }
+
+  // Write images in parallel, each to its own file.  The file name for
+  // each image is generated by substituting its position in the range
+  // for a scene specification (e.g. "frame%02d.png") in imageSpec_,
+  // or, if there is more than one image and imageSpec_ has no scene
+  // specification, by appending ".N".
+  template <class InputIterator>
+  void writeImagesParallel( InputIterator first_,
+                            InputIterator last_,
+                            const std::string &imageSpec_,
+                            const unsigned int threads_ = 0 ) {
+    WriteImagesParallelTask task;
+    addWriteImagesParallelTasks( &task, first_, last_ );
+    for ( size_t i = 0; i < task._images.size(); ++i )
+      {
+        char fileName[MaxTextExtent];
+        (void) MagickLib::MagickSceneFileName( fileName, imageSpec_.c_str(),
+                                               ".%lu",
+                                               task._images.size() > 1 ?
+                                               MagickTrue :
+                                               MagickFalse,
+                                               i );
+        task._fileNames.push_back( fileName );
+      }
+
+    MagickLib::ExceptionInfo exceptionInfo;
+    MagickLib::GetExceptionInfo( &exceptionInfo );
+    (void) MagickLib::ExecuteParallelTasks( &task.callBack, threads_, 0,
+                                            &task, 0, task._images.size(),
+                                            &exceptionInfo );
+    throwException( exceptionInfo );
+  }
+
+  // Write images in parallel, each to its own BLOB, which is appended
+  // to the container in the order of the range.  An empty BLOB takes
+  // the place of an image which could not be written, and the
+  // exception is then thrown once all BLOBs are appended.
+  template <class InputIterator, class Container>
+  void writeImagesParallel( InputIterator first_,
+                            InputIterator last_,
+                            Container *blobs_,
+                            const unsigned int threads_ = 0 ) {
+    WriteImagesParallelTask task;
+    addWriteImagesParallelTasks( &task, first_, last_ );
+    task._data.resize( task._images.size(), 0 );
+    task._lengths.resize( task._images.size(), 0 );
+
+    MagickLib::ExceptionInfo exceptionInfo;
+    MagickLib::GetExceptionInfo( &exceptionInfo );
+    (void) MagickLib::ExecuteParallelTasks( &task.callBack, threads_, 0,
+                                            &task, 0, task._images.size(),
+                                            &exceptionInfo );
+    for ( size_t i = 0; i < task._images.size(); ++i )
+      {
+        blobs_->push_back( Blob() );
+        if ( task._data[i] != 0 )
+          blobs_->back().updateNoCopy( task._data[i], task._lengths[i],
+                                       Blob::MallocAllocator );
+      }
+    throwException( exceptionInfo );
+  }
+
 } // namespace Magick
 
 #endif // Magick_STL_header
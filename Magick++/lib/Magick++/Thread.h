@@ -28,6 +28,15 @@ struct win32_mutex {
 # include <pthread.h>
 #endif // defined(HasPTHREADS)
 
+// Select the reference count implementation.  Atomic operations are
+// preferred since they avoid taking a mutex lock.
+#if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1700))
+# include <atomic>
+# define MagickReferenceCountStdAtomic 1
+#elif defined(__GNUC__) && defined(__ATOMIC_ACQ_REL)
+# define MagickReferenceCountBuiltinAtomic 1
+#endif
+
 namespace Magick
 {
   // Mutex lock wrapper
@@ -81,6 +90,42 @@ namespace Magick
 
     MutexLock* _mutexLock;
   };
+
+  // Thread-safe reference count.  Atomic operations are used where
+  // available so that updating the count does not require a lock.
+  class MagickDLLDecl ReferenceCount
+  {
+  public:
+    // Construct with a count of one
+    ReferenceCount( void );
+
+    // Increment count
+    void increment( void );
+
+    // Decrement count, returning the updated count
+    long decrement( void );
+
+    // Current count
+    long count( void ) const;
+
+  private:
+
+    // Don't support copy constructor
+    ReferenceCount ( const ReferenceCount& original_ );
+
+    // Don't support assignment
+    ReferenceCount& operator = ( const ReferenceCount& original_ );
+
+#if defined(MagickReferenceCountStdAtomic)
+    std::atomic<long> _count;
+#else
+    long              _count;
+#endif
+#if !defined(MagickReferenceCountStdAtomic) && \
+  !defined(MagickReferenceCountBuiltinAtomic)
+    mutable MutexLock _mutexLock;
+#endif
+  };
 }
 
 // Construct with mutex lock (locks mutex)
@@ -97,4 +142,50 @@ inline Magick::Lock::~Lock( void )
   _mutexLock=0;
 }
 
+// Construct with a count of one
+inline Magick::ReferenceCount::ReferenceCount( void )
+  : _count(1)
+{
+}
+
+// Increment count
+inline void Magick::ReferenceCount::increment( void )
+{
+#if defined(MagickReferenceCountStdAtomic)
+  _count.fetch_add(1, std::memory_order_relaxed);
+#elif defined(MagickReferenceCountBuiltinAtomic)
+  (void) __atomic_add_fetch(&_count, 1, __ATOMIC_RELAXED);
+#else
+  Lock lock( &_mutexLock );
+  ++_count;
+#endif
+}
+
+// Decrement count, returning the updated count.  The caller which
+// sees a count of zero owns the referenced object.
+inline long Magick::ReferenceCount::decrement( void )
+{
+#if defined(MagickReferenceCountStdAtomic)
+  return _count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+#elif defined(MagickReferenceCountBuiltinAtomic)
+  return __atomic_sub_fetch(&_count, 1, __ATOMIC_ACQ_REL);
+#else
+  Lock lock( &_mutexLock );
+  return --_count;
+#endif
+}
+
+// Current count
+inline long Magick::ReferenceCount::count( void ) const
+{
+#if defined(MagickReferenceCountStdAtomic)
+  return _count.load(std::memory_order_acquire);
+#elif defined(MagickReferenceCountBuiltinAtomic)
+  return __atomic_load_n(&_count, __ATOMIC_ACQUIRE);
+#else
+  Lock lock( &_mutexLock );
+  return _count;
+#endif
+}
+
 #endif // Magick_Thread_header
@@ -16,8 +16,14 @@
 
 namespace Magick
 {
-
-
+  // Make image unique if its pixels are to be modified
+  static Magick::Image& pixelRowsImage( Magick::Image &image_,
+                                        const bool writable_ )
+  {
+    if ( writable_ )
+      image_.modifyImage();
+    return image_;
+  }
 }
 
 // Construct pixel view using specified image.
@@ -121,3 +127,49 @@ Magick::IndexPacket* Magick::Pixels::indexes ( void )
 
   return pixel_indexes;
 }
+
+// Construct row iterator using specified image, map and storage type.
+Magick::PixelRows::PixelRows( Magick::Image &image_, const std::string &map_,
+                              const StorageType type_, const bool writable_ )
+  : _image(pixelRowsImage(image_, writable_)),
+    _iterator(0),
+    _channels(static_cast<unsigned int>(map_.length()))
+{
+  ExceptionInfo exceptionInfo;
+  GetExceptionInfo( &exceptionInfo );
+  _iterator = OpenPixelRowIterator( _image.image(), map_.c_str(), type_,
+                                    writable_ ? MagickTrue : MagickFalse,
+                                    &exceptionInfo );
+  throwException( exceptionInfo, _image.quiet() );
+}
+
+// Destroy row iterator
+Magick::PixelRows::~PixelRows( void )
+{
+  ClosePixelRowIterator( _iterator );
+}
+
+// Select the region whose rows are returned by next.
+void Magick::PixelRows::region ( const int x_, const int y_,
+                                 const unsigned int columns_,
+                                 const unsigned int rows_ )
+{
+  if ( !SetPixelRowIteratorRegion( _iterator, x_, y_, columns_, rows_ ) )
+    _image.throwImageException();
+}
+
+// Return the samples of the next row of the region.
+void* Magick::PixelRows::next ( void )
+{
+  void* row = NextPixelRowIteratorRow( _iterator );
+  if ( !row && !GetPixelRowIteratorStatus( _iterator ) )
+    _image.throwImageException();
+  return row;
+}
+
+// Transfer the most recently returned row to the image.
+void Magick::PixelRows::sync ( void )
+{
+  if ( !SyncPixelRowIteratorRow( _iterator ) )
+    _image.throwImageException();
+}
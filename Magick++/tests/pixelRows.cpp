@@ -0,0 +1,153 @@
+// This may look like C code, but it is really -*- C++ -*-
+//
+// Copyright (C) 2026 GraphicsMagick Group
+//
+// Test Magick::PixelRows and Magick::TypedPixelRows
+//
+
+#include <Magick++.h>
+#include <string>
+#include <iostream>
+
+using namespace std;
+
+using namespace Magick;
+
+int main( int /*argc*/, char ** argv)
+{
+
+  // Initialize ImageMagick install location for Windows
+  InitializeMagick(*argv);
+
+  int failures=0;
+
+  try {
+
+    Image image( Geometry(5, 4), Color("red") );
+
+    //
+    // Read all rows as 8-bit RGB samples
+    //
+    {
+      PixelRows8 rows( image, "RGB" );
+      rows.region( 0, 0, image.columns(), image.rows() );
+
+      unsigned int count = 0;
+      while ( unsigned char* row = rows.next() )
+        {
+          for ( unsigned int x = 0; x < image.columns(); x++ )
+            {
+              const unsigned char* pixel = row + x*rows.stride();
+              if ( pixel[0] != 255 || pixel[1] != 0 || pixel[2] != 0 )
+                {
+                  ++failures;
+                  cout << "Line: " << __LINE__
+                       << "  Unexpected RGB samples at " << x
+                       << "," << count << endl;
+                  break;
+                }
+            }
+          ++count;
+        }
+      if ( count != image.rows() )
+        {
+          ++failures;
+          cout << "Line: " << __LINE__
+               << "  Returned " << count << " rows rather than "
+               << image.rows() << endl;
+        }
+    }
+
+    //
+    // A warning already recorded with the image must not be reported
+    // when the end of the region is reached.
+    //
+    {
+      ThrowLoggedException( &image.image()->exception, CorruptImageWarning,
+                            "Pre-existing warning", 0, __FILE__, "main",
+                            __LINE__ );
+
+      PixelRows8 rows( image, "I" );
+      rows.region( 1, 1, 3, 2 );
+
+      unsigned int count = 0;
+      while ( rows.next() )
+        ++count;
+      if ( count != 2 )
+        {
+          ++failures;
+          cout << "Line: " << __LINE__
+               << "  Returned " << count << " rows rather than 2" << endl;
+        }
+    }
+
+    //
+    // Modify the green channel via a writable iterator
+    //
+    {
+      PixelRowsFloat rows( image, "G", true );
+      rows.region( 0, 2, image.columns(), 2 );
+      while ( float* row = rows.next() )
+        {
+          for ( unsigned int x = 0; x < image.columns(); x++ )
+            row[x*rows.stride()] = 1.0f;
+          rows.sync();
+        }
+
+      if ( image.pixelColor(0, 1) != Color("red") ||
+           image.pixelColor(4, 3) != Color("yellow") )
+        {
+          ++failures;
+          cout << "Line: " << __LINE__
+               << "  Writable iterator modified the wrong pixels" << endl;
+        }
+    }
+
+    //
+    // An empty region is an error
+    //
+    {
+      PixelRows16 rows( image, "RGBA" );
+      bool caught = false;
+      try
+        {
+          rows.region( 0, 0, 0, 1 );
+        }
+      catch ( Exception & )
+        {
+          caught = true;
+        }
+      if ( !caught )
+        {
+          ++failures;
+          cout << "Line: " << __LINE__
+               << "  Empty region did not throw" << endl;
+        }
+      if ( rows.next() != 0 )
+        {
+          ++failures;
+          cout << "Line: " << __LINE__
+               << "  Empty region returned a row" << endl;
+        }
+    }
+  }
+
+  catch( Exception &error_ )
+    {
+      cout << "Caught exception: " << error_.what() << endl;
+      return 1;
+    }
+  catch( exception &error_ )
+    {
+      cout << "Caught exception: " << error_.what() << endl;
+      return 1;
+    }
+
+  if ( failures )
+    {
+      cout << failures << " failures" << endl;
+      return 1;
+    }
+
+  return 0;
+}
@@ -9,6 +9,11 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <utility>
+#include <vector>
+#if defined(MagickCplusPlusRvalueReferences)
+#  include <type_traits>
+#endif
 
 using namespace std;
 
@@ -233,6 +238,117 @@ int main( int /*argc*/, char ** argv)
                  << signature << endl;
           }
       }
+
+#if defined(MagickCplusPlusRvalueReferences)
+      // Test moving BLOBs, images, and colors
+      {
+        Image image( srcdir + "test_image.miff" );
+        string signature = image.signature();
+
+        Blob blob;
+        image.write( &blob );
+        const void *data = blob.data();
+        size_t length = blob.length();
+
+        Blob moved( std::move(blob) );
+        if ( ( moved.data() != data ) || ( moved.length() != length ) ||
+             ( blob.length() != 0 ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Move constructed BLOB does not own data" << endl;
+          }
+
+        // A moved-from BLOB holds an empty BLOB
+        Blob emptyCopy;
+        emptyCopy = blob;
+        if ( ( emptyCopy.length() != 0 ) || ( blob.data() != 0 ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved-from BLOB is not empty" << endl;
+          }
+        blob.update( data, length );
+        if ( blob.length() != length )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved-from BLOB could not be updated" << endl;
+          }
+
+        blob = std::move(moved);
+        if ( ( blob.data() != data ) || ( blob.length() != length ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Move assigned BLOB does not own data" << endl;
+          }
+
+        Image movedImage( std::move(image) );
+        // A moved-from image reads as an empty image
+        if ( image.isValid() || ( image.columns() != 0 ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved-from image is not empty" << endl;
+          }
+        image.read( srcdir + "test_image.miff" );
+        if ( image.signature() != signature )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved-from image could not be read" << endl;
+          }
+        image = movedImage;
+        movedImage = Image( blob );
+        if ( ( image.signature() != signature ) ||
+             ( movedImage.signature() != signature ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved image signature differs" << endl;
+          }
+
+        // A vector moves rather than copies its elements when it grows
+        // only if moving cannot throw
+        if ( !std::is_nothrow_move_constructible<Image>::value ||
+             !std::is_nothrow_move_assignable<Image>::value ||
+             !std::is_nothrow_move_constructible<Blob>::value ||
+             !std::is_nothrow_move_assignable<Blob>::value )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moving may throw" << endl;
+          }
+
+        // Moving an image out of a vector does not allocate an image
+        {
+          std::vector<Image> images( 2, image );
+          std::vector<Image> movedImages;
+          movedImages.push_back( std::move(images[0]) );
+          movedImages.push_back( std::move(images[1]) );
+          if ( ( images[0].constImage() == image.constImage() ) ||
+               ( images[0].constImage() != images[1].constImage() ) ||
+               ( movedImages[0].constImage() != image.constImage() ) ||
+               ( movedImages[1].constImage() != image.constImage() ) )
+            {
+              ++failures;
+              cout << "Line: " << __LINE__
+                   << "  Moving an image allocated an image" << endl;
+            }
+        }
+
+        Color color( "red" );
+        Color movedColor( std::move(color) );
+        color = "blue";
+        if ( ( movedColor != Color("red") ) || ( color != Color("blue") ) )
+          {
+            ++failures;
+            cout << "Line: " << __LINE__
+                 << "  Moved color differs" << endl;
+          }
+      }
+#endif
     }
   
   catch( Exception &error_ )
@@ -15,12 +15,46 @@ using namespace std;
 
 using namespace Magick;
 
+// Function object which fails for all but the first image
+class failImage
+{
+public:
+  void operator()( Image &image_ ) const
+    {
+      if ( image_.scene() != 0 )
+        throw ErrorOption( "Image processing failed" );
+    }
+};
+
+// Function object which marks each image with a comment, and fails
+// for one scene
+class markImage
+{
+public:
+  markImage( const unsigned int failScene_ )
+    : _failScene( failScene_ )
+    {
+    }
+  void operator()( Image &image_ ) const
+    {
+      if ( image_.scene() == _failScene )
+        throw ErrorOption( "Image processing failed" );
+      image_.comment( "processed" );
+    }
+private:
+  unsigned int _failScene;
+};
+
 int main( int /*argc*/, char ** argv)
 {
 
   // Initialize ImageMagick install location for Windows
   InitializeMagick(*argv);
 
+  // Use three threads regardless of the number of CPUs so that the
+  // parallel functions really do execute tasks concurrently.
+  MagickLib::SetMagickResourceLimit( MagickLib::ThreadsResource, 3 );
+
   int failures=0;
 
   try {
@@ -95,6 +129,125 @@ int main( int /*argc*/, char ** argv)
 	firstIter++;
 	secondIter++;
       }
+
+    //
+    // Test forEachImageParallel, writeImagesParallel, and
+    // readImagesParallel
+    //
+
+    list<Image> flopped( first.begin(), first.end() );
+    for_each( flopped.begin(), flopped.end(), flopImage() );
+
+    vector<Image> parallel( first.begin(), first.end() );
+    forEachImageParallel( parallel.begin(), parallel.end(), flopImage(), 3 );
+
+    vector<Blob> blobs;
+    writeImagesParallel( parallel.begin(), parallel.end(), &blobs );
+
+    list<Image> third;
+    readImagesParallel( &third, blobs.begin(), blobs.end() );
+
+    if ( third.size() != flopped.size() )
+      {
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  Parallel read returned " << third.size()
+	     << " images rather than " << flopped.size() << endl;
+      }
+
+    list<Image>::iterator floppedIter = flopped.begin();
+    list<Image>::iterator thirdIter = third.begin();
+    while( floppedIter != flopped.end() && thirdIter != third.end() )
+      {
+	if ( floppedIter->signature( true ) != thirdIter->signature( true ) )
+	  {
+	    ++failures;
+	    cout << "Line: " << __LINE__
+		 << "  Parallel image scene: " << thirdIter->scene()
+		 << " is not equal to sequential result" << endl;
+	  }
+	floppedIter++;
+	thirdIter++;
+      }
+
+    try
+      {
+	forEachImageParallel( parallel.begin(), parallel.end(), failImage(),
+			      3 );
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  Parallel failed function did not throw" << endl;
+      }
+    catch( Error & )
+      {
+      }
+
+    // The exception for the first failed image is re-thrown
+    vector<string> names;
+    names.push_back( srcdir + "test_image_anim.miff" );
+    names.push_back( "testmagick_missing_1.miff" );
+    names.push_back( "testmagick_missing_2.miff" );
+    list<Image> fourth;
+    try
+      {
+	readImagesParallel( &fourth, names.begin(), names.end() );
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  Parallel read of missing file did not throw" << endl;
+      }
+    catch( Exception & )
+      {
+      }
+
+    // Every image before the first failed image is processed
+    vector<Image> marked;
+    for ( unsigned int scene = 0; scene < 12; ++scene )
+      {
+	marked.push_back( Image( Geometry( 4, 4 ), Color( "red" ) ) );
+	marked.back().scene( scene );
+      }
+    try
+      {
+	forEachImageParallel( marked.begin(), marked.end(), markImage( 6 ),
+			      3 );
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  Parallel failed function did not throw" << endl;
+      }
+    catch( Error & )
+      {
+      }
+    for ( unsigned int scene = 0; scene < 6; ++scene )
+      if ( marked[scene].comment() != "processed" )
+	{
+	  ++failures;
+	  cout << "Line: " << __LINE__
+	       << "  Image " << scene << " before the failed image"
+	       << " was not processed" << endl;
+	}
+    if ( marked[6].comment() == "processed" )
+      {
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  The failed image was processed" << endl;
+      }
+
+    // Images are read with the options of the image passed
+    vector<string> animations;
+    animations.push_back( srcdir + "test_image_anim.miff" );
+    animations.push_back( srcdir + "test_image_anim.miff" );
+    Image readOptions;
+    readOptions.subRange( 1 );
+    list<Image> fifth;
+    readImagesParallel( &fifth, animations.begin(), animations.end(),
+			readOptions );
+    if ( fifth.size() != animations.size() )
+      {
+	++failures;
+	cout << "Line: " << __LINE__
+	     << "  Parallel read with subRange returned " << fifth.size()
+	     << " images rather than " << animations.size() << endl;
+      }
   }
 
   catch( Exception &error_ )
@@ -1003,11 +1003,13 @@ static int wandObjCmd(
     static CONST char *metricNames[] = {
         "meanabsoluteerror",       "meansquarederror",    "peakabsoluteerror",
         "peaksignaltonoiseratio",  "rootmeansquarederror",
+        "structuralsimilarity",    "multiscalestructuralsimilarity",
         (char *) NULL
     };
     static ChannelType metricTypes[] = {
         MeanAbsoluteErrorMetric, MeanSquaredErrorMetric,  PeakAbsoluteErrorMetric,
-        PeakSignalToNoiseRatioMetric, RootMeanSquaredErrorMetric
+        PeakSignalToNoiseRatioMetric, RootMeanSquaredErrorMetric,
+        StructuralSimilarityMetric, MultiScaleStructuralSimilarityMetric
     };
     static CONST char *csNames[] = {
         "undefined", "RGB",   "GRAY",  "transparent",
@@ -200,7 +200,7 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
   {
     if (q < pixels || q  >= end)
       break;
-    count=ReadBlobByte(image);
+    count=ReadBlobByteInline(image);
     if (count == EOF)
       return MagickFail;
     if (count != 0)
@@ -209,7 +209,7 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
         /*
           Encoded mode.
         */
-        byte=ReadBlobByte(image);
+        byte=ReadBlobByteInline(image);
         if (byte == EOF)
           return MagickFail;
         if (compression == BI_RLE8)
@@ -234,7 +234,7 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
         /*
           Escape mode.
         */
-        count=ReadBlobByte(image);
+        count=ReadBlobByteInline(image);
         if (count == EOF)
           return MagickFail;
         if (count == 0x01)
@@ -256,11 +256,11 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
             /*
               Delta mode.
             */
-            byte=ReadBlobByte(image);
+            byte=ReadBlobByteInline(image);
             if (byte == EOF)
               return MagickFail;
             x+=byte;
-            byte=ReadBlobByte(image);
+            byte=ReadBlobByteInline(image);
             if (byte == EOF)
               return MagickFail;
             y+=byte;
@@ -276,7 +276,7 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
             if (compression == BI_RLE8)
               for (i=count; i != 0; --i)
                 {
-                  byte=ReadBlobByte(image);
+                  byte=ReadBlobByteInline(image);
                   if (byte == EOF)
                     return MagickFail;
                   *q++=byte;
@@ -286,7 +286,7 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
               {
                 if ((i & 0x01) == 0)
                   {
-                    byte=ReadBlobByte(image);
+                    byte=ReadBlobByteInline(image);
                     if (byte == EOF)
                       return MagickFail;
                   }
@@ -300,11 +300,11 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
             if (compression == BI_RLE8)
               {
                 if (count & 0x01)
-                  (void) ReadBlobByte(image);
+                  (void) ReadBlobByteInline(image);
               }
             else
               if (((count & 0x03) == 1) || ((count & 0x03) == 2))
-                (void) ReadBlobByte(image);
+                (void) ReadBlobByteInline(image);
             break;
           }
         }
@@ -315,8 +315,8 @@ static MagickPassFail DecodeImage(Image *image,const unsigned long compression,
 				  image->columns,image->rows))
         break;
   }
-  (void) ReadBlobByte(image);  /* end of line */
-  (void) ReadBlobByte(image);
+  (void) ReadBlobByteInline(image);  /* end of line */
+  (void) ReadBlobByteInline(image);
   return(MagickPass);
 }
 
@@ -538,7 +538,8 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
   unsigned char
     *bmp_colormap,
     magick[12],
-    *pixels;
+    *pixels,
+    *raster;
 
   unsigned int
     status;
@@ -1005,14 +1006,23 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
                                image->rows);
     if (pixels == (unsigned char *) NULL)
       ThrowBMPReaderException(ResourceLimitError,MemoryAllocationFailed,image);
+    raster=pixels;
     if ((bmp_info.compression == BI_RGB) ||
         (bmp_info.compression == BI_BITFIELDS))
       {
+        void
+          *raster_data;
+
         if (logging)
           (void) LogMagickEvent(CoderEvent,GetMagickModule(),
             "  Reading pixels (%" MAGICK_SIZE_T_F "u bytes)",
                                 (MAGICK_SIZE_T) length);
-        (void) ReadBlob(image,length,(char *) pixels);
+        /*
+          Access the raster in place if the blob is in memory.
+        */
+        raster_data=pixels;
+        (void) ReadBlobZC(image,length,&raster_data);
+        raster=(unsigned char *) raster_data;
       }
     else
       {
@@ -1097,7 +1107,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
         */
         for (y=(long) image->rows-1; y >= 0; y--)
         {
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1126,7 +1136,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
         */
         for (y=(long) image->rows-1; y >= 0; y--)
         {
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1158,7 +1168,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
           bytes_per_line=image->columns;
         for (y=(long) image->rows-1; y >= 0; y--)
         {
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1195,7 +1205,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
         image->storage_class=DirectClass;
         for (y=(long) image->rows-1; y >= 0; y--)
         {
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1247,7 +1257,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
         bytes_per_line=4*((image->columns*24+31)/32);
         for (y=(long) image->rows-1; y >= 0; y--)
         {
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1287,7 +1297,7 @@ static Image *ReadBMPImage(const ImageInfo *image_info,ExceptionInfo *exception)
           unsigned long
             pixel;
 
-          p=pixels+(image->rows-y-1)*bytes_per_line;
+          p=raster+(image->rows-y-1)*bytes_per_line;
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
@@ -1919,6 +1929,11 @@ static unsigned int WriteBMPImage(const ImageInfo *image_info,Image *image)
           (void) LogMagickEvent(CoderEvent,GetMagickModule(),
             "   Number_colors=%lu",bmp_info.number_colors);
       }
+    /*
+      Reserve the output size if writing to memory.
+    */
+    if (GetBlobFileHandle(image) == (FILE *) NULL)
+      (void) BlobReserveSize(image,TellBlob(image)+bmp_info.file_size);
     (void) WriteBlob(image,2,"BM");
     (void) WriteBlobLSBLong(image,bmp_info.file_size);
     (void) WriteBlobLSBLong(image,bmp_info.ba_offset);  /* always 0 */
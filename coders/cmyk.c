@@ -49,6 +49,7 @@
 */
 static unsigned int
   WriteCMYKImage(const ImageInfo *,Image *);
+
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -102,6 +103,7 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
     count;
 
   unsigned char
+    *pixels,
     *scanline;
 
   unsigned int
@@ -164,6 +166,7 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
 			       packet_size,image->tile_info.width);
   if (scanline == (unsigned char *) NULL)
     ThrowReaderException(ResourceLimitError,MemoryAllocationFailed,image);
+  pixels=scanline;
   /*
     Initialize import options.
   */
@@ -188,7 +191,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
       */
       image->scene++;
       for (y=0; y < (long) image->rows; y++)
-        (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+        (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                scanline,&pixels);
     }
   x=(long) (packet_size*image->tile_info.x);
   do
@@ -209,19 +213,21 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
           No interlacing:  CMYKCMYKCMYKCMYKCMYKCMYK...
         */
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
           if (!image->matte)
-            (void) ImportImagePixelArea(image,CMYKQuantum,quantum_size,scanline+x,
+            (void) ImportImagePixelArea(image,CMYKQuantum,quantum_size,pixels+x,
 					&import_options,0);
           else
-            (void) ImportImagePixelArea(image,CMYKAQuantum,quantum_size,scanline+x,
+            (void) ImportImagePixelArea(image,CMYKAQuantum,quantum_size,pixels+x,
 					&import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -234,7 +240,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         break;
       }
       case LineInterlace:
@@ -244,30 +251,35 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         */
         packet_size=(quantum_size)/8;
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,CyanQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,CyanQuantum,quantum_size,pixels+x,
 				      &import_options,0);
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
-          (void) ImportImagePixelArea(image,MagentaQuantum,quantum_size,scanline+x,
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
+          (void) ImportImagePixelArea(image,MagentaQuantum,quantum_size,pixels+x,
 				      &import_options,0);
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
-          (void) ImportImagePixelArea(image,YellowQuantum,quantum_size,scanline+x,
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
+          (void) ImportImagePixelArea(image,YellowQuantum,quantum_size,pixels+x,
 				      &import_options,0);
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
-          (void) ImportImagePixelArea(image,BlackQuantum,quantum_size,scanline+x,
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
+          (void) ImportImagePixelArea(image,BlackQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (image->matte)
             {
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
-              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,scanline+x,
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
+              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,pixels+x,
 					  &import_options,0);
             }
           if (!SyncImagePixels(image))
@@ -281,7 +293,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         break;
       }
       case PlaneInterlace:
@@ -302,17 +315,19 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
           }
         packet_size=(quantum_size)/8;
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         i=0;
         span=image->rows*(image->matte ? 5 : 4);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,CyanQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,CyanQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -326,7 +341,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image_info->interlace == PartitionInterlace)
           {
             CloseBlob(image);
@@ -336,14 +352,16 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
               ThrowReaderException(FileOpenError,UnableToOpenFile,image);
           }
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
           q=GetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,MagentaQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,MagentaQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -357,7 +375,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image_info->interlace == PartitionInterlace)
           {
             CloseBlob(image);
@@ -367,14 +386,16 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
               ThrowReaderException(FileOpenError,UnableToOpenFile,image);
           }
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
           q=GetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,YellowQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,YellowQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -388,7 +409,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image_info->interlace == PartitionInterlace)
           {
             CloseBlob(image);
@@ -398,14 +420,16 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
               ThrowReaderException(FileOpenError,UnableToOpenFile,image);
           }
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
           q=GetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,BlackQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,BlackQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -419,7 +443,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image->matte)
           {
             /*
@@ -434,16 +459,16 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
                   ThrowReaderException(FileOpenError,UnableToOpenFile,image);
               }
             for (y=0; y < image->tile_info.y; y++)
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
             for (y=0; y < (long) image->rows; y++)
             {
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
               q=GetImagePixels(image,0,y,image->columns,1);
               if (q == (PixelPacket *) NULL)
                 break;
-              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,scanline+x,
+              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,pixels+x,
 					  &import_options,0);
               if (!SyncImagePixels(image))
                 break;
@@ -457,8 +482,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
             }
             count=image->tile_info.height-image->rows-image->tile_info.y;
             for (i=0; i < (long) count; i++)
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
           }
         if (image_info->interlace == PartitionInterlace)
           (void) strlcpy(image->filename,image_info->filename,MaxTextExtent);
@@ -479,7 +504,8 @@ static Image *ReadCMYKImage(const ImageInfo *image_info,
         break;
     if (image_info->interlace == PartitionInterlace)
       break;
-    count=ReadBlob(image,packet_size*image->tile_info.width,scanline);
+    count=ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                           scanline,&pixels);
     if (count != 0)
       {
         /*
@@ -771,13 +771,13 @@ static size_t ReadBlobBlock(Image *image,unsigned char *data)
   size_t
     count=0;
 
-  unsigned char
+  int
     block_count;
 
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
   assert(data != (unsigned char *) NULL);
-  if (ReadBlob(image,1,&block_count) == 1)
+  if ((block_count=ReadBlobByteInline(image)) != EOF)
     {
       if ((count=ReadBlob(image,(size_t) block_count,data)) != (size_t) block_count)
 	count=0;
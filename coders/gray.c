@@ -162,6 +162,7 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
     count;
 
   unsigned char
+    *pixels,
     *scanline;
 
   unsigned int
@@ -227,6 +228,7 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
   scanline=MagickAllocateArray(unsigned char *,packet_size,image->tile_info.width);
   if (scanline == (unsigned char *) NULL)
     ThrowReaderException(ResourceLimitError,MemoryAllocationFailed,image);
+  pixels=scanline;
   /*
     Initialize import options.
   */
@@ -259,7 +261,8 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
       */
       image->scene++;
       for (y=0; y < (long) image->rows; y++)
-        (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+        (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                scanline,&pixels);
     }
   x=(long) (packet_size*image->tile_info.x);
   do
@@ -271,7 +274,8 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
       if (image->scene >= (image_info->subimage+image_info->subrange-1))
         break;
     for (y=0; y < image->tile_info.y; y++)
-      (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+      (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                              scanline,&pixels);
     /*
       Support GRAYA with matte channel
     */
@@ -280,13 +284,14 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
     for (y=0; y < (long) image->rows; y++)
     {
       if ((y > 0) || (image->previous == (Image *) NULL))
-        (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+        (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                scanline,&pixels);
       q=SetImagePixelsEx(image,0,y,image->columns,1,exception);
       if (q == (PixelPacket *) NULL)
         break;
       if (!is_grayscale)
         (void) memset(q,0,sizeof(PixelPacket)*image->columns);
-      (void) ImportImagePixelArea(image,quantum_type,quantum_size,scanline+x,
+      (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels+x,
         			  &import_options,0);
       if (!SyncImagePixelsEx(image,exception))
         break;
@@ -300,7 +305,8 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
     image->is_grayscale=is_grayscale;
     count=image->tile_info.height-image->rows-image->tile_info.y;
     for (j=0; j < (long) count; j++)
-      (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+      (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                              scanline,&pixels);
     if (EOFBlob(image))
       {
         ThrowException(exception,CorruptImageError,UnexpectedEndOfFile,
@@ -313,7 +319,8 @@ static Image *ReadGRAYImage(const ImageInfo *image_info,
     if (image_info->subrange != 0)
       if (image->scene >= (image_info->subimage+image_info->subrange-1))
         break;
-    count=ReadBlob(image,packet_size*image->tile_info.width,scanline);
+    count=ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                           scanline,&pixels);
     if (count != 0)
       {
         /*
@@ -723,6 +723,7 @@ ModuleExport void RegisterJP2Image(void)
   entry=SetMagickInfo("J2C");
   entry->description="JPEG-2000 Code Stream Syntax";
   entry->module="JP2";
+  entry->library="JasPer";
   entry->magick=(MagickHandler) IsJPC;
   entry->adjoin=False;
   entry->seekable_stream=True;
@@ -737,6 +738,7 @@ ModuleExport void RegisterJP2Image(void)
   entry=SetMagickInfo("JP2");
   entry->description="JPEG-2000 JP2 File Format Syntax";
   entry->module="JP2";
+  entry->library="JasPer";
   entry->magick=(MagickHandler) IsJP2;
   entry->adjoin=False;
   entry->seekable_stream=True;
@@ -751,6 +753,7 @@ ModuleExport void RegisterJP2Image(void)
   entry=SetMagickInfo("JPC");
   entry->description="JPEG-2000 Code Stream Syntax";
   entry->module="JP2";
+  entry->library="JasPer";
   entry->magick=(MagickHandler) IsJPC;
   entry->adjoin=False;
   entry->seekable_stream=True;
@@ -765,6 +768,7 @@ ModuleExport void RegisterJP2Image(void)
   entry=SetMagickInfo("PGX");
   entry->description="JPEG-2000 VM Format";
   entry->module="JP2";
+  entry->library="JasPer";
   entry->magick=(MagickHandler) IsJPC;
   entry->adjoin=False;
   entry->seekable_stream=True;
@@ -1527,7 +1527,7 @@ ModuleExport void RegisterJPEGImage(void)
 #endif
 
   entry=SetMagickInfo("JPEG");
-  entry->thread_support=False; /* libjpeg is not thread safe */
+  entry->thread_support=True;
 #if defined(HasJPEG)
   entry->decoder=(DecoderHandler) ReadJPEGImage;
   entry->encoder=(EncoderHandler) WriteJPEGImage;
@@ -1542,7 +1542,7 @@ ModuleExport void RegisterJPEGImage(void)
   (void) RegisterMagickInfo(entry);
 
   entry=SetMagickInfo("JPG");
-  entry->thread_support=False; /* libjpeg is not thread safe */
+  entry->thread_support=True;
 #if defined(HasJPEG)
   entry->decoder=(DecoderHandler) ReadJPEGImage;
   entry->encoder=(EncoderHandler) WriteJPEGImage;
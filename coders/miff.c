@@ -712,6 +712,622 @@ static void ZLIBFreeFunc(voidpf opaque, voidpf address)
 }
 #endif /* defined(HasZLIB) */
 
+/*
+  Banded pixel data.
+
+  If the header contains "band-rows=N", the image rows are divided into
+  bands of N rows (the last band may be shorter), and each band is
+  compressed independently of the others.  The pixel data starts with
+  an index holding the compressed length of each band as a 32-bit MSB
+  value, followed by the bands in order.  Since bands are independent,
+  they may be compressed or decompressed, and exported or imported, in
+  parallel.  Banded output is requested with "-define miff:band-rows=N".
+*/
+#define MIFFMaxBandLength 0x10000000UL
+
+static unsigned int
+MIFFBandThreads(const unsigned long bands)
+{
+  unsigned int
+    threads;
+
+  /*
+    Pixel cache views are allocated per OpenMP thread, so at most
+    omp_get_max_threads() threads may be used.
+  */
+  threads=(unsigned int) omp_get_max_threads();
+  if (threads > bands)
+    threads=(unsigned int) bands;
+  if (threads < 1)
+    threads=1;
+  return threads;
+}
+
+static size_t
+MIFFBandCompressBound(const CompressionType compression,const size_t length)
+{
+  switch (compression)
+    {
+#if defined(HasZLIB)
+    case ZipCompression:
+      return (size_t) compressBound((uLong) length);
+#endif /* defined(HasZLIB) */
+#if defined(HasBZLIB)
+    case BZipCompression:
+      return length+length/100+600;
+#endif /* defined(HasBZLIB) */
+    default:
+      return length;
+    }
+}
+
+static MagickPassFail
+MIFFCompressBand(const CompressionType compression,const int level,
+                 const unsigned char *source,const size_t source_length,
+                 unsigned char *destination,size_t *destination_length)
+{
+  MagickPassFail
+    status=MagickFail;
+
+  switch (compression)
+    {
+#if defined(HasZLIB)
+    case ZipCompression:
+      {
+        uLongf
+          length=(uLongf) *destination_length;
+
+        if (compress2(destination,&length,source,(uLong) source_length,
+                      level) == Z_OK)
+          {
+            *destination_length=(size_t) length;
+            status=MagickPass;
+          }
+        break;
+      }
+#endif /* defined(HasZLIB) */
+#if defined(HasBZLIB)
+    case BZipCompression:
+      {
+        unsigned int
+          length=(unsigned int) *destination_length;
+
+        if (BZ2_bzBuffToBuffCompress((char *) destination,&length,
+                                     (char *) source,
+                                     (unsigned int) source_length,
+                                     Max(level,1),0,0) == BZ_OK)
+          {
+            *destination_length=(size_t) length;
+            status=MagickPass;
+          }
+        break;
+      }
+#endif /* defined(HasBZLIB) */
+    default:
+      {
+        ARG_NOT_USED(level);
+        ARG_NOT_USED(source);
+        ARG_NOT_USED(source_length);
+        ARG_NOT_USED(destination);
+        ARG_NOT_USED(destination_length);
+        break;
+      }
+    }
+  return status;
+}
+
+static MagickPassFail
+MIFFDecompressBand(const CompressionType compression,
+                   const unsigned char *source,const size_t source_length,
+                   unsigned char *destination,const size_t destination_length)
+{
+  MagickPassFail
+    status=MagickFail;
+
+  switch (compression)
+    {
+#if defined(HasZLIB)
+    case ZipCompression:
+      {
+        uLongf
+          length=(uLongf) destination_length;
+
+        if ((uncompress(destination,&length,source,(uLong) source_length)
+             == Z_OK) && (length == (uLongf) destination_length))
+          status=MagickPass;
+        break;
+      }
+#endif /* defined(HasZLIB) */
+#if defined(HasBZLIB)
+    case BZipCompression:
+      {
+        unsigned int
+          length=(unsigned int) destination_length;
+
+        if ((BZ2_bzBuffToBuffDecompress((char *) destination,&length,
+                                        (char *) source,
+                                        (unsigned int) source_length,0,0)
+             == BZ_OK) && (length == (unsigned int) destination_length))
+          status=MagickPass;
+        break;
+      }
+#endif /* defined(HasBZLIB) */
+    default:
+      {
+        ARG_NOT_USED(source);
+        ARG_NOT_USED(source_length);
+        ARG_NOT_USED(destination);
+        ARG_NOT_USED(destination_length);
+        break;
+      }
+    }
+  return status;
+}
+
+static void
+DestroyMIFFBandBuffers(unsigned char **buffers,const unsigned int count)
+{
+  unsigned int
+    i;
+
+  if (buffers == (unsigned char **) NULL)
+    return;
+  for (i=0; i < count; i++)
+    MagickFreeMemory(buffers[i]);
+  MagickFreeMemory(buffers);
+}
+
+static unsigned char **
+AllocateMIFFBandBuffers(const unsigned int count,const size_t length)
+{
+  unsigned char
+    **buffers;
+
+  unsigned int
+    i;
+
+  buffers=MagickAllocateArray(unsigned char **,count,sizeof(unsigned char *));
+  if (buffers == (unsigned char **) NULL)
+    return buffers;
+  (void) memset(buffers,0,count*sizeof(unsigned char *));
+  for (i=0; i < count; i++)
+    {
+      buffers[i]=MagickAllocateMemory(unsigned char *,length);
+      if (buffers[i] == (unsigned char *) NULL)
+        {
+          DestroyMIFFBandBuffers(buffers,count);
+          return (unsigned char **) NULL;
+        }
+    }
+  return buffers;
+}
+
+/*
+  Read the band index and banded pixel data of an image.  Bands are
+  read in groups of one band per thread, and the bands of each group
+  are then decompressed and imported in parallel.  Band data is used
+  in place if the blob is in memory.
+*/
+static MagickPassFail
+ReadMIFFBands(Image *image,const CompressionType compression,
+              const unsigned long band_rows,const QuantumType quantum_type,
+              const unsigned int quantum_size,const size_t packet_size,
+              ExceptionInfo *exception)
+{
+  magick_uint32_t
+    *band_lengths = (magick_uint32_t *) NULL;
+
+  unsigned char
+    **compressed = (unsigned char **) NULL,
+    **uncompressed = (unsigned char **) NULL;
+
+  void
+    **band_data = (void **) NULL;
+
+  size_t
+    band_length,
+    compressed_length,
+    row_length;
+
+  unsigned long
+    band,
+    bands,
+    bands_done;
+
+  unsigned int
+    threads;
+
+  MagickPassFail
+    status=MagickPass;
+
+  row_length=MagickArraySize(packet_size,image->columns);
+  band_length=MagickArraySize(row_length,band_rows);
+  if ((row_length == 0) || (band_length == 0) ||
+      (band_length > MIFFMaxBandLength))
+    {
+      ThrowException(exception,CorruptImageError,ImproperImageHeader,
+                     image->filename);
+      return MagickFail;
+    }
+  compressed_length=MIFFBandCompressBound(compression,band_length);
+  bands=(image->rows+band_rows-1)/band_rows;
+  threads=MIFFBandThreads(bands);
+  (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                        "Reading %lu bands of %lu rows using %u threads",
+                        bands,band_rows,threads);
+
+  /*
+    Read band index.
+  */
+  band_lengths=MagickAllocateArray(magick_uint32_t *,bands,
+                                   sizeof(magick_uint32_t));
+  if (band_lengths == (magick_uint32_t *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      return MagickFail;
+    }
+  for (band=0; band < bands; band++)
+    {
+      band_lengths[band]=ReadBlobMSBLong(image);
+      if (EOFBlob(image) ||
+          (band_lengths[band] > compressed_length) ||
+          ((compression == NoCompression) &&
+           (band_lengths[band] !=
+            row_length*Min(band_rows,image->rows-band*band_rows))))
+        {
+          ThrowException(exception,CorruptImageError,ImproperImageHeader,
+                         image->filename);
+          status=MagickFail;
+          break;
+        }
+    }
+
+  if (status != MagickFail)
+    {
+      uncompressed=AllocateMIFFBandBuffers(threads,band_length);
+      if (compression != NoCompression)
+        compressed=AllocateMIFFBandBuffers(threads,compressed_length);
+      band_data=MagickAllocateArray(void **,threads,sizeof(void *));
+      if ((uncompressed == (unsigned char **) NULL) ||
+          ((compression != NoCompression) &&
+           (compressed == (unsigned char **) NULL)) ||
+          (band_data == (void **) NULL))
+        {
+          ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                         image->filename);
+          status=MagickFail;
+        }
+    }
+
+  bands_done=0;
+  for (band=0; (status != MagickFail) && (band < bands); band += threads)
+    {
+      long
+        group,
+        group_bands;
+
+      group_bands=(long) Min(threads,bands-band);
+
+      /*
+        Read the bands of this group.
+      */
+      for (group=0; group < group_bands; group++)
+        {
+          band_data[group]=(compression == NoCompression ?
+                            uncompressed[group] : compressed[group]);
+          if (ReadBlobZC(image,band_lengths[band+group],&band_data[group]) !=
+              (size_t) band_lengths[band+group])
+            {
+              ThrowException(exception,CorruptImageError,UnexpectedEndOfFile,
+                             image->filename);
+              status=MagickFail;
+              break;
+            }
+        }
+      if (status == MagickFail)
+        break;
+
+      /*
+        Decompress and import the bands of this group in parallel.
+      */
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for num_threads(threads) schedule(runtime) shared(status,bands_done)
+#  else
+#    pragma omp parallel for num_threads(threads) schedule(static,1) shared(status,bands_done)
+#  endif
+#endif
+      for (group=0; group < group_bands; group++)
+        {
+          const unsigned char
+            *p;
+
+          unsigned long
+            rows,
+            y,
+            y_start;
+
+          MagickPassFail
+            thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadMIFFImage)
+#endif
+          thread_status=status;
+          if (thread_status == MagickFail)
+            continue;
+
+          y_start=(band+group)*band_rows;
+          rows=Min(band_rows,image->rows-y_start);
+          if ((compression != NoCompression) &&
+              (MIFFDecompressBand(compression,
+                                  (const unsigned char *) band_data[group],
+                                  band_lengths[band+group],
+                                  uncompressed[group],rows*row_length)
+               == MagickFail))
+            {
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadMIFFImage)
+#endif
+              ThrowException(exception,CorruptImageError,
+                             UnableToUncompressImage,image->filename);
+              thread_status=MagickFail;
+            }
+          p=(compression == NoCompression ?
+             (const unsigned char *) band_data[group] : uncompressed[group]);
+          for (y=y_start; (thread_status != MagickFail) &&
+                 (y < y_start+rows); y++)
+            {
+              if ((SetImagePixels(image,0,(long) y,image->columns,1) ==
+                   (PixelPacket *) NULL) ||
+                  (ImportImagePixelArea(image,quantum_type,quantum_size,p,0,0)
+                   == MagickFail) ||
+                  !SyncImagePixels(image))
+                thread_status=MagickFail;
+              p+=row_length;
+            }
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadMIFFImage)
+#endif
+          {
+            if (thread_status == MagickFail)
+              status=MagickFail;
+            bands_done++;
+            if (image->previous == (Image *) NULL)
+              if (QuantumTick(bands_done,bands))
+                if (!MagickMonitorFormatted(bands_done,bands,exception,
+                                            LoadImageText,image->filename,
+                                            image->columns,image->rows))
+                  status=MagickFail;
+          }
+        }
+    }
+
+  DestroyMIFFBandBuffers(compressed,threads);
+  DestroyMIFFBandBuffers(uncompressed,threads);
+  MagickFreeMemory(band_data);
+  MagickFreeMemory(band_lengths);
+  return status;
+}
+
+/*
+  Write the band index and banded pixel data of an image.  A
+  placeholder index is written first, since the band lengths are only
+  known once the bands are compressed.  Bands are exported and
+  compressed in parallel in groups of one band per thread, the
+  bands of each group are written in order, and the index is then
+  rewritten.  The blob must be seekable.
+*/
+static MagickPassFail
+WriteMIFFBands(const ImageInfo *image_info,Image *image,
+               const CompressionType compression,const unsigned long band_rows,
+               const QuantumType quantum_type,const unsigned int quantum_size,
+               const size_t packet_size)
+{
+  magick_uint32_t
+    *band_lengths = (magick_uint32_t *) NULL;
+
+  unsigned char
+    **compressed = (unsigned char **) NULL,
+    **uncompressed = (unsigned char **) NULL;
+
+  size_t
+    band_length,
+    compressed_length,
+    row_length;
+
+  magick_off_t
+    index_offset;
+
+  unsigned long
+    band,
+    bands,
+    bands_done;
+
+  unsigned int
+    threads;
+
+  int
+    level;
+
+  MagickPassFail
+    status=MagickPass;
+
+  row_length=MagickArraySize(packet_size,image->columns);
+  band_length=MagickArraySize(row_length,band_rows);
+  compressed_length=MIFFBandCompressBound(compression,band_length);
+  level=(int) Min(image_info->quality/10,9);
+  bands=(image->rows+band_rows-1)/band_rows;
+  threads=MIFFBandThreads(bands);
+  (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                        "Writing %lu bands of %lu rows using %u threads",
+                        bands,band_rows,threads);
+
+  band_lengths=MagickAllocateArray(magick_uint32_t *,bands,
+                                   sizeof(magick_uint32_t));
+  uncompressed=AllocateMIFFBandBuffers(threads,band_length);
+  if (compression != NoCompression)
+    compressed=AllocateMIFFBandBuffers(threads,compressed_length);
+  if ((band_lengths == (magick_uint32_t *) NULL) ||
+      (uncompressed == (unsigned char **) NULL) ||
+      ((compression != NoCompression) &&
+       (compressed == (unsigned char **) NULL)))
+    {
+      ThrowException(&image->exception,ResourceLimitError,
+                     MemoryAllocationFailed,image->filename);
+      status=MagickFail;
+    }
+
+  /*
+    Write placeholder band index.
+  */
+  index_offset=TellBlob(image);
+  for (band=0; (status != MagickFail) && (band < bands); band++)
+    {
+      band_lengths[band]=0;
+      (void) WriteBlobMSBLong(image,0U);
+    }
+
+  bands_done=0;
+  for (band=0; (status != MagickFail) && (band < bands); band += threads)
+    {
+      long
+        group,
+        group_bands;
+
+      group_bands=(long) Min(threads,bands-band);
+
+      /*
+        Export and compress the bands of this group in parallel.
+      */
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for num_threads(threads) schedule(runtime) shared(status)
+#  else
+#    pragma omp parallel for num_threads(threads) schedule(static,1) shared(status)
+#  endif
+#endif
+      for (group=0; group < group_bands; group++)
+        {
+          unsigned char
+            *q;
+
+          size_t
+            length;
+
+          unsigned long
+            rows,
+            y,
+            y_start;
+
+          MagickPassFail
+            thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_WriteMIFFImage)
+#endif
+          thread_status=status;
+          if (thread_status == MagickFail)
+            continue;
+
+          y_start=(band+group)*band_rows;
+          rows=Min(band_rows,image->rows-y_start);
+          q=uncompressed[group];
+          for (y=y_start; y < y_start+rows; y++)
+            {
+              if ((AcquireImagePixels(image,0,(long) y,image->columns,1,
+                                      &image->exception) ==
+                   (const PixelPacket *) NULL) ||
+                  (ExportImagePixelArea(image,quantum_type,quantum_size,q,0,0)
+                   == MagickFail))
+                {
+                  thread_status=MagickFail;
+                  break;
+                }
+              q+=row_length;
+            }
+          length=rows*row_length;
+          if ((thread_status != MagickFail) &&
+              (compression != NoCompression))
+            {
+              length=compressed_length;
+              if (MIFFCompressBand(compression,level,uncompressed[group],
+                                   rows*row_length,compressed[group],&length)
+                  == MagickFail)
+                {
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_WriteMIFFImage)
+#endif
+                  ThrowException(&image->exception,CoderError,
+                                 UnableToZipCompressImage,image->filename);
+                  thread_status=MagickFail;
+                }
+            }
+          band_lengths[band+group]=(magick_uint32_t) length;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_WriteMIFFImage)
+#endif
+          {
+            if (thread_status == MagickFail)
+              status=MagickFail;
+          }
+        }
+      if (status == MagickFail)
+        break;
+
+      /*
+        Write the bands of this group.
+      */
+      for (group=0; group < group_bands; group++)
+        {
+          const unsigned char
+            *data;
+
+          data=(compression == NoCompression ? uncompressed[group] :
+                compressed[group]);
+          if (WriteBlob(image,band_lengths[band+group],data) !=
+              (size_t) band_lengths[band+group])
+            {
+              ThrowException(&image->exception,FileOpenError,
+                             UnableToWriteFile,image->filename);
+              status=MagickFail;
+              break;
+            }
+          bands_done++;
+          if (image->previous == (Image *) NULL)
+            if (QuantumTick(bands_done,bands))
+              if (!MagickMonitorFormatted(bands_done,bands,&image->exception,
+                                          SaveImageText,image->filename,
+                                          image->columns,image->rows))
+                status=MagickFail;
+        }
+    }
+
+  /*
+    Rewrite band index.
+  */
+  if (status != MagickFail)
+    {
+      if (SeekBlob(image,index_offset,SEEK_SET) != index_offset)
+        status=MagickFail;
+      for (band=0; (status != MagickFail) && (band < bands); band++)
+        (void) WriteBlobMSBLong(image,band_lengths[band]);
+      if ((status != MagickFail) && (SeekBlob(image,0,SEEK_END) < 0))
+        status=MagickFail;
+      if (status == MagickFail)
+        ThrowException(&image->exception,BlobError,UnableToSeekToOffset,
+                       image->filename);
+    }
+
+  DestroyMIFFBandBuffers(compressed,threads);
+  DestroyMIFFBandBuffers(uncompressed,threads);
+  MagickFreeMemory(band_lengths);
+  return status;
+}
+
 #define ThrowMIFFReaderException(code_,reason_,image_) \
 do { \
   if (number_of_profiles > 0) \
@@ -786,6 +1402,9 @@ static Image *ReadMIFFImage(const ImageInfo *image_info,
     packet_size,
     quantum_size;
 
+  unsigned long
+    band_rows;
+
   ProfileInfo
     *profiles=0;
 
@@ -824,6 +1443,7 @@ static Image *ReadMIFFImage(const ImageInfo *image_info,
     /*
       Decode image header;  header terminates one character beyond a ':'.
     */
+    band_rows=0;
     colors=0;
     image->depth=8;
     image->compression=NoCompression;
@@ -956,6 +1576,11 @@ static Image *ReadMIFFImage(const ImageInfo *image_info,
                       exception);
                     break;
                   }
+                if (LocaleCompare(keyword,"band-rows") == 0)
+                  {
+                    band_rows=MagickAtoL(values);
+                    break;
+                  }
                 if (LocaleCompare(keyword,"blue-primary") == 0)
                   {
                     (void) sscanf(values,"%lf,%lf",
@@ -1313,6 +1938,18 @@ static Image *ReadMIFFImage(const ImageInfo *image_info,
           }
       }
 
+    if (band_rows != 0)
+      {
+        /*
+          Banded pixel data is not supported with RLE compression.
+        */
+        if (image->compression == RLECompression)
+          ThrowMIFFReaderException(CorruptImageError,ImproperImageHeader,
+                                   image);
+        if (band_rows > image->rows)
+          band_rows=image->rows;
+      }
+
     /*
       Create a normalized version of depth.
     */
@@ -1522,223 +2159,252 @@ static Image *ReadMIFFImage(const ImageInfo *image_info,
       Read image pixels.
     */
    length=0;
-    switch (image->compression)
+    if (band_rows != 0)
       {
-#if defined(HasZLIB)
-      case ZipCompression:
-        {
-	  int
-	    code=0;
-
-          for (y=0; y < (long) image->rows; y++)
-            {
-              q=SetImagePixels(image,0,y,image->columns,1);
-              if (q == (PixelPacket *) NULL)
-                break;
-              if (y == 0)
-                {
-                  zip_info.zalloc=ZLIBAllocFunc;
-                  zip_info.zfree=ZLIBFreeFunc;
-                  zip_info.opaque=(voidpf) NULL;
-                  code=inflateInit(&zip_info);
-                  status|=code >= 0;
-                  zip_info.avail_in=0;
-                }
-              zip_info.next_out=pixels;
-              zip_info.avail_out=(uInt) (packet_size*image->columns);
-              do
-                {
-                  int
-                    zip_status;
-
-                  if (zip_info.avail_in == 0)
-                    {
-                      zip_info.next_in=compress_pixels;
-                      if (version == 0)
-                        {
-                          length=(int) (1.01*packet_size*image->columns+12);
-                          zip_info.avail_in=(uInt) ReadBlob(image,length,zip_info.next_in);
-                        }
-                      else
-                        {
-                          length=ReadBlobMSBLong(image);
-                          if (length > compressed_length)
-                            {
-                              (void) inflateEnd(&zip_info);
-                              ThrowMIFFReaderException(CorruptImageError,
-                                                       LengthAndFilesizeDoNotMatch,
-                                                       image);
-                            }
-                          zip_info.avail_in=(uInt) ReadBlob(image,length,zip_info.next_in);
-                          if ((size_t) zip_info.avail_in != length)
-                            {
-                              (void) inflateEnd(&zip_info);
-                              ThrowMIFFReaderException(CorruptImageError,
-                                                       UnexpectedEndOfFile,
-                                                       image);
-                            }
-                        }
-                    }
-                  zip_status=inflate(&zip_info,Z_NO_FLUSH);
-                  if (zip_status == Z_STREAM_END)
-                    break;
-                  else if (zip_status != Z_OK)
-                    {
-                      (void) inflateEnd(&zip_info);
-                      ThrowMIFFReaderException(CorruptImageError,UnableToUncompressImage,
-                                           image);
-                    }
-                } while (zip_info.avail_out != 0);
-              if (y == (long) (image->rows-1))
-                {
-                  if (version == 0)
-                    (void) SeekBlob(image,-((ExtendedSignedIntegralType)
-                                            zip_info.avail_in),SEEK_CUR);
-                  code=inflateEnd(&zip_info);
-                  status|=code >= 0;
-                }
-              (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
-              if (!SyncImagePixels(image))
-                break;
-              if (image->previous == (Image *) NULL)
-                if (QuantumTick(y,image->rows))
-                  if (!MagickMonitorFormatted(y,image->rows,exception,
-                                              LoadImageText,image->filename,
-					      image->columns,image->rows))
-                    break;
-            }
-          break;
-        } /* End case ZipCompression */
-#endif
-#if defined(HasBZLIB)
-      case BZipCompression:
-        {
-	  int
-	    code=0;
-
-          for (y=0; y < (long) image->rows; y++)
-            {
-              q=SetImagePixels(image,0,y,image->columns,1);
-              if (q == (PixelPacket *) NULL)
-                break;
-              if (y == 0)
-                {
-                  bzip_info.bzalloc=NULL;
-                  bzip_info.bzfree=NULL;
-                  bzip_info.opaque=NULL;
-                  code=BZ2_bzDecompressInit(&bzip_info,image_info->verbose,False);
-                  status|=code >= 0;
-                  bzip_info.avail_in=0;
-                }
-              bzip_info.next_out=(char *) pixels;
-              bzip_info.avail_out=(unsigned int) (packet_size*image->columns);
-              do
-                {
-                  int
-                    bz_status;
-
-                  if (bzip_info.avail_in == 0)
-                    {
-                      bzip_info.next_in=(char *) compress_pixels;
-                      if (version == 0)
-                        {
-                          length=(int) (1.01*packet_size*image->columns+600);
-                          bzip_info.avail_in=(unsigned int) ReadBlob(image,length,bzip_info.next_in);
-                        }
-                      else
-                        {
-                          length=ReadBlobMSBLong(image);
-                          bzip_info.avail_in=(unsigned int) ReadBlob(image,length,bzip_info.next_in);
-                          if ((size_t) bzip_info.avail_in != length)
-                            {
-                              ThrowMIFFReaderException(CorruptImageError,UnexpectedEndOfFile,
-                                                   image);
-                            }
-                        }
-                    }
-                  bz_status=BZ2_bzDecompress(&bzip_info);
-                  if (bz_status == BZ_STREAM_END)
-                    break;
-                  else if (bz_status != BZ_OK)
-                    {
-                      (void) BZ2_bzDecompressEnd(&bzip_info);
-                      ThrowMIFFReaderException(CorruptImageError,UnableToUncompressImage,
-                                           image);
-                    }
-                } while (bzip_info.avail_out != 0);
-              if (y == (long) (image->rows-1))
-                {
-                  if (version == 0)
-                    (void) SeekBlob(image,-((ExtendedSignedIntegralType)
-                                            bzip_info.avail_in),SEEK_CUR);
-                  code=BZ2_bzDecompressEnd(&bzip_info);
-                  status|=code >= 0;
-                }
-              (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
-              if (!SyncImagePixels(image))
-                break;
-              if (image->previous == (Image *) NULL)
-                if (QuantumTick(y,image->rows))
-                  if (!MagickMonitorFormatted(y,image->rows,exception,
-                                              LoadImageText,image->filename,
-					      image->columns,image->rows))
-                    break;
-            }
-          break;
-        } /* End case BZipCompression */
-#endif
-      case RLECompression:
-        {
-          for (y=0; y < (long) image->rows; y++)
-            {
-              q=SetImagePixels(image,0,y,image->columns,1);
-              if (q == (PixelPacket *) NULL)
-                break;
-              /*
-                Collect one pixel row
-              */
-              p=pixels;
-              for (length=0; length < image->columns; )
-                {
-                  p+=ReadBlob(image,packet_size,p);
-                  length+=*(p-1)+1;
-                }
-
-              (void) ImportRLEPixels(image,quantum_type,quantum_size,pixels);
-              if (!SyncImagePixels(image))
-                break;
-              if (image->previous == (Image *) NULL)
-                if (QuantumTick(y,image->rows))
-                  if (!MagickMonitorFormatted(y,image->rows,exception,
-                                              LoadImageText,image->filename,
-					      image->columns,image->rows))
-                    break;
-
-            }
-          break;
-        } /* End case RLECompression */
-      default:
-        {
-          for (y=0; y < (long) image->rows; y++)
-            {
-              q=SetImagePixels(image,0,y,image->columns,1);
-              if (q == (PixelPacket *) NULL)
-                break;
-              pixels_p=pixels;
-              (void) ReadBlobZC(image,packet_size*image->columns,&pixels_p);
-              (void) ImportImagePixelArea(image,quantum_type,quantum_size,(const unsigned char*) pixels_p,0,0);
-              if (!SyncImagePixels(image))
-                break;
-              if (image->previous == (Image *) NULL)
-                if (QuantumTick(y,image->rows))
-                  if (!MagickMonitorFormatted(y,image->rows,exception,
-                                              LoadImageText,image->filename,
-					      image->columns,image->rows))
-                    break;
-            }
-          break;
-        }
-      } /* End switch (image->compression) */
+        if (ReadMIFFBands(image,image->compression,band_rows,quantum_type,
+                          quantum_size,packet_size,exception) == MagickFail)
+          status=False;
+        y=(long) image->rows;
+      }
+    else
+      {
+	switch (image->compression)
+	  {
+    #if defined(HasZLIB)
+	  case ZipCompression:
+	    {
+	      int
+		code=0;
+
+	      for (y=0; y < (long) image->rows; y++)
+		{
+		  q=SetImagePixels(image,0,y,image->columns,1);
+		  if (q == (PixelPacket *) NULL)
+		    break;
+		  if (y == 0)
+		    {
+		      zip_info.zalloc=ZLIBAllocFunc;
+		      zip_info.zfree=ZLIBFreeFunc;
+		      zip_info.opaque=(voidpf) NULL;
+		      code=inflateInit(&zip_info);
+		      status|=code >= 0;
+		      zip_info.avail_in=0;
+		    }
+		  zip_info.next_out=pixels;
+		  zip_info.avail_out=(uInt) (packet_size*image->columns);
+		  do
+		    {
+		      int
+			zip_status;
+
+		      if (zip_info.avail_in == 0)
+			{
+			  zip_info.next_in=compress_pixels;
+			  if (version == 0)
+			    {
+			      length=(int) (1.01*packet_size*image->columns+12);
+			      zip_info.avail_in=(uInt) ReadBlob(image,length,zip_info.next_in);
+			    }
+			  else
+			    {
+			      void
+				*compress_data;
+
+			      length=ReadBlobMSBLong(image);
+			      if (length > compressed_length)
+				{
+				  (void) inflateEnd(&zip_info);
+				  ThrowMIFFReaderException(CorruptImageError,
+							   LengthAndFilesizeDoNotMatch,
+							   image);
+				}
+			      /* Inflate directly from the blob if it is in memory */
+			      compress_data=compress_pixels;
+			      zip_info.avail_in=(uInt) ReadBlobZC(image,length,&compress_data);
+			      zip_info.next_in=(Bytef *) compress_data;
+			      if ((size_t) zip_info.avail_in != length)
+				{
+				  (void) inflateEnd(&zip_info);
+				  ThrowMIFFReaderException(CorruptImageError,
+							   UnexpectedEndOfFile,
+							   image);
+				}
+			    }
+			}
+		      zip_status=inflate(&zip_info,Z_NO_FLUSH);
+		      if (zip_status == Z_STREAM_END)
+			break;
+		      else if (zip_status != Z_OK)
+			{
+			  (void) inflateEnd(&zip_info);
+			  ThrowMIFFReaderException(CorruptImageError,UnableToUncompressImage,
+					       image);
+			}
+		    } while (zip_info.avail_out != 0);
+		  if (y == (long) (image->rows-1))
+		    {
+		      if (version == 0)
+			(void) SeekBlob(image,-((ExtendedSignedIntegralType)
+						zip_info.avail_in),SEEK_CUR);
+		      code=inflateEnd(&zip_info);
+		      status|=code >= 0;
+		    }
+		  (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
+		  if (!SyncImagePixels(image))
+		    break;
+		  if (image->previous == (Image *) NULL)
+		    if (QuantumTick(y,image->rows))
+		      if (!MagickMonitorFormatted(y,image->rows,exception,
+						  LoadImageText,image->filename,
+						  image->columns,image->rows))
+			break;
+		}
+	      break;
+	    } /* End case ZipCompression */
+    #endif
+    #if defined(HasBZLIB)
+	  case BZipCompression:
+	    {
+	      int
+		code=0;
+
+	      for (y=0; y < (long) image->rows; y++)
+		{
+		  q=SetImagePixels(image,0,y,image->columns,1);
+		  if (q == (PixelPacket *) NULL)
+		    break;
+		  if (y == 0)
+		    {
+		      bzip_info.bzalloc=NULL;
+		      bzip_info.bzfree=NULL;
+		      bzip_info.opaque=NULL;
+		      code=BZ2_bzDecompressInit(&bzip_info,image_info->verbose,False);
+		      status|=code >= 0;
+		      bzip_info.avail_in=0;
+		    }
+		  bzip_info.next_out=(char *) pixels;
+		  bzip_info.avail_out=(unsigned int) (packet_size*image->columns);
+		  do
+		    {
+		      int
+			bz_status;
+
+		      if (bzip_info.avail_in == 0)
+			{
+			  bzip_info.next_in=(char *) compress_pixels;
+			  if (version == 0)
+			    {
+			      length=(int) (1.01*packet_size*image->columns+600);
+			      bzip_info.avail_in=(unsigned int) ReadBlob(image,length,bzip_info.next_in);
+			    }
+			  else
+			    {
+			      void
+				*compress_data;
+
+			      length=ReadBlobMSBLong(image);
+			      if (length > compressed_length)
+				{
+				  (void) BZ2_bzDecompressEnd(&bzip_info);
+				  ThrowMIFFReaderException(CorruptImageError,
+							   LengthAndFilesizeDoNotMatch,
+							   image);
+				}
+			      /* Decompress directly from the blob if it is in memory */
+			      compress_data=compress_pixels;
+			      bzip_info.avail_in=(unsigned int) ReadBlobZC(image,length,&compress_data);
+			      bzip_info.next_in=(char *) compress_data;
+			      if ((size_t) bzip_info.avail_in != length)
+				{
+				  ThrowMIFFReaderException(CorruptImageError,UnexpectedEndOfFile,
+						       image);
+				}
+			    }
+			}
+		      bz_status=BZ2_bzDecompress(&bzip_info);
+		      if (bz_status == BZ_STREAM_END)
+			break;
+		      else if (bz_status != BZ_OK)
+			{
+			  (void) BZ2_bzDecompressEnd(&bzip_info);
+			  ThrowMIFFReaderException(CorruptImageError,UnableToUncompressImage,
+					       image);
+			}
+		    } while (bzip_info.avail_out != 0);
+		  if (y == (long) (image->rows-1))
+		    {
+		      if (version == 0)
+			(void) SeekBlob(image,-((ExtendedSignedIntegralType)
+						bzip_info.avail_in),SEEK_CUR);
+		      code=BZ2_bzDecompressEnd(&bzip_info);
+		      status|=code >= 0;
+		    }
+		  (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
+		  if (!SyncImagePixels(image))
+		    break;
+		  if (image->previous == (Image *) NULL)
+		    if (QuantumTick(y,image->rows))
+		      if (!MagickMonitorFormatted(y,image->rows,exception,
+						  LoadImageText,image->filename,
+						  image->columns,image->rows))
+			break;
+		}
+	      break;
+	    } /* End case BZipCompression */
+    #endif
+	  case RLECompression:
+	    {
+	      for (y=0; y < (long) image->rows; y++)
+		{
+		  q=SetImagePixels(image,0,y,image->columns,1);
+		  if (q == (PixelPacket *) NULL)
+		    break;
+		  /*
+		    Collect one pixel row
+		  */
+		  p=pixels;
+		  for (length=0; length < image->columns; )
+		    {
+		      p+=ReadBlob(image,packet_size,p);
+		      length+=*(p-1)+1;
+		    }
+
+		  (void) ImportRLEPixels(image,quantum_type,quantum_size,pixels);
+		  if (!SyncImagePixels(image))
+		    break;
+		  if (image->previous == (Image *) NULL)
+		    if (QuantumTick(y,image->rows))
+		      if (!MagickMonitorFormatted(y,image->rows,exception,
+						  LoadImageText,image->filename,
+						  image->columns,image->rows))
+			break;
+
+		}
+	      break;
+	    } /* End case RLECompression */
+	  default:
+	    {
+	      for (y=0; y < (long) image->rows; y++)
+		{
+		  q=SetImagePixels(image,0,y,image->columns,1);
+		  if (q == (PixelPacket *) NULL)
+		    break;
+		  pixels_p=pixels;
+		  (void) ReadBlobZC(image,packet_size*image->columns,&pixels_p);
+		  (void) ImportImagePixelArea(image,quantum_type,quantum_size,(const unsigned char*) pixels_p,0,0);
+		  if (!SyncImagePixels(image))
+		    break;
+		  if (image->previous == (Image *) NULL)
+		    if (QuantumTick(y,image->rows))
+		      if (!MagickMonitorFormatted(y,image->rows,exception,
+						  LoadImageText,image->filename,
+						  image->columns,image->rows))
+			break;
+		}
+	      break;
+	    }
+	  } /* End switch (image->compression) */
+      }
 
     /*
       Verify that pixel transfer loops completed
@@ -2141,6 +2807,7 @@ static unsigned int WriteMIFFImage(const ImageInfo *image_info,Image *image)
     quantum_size;
 
   unsigned long
+    band_rows,
     packet_size,
     scene;
 
@@ -2148,7 +2815,8 @@ static unsigned int WriteMIFFImage(const ImageInfo *image_info,Image *image)
     profile_iterator;
   
   const char
-    *profile_name;
+    *profile_name,
+    *value;
   
   const unsigned char
     *profile_info;
@@ -2269,6 +2937,31 @@ static unsigned int WriteMIFFImage(const ImageInfo *image_info,Image *image)
       }
     if (*buffer != '\0')
       (void) WriteBlobString(image,buffer);
+    /*
+      Banded pixel data (see ReadMIFFBands()) is written if requested,
+      and if the blob is seekable so that the band index may be updated.
+    */
+    band_rows=0;
+    if ((compression != RLECompression) && BlobIsSeekable(image) &&
+        ((value=AccessDefinition(image_info,"miff","band-rows")) !=
+         (const char *) NULL))
+      {
+        long
+          rows;
+
+        rows=MagickAtoL(value);
+        if (rows > 0)
+          band_rows=Min((unsigned long) rows,image->rows);
+        if (packet_size*image->columns > MIFFMaxBandLength)
+          band_rows=0;
+        else if (band_rows > MIFFMaxBandLength/(packet_size*image->columns))
+          band_rows=MIFFMaxBandLength/(packet_size*image->columns);
+      }
+    if (band_rows != 0)
+      {
+        FormatString(buffer,"band-rows=%lu\n",band_rows);
+        (void) WriteBlobString(image,buffer);
+      }
     FormatString(buffer,"columns=%lu  rows=%lu  depth=%u\n",image->columns,
       image->rows,depth);
     (void) WriteBlobString(image,buffer);
@@ -2573,160 +3266,170 @@ static unsigned int WriteMIFFImage(const ImageInfo *image_info,Image *image)
     (void) LogMagickEvent(CoderEvent,GetMagickModule(),
                           "Using QuantumType %s, depth %u",
                           QuantumTypeToString(quantum_type),quantum_size);
-    for (y=0; y < (long) image->rows; y++)
-    {
-      p=AcquireImagePixels(image,0,y,image->columns,1,&image->exception);
-      if (p == (const PixelPacket *) NULL)
-        break;
-      indexes=AccessImmutableIndexes(image);
-      q=pixels;
-      switch (compression)
+    if (band_rows != 0)
       {
-#if defined(HasZLIB)
-        case ZipCompression:
-        {
-	  int
-	    code;
-
-          if (y == 0)
-            {
-              zip_info.zalloc=ZLIBAllocFunc;
-              zip_info.zfree=ZLIBFreeFunc;
-              zip_info.opaque=(voidpf) NULL;
-              code=deflateInit(&zip_info,(int) Min(image_info->quality/10,9));
-              status|=code >= 0;
-            }
-          zip_info.next_in=pixels;
-          zip_info.avail_in=(uInt) (packet_size*image->columns);
-          (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
-          do
-          {
-            zip_info.next_out=compress_pixels;
-            zip_info.avail_out=(uInt) (1.01*packet_size*image->columns+12);
-            code=deflate(&zip_info,Z_NO_FLUSH);
-            status|=code >= 0;
-            length=zip_info.next_out-compress_pixels;
-            if (length != 0)
-              {
-                (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
-                (void) WriteBlob(image,length,compress_pixels);
-              }
-          } while (zip_info.avail_in != 0);
-          if (y == (long) (image->rows-1))
-            {
-              for ( ; ; )
-              {
-                zip_info.next_out=compress_pixels;
-                zip_info.avail_out=(uInt) (1.01*packet_size*image->columns+12);
-                code=deflate(&zip_info,Z_FINISH);
-                status|=code >= 0;
-                length=zip_info.next_out-compress_pixels;
-                if (length == 0)
-                  break;
-                (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
-                (void) WriteBlob(image,length,compress_pixels);
-              }
-              status=!deflateEnd(&zip_info);
-            }
-          break;
-        }
-#endif
-#if defined(HasBZLIB)
-        case BZipCompression:
-        {
-	  int
-	    code;
-
-          if (y == 0)
-            {
-              bzip_info.bzalloc=NULL;
-              bzip_info.bzfree=NULL;
-              bzip_info.opaque=NULL;
-              code=BZ2_bzCompressInit(&bzip_info,
-                (int) Min(image_info->quality/10,9),image_info->verbose,0);
-              status|=code >= 0;
-            }
-          bzip_info.next_in=(char *) pixels;
-          bzip_info.avail_in=(unsigned int) (packet_size*image->columns);
-          (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
-          do
-          {
-            bzip_info.next_out=(char *) compress_pixels;
-            bzip_info.avail_out=(unsigned int)
-              (1.01*packet_size*image->columns+600);
-            code=BZ2_bzCompress(&bzip_info,BZ_FLUSH);
-            status|=code >= 0;
-            length=bzip_info.next_out-(char *) compress_pixels;
-            if (length != 0)
-              {
-                (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
-                (void) WriteBlob(image,length,compress_pixels);
-              }
-          } while (bzip_info.avail_in != 0);
-          if (y == (long) (image->rows-1))
-            {
-              for ( ; ; )
-              {
-                bzip_info.next_out=(char *) compress_pixels;
-                bzip_info.avail_out=(unsigned int)
-                  (1.01*packet_size*image->columns+600);
-                code=BZ2_bzCompress(&bzip_info,BZ_FINISH);
-                status|=code >= 0;
-                length=bzip_info.next_out-(char *) compress_pixels;
-                if (length == 0)
-                  break;
-                (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
-                (void) WriteBlob(image,length,compress_pixels);
-              }
-              status=!BZ2_bzCompressEnd(&bzip_info);
-            }
-          break;
-        }
-#endif
-        case RLECompression:
-        {
-          pixel=(*p);
-          index=0;
-          if (image->storage_class == PseudoClass)
-            index=(*indexes);
-          length=255;
-          for (x=0; x < (long) image->columns; x++)
-          {
-            if ((length < 255) && (x < (long) (image->columns-1)) &&
-                ColorMatch(p,(&pixel)) &&
-                ((image->matte == False) || (p->opacity == pixel.opacity)))
-              length++;
-            else
-              {
-                if (x > 0)
-                  WriteRunlengthPacket(image,quantum_size,&pixel,length,&q,index);
-                length=0;
-              }
-            if (image->storage_class == PseudoClass)
-              index=indexes[x];
-            pixel=(*p);
-            p++;
-          }
-          WriteRunlengthPacket(image,quantum_size,&pixel,length,&q,index);
-          (void) WriteBlob(image,q-pixels,pixels);
-          break;
-        }
-        default:
-        {
-          (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
-          (void) WriteBlob(image,packet_size*image->columns,pixels);
-          break;
-        }
+        status=WriteMIFFBands(image_info,image,compression,band_rows,
+                              quantum_type,quantum_size,packet_size);
+      }
+    else
+      {
+	for (y=0; y < (long) image->rows; y++)
+	{
+	  p=AcquireImagePixels(image,0,y,image->columns,1,&image->exception);
+	  if (p == (const PixelPacket *) NULL)
+	    break;
+	  indexes=AccessImmutableIndexes(image);
+	  q=pixels;
+	  switch (compression)
+	  {
+    #if defined(HasZLIB)
+	    case ZipCompression:
+	    {
+	      int
+		code;
+
+	      if (y == 0)
+		{
+		  zip_info.zalloc=ZLIBAllocFunc;
+		  zip_info.zfree=ZLIBFreeFunc;
+		  zip_info.opaque=(voidpf) NULL;
+		  code=deflateInit(&zip_info,(int) Min(image_info->quality/10,9));
+		  status|=code >= 0;
+		}
+	      zip_info.next_in=pixels;
+	      zip_info.avail_in=(uInt) (packet_size*image->columns);
+	      (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
+	      do
+	      {
+		zip_info.next_out=compress_pixels;
+		zip_info.avail_out=(uInt) (1.01*packet_size*image->columns+12);
+		code=deflate(&zip_info,Z_NO_FLUSH);
+		status|=code >= 0;
+		length=zip_info.next_out-compress_pixels;
+		if (length != 0)
+		  {
+		    (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
+		    (void) WriteBlob(image,length,compress_pixels);
+		  }
+	      } while (zip_info.avail_in != 0);
+	      if (y == (long) (image->rows-1))
+		{
+		  for ( ; ; )
+		  {
+		    zip_info.next_out=compress_pixels;
+		    zip_info.avail_out=(uInt) (1.01*packet_size*image->columns+12);
+		    code=deflate(&zip_info,Z_FINISH);
+		    status|=code >= 0;
+		    length=zip_info.next_out-compress_pixels;
+		    if (length == 0)
+		      break;
+		    (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
+		    (void) WriteBlob(image,length,compress_pixels);
+		  }
+		  status=!deflateEnd(&zip_info);
+		}
+	      break;
+	    }
+    #endif
+    #if defined(HasBZLIB)
+	    case BZipCompression:
+	    {
+	      int
+		code;
+
+	      if (y == 0)
+		{
+		  bzip_info.bzalloc=NULL;
+		  bzip_info.bzfree=NULL;
+		  bzip_info.opaque=NULL;
+		  code=BZ2_bzCompressInit(&bzip_info,
+		    (int) Min(image_info->quality/10,9),image_info->verbose,0);
+		  status|=code >= 0;
+		}
+	      bzip_info.next_in=(char *) pixels;
+	      bzip_info.avail_in=(unsigned int) (packet_size*image->columns);
+	      (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
+	      do
+	      {
+		bzip_info.next_out=(char *) compress_pixels;
+		bzip_info.avail_out=(unsigned int)
+		  (1.01*packet_size*image->columns+600);
+		code=BZ2_bzCompress(&bzip_info,BZ_FLUSH);
+		status|=code >= 0;
+		length=bzip_info.next_out-(char *) compress_pixels;
+		if (length != 0)
+		  {
+		    (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
+		    (void) WriteBlob(image,length,compress_pixels);
+		  }
+	      } while (bzip_info.avail_in != 0);
+	      if (y == (long) (image->rows-1))
+		{
+		  for ( ; ; )
+		  {
+		    bzip_info.next_out=(char *) compress_pixels;
+		    bzip_info.avail_out=(unsigned int)
+		      (1.01*packet_size*image->columns+600);
+		    code=BZ2_bzCompress(&bzip_info,BZ_FINISH);
+		    status|=code >= 0;
+		    length=bzip_info.next_out-(char *) compress_pixels;
+		    if (length == 0)
+		      break;
+		    (void) WriteBlobMSBLong(image,(const magick_uint32_t) length);
+		    (void) WriteBlob(image,length,compress_pixels);
+		  }
+		  status=!BZ2_bzCompressEnd(&bzip_info);
+		}
+	      break;
+	    }
+    #endif
+	    case RLECompression:
+	    {
+	      pixel=(*p);
+	      index=0;
+	      if (image->storage_class == PseudoClass)
+		index=(*indexes);
+	      length=255;
+	      for (x=0; x < (long) image->columns; x++)
+	      {
+		if ((length < 255) && (x < (long) (image->columns-1)) &&
+		    ColorMatch(p,(&pixel)) &&
+		    ((image->matte == False) || (p->opacity == pixel.opacity)))
+		  length++;
+		else
+		  {
+		    if (x > 0)
+		      WriteRunlengthPacket(image,quantum_size,&pixel,length,&q,index);
+		    length=0;
+		  }
+		if (image->storage_class == PseudoClass)
+		  index=indexes[x];
+		pixel=(*p);
+		p++;
+	      }
+	      WriteRunlengthPacket(image,quantum_size,&pixel,length,&q,index);
+	      (void) WriteBlob(image,q-pixels,pixels);
+	      break;
+	    }
+	    default:
+	    {
+	      (void) ExportImagePixelArea(image,quantum_type,quantum_size,pixels,0,0);
+	      (void) WriteBlob(image,packet_size*image->columns,pixels);
+	      break;
+	    }
+	  }
+	  if (image->previous == (Image *) NULL)
+	    if (QuantumTick(y,image->rows))
+	      if (!MagickMonitorFormatted(y,image->rows,&image->exception,
+					  SaveImageText,image->filename,
+					  image->columns,image->rows))
+		break;
+	}
       }
-      if (image->previous == (Image *) NULL)
-        if (QuantumTick(y,image->rows))
-          if (!MagickMonitorFormatted(y,image->rows,&image->exception,
-                                      SaveImageText,image->filename,
-				      image->columns,image->rows))
-            break;
-    }
     MagickFreeMemory(pixels);
     MagickFreeMemory(compress_pixels);
+    if (status == False)
+      break;
     if (image->next == (Image *) NULL)
       break;
     image=SyncNextImageInList(image);
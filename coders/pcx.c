@@ -467,9 +467,9 @@ static Image *ReadPCXImage(const ImageInfo *image_info,ExceptionInfo *exception)
         p=pcx_pixels;
         while(pcx_packets != 0)
           {
-            packet=ReadBlobByte(image);
-            if (EOFBlob(image))
+            if ((c=ReadBlobByteInline(image)) == EOF)
               ThrowPCXReaderException(CorruptImageError,CorruptImage,image);
+            packet=(unsigned char) c;
             *p++=packet;
             pcx_packets--;
             continue;
@@ -483,9 +483,9 @@ static Image *ReadPCXImage(const ImageInfo *image_info,ExceptionInfo *exception)
         p=pcx_pixels;
         while (pcx_packets != 0)
           {
-            packet=ReadBlobByte(image);
-            if (EOFBlob(image))
+            if ((c=ReadBlobByteInline(image)) == EOF)
               ThrowPCXReaderException(CorruptImageError,CorruptImage,image);
+            packet=(unsigned char) c;
             if ((packet & 0xc0) != 0xc0)
               {
                 *p++=packet;
@@ -493,9 +493,9 @@ static Image *ReadPCXImage(const ImageInfo *image_info,ExceptionInfo *exception)
                 continue;
               }
             count=packet & 0x3f;
-            packet=ReadBlobByte(image);
-            if (EOFBlob(image))
+            if ((c=ReadBlobByteInline(image)) == EOF)
               ThrowPCXReaderException(CorruptImageError,CorruptImage,image);
+            packet=(unsigned char) c;
             for (; count != 0; count--)
               {
                 *p++=packet;
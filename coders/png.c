@@ -6046,6 +6046,543 @@ png_write_raw_profile(const ImageInfo *image_info,png_struct *ping,
   png_free(ping,text);
 }
 
+static void PNGSetTextChunks(png_struct *ping,png_info *ping_info,
+                             const ImageInfo *image_info,Image *image,
+                             const unsigned int logging)
+{
+  const ImageAttribute
+    *attribute;
+
+  attribute=GetImageAttribute(image,(char *) NULL);
+  for ( ; attribute != (const ImageAttribute *) NULL;
+        attribute=attribute->next)
+    {
+      png_textp
+        text;
+
+      if (*attribute->key == '[')
+        continue; 
+      if (LocaleCompare(attribute->key,"png:IHDR.color-type-orig") == 0 ||
+          LocaleCompare(attribute->key,"png:IHDR.bit-depth-orig") == 0)
+        continue; 
+#if PNG_LIBPNG_VER >= 14000
+            text=(png_textp) png_malloc(ping,
+                 (png_alloc_size_t) sizeof(png_text));
+#else
+            text=(png_textp) png_malloc(ping,(png_size_t) sizeof(png_text));
+#endif
+      text[0].key=attribute->key;
+      text[0].text=attribute->value;
+      text[0].text_length=strlen(attribute->value);
+      text[0].compression=image_info->compression == NoCompression ||
+        (image_info->compression == UndefinedCompression &&
+         text[0].text_length < 128) ? -1 : 0;
+      if (logging)
+        {
+          (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                "  Setting up text chunk");
+          (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                "    keyword: %s",text[0].key);
+        }
+      png_set_text(ping,ping_info,text,1);
+      png_free(ping,text);
+    }
+}
+
+/*
+  Parallel IDAT encoding.
+
+  When the "png:parallel-encode" define is set, the image rows are
+  split into bands which are filtered and deflated concurrently.  Each
+  band is compressed as a raw deflate stream (primed with the tail of
+  the preceding band as its dictionary) and terminated with a sync
+  flush, so that the concatenated bands form a single zlib stream.  The
+  per-band Adler-32 checksums are merged with adler32_combine().
+*/
+#define PNGParallelBandBytes 262144
+#define PNGParallelWindowBytes 32768
+
+#if defined(HAVE_OPENMP)
+#  define PNGParallelThreads (omp_get_max_threads())
+#else
+#  define PNGParallelThreads 1
+#endif
+
+typedef struct _PNGParallelBand
+{
+  unsigned long
+    first_row,                /* first row of band */
+    rows;                     /* number of rows in band */
+
+  unsigned char
+    *pixels,                  /* exported rows, preceded by prior row */
+    *filtered,                /* filter type byte + filtered row, per row */
+    *compressed,              /* raw deflate data */
+    *scratch;                 /* adaptive filter trial row */
+
+  size_t
+    filtered_length,
+    compressed_length;
+
+  uLong
+    adler;                    /* Adler-32 of filtered data */
+
+  MagickPassFail
+    status;
+} PNGParallelBand;
+
+static inline unsigned char PNGPaethPredictor(const unsigned char a,
+                                              const unsigned char b,
+                                              const unsigned char c)
+{
+  int
+    p,
+    pa,
+    pb,
+    pc;
+
+  p=(int) a+b-c;
+  pa=abs(p-a);
+  pb=abs(p-b);
+  pc=abs(p-c);
+  if ((pa <= pb) && (pa <= pc))
+    return a;
+  if (pb <= pc)
+    return b;
+  return c;
+}
+
+static void PNGFilterRow(const int filter,const unsigned char *row,
+                         const unsigned char *prior,const size_t rowbytes,
+                         const size_t bpp,unsigned char *out)
+{
+  register size_t
+    i;
+
+  *out++=(unsigned char) filter;
+  switch (filter)
+    {
+    case PNG_FILTER_VALUE_SUB:
+      {
+        for (i=0; i < bpp; i++)
+          out[i]=row[i];
+        for ( ; i < rowbytes; i++)
+          out[i]=(unsigned char) (row[i]-row[i-bpp]);
+        break;
+      }
+    case PNG_FILTER_VALUE_UP:
+      {
+        for (i=0; i < rowbytes; i++)
+          out[i]=(unsigned char) (row[i]-prior[i]);
+        break;
+      }
+    case PNG_FILTER_VALUE_AVG:
+      {
+        for (i=0; i < bpp; i++)
+          out[i]=(unsigned char) (row[i]-(prior[i] >> 1));
+        for ( ; i < rowbytes; i++)
+          out[i]=(unsigned char) (row[i]-((row[i-bpp]+prior[i]) >> 1));
+        break;
+      }
+    case PNG_FILTER_VALUE_PAETH:
+      {
+        for (i=0; i < bpp; i++)
+          out[i]=(unsigned char) (row[i]-prior[i]);
+        for ( ; i < rowbytes; i++)
+          out[i]=(unsigned char) (row[i]-PNGPaethPredictor(row[i-bpp],
+                                                           prior[i],
+                                                           prior[i-bpp]));
+        break;
+      }
+    default:
+      {
+        (void) memcpy(out,row,rowbytes);
+        break;
+      }
+    }
+}
+
+static unsigned long PNGFilterCost(const unsigned char *filtered,
+                                   const size_t rowbytes)
+{
+  register size_t
+    i;
+
+  unsigned long
+    cost;
+
+  /*
+    Minimum sum of absolute differences heuristic, as used by libpng.
+  */
+  cost=0;
+  for (i=1; i <= rowbytes; i++)
+    cost+=(unsigned long) abs((int) ((signed char) filtered[i]));
+  return cost;
+}
+
+static void PNGFilterBand(PNGParallelBand *band,const size_t rowbytes,
+                          const size_t bpp,const int base_filter,
+                          const unsigned char *zero_row)
+{
+  const unsigned char
+    *prior,
+    *row;
+
+  unsigned char
+    *out;
+
+  unsigned long
+    i;
+
+  int
+    filter;
+
+  prior=(band->first_row == 0) ? zero_row : band->pixels;
+  row=band->pixels+rowbytes;
+  out=band->filtered;
+  for (i=0; i < band->rows; i++)
+    {
+      if ((base_filter >= PNG_FILTER_VALUE_NONE) &&
+          (base_filter < PNG_FILTER_VALUE_LAST))
+        filter=base_filter;
+      else
+        {
+          int
+            candidate;
+
+          unsigned long
+            cost,
+            min_cost;
+
+          filter=PNG_FILTER_VALUE_NONE;
+          min_cost=~0UL;
+          for (candidate=PNG_FILTER_VALUE_NONE;
+               candidate < PNG_FILTER_VALUE_LAST; candidate++)
+            {
+              PNGFilterRow(candidate,row,prior,rowbytes,bpp,band->scratch);
+              cost=PNGFilterCost(band->scratch,rowbytes);
+              if (cost < min_cost)
+                {
+                  min_cost=cost;
+                  filter=candidate;
+                }
+            }
+        }
+      PNGFilterRow(filter,row,prior,rowbytes,bpp,out);
+      prior=row;
+      row+=rowbytes;
+      out+=rowbytes+1;
+    }
+  band->filtered_length=(size_t) band->rows*(rowbytes+1);
+}
+
+static void PNGCompressBand(PNGParallelBand *band,
+                            const unsigned char *dictionary,
+                            const size_t dictionary_length,
+                            const size_t compressed_extent,
+                            const int level,const int strategy,
+                            const MagickBool last_band)
+{
+  z_stream
+    stream;
+
+  band->adler=adler32(adler32(0L,Z_NULL,0),band->filtered,
+                      (uInt) band->filtered_length);
+  (void) memset(&stream,0,sizeof(stream));
+  if (deflateInit2(&stream,level,Z_DEFLATED,-15,9,strategy) != Z_OK)
+    {
+      band->status=MagickFail;
+      return;
+    }
+  if ((dictionary_length != 0) &&
+      (deflateSetDictionary(&stream,dictionary,(uInt) dictionary_length)
+       != Z_OK))
+    band->status=MagickFail;
+  stream.next_in=band->filtered;
+  stream.avail_in=(uInt) band->filtered_length;
+  stream.next_out=band->compressed;
+  stream.avail_out=(uInt) compressed_extent;
+  if (band->status != MagickFail)
+    {
+      int
+        result;
+
+      result=deflate(&stream,last_band ? Z_FINISH : Z_SYNC_FLUSH);
+      if ((last_band && (result != Z_STREAM_END)) ||
+          (!last_band && ((result != Z_OK) || (stream.avail_in != 0) ||
+                          (stream.avail_out == 0))))
+        band->status=MagickFail;
+    }
+  band->compressed_length=compressed_extent-stream.avail_out;
+  (void) deflateEnd(&stream);
+}
+
+static MagickPassFail WritePNGParallelIDAT(png_struct *ping,Image *image,
+                                           const QuantumType quantum_type,
+                                           const unsigned int quantum_size,
+                                           const size_t rowbytes,
+                                           const size_t bpp,
+                                           const int base_filter,
+                                           const int level,
+                                           const int strategy,
+                                           const unsigned int logging)
+{
+  PNGParallelBand
+    *bands;
+
+  unsigned char
+    header[2],
+    trailer[4],
+    *window,
+    *zero_row;
+
+  size_t
+    compressed_extent,
+    window_length;
+
+  uLong
+    adler;
+
+  unsigned long
+    band_rows,
+    first_row;
+
+  unsigned int
+    batch_bands,
+    flevel,
+    i;
+
+  MagickPassFail
+    status;
+
+  status=MagickPass;
+  band_rows=Max(1,PNGParallelBandBytes/(rowbytes+1));
+  band_rows=Min(band_rows,image->rows);
+  batch_bands=(unsigned int) Max(1,4*PNGParallelThreads);
+  compressed_extent=compressBound((uLong) band_rows*(rowbytes+1))+64;
+  if (logging)
+    (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                          "  Parallel IDAT encode: %lu rows per band,"
+                          " %u bands per batch, %d threads",
+                          band_rows,batch_bands,(int) PNGParallelThreads);
+
+  bands=MagickAllocateArray(PNGParallelBand *,batch_bands,
+                            sizeof(PNGParallelBand));
+  window=MagickAllocateMemory(unsigned char *,PNGParallelWindowBytes);
+  zero_row=MagickAllocateMemory(unsigned char *,rowbytes);
+  if ((bands == (PNGParallelBand *) NULL) ||
+      (window == (unsigned char *) NULL) ||
+      (zero_row == (unsigned char *) NULL))
+    status=MagickFail;
+  if (bands != (PNGParallelBand *) NULL)
+    (void) memset(bands,0,batch_bands*sizeof(PNGParallelBand));
+  if (zero_row != (unsigned char *) NULL)
+    (void) memset(zero_row,0,rowbytes);
+  for (i=0; (status != MagickFail) && (i < batch_bands); i++)
+    {
+      bands[i].pixels=MagickAllocateArray(unsigned char *,band_rows+1,
+                                          rowbytes);
+      bands[i].filtered=MagickAllocateArray(unsigned char *,band_rows,
+                                            rowbytes+1);
+      bands[i].compressed=MagickAllocateMemory(unsigned char *,
+                                               compressed_extent);
+      bands[i].scratch=MagickAllocateMemory(unsigned char *,rowbytes+1);
+      if ((bands[i].pixels == (unsigned char *) NULL) ||
+          (bands[i].filtered == (unsigned char *) NULL) ||
+          (bands[i].compressed == (unsigned char *) NULL) ||
+          (bands[i].scratch == (unsigned char *) NULL))
+        status=MagickFail;
+    }
+
+  /*
+    zlib stream header (32K window, no preset dictionary).
+  */
+  if ((strategy == Z_HUFFMAN_ONLY) || (level < 2))
+    flevel=0;
+  else if (level < 6)
+    flevel=1;
+  else if (level == 6)
+    flevel=2;
+  else
+    flevel=3;
+  header[0]=0x78;
+  header[1]=(unsigned char) (flevel << 6);
+  header[1]+=(unsigned char) (31-(((unsigned int) header[0] << 8)+
+                                  header[1]) % 31);
+  adler=adler32(0L,Z_NULL,0);
+  window_length=0;
+
+  for (first_row=0;
+       (status != MagickFail) && (first_row < image->rows); )
+    {
+      long
+        band;
+
+      unsigned int
+        count;
+
+      /*
+        Assign rows to the bands of this batch.
+      */
+      for (count=0;
+           (count < batch_bands) && (first_row < image->rows); count++)
+        {
+          bands[count].first_row=first_row;
+          bands[count].rows=Min(band_rows,image->rows-first_row);
+          bands[count].status=MagickPass;
+          first_row+=bands[count].rows;
+        }
+
+      /*
+        Export and filter each band.
+      */
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for schedule(runtime)
+#  else
+#    pragma omp parallel for schedule(static,1)
+#  endif
+#endif
+      for (band=0; band < (long) count; band++)
+        {
+          PNGParallelBand
+            *b = &bands[band];
+
+          unsigned long
+            row;
+
+          long
+            y;
+
+          y=(long) b->first_row-1;
+          for (row=0; row <= b->rows; row++, y++)
+            {
+              if (y < 0)
+                continue;
+              if ((AcquireImagePixels(image,0,y,image->columns,1,
+                                      &image->exception) ==
+                   (const PixelPacket *) NULL) ||
+                  (ExportImagePixelArea(image,quantum_type,quantum_size,
+                                        b->pixels+row*rowbytes,0,0) ==
+                   MagickFail))
+                {
+                  b->status=MagickFail;
+                  break;
+                }
+            }
+          if (b->status != MagickFail)
+            PNGFilterBand(b,rowbytes,bpp,base_filter,zero_row);
+        }
+
+      /*
+        Deflate each band, using the tail of the previous band as the
+        dictionary.
+      */
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for schedule(runtime)
+#  else
+#    pragma omp parallel for schedule(static,1)
+#  endif
+#endif
+      for (band=0; band < (long) count; band++)
+        {
+          const unsigned char
+            *dictionary;
+
+          size_t
+            dictionary_length;
+
+          if (bands[band].status == MagickFail)
+            continue;
+          if (band == 0)
+            {
+              dictionary=window;
+              dictionary_length=window_length;
+            }
+          else
+            {
+              dictionary_length=Min(bands[band-1].filtered_length,
+                                    PNGParallelWindowBytes);
+              dictionary=bands[band-1].filtered+
+                bands[band-1].filtered_length-dictionary_length;
+            }
+          PNGCompressBand(&bands[band],dictionary,dictionary_length,
+                          compressed_extent,level,strategy,
+                          bands[band].first_row+bands[band].rows ==
+                          image->rows);
+        }
+
+      /*
+        Write the bands in order as IDAT chunks.
+      */
+      for (band=0; band < (long) count; band++)
+        {
+          PNGParallelBand
+            *b = &bands[band];
+
+          png_uint_32
+            length;
+
+          MagickBool
+            last_band;
+
+          if (b->status == MagickFail)
+            {
+              status=MagickFail;
+              break;
+            }
+          adler=adler32_combine(adler,b->adler,(z_off_t) b->filtered_length);
+          last_band=(b->first_row+b->rows == image->rows);
+          length=(png_uint_32) b->compressed_length;
+          if (b->first_row == 0)
+            length+=2;
+          if (last_band)
+            {
+              length+=4;
+              trailer[0]=(unsigned char) ((adler >> 24) & 0xff);
+              trailer[1]=(unsigned char) ((adler >> 16) & 0xff);
+              trailer[2]=(unsigned char) ((adler >> 8) & 0xff);
+              trailer[3]=(unsigned char) (adler & 0xff);
+            }
+          png_write_chunk_start(ping,(png_bytep) mng_IDAT,length);
+          if (b->first_row == 0)
+            png_write_chunk_data(ping,header,2);
+          png_write_chunk_data(ping,b->compressed,b->compressed_length);
+          if (last_band)
+            png_write_chunk_data(ping,trailer,4);
+          png_write_chunk_end(ping);
+        }
+      if (status == MagickFail)
+        break;
+      window_length=Min(bands[count-1].filtered_length,
+                        PNGParallelWindowBytes);
+      (void) memcpy(window,bands[count-1].filtered+
+                    bands[count-1].filtered_length-window_length,
+                    window_length);
+      if (image->previous == (Image *) NULL)
+        if (!MagickMonitorFormatted(first_row,image->rows,&image->exception,
+                                    SaveImageTag,image->filename,
+                                    image->columns,image->rows))
+          status=MagickFail;
+    }
+
+  if (bands != (PNGParallelBand *) NULL)
+    {
+      for (i=0; i < batch_bands; i++)
+        {
+          MagickFreeMemory(bands[i].pixels);
+          MagickFreeMemory(bands[i].filtered);
+          MagickFreeMemory(bands[i].compressed);
+          MagickFreeMemory(bands[i].scratch);
+        }
+      MagickFreeMemory(bands);
+    }
+  MagickFreeMemory(window);
+  MagickFreeMemory(zero_row);
+  return status;
+}
+
 static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
                                        const ImageInfo *image_info,Image *imagep)
 {
@@ -6054,15 +6591,15 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
     *image;                      /* Use only 'image' after setjmp() */
 
   /* Write one PNG image */
-  const ImageAttribute
-    *attribute;
-
   char
     s[2];
 
   int
     num_passes,
     pass,
+    ping_base_filter = PNG_NO_FILTERS,
+    ping_compression_level = Z_DEFAULT_COMPRESSION,
+    ping_compression_strategy = Z_DEFAULT_STRATEGY,
     ping_bit_depth = 0,
     ping_colortype = 0,
     ping_interlace_method = 0,
@@ -6113,6 +6650,12 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
     logging,
     matte;
 
+  MagickBool
+    parallel_encode = MagickFalse;
+
+  QuantumType
+    parallel_quantum_type = UndefinedQuantum;
+
   unsigned long
     quantum_size,  /* depth for ExportImage */
     rowbytes,
@@ -6897,6 +7440,7 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
         (void) LogMagickEvent(CoderEvent,GetMagickModule(),
                               "    Compression level: %d",level);
       png_set_compression_level(ping,level);
+      ping_compression_level=level;
     }
   else
     {
@@ -6905,6 +7449,8 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
                               "    Compression strategy: Z_HUFFMAN_ONLY");
       png_set_compression_strategy(ping, Z_HUFFMAN_ONLY);
       png_set_compression_level(ping,2);
+      ping_compression_level=2;
+      ping_compression_strategy=Z_HUFFMAN_ONLY;
     }
   if (logging)
     (void) LogMagickEvent(CoderEvent,GetMagickModule(),
@@ -6950,6 +7496,7 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
                                 "    Base filter method: NONE");
       }
     png_set_filter(ping,PNG_FILTER_TYPE_BASE,base_filter);
+    ping_base_filter=base_filter;
   }
 
   ping_interlace_method=(image_info->interlace == LineInterlace);
@@ -7235,6 +7782,70 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
         }
     }
 
+  /*
+    Decide if the image data may be filtered and compressed in
+    parallel.  Only non-interlaced PNG (not MNG) images with a whole
+    number of bytes per sample are supported.
+  */
+  {
+    const char
+      *value;
+
+    if (((value=AccessDefinition(image_info,"png","parallel-encode")) !=
+         NULL) && (LocaleCompare(value,"false") != 0) &&
+        !mng_info->write_mng && (ping_interlace_method == 0) &&
+        (ping_filter_method == 0) && (ping_bit_depth == (int) quantum_size) &&
+        ((ping_bit_depth == 8) || (ping_bit_depth == 16)) &&
+        !((!mng_info->write_png8 && !mng_info->write_png24 &&
+           !mng_info->write_png32 && !mng_info->write_png48 &&
+           !mng_info->write_png64) && (mng_info->IsPalette ||
+           image_info->type == BilevelType) &&
+          !image_matte &&
+          IsMonochromeImage(image,&image->exception)))
+      {
+        /*
+          Select the same export quantum as the row-by-row writer below.
+        */
+        if ((image_depth > 8) ||
+            (mng_info->write_png24 || mng_info->write_png32 ||
+             mng_info->write_png48 || mng_info->write_png64 ||
+             (!mng_info->write_png8 && !mng_info->IsPalette)))
+          {
+            if (ping_colortype == PNG_COLOR_TYPE_GRAY)
+              parallel_quantum_type=(image->storage_class == DirectClass) ?
+                RedQuantum : GrayQuantum;
+            else if (ping_colortype == PNG_COLOR_TYPE_GRAY_ALPHA)
+              parallel_quantum_type=GrayAlphaQuantum;
+            else if (image_matte)
+              parallel_quantum_type=RGBAQuantum;
+            else
+              parallel_quantum_type=RGBQuantum;
+          }
+        else
+          {
+            if (ping_colortype == PNG_COLOR_TYPE_GRAY)
+              parallel_quantum_type=GrayQuantum;
+            else if (ping_colortype == PNG_COLOR_TYPE_GRAY_ALPHA)
+              parallel_quantum_type=GrayAlphaQuantum;
+            else
+              parallel_quantum_type=IndexQuantum;
+          }
+        parallel_encode=(MagickGetQuantumSamplesPerPixel(parallel_quantum_type)
+                         == png_get_channels(ping,ping_info));
+      }
+    if (logging)
+      (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                            "  Parallel encode: %s",
+                            parallel_encode ? "yes" : "no");
+  }
+
+  /*
+    Text chunks must precede IDAT when libpng does not write the image
+    data itself.
+  */
+  if (parallel_encode)
+    PNGSetTextChunks(ping,ping_info,image_info,image,logging);
+
   png_write_info(ping,ping_info);
 
 #if (PNG_LIBPNG_VER == 10206)
@@ -7290,7 +7901,26 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
     Initialize image scanlines.
   */
   num_passes=png_set_interlace_handling(ping);
-  if ((!mng_info->write_png8 && !mng_info->write_png24 &&
+  if (parallel_encode)
+    {
+      size_t
+        bytes_per_pixel;
+
+      bytes_per_pixel=(size_t) png_get_channels(ping,ping_info)*
+        (ping_bit_depth/8);
+      if (WritePNGParallelIDAT(ping,image,parallel_quantum_type,
+                               quantum_size,
+                               (size_t) image->columns*bytes_per_pixel,
+                               bytes_per_pixel,ping_base_filter,
+                               ping_compression_level,
+                               (ping_compression_strategy == Z_HUFFMAN_ONLY) ?
+                               Z_HUFFMAN_ONLY :
+                               (ping_base_filter != PNG_NO_FILTERS) ?
+                               Z_FILTERED : Z_DEFAULT_STRATEGY,
+                               logging) == MagickFail)
+        png_error(ping,"Parallel IDAT encoding failed");
+    }
+  else if ((!mng_info->write_png8 && !mng_info->write_png24 &&
        !mng_info->write_png32 && !mng_info->write_png48 &&
        !mng_info->write_png64) && (mng_info->IsPalette ||
        image_info->type == BilevelType) &&
@@ -7529,44 +8159,15 @@ static MagickPassFail WriteOnePNGImage(MngInfo *mng_info,
   /*
     Generate text chunks.
   */
-  attribute=GetImageAttribute(image,(char *) NULL);
-  for ( ; attribute != (const ImageAttribute *) NULL;
-        attribute=attribute->next)
-    {
-      png_textp
-        text;
-
-      if (*attribute->key == '[')
-        continue; 
-      if (LocaleCompare(attribute->key,"png:IHDR.color-type-orig") == 0 ||
-          LocaleCompare(attribute->key,"png:IHDR.bit-depth-orig") == 0)
-        continue; 
-#if PNG_LIBPNG_VER >= 14000
-            text=(png_textp) png_malloc(ping,
-                 (png_alloc_size_t) sizeof(png_text));
-#else
-            text=(png_textp) png_malloc(ping,(png_size_t) sizeof(png_text));
-#endif
-      text[0].key=attribute->key;
-      text[0].text=attribute->value;
-      text[0].text_length=strlen(attribute->value);
-      text[0].compression=image_info->compression == NoCompression ||
-        (image_info->compression == UndefinedCompression &&
-         text[0].text_length < 128) ? -1 : 0;
-      if (logging)
-        {
-          (void) LogMagickEvent(CoderEvent,GetMagickModule(),
-                                "  Setting up text chunk");
-          (void) LogMagickEvent(CoderEvent,GetMagickModule(),
-                                "    keyword: %s",text[0].key);
-        }
-      png_set_text(ping,ping_info,text,1);
-      png_free(ping,text);
-    }
+  if (!parallel_encode)
+    PNGSetTextChunks(ping,ping_info,image_info,image,logging);
   if (logging)
     (void) LogMagickEvent(CoderEvent,GetMagickModule(),
                           "  Writing PNG end info");
-  png_write_end(ping,ping_info);
+  if (parallel_encode)
+    png_write_chunk(ping,(png_bytep) mng_IEND,NULL,0);
+  else
+    png_write_end(ping,ping_info);
   if (mng_info->need_fram && (int) image->dispose == BackgroundDispose)
     {
       if (mng_info->page.x || mng_info->page.y || (ping_width !=
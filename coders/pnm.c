@@ -55,6 +55,11 @@
 static unsigned int
   WritePNMImage(const ImageInfo *,Image *);
 
+static MagickPassFail
+  BeginPNMRowEncoder(const ImageInfo *,Image *,void **),
+  EndPNMRowEncoder(Image *,void *,const MagickPassFail),
+  WritePNMRowEncoderRow(Image *,const Image *,const unsigned long,void *);
+
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -141,7 +146,7 @@ static unsigned int PNMInteger(Image *image,const unsigned int base)
   */
   do
   {
-    c=ReadBlobByte(image);
+    c=ReadBlobByteInline(image);
     if (c == EOF)
       return(0);
     if (c == '#')
@@ -178,7 +183,7 @@ static unsigned int PNMInteger(Image *image,const unsigned int base)
                   break;
                 p=comment+strlen(comment);
               }
-            c=ReadBlobByte(image);
+            c=ReadBlobByteInline(image);
             *p=c;
             *(p+1)='\0';
           }
@@ -202,7 +207,7 @@ static unsigned int PNMInteger(Image *image,const unsigned int base)
   {
     value*=10;
     value+=c-'0';
-    c=ReadBlobByte(image);
+    c=ReadBlobByteInline(image);
     if (c == EOF)
       return(value);
   }
@@ -1140,6 +1145,9 @@ ModuleExport void RegisterPNMImage(void)
   entry=SetMagickInfo("PAM");
   entry->decoder=(DecoderHandler) ReadPNMImage;
   entry->encoder=(EncoderHandler) WritePNMImage;
+  entry->row_encoder_begin=(RowEncoderBeginHandler) BeginPNMRowEncoder;
+  entry->row_encoder_row=(RowEncoderRowHandler) WritePNMRowEncoderRow;
+  entry->row_encoder_end=(RowEncoderEndHandler) EndPNMRowEncoder;
   entry->description="Portable Arbitrary Map format";
   entry->module="PNM";
   entry->coder_class=PrimaryCoderClass;
@@ -1148,6 +1156,9 @@ ModuleExport void RegisterPNMImage(void)
   entry=SetMagickInfo("PBM");
   entry->decoder=(DecoderHandler) ReadPNMImage;
   entry->encoder=(EncoderHandler) WritePNMImage;
+  entry->row_encoder_begin=(RowEncoderBeginHandler) BeginPNMRowEncoder;
+  entry->row_encoder_row=(RowEncoderRowHandler) WritePNMRowEncoderRow;
+  entry->row_encoder_end=(RowEncoderEndHandler) EndPNMRowEncoder;
   entry->description="Portable bitmap format (black/white)";
   entry->module="PNM";
   entry->coder_class=PrimaryCoderClass;
@@ -1156,6 +1167,9 @@ ModuleExport void RegisterPNMImage(void)
   entry=SetMagickInfo("PGM");
   entry->decoder=(DecoderHandler) ReadPNMImage;
   entry->encoder=(EncoderHandler) WritePNMImage;
+  entry->row_encoder_begin=(RowEncoderBeginHandler) BeginPNMRowEncoder;
+  entry->row_encoder_row=(RowEncoderRowHandler) WritePNMRowEncoderRow;
+  entry->row_encoder_end=(RowEncoderEndHandler) EndPNMRowEncoder;
   entry->description="Portable graymap format (gray scale)";
   entry->module="PNM";
   entry->coder_class=PrimaryCoderClass;
@@ -1164,6 +1178,9 @@ ModuleExport void RegisterPNMImage(void)
   entry=SetMagickInfo("PNM");
   entry->decoder=(DecoderHandler) ReadPNMImage;
   entry->encoder=(EncoderHandler) WritePNMImage;
+  entry->row_encoder_begin=(RowEncoderBeginHandler) BeginPNMRowEncoder;
+  entry->row_encoder_row=(RowEncoderRowHandler) WritePNMRowEncoderRow;
+  entry->row_encoder_end=(RowEncoderEndHandler) EndPNMRowEncoder;
   entry->magick=(MagickHandler) IsPNM;
   entry->description="Portable anymap";
   entry->module="PNM";
@@ -1173,6 +1190,9 @@ ModuleExport void RegisterPNMImage(void)
   entry=SetMagickInfo("PPM");
   entry->decoder=(DecoderHandler) ReadPNMImage;
   entry->encoder=(EncoderHandler) WritePNMImage;
+  entry->row_encoder_begin=(RowEncoderBeginHandler) BeginPNMRowEncoder;
+  entry->row_encoder_row=(RowEncoderRowHandler) WritePNMRowEncoderRow;
+  entry->row_encoder_end=(RowEncoderEndHandler) EndPNMRowEncoder;
   entry->description="Portable pixmap format (color)";
   entry->module="PNM";
   entry->coder_class=PrimaryCoderClass;
@@ -1275,7 +1295,7 @@ static char *lut_255[] =
     } \
 }
 
-static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
+static void WritePNMFormatHeader(Image *image,const PNMSubformat format)
 {
   char
     buffer[MaxTextExtent];
@@ -1283,6 +1303,101 @@ static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
   const ImageAttribute
     *attribute;
 
+  const char
+    *header = "";
+
+  switch (format)
+    {
+    case Undefined_PNM_Format: break;
+    case PBM_ASCII_Format: header="P1"; break;
+    case PGM_ASCII_Format: header="P2"; break;
+    case PPM_ASCII_Format: header="P3"; break;
+    case PBM_RAW_Format:   header="P4"; break;
+    case PGM_RAW_Format:   header="P5"; break;
+    case PPM_RAW_Format:   header="P6"; break;
+    case PAM_Format:       header="P7"; break;
+    case XV_332_Format:    header="P7 332"; break;
+    }
+  (void) LogMagickEvent(CoderEvent,GetMagickModule(),"Format Id: %s",
+                        header);
+  (void) WriteBlobString(image,header);
+  (void) WriteBlobByte(image,'\n');
+
+  attribute=GetImageAttribute(image,"comment");
+  if (attribute != (const ImageAttribute *) NULL)
+    {
+      register char
+        *av;
+
+      /*
+        Write comments to file.
+      */
+      (void) WriteBlobByte(image,'#');
+      for (av=attribute->value; *av != '\0'; av++)
+        {
+          (void) WriteBlobByte(image,*av);
+          if ((*av == '\n') && (*(av+1) != '\0'))
+            (void) WriteBlobByte(image,'#');
+        }
+      (void) WriteBlobByte(image,'\n');
+    }
+  if ((PAM_Format != format) && (XV_332_Format != format))
+    {
+      FormatString(buffer,"%lu %lu\n",image->columns,image->rows);
+      (void) WriteBlobString(image,buffer);
+    }
+}
+
+static void WritePNMRawHeader(Image *image,const PNMSubformat format,
+                              const QuantumType quantum_type,
+                              const unsigned int bits_per_sample)
+{
+  char
+    buffer[MaxTextExtent];
+
+  if (PAM_Format == format)
+    {
+      /*
+        PAM header
+      */
+      const char *tuple_type=NULL;
+
+      if (GrayQuantum == quantum_type)
+        tuple_type="BLACKANDWHITE";
+      else if (GrayAlphaQuantum == quantum_type)
+        tuple_type="BLACKANDWHITE_ALPHA";
+      else if (RGBQuantum == quantum_type)
+        tuple_type="RGB";
+      else if (RGBAQuantum == quantum_type)
+        tuple_type="RGB_ALPHA";
+      else if (CMYKQuantum == quantum_type)
+        tuple_type="CMYK";
+      else if (CMYKAQuantum == quantum_type)
+        tuple_type="CMYK_ALPHA";
+
+      FormatString(buffer,"WIDTH %lu\nHEIGHT %lu\nDEPTH %u\nMAXVAL %lu\nTUPLTYPE %s\n",
+                   image->columns,image->rows,
+                   MagickGetQuantumSamplesPerPixel(quantum_type),
+                   MaxValueGivenBits(bits_per_sample),tuple_type);
+      WriteBlobString(image,buffer);
+
+      (void) WriteBlobString(image,"ENDHDR\n");
+    }
+  else if ((PGM_RAW_Format == format) || (PPM_RAW_Format == format))
+    {
+      /*
+        PGM, PPM header
+      */
+      FormatString(buffer,"%lu\n",MaxValueGivenBits(bits_per_sample));
+      WriteBlobString(image,buffer);
+    }
+}
+
+static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
+{
+  char
+    buffer[MaxTextExtent];
+
   IndexPacket
     index;
 
@@ -1420,49 +1535,7 @@ static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
 	    }
 	}
 
-      {
-	const char *header = "";
-	switch (format)
-	  {
-	  case Undefined_PNM_Format: break;
-	  case PBM_ASCII_Format: header="P1"; break;
-	  case PGM_ASCII_Format: header="P2"; break;
-	  case PPM_ASCII_Format: header="P3"; break;
-	  case PBM_RAW_Format:   header="P4"; break;
-	  case PGM_RAW_Format:   header="P5"; break;
-	  case PPM_RAW_Format:   header="P6"; break;
-	  case PAM_Format:       header="P7"; break;
-	  case XV_332_Format:    header="P7 332"; break;
-	  }
-	(void) LogMagickEvent(CoderEvent,GetMagickModule(),"Format Id: %s",
-			      header);
-	(void) WriteBlobString(image,header);
-	(void) WriteBlobByte(image,'\n');
-      }
-
-      attribute=GetImageAttribute(image,"comment");
-      if (attribute != (const ImageAttribute *) NULL)
-	{
-	  register char
-	    *av;
-
-	  /*
-	    Write comments to file.
-	  */
-	  (void) WriteBlobByte(image,'#');
-	  for (av=attribute->value; *av != '\0'; av++)
-	    {
-	      (void) WriteBlobByte(image,*av);
-	      if ((*av == '\n') && (*(av+1) != '\0'))
-		(void) WriteBlobByte(image,'#');
-	    }
-	  (void) WriteBlobByte(image,'\n');
-	}
-      if ((PAM_Format != format) && (XV_332_Format != format))
-	{
-	  FormatString(buffer,"%lu %lu\n",image->columns,image->rows);
-	  (void) WriteBlobString(image,buffer);
-	}
+      WritePNMFormatHeader(image,format);
       /*
 	Write PNM raster pixels.
       */
@@ -1841,41 +1914,14 @@ static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
 	    /*
 	      Output header details
 	    */
-	    if (PAM_Format == format)
-	      {
-		/*
-		  PAM header
-		*/
-		const char *tuple_type=NULL;
-
-		if (GrayQuantum == quantum_type)
-		  tuple_type="BLACKANDWHITE";
-		else if (GrayAlphaQuantum == quantum_type)
-		  tuple_type="BLACKANDWHITE_ALPHA";
-		else if (RGBQuantum == quantum_type)
-		  tuple_type="RGB";
-		else if (RGBAQuantum == quantum_type)
-		  tuple_type="RGB_ALPHA";
-		else if (CMYKQuantum == quantum_type)
-		  tuple_type="CMYK";
-		else if (CMYKAQuantum == quantum_type)
-		  tuple_type="CMYK_ALPHA";
-
-		FormatString(buffer,"WIDTH %lu\nHEIGHT %lu\nDEPTH %u\nMAXVAL %lu\nTUPLTYPE %s\n",
-			     image->columns,image->rows,samples_per_pixel,
-			     MaxValueGivenBits(bits_per_sample),tuple_type);
-		WriteBlobString(image,buffer);
-
-		(void) WriteBlobString(image,"ENDHDR\n");
-	      }
-	    else if ((PGM_RAW_Format == format) || (PPM_RAW_Format == format))
-	      {
-		/*
-		  PGM, PPM header
-		*/
-		FormatString(buffer,"%lu\n",MaxValueGivenBits(bits_per_sample));
-		WriteBlobString(image,buffer);
-	      }
+	    WritePNMRawHeader(image,format,quantum_type,bits_per_sample);
+
+	    /*
+	      Reserve the output size if writing to memory.
+	    */
+	    if (GetBlobFileHandle(image) == (FILE *) NULL)
+	      (void) BlobReserveSize(image,TellBlob(image)+
+				     (magick_off_t) bytes_per_row*image->rows);
 
 	    /*
 	      Output pixels
@@ -2047,3 +2093,185 @@ static unsigned int WritePNMImage(const ImageInfo *image_info,Image *image)
   CloseBlob(image);
   return(True);
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   B e g i n P N M R o w E n c o d e r                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  BeginPNMRowEncoder(), WritePNMRowEncoderRow(), and EndPNMRowEncoder()
+%  implement the row-streaming encoder (see OpenImageRowEncoder()) for
+%  the raw PBM, PGM, PPM, and PAM subformats.  Since the pixels are not
+%  available in advance, the subformat is selected based on the image's
+%  is_monochrome, is_grayscale, matte, and colorspace attributes rather
+%  than by analyzing the image.  The ASCII and XV subformats are not
+%  streamed.
+%
+*/
+typedef struct _PNMRowEncoderState
+{
+  ExportPixelAreaOptions
+    export_options;
+
+  QuantumType
+    quantum_type;
+
+  unsigned int
+    bits_per_sample;
+
+  size_t
+    bytes_per_row;
+
+  unsigned char
+    *pixels;
+} PNMRowEncoderState;
+
+static MagickPassFail BeginPNMRowEncoder(const ImageInfo *image_info,
+                                         Image *image,void **state)
+{
+  PNMRowEncoderState
+    *pnm_state;
+
+  PNMSubformat
+    format;
+
+  QuantumType
+    quantum_type;
+
+  unsigned int
+    bits_per_sample,
+    depth;
+
+  MagickBool
+    cmyk;
+
+  *state=(void *) NULL;
+  if ((image_info->quality == 0) ||
+      (AccessDefinition(image_info,"pnm","ascii")))
+    return MagickFail;
+
+  cmyk=(image->colorspace == CMYKColorspace);
+  if (LocaleCompare(image_info->magick,"PPM") == 0)
+    format=PPM_RAW_Format;
+  else if (LocaleCompare(image_info->magick,"PGM") == 0)
+    format=PGM_RAW_Format;
+  else if (LocaleCompare(image_info->magick,"PBM") == 0)
+    format=PBM_RAW_Format;
+  else if (LocaleCompare(image_info->magick,"PAM") == 0)
+    format=PAM_Format;
+  else if (LocaleCompare(image_info->magick,"PNM") == 0)
+    format=(image->is_monochrome ? PBM_RAW_Format :
+            image->is_grayscale ? PGM_RAW_Format : PPM_RAW_Format);
+  else
+    return MagickFail;
+  if (cmyk && (PAM_Format != format))
+    return MagickFail;
+  if (!cmyk && !IsRGBColorspace(image->colorspace))
+    return MagickFail;
+
+  depth=(image->depth <= 8 ? 8 : image->depth <= 16 ? 16 : 32);
+  bits_per_sample=depth;
+  switch (format)
+    {
+    case PBM_RAW_Format:
+      bits_per_sample=1;
+      quantum_type=GrayQuantum;
+      break;
+    case PGM_RAW_Format:
+      quantum_type=GrayQuantum;
+      break;
+    case PAM_Format:
+      if (cmyk)
+        quantum_type=(image->matte ? CMYKAQuantum : CMYKQuantum);
+      else if (image->is_monochrome || image->is_grayscale)
+        quantum_type=(image->matte ? GrayAlphaQuantum : GrayQuantum);
+      else
+        quantum_type=(image->matte ? RGBAQuantum : RGBQuantum);
+      if (image->is_monochrome)
+        bits_per_sample=1;
+      break;
+    default:
+      quantum_type=RGBQuantum;
+      break;
+    }
+
+  pnm_state=MagickAllocateMemory(PNMRowEncoderState *,
+                                 sizeof(PNMRowEncoderState));
+  if (pnm_state == (PNMRowEncoderState *) NULL)
+    ThrowBinaryException(ResourceLimitError,MemoryAllocationFailed,
+                         image->filename);
+  (void) memset(pnm_state,0,sizeof(PNMRowEncoderState));
+  pnm_state->quantum_type=quantum_type;
+  pnm_state->bits_per_sample=bits_per_sample;
+  if (1 == bits_per_sample)
+    pnm_state->bytes_per_row=((image->columns+7) >> 3);
+  else
+    pnm_state->bytes_per_row=(((bits_per_sample+7)/8)*
+                              MagickGetQuantumSamplesPerPixel(quantum_type))*
+      image->columns;
+  ExportPixelAreaOptionsInit(&pnm_state->export_options);
+  pnm_state->export_options.grayscale_miniswhite=(1 == bits_per_sample);
+  pnm_state->pixels=MagickAllocateMemory(unsigned char *,
+                                         pnm_state->bytes_per_row);
+  if (pnm_state->pixels == (unsigned char *) NULL)
+    {
+      MagickFreeMemory(pnm_state);
+      ThrowBinaryException(ResourceLimitError,MemoryAllocationFailed,
+                           image->filename);
+    }
+
+  if (OpenBlob(image_info,image,WriteBinaryBlobMode,&image->exception)
+      == MagickFail)
+    {
+      MagickFreeMemory(pnm_state->pixels);
+      MagickFreeMemory(pnm_state);
+      ThrowBinaryException(FileOpenError,UnableToOpenFile,image->filename);
+    }
+  WritePNMFormatHeader(image,format);
+  WritePNMRawHeader(image,format,quantum_type,bits_per_sample);
+  *state=(void *) pnm_state;
+  return MagickPass;
+}
+
+static MagickPassFail WritePNMRowEncoderRow(Image *image,
+                                            const Image *row_image,
+                                            const unsigned long y,
+                                            void *state)
+{
+  PNMRowEncoderState
+    *pnm_state=(PNMRowEncoderState *) state;
+
+  ARG_NOT_USED(y);
+  if (AcquireImagePixels(row_image,0,0,row_image->columns,1,
+                         &image->exception) == (const PixelPacket *) NULL)
+    return MagickFail;
+  if (ExportImagePixelArea(row_image,pnm_state->quantum_type,
+                           pnm_state->bits_per_sample,pnm_state->pixels,
+                           &pnm_state->export_options,0) == MagickFail)
+    return MagickFail;
+  if (WriteBlob(image,pnm_state->bytes_per_row,(char *) pnm_state->pixels)
+      != pnm_state->bytes_per_row)
+    ThrowBinaryException(BlobError,UnableToWriteBlob,image->filename);
+  return MagickPass;
+}
+
+static MagickPassFail EndPNMRowEncoder(Image *image,void *state,
+                                       const MagickPassFail status)
+{
+  PNMRowEncoderState
+    *pnm_state=(PNMRowEncoderState *) state;
+
+  if (pnm_state != (PNMRowEncoderState *) NULL)
+    {
+      MagickFreeMemory(pnm_state->pixels);
+      MagickFreeMemory(pnm_state);
+    }
+  CloseBlob(image);
+  return status;
+}
@@ -49,6 +49,7 @@
 */
 static unsigned int
   WriteRGBImage(const ImageInfo *,Image *);
+
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -100,6 +101,7 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
     count;
 
   unsigned char
+    *pixels,
     *scanline;
 
   unsigned int
@@ -162,6 +164,7 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
 			       packet_size,image->tile_info.width);
   if (scanline == (unsigned char *) NULL)
     ThrowReaderException(ResourceLimitError,MemoryAllocationFailed,image);
+  pixels=scanline;
   /*
     Initialize import options.
   */
@@ -186,7 +189,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
       */
       image->scene++;
       for (y=0; y < (long) image->rows; y++)
-        (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+        (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                scanline,&pixels);
     }
   x=(long) (packet_size*image->tile_info.x);
   do
@@ -210,15 +214,17 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         */
 	quantum_type=(image->matte ? RGBAQuantum : RGBQuantum);
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-	  (void) ImportImagePixelArea(image,quantum_type,quantum_size,scanline+x,
+	  (void) ImportImagePixelArea(image,quantum_type,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -231,7 +237,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         break;
       }
       case LineInterlace:
@@ -241,27 +248,31 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         */
         packet_size=(quantum_size)/8;
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,RedQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,RedQuantum,quantum_size,pixels+x,
 				      &import_options,0);
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
-          (void) ImportImagePixelArea(image,GreenQuantum,quantum_size,scanline+x,
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
+          (void) ImportImagePixelArea(image,GreenQuantum,quantum_size,pixels+x,
 				      &import_options,0);
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
-          (void) ImportImagePixelArea(image,BlueQuantum,quantum_size,scanline+x,
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
+          (void) ImportImagePixelArea(image,BlueQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (image->matte)
             {
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
-              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,scanline+x,
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
+              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,pixels+x,
 					  &import_options,0);
             }
           if (!SyncImagePixels(image))
@@ -275,7 +286,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         break;
       }
       case PlaneInterlace:
@@ -296,17 +308,19 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
           }
         packet_size=(quantum_size)/8;
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         i=0;
         span=image->rows*(image->matte ? 4 : 3);
         for (y=0; y < (long) image->rows; y++)
         {
           if ((y > 0) || (image->previous == (Image *) NULL))
-            (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+            (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                    scanline,&pixels);
           q=SetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,RedQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,RedQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -320,7 +334,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image_info->interlace == PartitionInterlace)
           {
             CloseBlob(image);
@@ -330,14 +345,16 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
               ThrowReaderException(FileOpenError,UnableToOpenFile,image);
           }
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
           q=GetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,GreenQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,GreenQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -351,7 +368,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image_info->interlace == PartitionInterlace)
           {
             CloseBlob(image);
@@ -361,14 +379,16 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
               ThrowReaderException(FileOpenError,UnableToOpenFile,image);
           }
         for (y=0; y < image->tile_info.y; y++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         for (y=0; y < (long) image->rows; y++)
         {
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
           q=GetImagePixels(image,0,y,image->columns,1);
           if (q == (PixelPacket *) NULL)
             break;
-          (void) ImportImagePixelArea(image,BlueQuantum,quantum_size,scanline+x,
+          (void) ImportImagePixelArea(image,BlueQuantum,quantum_size,pixels+x,
 				      &import_options,0);
           if (!SyncImagePixels(image))
             break;
@@ -382,7 +402,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         }
         count=image->tile_info.height-image->rows-image->tile_info.y;
         for (i=0; i < (long) count; i++)
-          (void) ReadBlob(image,packet_size*image->tile_info.width,scanline);
+          (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                  scanline,&pixels);
         if (image->matte)
           {
             /*
@@ -397,16 +418,16 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
                   ThrowReaderException(FileOpenError,UnableToOpenFile,image);
               }
             for (y=0; y < image->tile_info.y; y++)
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
             for (y=0; y < (long) image->rows; y++)
             {
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
               q=GetImagePixels(image,0,y,image->columns,1);
               if (q == (PixelPacket *) NULL)
                 break;
-              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,scanline+x,
+              (void) ImportImagePixelArea(image,AlphaQuantum,quantum_size,pixels+x,
 					  &import_options,0);
               if (!SyncImagePixels(image))
                 break;
@@ -420,8 +441,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
             }
             count=image->tile_info.height-image->rows-image->tile_info.y;
             for (i=0; i < (long) count; i++)
-              (void) ReadBlob(image,packet_size*image->tile_info.width,
-                scanline);
+              (void) ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                                      scanline,&pixels);
           }
         if (image_info->interlace == PartitionInterlace)
           (void) strlcpy(image->filename,image_info->filename,MaxTextExtent);
@@ -442,7 +463,8 @@ static Image *ReadRGBImage(const ImageInfo *image_info,ExceptionInfo *exception)
         break;
     if (image_info->interlace == PartitionInterlace)
       break;
-    count=ReadBlob(image,packet_size*image->tile_info.width,scanline);
+    count=ReadBlobZCBuffer(image,packet_size*image->tile_info.width,
+                           scanline,&pixels);
     if (count != 0)
       {
         /*
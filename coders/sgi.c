@@ -161,14 +161,16 @@ static unsigned int IsSGI(const unsigned char *magick,const size_t length)
 */
 
 static int SGIDecode(const unsigned long bytes_per_pixel,
-		     unsigned char *max_packets,unsigned char *pixels,
+		     const unsigned char *max_packets,unsigned char *pixels,
 		     unsigned long npackets,unsigned long npixels)
 {
   unsigned long
     count;
 
+  register const unsigned char
+    *p;
+
   register unsigned char
-    *p,
     *q;
 
   unsigned int
@@ -514,25 +516,33 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 	      p=iris_pixels+bytes_per_pixel*z;
 	      for (y=0; y < (long) iris_info.ysize; y++)
 		{
-		  (void) ReadBlob(image,bytes_per_pixel*iris_info.xsize,
-				  (char *) scanline);
+		  const unsigned char
+		    *samples;
+
+		  void
+		    *scanline_data;
+
+		  scanline_data=scanline;
+		  (void) ReadBlobZC(image,bytes_per_pixel*iris_info.xsize,
+				    &scanline_data);
 		  if (EOFBlob(image))
 		    {
 		      ThrowSGIReaderException(CorruptImageError,
                                               UnexpectedEndOfFile, image);
 		      break;
 		    }
+		  samples=(const unsigned char *) scanline_data;
 		  if (bytes_per_pixel == 2)
 		    for (x=0; x < (long) iris_info.xsize; x++)
 		      {
-			*p=scanline[2*x];
-			*(p+1)=scanline[2*x+1];
+			*p=samples[2*x];
+			*(p+1)=samples[2*x+1];
 			p+=8;
 		      }
 		  else
 		    for (x=0; x < (long) iris_info.xsize; x++)
 		      {
-			*p=scanline[x];
+			*p=samples[x];
 			p+=4;
 		      }
 		}
@@ -549,6 +559,9 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 	  unsigned long
 	    offset;
 
+	  void
+	    *packets;
+
 	  /*
 	    Read runlength-encoded image format.
 	  */
@@ -599,8 +612,9 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 			  offset=offsets[y+z*iris_info.ysize];
 			  (void) SeekBlob(image,(long) offset,SEEK_SET);
 			}
-		      (void) ReadBlob(image,runlength[y+z*iris_info.ysize],
-				      (char *) max_packets);
+		      packets=max_packets;
+		      (void) ReadBlobZC(image,runlength[y+z*iris_info.ysize],
+					&packets);
 		      if (EOFBlob(image))
 			{
 			  ThrowSGIReaderException(CorruptImageError,
@@ -608,7 +622,8 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 			  break;
 			}
 		      offset+=runlength[y+z*iris_info.ysize];
-		      if (SGIDecode(bytes_per_pixel,max_packets,p+bytes_per_pixel*z,
+		      if (SGIDecode(bytes_per_pixel,(const unsigned char *) packets,
+				    p+bytes_per_pixel*z,
 				    runlength[y+z*iris_info.ysize]/bytes_per_pixel,
 				    iris_info.xsize) == -1)
 			ThrowSGIReaderException(CorruptImageError,
@@ -629,8 +644,9 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 			  offset=offsets[y+z*iris_info.ysize];
 			  (void) SeekBlob(image,(long) offset,SEEK_SET);
 			}
-		      (void) ReadBlob(image,runlength[y+z*iris_info.ysize],
-				      (char *) max_packets);
+		      packets=max_packets;
+		      (void) ReadBlobZC(image,runlength[y+z*iris_info.ysize],
+					&packets);
 		      if (EOFBlob(image))
 			{
 			  ThrowSGIReaderException(CorruptImageError,
@@ -638,7 +654,8 @@ static Image *ReadSGIImage(const ImageInfo *image_info,ExceptionInfo *exception)
 			  break;
 			}
 		      offset+=runlength[y+z*iris_info.ysize];
-		      if (SGIDecode(bytes_per_pixel,max_packets,p+bytes_per_pixel*z,
+		      if (SGIDecode(bytes_per_pixel,(const unsigned char *) packets,
+				    p+bytes_per_pixel*z,
 				    runlength[y+z*iris_info.ysize]/bytes_per_pixel,
 				    iris_info.xsize) == -1)
 			ThrowSGIReaderException(CorruptImageError,
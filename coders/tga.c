@@ -75,6 +75,30 @@ int ReadBlobByteFromBuffer(unsigned char* buffer, size_t* readerpos)
   return(value);
 }
 
+/*
+  Return a pointer to the next pixel packet of 'length' bytes.  If a
+  scanline of uncompressed pixels has been read then the packet is
+  taken from the scanline, otherwise it is read from the blob into the
+  provided buffer.  Returns NULL if the packet could not be read.
+*/
+static unsigned char *ReadTGAPacket(Image *image,const size_t length,
+                                    unsigned char *buffer,
+                                    unsigned char **scanline)
+{
+  unsigned char
+    *packet;
+
+  if (*scanline != (unsigned char *) NULL)
+    {
+      packet=*scanline;
+      *scanline+=length;
+      return packet;
+    }
+  if (ReadBlob(image,length,buffer) != length)
+    return (unsigned char *) NULL;
+  return buffer;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -143,6 +167,9 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
   Image
     *image;
 
+  int
+    c;
+
   unsigned int
     index;
 
@@ -166,7 +193,13 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
     tga_info;
 
   unsigned char
-    runlength;
+    *packet_data,
+    *pixels,
+    runlength,
+    *scanline;
+
+  size_t
+    packet_size;
 
   unsigned int
     alpha_bits,
@@ -419,6 +452,39 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
       if (CheckImagePixelLimits(image, exception) != MagickPass)
         ThrowReaderException(ResourceLimitError,ImagePixelLimitExceeded,image);
 
+      /*
+        Uncompressed pixels are read a scanline at a time, accessing
+        the scanline in place if the blob is in memory.
+      */
+      switch (tga_info.bits_per_pixel)
+        {
+        case 15:
+        case 16:
+          packet_size=2;
+          break;
+        case 24:
+          packet_size=3;
+          break;
+        case 32:
+          packet_size=4;
+          break;
+        default:
+          packet_size=1;
+          break;
+        }
+      pixels=(unsigned char *) NULL;
+      scanline=(unsigned char *) NULL;
+      if ((tga_info.image_type == TGAColormap) ||
+          (tga_info.image_type == TGARGB) ||
+          (tga_info.image_type == TGAMonochrome))
+        {
+          pixels=MagickAllocateArray(unsigned char *,image->columns,
+                                     packet_size);
+          if (pixels == (unsigned char *) NULL)
+            ThrowReaderException(ResourceLimitError,MemoryAllocationFailed,
+                                 image);
+        }
+
       /*
         Convert TGA pixels to pixel packets.
       */
@@ -439,6 +505,21 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
           if (q == (PixelPacket *) NULL)
             break;
           indexes=AccessMutableIndexes(image);
+          if (pixels != (unsigned char *) NULL)
+            {
+              void
+                *scanline_data;
+
+              scanline_data=pixels;
+              if (ReadBlobZC(image,packet_size*image->columns,&scanline_data)
+                  != packet_size*image->columns)
+                {
+                  MagickFreeMemory(pixels);
+                  ThrowReaderException(CorruptImageError,UnableToReadImageData,
+                                       image);
+                }
+              scanline=(unsigned char *) scanline_data;
+            }
           for (x=0; x < (long) image->columns; x++)
             {
               if ((tga_info.image_type == TGARLEColormap) ||
@@ -452,11 +533,12 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
                     }
                   else
                     {
-                      if (ReadBlob(image,1,(char *) &runlength) != 1)
+                      if ((c=ReadBlobByteInline(image)) == EOF)
                         {
                           status=MagickFail;
                           break;
                         }
+                      runlength=(unsigned char) c;
                       flag=runlength & 0x80;
                       if (flag != 0)
                         runlength-=128;
@@ -472,7 +554,13 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
                       /*
                         Gray scale.
                       */
-                      index=ReadBlobByte(image);
+                      if ((packet_data=ReadTGAPacket(image,1,readbuffer,
+                                                     &scanline)) == NULL)
+                        {
+                          status=MagickFail;
+                          break;
+                        }
+                      index=*packet_data;
                       if (image->storage_class == PseudoClass)
                         {
                           VerifyColormapIndex(image,index);
@@ -493,14 +581,15 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
                       unsigned int
                         packet;
 
-                      if (ReadBlob(image, 2, readbuffer) != 2)
+                      if ((packet_data=ReadTGAPacket(image,2,readbuffer,
+                                                     &scanline)) == NULL)
 			{
 			  status=MagickFail;
 			  break;
 			}
 		      readbufferpos = 0;
-		      packet = ReadBlobByteFromBuffer(readbuffer, &readbufferpos);
-		      packet |= (((unsigned int) ReadBlobByteFromBuffer(readbuffer, &readbufferpos)) << 8);
+		      packet = ReadBlobByteFromBuffer(packet_data, &readbufferpos);
+		      packet |= (((unsigned int) ReadBlobByteFromBuffer(packet_data, &readbufferpos)) << 8);
 
                       pixel.red=(packet >> 10) & 0x1f;
                       pixel.red=ScaleCharToQuantum(ScaleColor5to8(pixel.red));
@@ -527,38 +616,43 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
                     /*
                       8 bits each of blue green and red.
                     */
-                    if (ReadBlob(image, 3, readbuffer) != 3)
+                    if ((packet_data=ReadTGAPacket(image,3,readbuffer,
+                                                   &scanline)) == NULL)
 		      {
 			status=MagickFail;
 			break;
 		      }
                     readbufferpos = 0;
-                    pixel.blue=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
-                    pixel.green=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
-                    pixel.red=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
+                    pixel.blue=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
+                    pixel.green=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
+                    pixel.red=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
                     break;
                   case 32:
                     {
                       /*
                         8 bits each of blue green and red.
                       */
-                      if (ReadBlob(image, 4, readbuffer) != 4)
+                      if ((packet_data=ReadTGAPacket(image,4,readbuffer,
+                                                     &scanline)) == NULL)
 			{
 			  status=MagickFail;
 			  break;
 			}
                       readbufferpos = 0;
-                      pixel.blue=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
-                      pixel.green=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
-                      pixel.red=ScaleCharToQuantum(ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
-                      pixel.opacity=ScaleCharToQuantum(255-ReadBlobByteFromBuffer(readbuffer, &readbufferpos));
+                      pixel.blue=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
+                      pixel.green=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
+                      pixel.red=ScaleCharToQuantum(ReadBlobByteFromBuffer(packet_data, &readbufferpos));
+                      pixel.opacity=ScaleCharToQuantum(255-ReadBlobByteFromBuffer(packet_data, &readbufferpos));
                       break;
                     }
                   }
               if (EOFBlob(image))
                 status = MagickFail;
               if (status == MagickFail)
-                ThrowReaderException(CorruptImageError,UnableToReadImageData,image);
+                {
+                  MagickFreeMemory(pixels);
+                  ThrowReaderException(CorruptImageError,UnableToReadImageData,image);
+                }
               if (image->storage_class == PseudoClass)
                 indexes[x]=index;
               *q++=pixel;
@@ -591,6 +685,7 @@ static Image *ReadTGAImage(const ImageInfo *image_info,ExceptionInfo *exception)
 					  image->columns,image->rows))
                 break;
         }
+      MagickFreeMemory(pixels);
       if (EOFBlob(image))
         {
           ThrowException(exception,CorruptImageError,UnexpectedEndOfFile,
@@ -118,6 +118,13 @@
 */
 static MagickTsdKey_t tsd_key = (MagickTsdKey_t) 0;
 
+/*
+  The libtiff error and warning handlers are process-wide, so the
+  exception to report to, and whether warnings are reported as an
+  exception at all, are kept per thread.
+*/
+static MagickTsdKey_t tsd_warnings_key = (MagickTsdKey_t) 0;
+
 /* static ExceptionInfo */
 /*   *tiff_exception; */
 
@@ -752,6 +759,18 @@ CheckThrowWarnings(const ImageInfo *image_info)
   return report_warnings;
 }
 
+/*
+  Set the calling thread's target for libtiff errors and warnings.
+*/
+static void
+TIFFSetThreadExceptionInfo(ExceptionInfo *exception,
+                           const MagickBool throw_warnings)
+{
+  (void) MagickTsdSetSpecific(tsd_key,(void *) exception);
+  (void) MagickTsdSetSpecific(tsd_warnings_key,
+                              (void *) (throw_warnings ? exception : NULL));
+}
+
 
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
@@ -908,31 +927,13 @@ TIFFUnmapBlob(thandle_t ARGUNUSED(image),
 #endif  /* LOG_TIFF_BLOB_IO */
 }
 
-/* Report warnings as a coder log message. */
-static unsigned int
-TIFFWarningsLogOnly(const char *module,const char *format,va_list warning)
-{
-/*   ExceptionInfo */
-/*     *tiff_exception; */
-
-  char
-    message[MaxTextExtent];
-
-  (void) module;
-  errno=0;
-  (void) vsnprintf(message,MaxTextExtent-2,format,warning);
-  message[MaxTextExtent-2]='\0';
-  (void) strlcat(message,".",MaxTextExtent);
-/*   tiff_exception=(ExceptionInfo *) MagickTsdGetSpecific(tsd_key); */
-/*   ThrowException2(tiff_exception,CoderWarning,message,module); */
-  (void) LogMagickEvent(CoderEvent,GetMagickModule(),
-                        "TIFF Warning: %s",message);
-  return(True);
-}
-
-/* Report warnings as exception in thread-specific ExceptionInfo */
+/*
+  Report warnings as exception in thread-specific ExceptionInfo if
+  requested via the tiff:report-warnings define, and otherwise as a
+  coder log message.
+*/
 static unsigned int
-TIFFWarningsThrowException(const char *module,const char *format,va_list warning)
+TIFFWarnings(const char *module,const char *format,va_list warning)
 {
   ExceptionInfo
     *tiff_exception;
@@ -945,8 +946,9 @@ TIFFWarningsThrowException(const char *module,const char *format,va_list warning
   (void) vsnprintf(message,MaxTextExtent-2,format,warning);
   message[MaxTextExtent-2]='\0';
   (void) strlcat(message,".",MaxTextExtent);
-  tiff_exception=(ExceptionInfo *) MagickTsdGetSpecific(tsd_key);
-  ThrowException2(tiff_exception,CoderWarning,message,module);
+  tiff_exception=(ExceptionInfo *) MagickTsdGetSpecific(tsd_warnings_key);
+  if (tiff_exception != (ExceptionInfo *) NULL)
+    ThrowException2(tiff_exception,CoderWarning,message,module);
   (void) LogMagickEvent(CoderEvent,GetMagickModule(),
                         "TIFF Warning: %s",message);
   return(True);
@@ -1044,6 +1046,561 @@ SwabDataToNativeEndian(const uint16 bits_per_sample, tdata_t data,
 }
 #endif
 
+/*
+  Strips (and tiles) are compressed independently of each other, so
+  they may be decoded or encoded concurrently.  Since a libtiff handle
+  carries codec state and a file position, each worker thread uses its
+  own handle.  Read handles are opened on the same input via pread()
+  or the in-memory blob, and positioned on the current directory.
+  Write handles encode into a private memory buffer, from which the
+  encoded strip is copied into the output file using TIFFWriteRawStrip().
+*/
+typedef struct _Magick_TIFF_ThreadClientData
+{
+  Image
+    *image;             /* Source image (read) */
+
+  const unsigned char
+    *base;              /* In-memory blob data (read) */
+
+  int
+    file;               /* File descriptor for pread() (read) */
+
+  unsigned char
+    *data;              /* Encoded data buffer (write) */
+
+  magick_off_t
+    offset,             /* Current offset */
+    length,             /* Length of data */
+    extent;             /* Allocated size of data buffer (write) */
+} Magick_TIFF_ThreadClientData;
+
+typedef struct _Magick_TIFF_ThreadSet
+{
+  unsigned int
+    nthreads;           /* Number of worker handles */
+
+  TIFF
+    **tiff;             /* Per-thread libtiff handles */
+
+  Magick_TIFF_ThreadClientData
+    *client_data;       /* Per-thread I/O state */
+
+  unsigned char
+    **buffer;           /* Per-thread strip/tile buffers */
+
+  ExceptionInfo
+    *exception;         /* Per-thread libtiff error reports */
+
+  MagickBool
+    throw_warnings;     /* Report libtiff warnings as exceptions */
+} Magick_TIFF_ThreadSet;
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+static tsize_t
+TIFFReadThreadBlob(thandle_t handle,tdata_t data,tsize_t size)
+{
+  Magick_TIFF_ThreadClientData
+    *client_data = (Magick_TIFF_ThreadClientData *) handle;
+
+  tsize_t
+    result;
+
+  result=0;
+  if (client_data->base != (const unsigned char *) NULL)
+    {
+      if (client_data->offset < client_data->length)
+        {
+          result=(tsize_t) Min((magick_off_t) size,
+                               client_data->length-client_data->offset);
+          (void) memcpy(data,client_data->base+client_data->offset,
+                        (size_t) result);
+        }
+    }
+#if defined(HAVE_PREAD)
+  else if (client_data->file >= 0)
+    {
+      ssize_t
+        count;
+
+      count=pread(client_data->file,data,(size_t) size,
+                  (off_t) client_data->offset);
+      if (count > 0)
+        result=(tsize_t) count;
+    }
+#endif /* defined(HAVE_PREAD) */
+  client_data->offset+=result;
+  return result;
+}
+
+static tsize_t
+TIFFWriteThreadBlob(thandle_t handle,tdata_t data,tsize_t size)
+{
+  Magick_TIFF_ThreadClientData
+    *client_data = (Magick_TIFF_ThreadClientData *) handle;
+
+  if (client_data->base != (const unsigned char *) NULL)
+    return -1;
+  if (client_data->offset+size > client_data->extent)
+    {
+      magick_off_t
+        extent;
+
+      extent=Max(2*client_data->extent,client_data->offset+size);
+      MagickReallocMemory(unsigned char *,client_data->data,(size_t) extent);
+      if (client_data->data == (unsigned char *) NULL)
+        {
+          client_data->extent=0;
+          client_data->length=0;
+          return -1;
+        }
+      client_data->extent=extent;
+    }
+  (void) memcpy(client_data->data+client_data->offset,data,(size_t) size);
+  client_data->offset+=size;
+  if (client_data->offset > client_data->length)
+    client_data->length=client_data->offset;
+  return size;
+}
+
+static toff_t
+TIFFSeekThreadBlob(thandle_t handle,toff_t offset,int whence)
+{
+  Magick_TIFF_ThreadClientData
+    *client_data = (Magick_TIFF_ThreadClientData *) handle;
+
+  switch (whence)
+    {
+    case SEEK_SET:
+      client_data->offset=(magick_off_t) offset;
+      break;
+    case SEEK_CUR:
+      client_data->offset+=(magick_off_t) offset;
+      break;
+    case SEEK_END:
+      client_data->offset=client_data->length+(magick_off_t) offset;
+      break;
+    default:
+      return (toff_t) -1;
+    }
+  return (toff_t) client_data->offset;
+}
+
+static int
+TIFFCloseThreadBlob(thandle_t ARGUNUSED(handle))
+{
+  return 0;
+}
+
+static toff_t
+TIFFGetThreadBlobSize(thandle_t handle)
+{
+  return (toff_t) ((Magick_TIFF_ThreadClientData *) handle)->length;
+}
+
+static int
+TIFFMapThreadBlob(thandle_t handle,tdata_t *base,toff_t *size)
+{
+  Magick_TIFF_ThreadClientData
+    *client_data = (Magick_TIFF_ThreadClientData *) handle;
+
+  if (client_data->base == (const unsigned char *) NULL)
+    return 0;
+  *base=(tdata_t) client_data->base;
+  *size=(toff_t) client_data->length;
+  return 1;
+}
+
+static void
+TIFFUnmapThreadBlob(thandle_t ARGUNUSED(handle),
+                    tdata_t ARGUNUSED(base),
+                    toff_t ARGUNUSED(size))
+{
+}
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+/*
+  Return the number of threads to use for strip/tile coding.
+*/
+static unsigned int
+TIFFCodecThreads(const ImageInfo *image_info)
+{
+  unsigned int
+    threads = 1;
+
+#if defined(HAVE_OPENMP)
+  const char
+    *value;
+
+  /*
+    Pixel cache views are allocated per OpenMP thread, so at most
+    omp_get_max_threads() threads may be used.
+  */
+  threads=(unsigned int) omp_get_max_threads();
+  if ((value=AccessDefinition(image_info,"tiff","threads")))
+    threads=Min(threads,(unsigned int) Max(1,MagickAtoI(value)));
+#else
+  ARG_NOT_USED(image_info);
+#endif /* defined(HAVE_OPENMP) */
+  return threads;
+}
+
+static void
+DestroyTIFFThreadSet(Magick_TIFF_ThreadSet *thread_set)
+{
+  unsigned int
+    i;
+
+  if (thread_set == (Magick_TIFF_ThreadSet *) NULL)
+    return;
+  for (i=0; i < thread_set->nthreads; i++)
+    {
+      if ((thread_set->tiff != (TIFF **) NULL) &&
+          (thread_set->tiff[i] != (TIFF *) NULL))
+        TIFFCleanup(thread_set->tiff[i]);
+      if (thread_set->client_data != (Magick_TIFF_ThreadClientData *) NULL)
+        MagickFreeMemory(thread_set->client_data[i].data);
+      if (thread_set->buffer != (unsigned char **) NULL)
+        MagickFreeMemory(thread_set->buffer[i]);
+      if (thread_set->exception != (ExceptionInfo *) NULL)
+        DestroyExceptionInfo(&thread_set->exception[i]);
+    }
+  MagickFreeMemory(thread_set->tiff);
+  MagickFreeMemory(thread_set->client_data);
+  MagickFreeMemory(thread_set->buffer);
+  MagickFreeMemory(thread_set->exception);
+  (void) memset((void *) thread_set,0xbf,sizeof(Magick_TIFF_ThreadSet));
+  MagickFreeMemory(thread_set);
+}
+
+static Magick_TIFF_ThreadSet *
+AllocateTIFFThreadSet(const unsigned int nthreads,const size_t buffer_size)
+{
+  Magick_TIFF_ThreadSet
+    *thread_set;
+
+  unsigned int
+    i;
+
+  thread_set=MagickAllocateMemory(Magick_TIFF_ThreadSet *,
+                                  sizeof(Magick_TIFF_ThreadSet));
+  if (thread_set == (Magick_TIFF_ThreadSet *) NULL)
+    return thread_set;
+  thread_set->nthreads=nthreads;
+  thread_set->throw_warnings=
+    (MagickTsdGetSpecific(tsd_warnings_key) != (void *) NULL);
+  thread_set->tiff=MagickAllocateArray(TIFF **,nthreads,sizeof(TIFF *));
+  thread_set->client_data=
+    MagickAllocateArray(Magick_TIFF_ThreadClientData *,nthreads,
+                        sizeof(Magick_TIFF_ThreadClientData));
+  thread_set->buffer=MagickAllocateArray(unsigned char **,nthreads,
+                                         sizeof(unsigned char *));
+  thread_set->exception=MagickAllocateArray(ExceptionInfo *,nthreads,
+                                            sizeof(ExceptionInfo));
+  if ((thread_set->tiff == (TIFF **) NULL) ||
+      (thread_set->client_data == (Magick_TIFF_ThreadClientData *) NULL) ||
+      (thread_set->buffer == (unsigned char **) NULL) ||
+      (thread_set->exception == (ExceptionInfo *) NULL))
+    {
+      MagickFreeMemory(thread_set->exception);
+      thread_set->nthreads=0;
+      DestroyTIFFThreadSet(thread_set);
+      return (Magick_TIFF_ThreadSet *) NULL;
+    }
+  (void) memset(thread_set->tiff,0,nthreads*sizeof(TIFF *));
+  (void) memset(thread_set->client_data,0,
+                nthreads*sizeof(Magick_TIFF_ThreadClientData));
+  (void) memset(thread_set->buffer,0,nthreads*sizeof(unsigned char *));
+  for (i=0; i < nthreads; i++)
+    {
+      GetExceptionInfo(&thread_set->exception[i]);
+      thread_set->client_data[i].file=-1;
+    }
+  for (i=0; i < nthreads; i++)
+    {
+      thread_set->buffer[i]=MagickAllocateMemory(unsigned char *,buffer_size);
+      if (thread_set->buffer[i] == (unsigned char *) NULL)
+        {
+          DestroyTIFFThreadSet(thread_set);
+          return (Magick_TIFF_ThreadSet *) NULL;
+        }
+    }
+  return thread_set;
+}
+
+/*
+  Open a read handle per thread on the input of an open TIFF, and
+  select the same directory.  Returns NULL if the input does not
+  support independent positioned reads.
+*/
+static Magick_TIFF_ThreadSet *
+AllocateTIFFReadThreadSet(Image *image,TIFF *tiff,
+                          const unsigned int nthreads,
+                          const size_t buffer_size)
+{
+  Magick_TIFF_ThreadSet
+    *thread_set;
+
+  const unsigned char
+    *base;
+
+  int
+    file;
+
+  tdir_t
+    directory;
+
+  uint16
+    compress_tag,
+    photometric,
+    samples_per_pixel;
+
+  unsigned int
+    i;
+
+  if ((nthreads < 2) || !BlobIsSeekable(image))
+    return (Magick_TIFF_ThreadSet *) NULL;
+  file=-1;
+  base=GetBlobStreamData(image);
+#if defined(HAVE_PREAD)
+  if (base == (const unsigned char *) NULL)
+    {
+      FILE
+        *file_handle;
+
+      if ((file_handle=GetBlobFileHandle(image)) != (FILE *) NULL)
+        file=fileno(file_handle);
+    }
+#endif /* defined(HAVE_PREAD) */
+  if ((base == (const unsigned char *) NULL) && (file < 0))
+    return (Magick_TIFF_ThreadSet *) NULL;
+
+  thread_set=AllocateTIFFThreadSet(nthreads,buffer_size);
+  if (thread_set == (Magick_TIFF_ThreadSet *) NULL)
+    return thread_set;
+  directory=TIFFCurrentDirectory(tiff);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_COMPRESSION,&compress_tag);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_PHOTOMETRIC,&photometric);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_SAMPLESPERPIXEL,&samples_per_pixel);
+  for (i=0; i < nthreads; i++)
+    {
+      Magick_TIFF_ThreadClientData
+        *client_data = &thread_set->client_data[i];
+
+      client_data->image=image;
+      client_data->base=base;
+      client_data->file=file;
+      client_data->length=(magick_off_t) GetBlobSize(image);
+      thread_set->tiff[i]=TIFFClientOpen(image->filename,"rb",
+                                         (thandle_t) client_data,
+                                         TIFFReadThreadBlob,
+                                         TIFFWriteThreadBlob,
+                                         TIFFSeekThreadBlob,
+                                         TIFFCloseThreadBlob,
+                                         TIFFGetThreadBlobSize,
+                                         TIFFMapThreadBlob,
+                                         TIFFUnmapThreadBlob);
+      if ((thread_set->tiff[i] == (TIFF *) NULL) ||
+          (TIFFSetDirectory(thread_set->tiff[i],directory) != 1))
+        {
+          DestroyTIFFThreadSet(thread_set);
+          return (Magick_TIFF_ThreadSet *) NULL;
+        }
+      /*
+        Apply the same pseudo-tag settings as ReadTIFFImage().
+      */
+      if ((photometric == PHOTOMETRIC_LOGL) ||
+          (photometric == PHOTOMETRIC_LOGLUV))
+        (void) TIFFSetField(thread_set->tiff[i],TIFFTAG_SGILOGDATAFMT,
+                            SGILOGDATAFMT_FLOAT);
+      if ((samples_per_pixel > 1) && (compress_tag == COMPRESSION_JPEG) &&
+          (photometric == PHOTOMETRIC_YCBCR))
+        (void) TIFFSetField(thread_set->tiff[i],TIFFTAG_JPEGCOLORMODE,
+                            JPEGCOLORMODE_RGB);
+    }
+  return thread_set;
+}
+
+/*
+  Open a scratch write handle per thread which encodes one strip of
+  'rows_per_strip' rows using the same layout and codec settings as
+  'tiff'.
+*/
+static Magick_TIFF_ThreadSet *
+AllocateTIFFWriteThreadSet(TIFF *tiff,const unsigned int nthreads,
+                           const size_t buffer_size,
+                           const uint32 rows_per_strip)
+{
+  Magick_TIFF_ThreadSet
+    *thread_set;
+
+  uint16
+    bits_per_sample,
+    compress_tag,
+    extra_samples,
+    fill_order,
+    photometric,
+    planar_config,
+    predictor,
+    *sample_info,
+    sample_format,
+    samples_per_pixel;
+
+  uint32
+    columns;
+
+  unsigned int
+    i;
+
+  if (nthreads < 2)
+    return (Magick_TIFF_ThreadSet *) NULL;
+  (void) TIFFGetField(tiff,TIFFTAG_IMAGEWIDTH,&columns);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_BITSPERSAMPLE,&bits_per_sample);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_COMPRESSION,&compress_tag);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_FILLORDER,&fill_order);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_PHOTOMETRIC,&photometric);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_PLANARCONFIG,&planar_config);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_SAMPLEFORMAT,&sample_format);
+  (void) TIFFGetFieldDefaulted(tiff,TIFFTAG_SAMPLESPERPIXEL,&samples_per_pixel);
+  if (TIFFGetField(tiff,TIFFTAG_EXTRASAMPLES,&extra_samples,&sample_info) != 1)
+    extra_samples=0;
+  if (TIFFGetField(tiff,TIFFTAG_PREDICTOR,&predictor) != 1)
+    predictor=0;
+
+  thread_set=AllocateTIFFThreadSet(nthreads,buffer_size);
+  if (thread_set == (Magick_TIFF_ThreadSet *) NULL)
+    return thread_set;
+  for (i=0; i < nthreads; i++)
+    {
+      TIFF
+        *scratch;
+
+      scratch=TIFFClientOpen("scratch",TIFFIsBigEndian(tiff) ? "wb" : "wl",
+                             (thandle_t) &thread_set->client_data[i],
+                             TIFFReadThreadBlob,TIFFWriteThreadBlob,
+                             TIFFSeekThreadBlob,TIFFCloseThreadBlob,
+                             TIFFGetThreadBlobSize,TIFFMapThreadBlob,
+                             TIFFUnmapThreadBlob);
+      thread_set->tiff[i]=scratch;
+      if (scratch == (TIFF *) NULL)
+        {
+          DestroyTIFFThreadSet(thread_set);
+          return (Magick_TIFF_ThreadSet *) NULL;
+        }
+      (void) TIFFSetField(scratch,TIFFTAG_IMAGEWIDTH,columns);
+      (void) TIFFSetField(scratch,TIFFTAG_IMAGELENGTH,rows_per_strip);
+      (void) TIFFSetField(scratch,TIFFTAG_ROWSPERSTRIP,rows_per_strip);
+      (void) TIFFSetField(scratch,TIFFTAG_BITSPERSAMPLE,bits_per_sample);
+      (void) TIFFSetField(scratch,TIFFTAG_SAMPLESPERPIXEL,samples_per_pixel);
+      (void) TIFFSetField(scratch,TIFFTAG_SAMPLEFORMAT,sample_format);
+      (void) TIFFSetField(scratch,TIFFTAG_PHOTOMETRIC,photometric);
+      (void) TIFFSetField(scratch,TIFFTAG_PLANARCONFIG,planar_config);
+      (void) TIFFSetField(scratch,TIFFTAG_FILLORDER,fill_order);
+      if (extra_samples != 0)
+        (void) TIFFSetField(scratch,TIFFTAG_EXTRASAMPLES,extra_samples,
+                            sample_info);
+      (void) TIFFSetField(scratch,TIFFTAG_COMPRESSION,compress_tag);
+      if (predictor != 0)
+        (void) TIFFSetField(scratch,TIFFTAG_PREDICTOR,predictor);
+      switch (compress_tag)
+        {
+        case COMPRESSION_ADOBE_DEFLATE:
+        case COMPRESSION_DEFLATE:
+          {
+            int
+              zip_quality;
+
+            if (TIFFGetField(tiff,TIFFTAG_ZIPQUALITY,&zip_quality) == 1)
+              (void) TIFFSetField(scratch,TIFFTAG_ZIPQUALITY,zip_quality);
+            break;
+          }
+        case COMPRESSION_CCITTFAX3:
+          {
+            uint32
+              group_three_options;
+
+            if (TIFFGetField(tiff,TIFFTAG_GROUP3OPTIONS,
+                             &group_three_options) == 1)
+              (void) TIFFSetField(scratch,TIFFTAG_GROUP3OPTIONS,
+                                  group_three_options);
+            break;
+          }
+#if defined(COMPRESSION_LZMA)
+        case COMPRESSION_LZMA:
+          {
+            int
+              lzma_preset;
+
+            if (TIFFGetField(tiff,TIFFTAG_LZMAPRESET,&lzma_preset) == 1)
+              (void) TIFFSetField(scratch,TIFFTAG_LZMAPRESET,lzma_preset);
+            break;
+          }
+#endif /* defined(COMPRESSION_LZMA) */
+        default:
+          break;
+        }
+    }
+  return thread_set;
+}
+
+/*
+  Encode one strip using the calling thread's scratch handle, and
+  return a pointer to the encoded data.
+*/
+static const unsigned char *
+TIFFEncodeThreadStrip(Magick_TIFF_ThreadSet *thread_set,
+                      const unsigned int thread,tdata_t data,
+                      const tsize_t size,tsize_t *encoded_size)
+{
+  Magick_TIFF_ThreadClientData
+    *client_data = &thread_set->client_data[thread];
+
+  TIFF
+    *scratch = thread_set->tiff[thread];
+
+  toff_t
+    *byte_counts,
+    *offsets;
+
+  /*
+    Each strip is appended after the previous one, so rewind the
+    buffer first.  libtiff requires that data follows the header.
+  */
+  client_data->length=Min(client_data->length,8);
+  if (TIFFWriteEncodedStrip(scratch,0,data,size) == -1)
+    return (const unsigned char *) NULL;
+  if ((TIFFGetField(scratch,TIFFTAG_STRIPOFFSETS,&offsets) != 1) ||
+      (TIFFGetField(scratch,TIFFTAG_STRIPBYTECOUNTS,&byte_counts) != 1) ||
+      (client_data->data == (unsigned char *) NULL) ||
+      ((magick_off_t) (offsets[0]+byte_counts[0]) > client_data->length))
+    return (const unsigned char *) NULL;
+  *encoded_size=(tsize_t) byte_counts[0];
+  return client_data->data+offsets[0];
+}
+
+/*
+  Report the most severe libtiff error or warning raised by a worker
+  thread, and restore the calling thread's exception target.
+*/
+static void
+TIFFThreadSetExceptions(Magick_TIFF_ThreadSet *thread_set,
+                        ExceptionInfo *exception)
+{
+  unsigned int
+    i;
+
+  TIFFSetThreadExceptionInfo(exception,thread_set->throw_warnings);
+  for (i=0; i < thread_set->nthreads; i++)
+    if (thread_set->exception[i].severity > exception->severity)
+      CopyException(exception,&thread_set->exception[i]);
+}
+
 /*
   Initialize the image colormap.
 */
@@ -1667,11 +2224,7 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
   status=OpenBlob(image_info,image,ReadBinaryBlobMode,exception);
   if (status == MagickFail)
     ThrowReaderException(FileOpenError,UnableToOpenFile,image);
-  (void) MagickTsdSetSpecific(tsd_key,(void *) exception);
-  (void) TIFFSetErrorHandler((TIFFErrorHandler) TIFFErrors);
-  (void) TIFFSetWarningHandler((TIFFErrorHandler) (CheckThrowWarnings(image_info) ?
-                                                   TIFFWarningsThrowException :
-                                                   TIFFWarningsLogOnly));
+  TIFFSetThreadExceptionInfo(exception,CheckThrowWarnings(image_info));
   client_data.image=image;
   client_data.image_info=image_info;
   tiff=TIFFClientOpen(image->filename,"rb",(thandle_t) &client_data,TIFFReadBlob,
@@ -2154,6 +2707,10 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
               method=TiledMethod;
             else if ((TIFFStripSize(tiff)) <= (1024*64))
               method=StrippedMethod;
+            else if ((TIFFCodecThreads(image_info) > 1) &&
+                     (TIFFNumberOfStrips(tiff) > 1))
+              /* Decode strips in parallel */
+              method=StrippedMethod;
             if (photometric == PHOTOMETRIC_MINISWHITE)
               import_options.grayscale_miniswhite=MagickTrue;
           }
@@ -2356,6 +2913,12 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
               stride,
               rows_remaining;
 
+            unsigned long
+              strips_per_plane;
+
+            Magick_TIFF_ThreadSet
+              *thread_set;
+
             int
               max_sample,
               quantum_samples,
@@ -2418,6 +2981,20 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
               Compute per-row stride.
             */
             stride=TIFFVStripSize(tiff,1);
+            /*
+              Open per-thread handles for decoding strips in parallel.
+            */
+            strips_per_plane=1;
+            if ((rows_per_strip != 0) && (rows_per_strip < image->rows))
+              strips_per_plane=(image->rows+rows_per_strip-1)/rows_per_strip;
+            thread_set=AllocateTIFFReadThreadSet(image,tiff,
+                                                 Min(TIFFCodecThreads(image_info),
+                                                     strips_per_plane),
+                                                 (size_t) strip_size_max);
+            if (logging && (thread_set != (Magick_TIFF_ThreadSet *) NULL))
+              (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                    "Decoding %lu strips per plane using %u threads",
+                                    strips_per_plane,thread_set->nthreads);
             /*
               Process each plane
             */
@@ -2438,6 +3015,149 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
                     status=MagickFail;
                     break;
                   }
+                if (thread_set != (Magick_TIFF_ThreadSet *) NULL)
+                  {
+                    long
+                      strip_index;
+
+                    unsigned long
+                      strips_done;
+
+                    strips_done=0;
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(runtime) shared(status,strips_done)
+#  else
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(static,1) shared(status,strips_done)
+#  endif
+#endif
+                    for (strip_index=0; strip_index < (long) strips_per_plane;
+                         strip_index++)
+                      {
+                        unsigned char
+                          *strip_pixels;
+
+                        unsigned long
+                          strip_rows,
+                          yy;
+
+                        unsigned int
+                          thread;
+
+                        tsize_t
+                          thread_strip_size;
+
+                        MagickPassFail
+                          thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadTIFFImage)
+#endif
+                        thread_status=status;
+                        if (thread_status == MagickFail)
+                          continue;
+
+#if defined(HAVE_OPENMP)
+                        thread=omp_get_thread_num();
+#else
+                        thread=0;
+#endif /* defined(HAVE_OPENMP) */
+                        TIFFSetThreadExceptionInfo(&thread_set->exception[thread],
+                                                   thread_set->throw_warnings);
+                        strip_pixels=thread_set->buffer[thread];
+                        thread_strip_size=
+                          TIFFReadEncodedStrip(thread_set->tiff[thread],
+                                               (tstrip_t) (sample*strips_per_plane+
+                                                           strip_index),
+                                               strip_pixels,strip_size_max);
+                        if (thread_strip_size == -1)
+                          thread_status=MagickFail;
+#if !defined(WORDS_BIGENDIAN)
+                        if ((thread_status != MagickFail) &&
+                            (24 == bits_per_sample))
+                          SwabDataToBigEndian(bits_per_sample,strip_pixels,
+                                              thread_strip_size);
+#endif
+                        strip_rows=Min(rows_per_strip,
+                                       image->rows-strip_index*rows_per_strip);
+                        for (yy=strip_index*rows_per_strip;
+                             (thread_status != MagickFail) &&
+                               (yy < strip_index*rows_per_strip+strip_rows);
+                             yy++)
+                          {
+                            PixelPacket
+                              *thread_q;
+
+                            if (sample == 0)
+                              thread_q=SetImagePixels(image,0,yy,image->columns,1);
+                            else
+                              thread_q=GetImagePixels(image,0,yy,image->columns,1);
+                            if (thread_q == (PixelPacket *) NULL)
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            if ((samples_per_pixel > quantum_samples) &&
+                                (planar_config == PLANARCONFIG_CONTIG))
+                              CompactSamples(image->columns, bits_per_sample,
+                                             samples_per_pixel, quantum_samples,
+                                             strip_pixels);
+                            if (ImportImagePixelArea(image,quantum_type,
+                                                     bits_per_sample,strip_pixels,
+                                                     &import_options,0)
+                                == MagickFail)
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            if ((image->matte) && (alpha_type == AssociatedAlpha)
+                                && (sample == (max_sample-1)))
+                              DisassociateAlphaRegion(image);
+                            if (!SyncImagePixels(image))
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            strip_pixels += stride;
+                          }
+
+                        /*
+                          Do not leave this (possibly pooled) thread reporting to the
+                          thread set, which is destroyed after the loop.
+                        */
+                        TIFFSetThreadExceptionInfo((ExceptionInfo *) NULL,
+                                                   MagickFalse);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadTIFFImage)
+#endif
+                        {
+                          if (thread_status == MagickFail)
+                            status=MagickFail;
+                          strips_done++;
+                          if (image->previous == (Image *) NULL)
+                            if (QuantumTick(strips_done+strips_per_plane*sample,
+                                            strips_per_plane*max_sample))
+                              if (!MagickMonitorFormatted(strips_done+
+                                                          strips_per_plane*sample,
+                                                          strips_per_plane*max_sample,
+                                                          exception,
+                                                          LoadImageText,
+                                                          image->filename,
+                                                          image->columns,
+                                                          image->rows))
+                                status=MagickFail;
+                        }
+                      }
+                    TIFFThreadSetExceptions(thread_set,exception);
+                    if (status == MagickFail)
+                      {
+                        if (image->exception.severity > exception->severity)
+                          CopyException(exception,&image->exception);
+                        break;
+                      }
+                    continue;
+                  }
                 for (y=0; y < image->rows; y++)
                   {
                     /*
@@ -2525,6 +3245,7 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
                 if (status == MagickFail)
                   break;
               }
+            DestroyTIFFThreadSet(thread_set);
             MagickFreeMemory(strip);
             break;
           }
@@ -2554,7 +3275,12 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
               quantum_type;
 
             unsigned long
-              tile_total_pixels;
+              tile_total_pixels,
+              tiles_across,
+              tiles_per_plane;
+
+            Magick_TIFF_ThreadSet
+              *thread_set;
         
             if (logging)
               (void) LogMagickEvent(CoderEvent,GetMagickModule(),
@@ -2618,6 +3344,20 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
               Compute per-row stride.
             */
             stride=TIFFTileRowSize(tiff);
+            /*
+              Open per-thread handles for decoding tiles in parallel.
+            */
+            tiles_across=(image->columns+tile_columns-1)/tile_columns;
+            tiles_per_plane=tiles_across*
+              ((image->rows+tile_rows-1)/tile_rows);
+            thread_set=AllocateTIFFReadThreadSet(image,tiff,
+                                                 Min(TIFFCodecThreads(image_info),
+                                                     tiles_per_plane),
+                                                 (size_t) tile_size_max);
+            if (logging && (thread_set != (Magick_TIFF_ThreadSet *) NULL))
+              (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                    "Decoding %lu tiles per plane using %u threads",
+                                    tiles_per_plane,thread_set->nthreads);
 
 	    /*
 	      Process each plane.
@@ -2637,6 +3377,154 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
 		    status=MagickFail;
 		    break;
 		  }
+                if (thread_set != (Magick_TIFF_ThreadSet *) NULL)
+                  {
+                    long
+                      tile_index;
+
+                    unsigned long
+                      tiles_done;
+
+                    tiles_done=0;
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(runtime) shared(status,tiles_done)
+#  else
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(static,1) shared(status,tiles_done)
+#  endif
+#endif
+                    for (tile_index=0; tile_index < (long) tiles_per_plane;
+                         tile_index++)
+                      {
+                        unsigned char
+                          *tile_pixels;
+
+                        unsigned long
+                          tile_set_columns,
+                          tile_set_rows,
+                          tile_x,
+                          tile_y,
+                          yy;
+
+                        unsigned int
+                          thread;
+
+                        tsize_t
+                          thread_tile_size;
+
+                        MagickPassFail
+                          thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadTIFFImage)
+#endif
+                        thread_status=status;
+                        if (thread_status == MagickFail)
+                          continue;
+
+#if defined(HAVE_OPENMP)
+                        thread=omp_get_thread_num();
+#else
+                        thread=0;
+#endif /* defined(HAVE_OPENMP) */
+                        TIFFSetThreadExceptionInfo(&thread_set->exception[thread],
+                                                   thread_set->throw_warnings);
+                        tile_pixels=thread_set->buffer[thread];
+                        tile_x=(tile_index % tiles_across)*tile_columns;
+                        tile_y=(tile_index / tiles_across)*tile_rows;
+                        tile_set_columns=Min(tile_columns,image->columns-tile_x);
+                        tile_set_rows=Min(tile_rows,image->rows-tile_y);
+                        thread_tile_size=TIFFReadTile(thread_set->tiff[thread],
+                                                      tile_pixels,tile_x,tile_y,
+                                                      0,sample);
+                        if (thread_tile_size == -1)
+                          thread_status=MagickFail;
+#if !defined(WORDS_BIGENDIAN)
+                        if ((thread_status != MagickFail) &&
+                            (24 == bits_per_sample))
+                          SwabDataToBigEndian(bits_per_sample,tile_pixels,
+                                              thread_tile_size);
+#endif
+                        for (yy=tile_y;
+                             (thread_status != MagickFail) &&
+                               (yy < tile_y+tile_set_rows);
+                             yy++)
+                          {
+                            PixelPacket
+                              *thread_q;
+
+                            if (sample == 0)
+                              thread_q=SetImagePixels(image,tile_x,yy,
+                                                      tile_set_columns,1);
+                            else
+                              thread_q=GetImagePixels(image,tile_x,yy,
+                                                      tile_set_columns,1);
+                            if (thread_q == (PixelPacket *) NULL)
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            if ((samples_per_pixel > quantum_samples) &&
+                                (planar_config == PLANARCONFIG_CONTIG))
+                              CompactSamples(tile_set_columns, bits_per_sample,
+                                             samples_per_pixel, quantum_samples,
+                                             tile_pixels);
+                            if (ImportImagePixelArea(image,quantum_type,
+                                                     bits_per_sample,tile_pixels,
+                                                     &import_options,0)
+                                == MagickFail)
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            if ((image->matte) && (alpha_type == AssociatedAlpha)
+                                && (sample == (max_sample-1)))
+                              DisassociateAlphaRegion(image);
+                            if (!SyncImagePixels(image))
+                              {
+                                thread_status=MagickFail;
+                                break;
+                              }
+                            tile_pixels += stride;
+                          }
+
+                        /*
+                          Do not leave this (possibly pooled) thread reporting to the
+                          thread set, which is destroyed after the loop.
+                        */
+                        TIFFSetThreadExceptionInfo((ExceptionInfo *) NULL,
+                                                   MagickFalse);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ReadTIFFImage)
+#endif
+                        {
+                          if (thread_status == MagickFail)
+                            status=MagickFail;
+                          tiles_done++;
+                          if (image->previous == (Image *) NULL)
+                            if (QuantumTick(tiles_done+tiles_per_plane*sample,
+                                            tiles_per_plane*max_sample))
+                              if (!MagickMonitorFormatted(tiles_done+
+                                                          tiles_per_plane*sample,
+                                                          tiles_per_plane*max_sample,
+                                                          exception,
+                                                          LoadImageText,
+                                                          image->filename,
+                                                          image->columns,
+                                                          image->rows))
+                                status=MagickFail;
+                        }
+                      }
+                    TIFFThreadSetExceptions(thread_set,exception);
+                    if (status == MagickFail)
+                      {
+                        if (image->exception.severity > exception->severity)
+                          CopyException(exception,&image->exception);
+                        break;
+                      }
+                    continue;
+                  }
 		for (y=0; y < image->rows; y+=tile_rows)
 		  {
 		    for (x=0; x < image->columns; x+=tile_columns)
@@ -2750,6 +3638,7 @@ ReadTIFFImage(const ImageInfo *image_info,ExceptionInfo *exception)
                   break;
               }
 
+            DestroyTIFFThreadSet(thread_set);
             MagickFreeMemory(tile);
             break;
           }
@@ -3197,6 +4086,15 @@ RegisterTIFFImage(void)
   */
   if (tsd_key == (MagickTsdKey_t) 0)
     (void) MagickTsdKeyCreate(&tsd_key);
+  if (tsd_warnings_key == (MagickTsdKey_t) 0)
+    (void) MagickTsdKeyCreate(&tsd_warnings_key);
+
+  /*
+    Install the libtiff error and warning handlers once.  They report
+    via the thread-specific exception set by TIFFSetThreadExceptionInfo().
+  */
+  (void) TIFFSetErrorHandler((TIFFErrorHandler) TIFFErrors);
+  (void) TIFFSetWarningHandler((TIFFErrorHandler) TIFFWarnings);
 
   version[0]='\0';
   {
@@ -3219,7 +4117,7 @@ RegisterTIFFImage(void)
   */
 #if defined(HasBigTIFF)
   entry=SetMagickInfo("BIGTIFF");
-  entry->thread_support=MagickFalse; /* libtiff uses libjpeg which is not thread safe */
+  entry->thread_support=MagickTrue;
   entry->decoder=(DecoderHandler) ReadTIFFImage;
   entry->encoder=(EncoderHandler) WriteTIFFImage;
   entry->seekable_stream=MagickTrue;
@@ -3249,7 +4147,7 @@ RegisterTIFFImage(void)
     Pyramid TIFF (sequence of successively smaller versions of the same image)
   */
   entry=SetMagickInfo("PTIF");
-  entry->thread_support=MagickFalse; /* libtiff uses libjpeg which is not thread safe */
+  entry->thread_support=MagickTrue;
   entry->decoder=(DecoderHandler) ReadTIFFImage;
   entry->encoder=(EncoderHandler) WritePTIFImage;
   entry->seekable_stream=MagickTrue;
@@ -3261,7 +4159,7 @@ RegisterTIFFImage(void)
     Another name for 32-bit TIFF
   */
   entry=SetMagickInfo("TIF");
-  entry->thread_support=MagickFalse; /* libtiff uses libjpeg which is not thread safe */
+  entry->thread_support=MagickTrue;
   entry->decoder=(DecoderHandler) ReadTIFFImage;
   entry->encoder=(EncoderHandler) WriteTIFFImage;
   entry->seekable_stream=MagickTrue;
@@ -3277,7 +4175,7 @@ RegisterTIFFImage(void)
     Traditional 32-bit TIFF
   */
   entry=SetMagickInfo("TIFF");
-  entry->thread_support=MagickFalse; /* libtiff uses libjpeg which is not thread safe */
+  entry->thread_support=MagickTrue;
   entry->decoder=(DecoderHandler) ReadTIFFImage;
   entry->encoder=(EncoderHandler) WriteTIFFImage;
   entry->magick=(MagickHandler) IsTIFF;
@@ -3332,13 +4230,18 @@ UnregisterTIFFImage(void)
   (void) UnregisterMagickInfo("TIFF");
 
   /*
-    Destroy thread specific data key.
+    Destroy thread specific data keys.
   */
   if (tsd_key != (MagickTsdKey_t) 0)
     {
       (void) MagickTsdKeyDelete(tsd_key);
       tsd_key = (MagickTsdKey_t) 0;
     }
+  if (tsd_warnings_key != (MagickTsdKey_t) 0)
+    {
+      (void) MagickTsdKeyDelete(tsd_warnings_key);
+      tsd_warnings_key = (MagickTsdKey_t) 0;
+    }
 #endif
 }
 
@@ -3437,11 +4340,7 @@ WriteGROUP4RAWImage(const ImageInfo *image_info,Image *image)
       return MagickFail;
     }
 
-  (void) MagickTsdSetSpecific(tsd_key,(void *) (&image->exception));
-  (void) TIFFSetErrorHandler((TIFFErrorHandler) TIFFErrors);
-  (void) TIFFSetWarningHandler((TIFFErrorHandler) (CheckThrowWarnings(image_info) ?
-                                                   TIFFWarningsThrowException :
-                                                   TIFFWarningsLogOnly));
+  TIFFSetThreadExceptionInfo(&image->exception,CheckThrowWarnings(image_info));
 
   tiff=TIFFOpen(temporary_filename,"rb");
   if (tiff == (TIFF *) NULL)
@@ -3761,6 +4660,9 @@ WriteTIFFImage(const ImageInfo *image_info,Image *image)
   Magick_TIFF_ClientData
     client_data;
 
+  Magick_TIFF_ThreadSet
+    *thread_set;
+
   ExportPixelAreaOptions
     export_options;
 
@@ -3788,11 +4690,7 @@ WriteTIFFImage(const ImageInfo *image_info,Image *image)
   status=OpenBlob(image_info,image,WriteBinaryBlobMode,&image->exception);
   if (status == MagickFail)
     ThrowWriterException(FileOpenError,UnableToOpenFile,image);
-  (void) MagickTsdSetSpecific(tsd_key,(void *) (&image->exception));
-  (void) TIFFSetErrorHandler((TIFFErrorHandler) TIFFErrors);
-  (void) TIFFSetWarningHandler((TIFFErrorHandler) (CheckThrowWarnings(image_info) ?
-                                                   TIFFWarningsThrowException :
-                                                   TIFFWarningsLogOnly));
+  TIFFSetThreadExceptionInfo(&image->exception,CheckThrowWarnings(image_info));
   (void) strlcpy(filename,image->filename,MaxTextExtent);
   /*
     Open TIFF file
@@ -5155,8 +6053,274 @@ WriteTIFFImage(const ImageInfo *image_info,Image *image)
 
         FIXME: JBIG needs a Strip writer.
       */
+      thread_set=(Magick_TIFF_ThreadSet *) NULL;
+      if ((method == ScanLineMethod) &&
+          (TIFFCodecThreads(image_info) > 1) &&
+          (planar_config == PLANARCONFIG_CONTIG) &&
+          (rows_per_strip != 0) && (rows_per_strip < image->rows) &&
+          (compress_tag != COMPRESSION_JPEG) &&
+          (compress_tag != COMPRESSION_OJPEG) &&
+#if defined(COMPRESSION_JBIG)
+          (compress_tag != COMPRESSION_JBIG) &&
+#endif
+          !((image->matte) && (alpha_type == AssociatedAlpha)))
+        {
+          /*
+            Strips are independent, so encode them in parallel if a
+            scratch encoder can be opened for each thread.  Otherwise
+            use the serial scanline writer.
+          */
+          thread_set=AllocateTIFFWriteThreadSet(tiff,
+                                                Min(TIFFCodecThreads(image_info),
+                                                    (image->rows+rows_per_strip-1)/
+                                                    rows_per_strip),
+                                                (size_t) TIFFScanlineSize(tiff)*
+                                                rows_per_strip,
+                                                rows_per_strip);
+          if (thread_set != (Magick_TIFF_ThreadSet *) NULL)
+            method=StrippedMethod;
+          else if (logging)
+            (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                  "Unable to open parallel strip encoders, "
+                                  "using scanline write method");
+        }
       switch (method)
         {
+        case StrippedMethod:
+          {
+            /*
+              Write TIFF image as strips which are encoded in parallel.
+            */
+            unsigned char
+              **encoded;
+
+            tsize_t
+              *encoded_size,
+              *encoded_extent;
+
+            unsigned long
+              strips,
+              strips_done,
+              first_strip;
+
+            int
+              quantum_samples;
+
+            unsigned int
+              slot;
+
+            QuantumType
+              quantum_type;
+
+            scanline_size=TIFFScanlineSize(tiff);
+            strips=(image->rows+rows_per_strip-1)/rows_per_strip;
+            if (QuantumTransferMode(image,photometric,compress_tag,
+                                    sample_format,samples_per_pixel,
+                                    planar_config,0,&quantum_type,
+                                    &quantum_samples,&image->exception)
+                == MagickFail)
+              {
+                DestroyTIFFThreadSet(thread_set);
+                status=MagickFail;
+                break;
+              }
+            if (logging)
+              (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                                    "Using stripped %s write method with %u "
+                                    "bits per sample, encoding %lu strips "
+                                    "using %u threads",
+                                    PhotometricTagToString(photometric),
+                                    bits_per_sample,strips,
+                                    thread_set->nthreads);
+            encoded=MagickAllocateArray(unsigned char **,thread_set->nthreads,
+                                        sizeof(unsigned char *));
+            encoded_size=MagickAllocateArray(tsize_t *,thread_set->nthreads,
+                                             sizeof(tsize_t));
+            encoded_extent=MagickAllocateArray(tsize_t *,thread_set->nthreads,
+                                               sizeof(tsize_t));
+            if ((encoded == (unsigned char **) NULL) ||
+                (encoded_size == (tsize_t *) NULL) ||
+                (encoded_extent == (tsize_t *) NULL))
+              {
+                MagickFreeMemory(encoded);
+                MagickFreeMemory(encoded_size);
+                MagickFreeMemory(encoded_extent);
+                DestroyTIFFThreadSet(thread_set);
+                ThrowWriterException(ResourceLimitError,
+                                     MemoryAllocationFailed,image);
+              }
+            for (slot=0; slot < thread_set->nthreads; slot++)
+              {
+                encoded[slot]=(unsigned char *) NULL;
+                encoded_extent[slot]=0;
+              }
+            strips_done=0;
+            for (first_strip=0; first_strip < strips;
+                 first_strip+=thread_set->nthreads)
+              {
+                long
+                  strip_slot;
+
+                unsigned int
+                  batch_strips;
+
+                batch_strips=(unsigned int) Min(thread_set->nthreads,
+                                                strips-first_strip);
+                /*
+                  Export and encode a batch of strips.
+                */
+#if defined(HAVE_OPENMP)
+#  if defined(TUNE_OPENMP)
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(runtime) shared(status,strips_done)
+#  else
+#    pragma omp parallel for num_threads(thread_set->nthreads) schedule(static,1) shared(status,strips_done)
+#  endif
+#endif
+                for (strip_slot=0; strip_slot < (long) batch_strips; strip_slot++)
+                  {
+                    const unsigned char
+                      *strip_data;
+
+                    unsigned char
+                      *strip_pixels;
+
+                    unsigned long
+                      strip_rows,
+                      strip_y,
+                      yy;
+
+                    unsigned int
+                      thread;
+
+                    tsize_t
+                      strip_data_size;
+
+                    ExportPixelAreaInfo
+                      thread_export_info;
+
+                    MagickPassFail
+                      thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_WriteTIFFImage)
+#endif
+                    thread_status=status;
+                    if (thread_status == MagickFail)
+                      continue;
+
+#if defined(HAVE_OPENMP)
+                    thread=omp_get_thread_num();
+#else
+                    thread=0;
+#endif /* defined(HAVE_OPENMP) */
+                    TIFFSetThreadExceptionInfo(&thread_set->exception[thread],
+                                               thread_set->throw_warnings);
+                    strip_pixels=thread_set->buffer[thread];
+                    strip_y=(first_strip+strip_slot)*rows_per_strip;
+                    strip_rows=Min(rows_per_strip,image->rows-strip_y);
+                    for (yy=strip_y; yy < strip_y+strip_rows; yy++)
+                      {
+                        if ((AcquireImagePixels(image,0,yy,image->columns,1,
+                                                &image->exception) ==
+                             (const PixelPacket *) NULL) ||
+                            (ExportImagePixelArea(image,quantum_type,
+                                                  bits_per_sample,strip_pixels,
+                                                  &export_options,
+                                                  &thread_export_info)
+                             == MagickFail))
+                          {
+                            thread_status=MagickFail;
+                            break;
+                          }
+#if !defined(WORDS_BIGENDIAN)
+                        if (24 == bits_per_sample)
+                          SwabDataToNativeEndian(bits_per_sample,strip_pixels,
+                                                 scanline_size);
+#endif
+                        strip_pixels += scanline_size;
+                      }
+                    strip_data=(const unsigned char *) NULL;
+                    strip_data_size=0;
+                    if (thread_status != MagickFail)
+                      strip_data=TIFFEncodeThreadStrip(thread_set,thread,
+                                                       thread_set->buffer[thread],
+                                                       (tsize_t) strip_rows*
+                                                       scanline_size,
+                                                       &strip_data_size);
+                    if (strip_data == (const unsigned char *) NULL)
+                      thread_status=MagickFail;
+                    /*
+                      Keep a copy since the thread may encode another
+                      strip of this batch.
+                    */
+                    if ((thread_status != MagickFail) &&
+                        (strip_data_size > encoded_extent[strip_slot]))
+                      {
+                        MagickReallocMemory(unsigned char *,encoded[strip_slot],
+                                            (size_t) strip_data_size);
+                        encoded_extent[strip_slot]=(encoded[strip_slot] ==
+                                                    (unsigned char *) NULL) ?
+                          0 : strip_data_size;
+                        if (encoded[strip_slot] == (unsigned char *) NULL)
+                          thread_status=MagickFail;
+                      }
+                    if (thread_status != MagickFail)
+                      {
+                        (void) memcpy(encoded[strip_slot],strip_data,
+                                      (size_t) strip_data_size);
+                        encoded_size[strip_slot]=strip_data_size;
+                      }
+
+                    /*
+                      Do not leave this (possibly pooled) thread reporting to the
+                      thread set, which is destroyed after the loop.
+                    */
+                    TIFFSetThreadExceptionInfo((ExceptionInfo *) NULL,
+                                               MagickFalse);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_WriteTIFFImage)
+#endif
+                    {
+                      if (thread_status == MagickFail)
+                        status=MagickFail;
+                      strips_done++;
+                      if (image->previous == (Image *) NULL)
+                        if (QuantumTick(strips_done,strips))
+                          if (!MagickMonitorFormatted(strips_done,strips,
+                                                      &image->exception,
+                                                      SaveImageText,
+                                                      image->filename,
+                                                      image->columns,
+                                                      image->rows))
+                            status=MagickFail;
+                    }
+                  }
+                TIFFThreadSetExceptions(thread_set,&image->exception);
+                if (status == MagickFail)
+                  break;
+                /*
+                  Write the encoded strips in order.
+                */
+                for (slot=0; slot < batch_strips; slot++)
+                  if (TIFFWriteRawStrip(tiff,(tstrip_t) (first_strip+slot),
+                                        encoded[slot],encoded_size[slot])
+                      == -1)
+                    {
+                      status=MagickFail;
+                      break;
+                    }
+                if (status == MagickFail)
+                  break;
+              }
+            for (slot=0; slot < thread_set->nthreads; slot++)
+              MagickFreeMemory(encoded[slot]);
+            MagickFreeMemory(encoded);
+            MagickFreeMemory(encoded_size);
+            MagickFreeMemory(encoded_extent);
+            DestroyTIFFThreadSet(thread_set);
+            break;
+          }
         default:
         case ScanLineMethod:
           {
@@ -90,6 +90,7 @@ extern "C" {
 #include "magick/montage.h"
 #include "magick/operator.h"
 #include "magick/paint.h"
+#include "magick/parallel.h"
 #include "magick/pixel_cache.h"
 #include "magick/pixel_iterator.h"
 #include "magick/plasma.h"
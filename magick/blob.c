@@ -56,6 +56,7 @@
 #include "magick/semaphore.h"
 #include "magick/tempfile.h"
 #include "magick/utility.h"
+#include "magick/version.h"
 #if defined(HasZLIB)
 #  include "zlib.h"
 #endif
@@ -67,6 +68,8 @@
   Define declarations.
 */
 #define DefaultBlobQuantum  65541
+#define BlobSegmentSize 1048576
+#define BlobReadBufferSize 16384
 
 
 /*
@@ -80,7 +83,8 @@ typedef enum
   PipeStream,       /* Command pipe stream opened via popen() */
   ZipStream,        /* Opened with zlib's gzopen() */
   BZipStream,       /* Opened with bzlib's BZ2_bzopen() */
-  BlobStream        /* Memory mapped, or in allocated RAM */
+  BlobStream,       /* Memory mapped, or in allocated RAM */
+  SegmentStream     /* In allocated RAM, as a list of fixed-size segments */
 } StreamType;
 
 /*
@@ -100,6 +104,9 @@ typedef union _MagickFileHandle
 
 struct _BlobInfo
 {
+  BlobReadBuffer
+    read_buffer;        /* Read-ahead buffer (must be the first member) */
+
   size_t
     block_size,         /* I/O block size */
     length,             /* The current size of the BLOB data. */
@@ -136,6 +143,21 @@ struct _BlobInfo
   MagickBool
     fsync;              /* Fsync on close if true */
 
+  unsigned char
+    **segments;         /* Segments of a SegmentStream */
+
+  size_t
+    segment_count;      /* Number of allocated segments */
+
+  MagickBool
+    segmented;          /* Write in-memory output as a SegmentStream */
+
+  unsigned char
+    *read_buffer_data;  /* Storage for FileStream read-ahead */
+
+  MagickBool
+    read_buffered;      /* FileStream input may be read ahead */
+
   SemaphoreInfo
     *semaphore;         /* Lock for reference_count access */
 
@@ -151,6 +173,114 @@ struct _BlobInfo
 */
 static int SyncBlob(Image *image);
 
+/*
+  The read-ahead buffer (see ReadBlobByteInline()) describes input which
+  has been obtained from the underlying stream but not yet consumed, so
+  the position of the underlying stream is that of the end of the
+  buffer.  For a BlobStream the buffer is simply a window on the
+  remaining blob data, while a FileStream opened on a regular file
+  reads ahead into read_buffer_data.  Operations other than reading
+  must first return unconsumed input to the underlying stream.
+*/
+#define BlobReadBufferCount(blob) \
+  ((size_t) ((blob)->read_buffer.end-(blob)->read_buffer.next))
+
+static void DrainBlobReadBuffer(BlobInfo *blob)
+{
+  size_t
+    count;
+
+  count=BlobReadBufferCount(blob);
+  if (count != 0)
+    {
+      if (blob->type == BlobStream)
+        blob->offset-=count;
+      else if (blob->type == FileStream)
+        (void) MagickFseek(blob->handle.std,-((magick_off_t) count),SEEK_CUR);
+    }
+  blob->read_buffer.next=(const unsigned char *) NULL;
+  blob->read_buffer.end=(const unsigned char *) NULL;
+}
+
+static MagickPassFail FillBlobReadBuffer(BlobInfo *blob)
+{
+  size_t
+    count;
+
+  if (blob->read_buffer_data == (unsigned char *) NULL)
+    {
+      blob->read_buffer_data=MagickAllocateMemory(unsigned char *,
+                                                  BlobReadBufferSize);
+      if (blob->read_buffer_data == (unsigned char *) NULL)
+        {
+          blob->read_buffered=MagickFalse;
+          return(MagickFail);
+        }
+    }
+  count=fread(blob->read_buffer_data,1,BlobReadBufferSize,blob->handle.std);
+  /*
+    Like getc(), only report EOF once a read has returned no data.
+  */
+  if ((count != 0) && feof(blob->handle.std) && !ferror(blob->handle.std))
+    clearerr(blob->handle.std);
+  blob->read_buffer.next=blob->read_buffer_data;
+  blob->read_buffer.end=blob->read_buffer_data+count;
+  return(count != 0 ? MagickPass : MagickFail);
+}
+
+/*
+  Read ahead from BLOBs and from regular files, where unconsumed input
+  may be returned to the file by seeking backwards.  Setting
+  MAGICK_BLOB_READ_AHEAD to FALSE disables reading ahead, which is
+  useful for comparing performance.
+*/
+static void SetBlobReadAhead(BlobInfo *blob,const BlobMode mode)
+{
+  const char
+    *env_val;
+
+  blob->read_buffered=MagickFalse;
+  if ((mode != ReadBinaryBlobMode) ||
+      ((blob->type != FileStream) && (blob->type != BlobStream)))
+    return;
+  if (((env_val=getenv("MAGICK_BLOB_READ_AHEAD")) != (const char *) NULL) &&
+      (LocaleCompare(env_val,"FALSE") == 0))
+    return;
+  if (blob->type == FileStream)
+    {
+      MagickStatStruct_t
+        attributes;
+
+      if ((MagickFstat(fileno(blob->handle.std),&attributes) < 0) ||
+          !S_ISREG(attributes.st_mode))
+        return;
+    }
+  blob->read_buffered=MagickTrue;
+}
+
+/*
+  Obtain the next length octets of input, either in place from the
+  read-ahead buffer or by reading into the supplied buffer.  Returns
+  NULL if insufficient input is available.
+*/
+static inline const unsigned char *ReadBlobOctets(Image *image,
+                                                  const size_t length,
+                                                  unsigned char *buffer)
+{
+  const unsigned char
+    *octets;
+
+  if (BlobReadBufferCount(image->blob) >= length)
+    {
+      octets=image->blob->read_buffer.next;
+      image->blob->read_buffer.next+=length;
+      return(octets);
+    }
+  if (ReadBlob(image,length,buffer) != length)
+    return((const unsigned char *) NULL);
+  return(buffer);
+}
+
 /*
   Some systems have unlocked versions of getc & putc which are faster
   when multi-threading is enabled.  Blobs do not require multi-thread
@@ -196,6 +326,9 @@ static const char *BlobStreamTypeToString(StreamType stream_type)
   case BlobStream:
     type_string="Blob";
     break;
+  case SegmentStream:
+    type_string="Segment";
+    break;
   }
   return type_string;
 }
@@ -314,6 +447,150 @@ static inline size_t WriteBlobStream(Image *image,const size_t length,
     image->blob->length=image->blob->offset;
   return length;
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e g m e n t S t r e a m                                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  The SegmentStream functions implement an in-memory Blob which is stored
+%  as a table of fixed-size segments rather than as one contiguous buffer,
+%  so that growing the Blob never copies the data written so far.
+%
+%  ExtendBlobSegments() allocates segments so that the first 'extent' bytes
+%  are backed by memory.  ReadSegmentStream() and WriteSegmentStream() copy
+%  data from or to the segments at the current offset.  Any gap left by
+%  seeking beyond the end of the Blob before writing is zero filled.
+%  DestroyBlobSegmentTable() deallocates the segments.
+%
+*/
+static void DestroyBlobSegmentTable(BlobInfo *blob_info)
+{
+  size_t
+    i;
+
+  if (blob_info->segments != (unsigned char **) NULL)
+    {
+      for (i=0; i < blob_info->segment_count; i++)
+        MagickFreeMemory(blob_info->segments[i]);
+      MagickFreeMemory(blob_info->segments);
+    }
+  blob_info->segment_count=0;
+  blob_info->extent=0;
+}
+
+static MagickPassFail ExtendBlobSegments(BlobInfo *blob_info,
+                                         const magick_off_t extent)
+{
+  size_t
+    count;
+
+  count=(size_t) ((extent+BlobSegmentSize-1)/BlobSegmentSize);
+  if (count <= blob_info->segment_count)
+    return MagickPass;
+  MagickReallocMemory(unsigned char **,blob_info->segments,
+                      MagickArraySize(count,sizeof(unsigned char *)));
+  if (blob_info->segments == (unsigned char **) NULL)
+    {
+      blob_info->segment_count=0;
+      return MagickFail;
+    }
+  for ( ; blob_info->segment_count < count; blob_info->segment_count++)
+    {
+      blob_info->segments[blob_info->segment_count]=
+        MagickAllocateMemory(unsigned char *,BlobSegmentSize);
+      if (blob_info->segments[blob_info->segment_count] ==
+          (unsigned char *) NULL)
+        return MagickFail;
+    }
+  blob_info->extent=blob_info->segment_count*(size_t) BlobSegmentSize;
+  return MagickPass;
+}
+
+static size_t ReadSegmentStream(Image *image,const size_t length,void *data)
+{
+  BlobInfo
+    *blob_info=image->blob;
+
+  size_t
+    available,
+    count;
+
+  if (blob_info->offset >= (magick_off_t) blob_info->length)
+    {
+      blob_info->eof=MagickTrue;
+      return 0;
+    }
+  available=Min(length,blob_info->length-blob_info->offset);
+  for (count=0; count < available; )
+    {
+      size_t
+        index,
+        position,
+        segment_count;
+
+      index=(size_t) (blob_info->offset/BlobSegmentSize);
+      position=(size_t) (blob_info->offset%BlobSegmentSize);
+      segment_count=Min(available-count,BlobSegmentSize-position);
+      (void) memcpy((unsigned char *) data+count,
+                    blob_info->segments[index]+position,segment_count);
+      blob_info->offset+=segment_count;
+      count+=segment_count;
+    }
+  if (available < length)
+    blob_info->eof=MagickTrue;
+  return available;
+}
+
+static size_t WriteSegmentStream(Image *image,const size_t length,
+                                 const void *data)
+{
+  BlobInfo
+    *blob_info=image->blob;
+
+  size_t
+    count;
+
+  if (!ExtendBlobSegments(blob_info,blob_info->offset+length))
+    return 0;
+  while (blob_info->length < (size_t) blob_info->offset)
+    {
+      size_t
+        position,
+        segment_count;
+
+      position=blob_info->length%BlobSegmentSize;
+      segment_count=Min((size_t) blob_info->offset-blob_info->length,
+                        BlobSegmentSize-position);
+      (void) memset(blob_info->segments[blob_info->length/BlobSegmentSize]+
+                    position,0,segment_count);
+      blob_info->length+=segment_count;
+    }
+  for (count=0; count < length; )
+    {
+      size_t
+        index,
+        position,
+        segment_count;
+
+      index=(size_t) (blob_info->offset/BlobSegmentSize);
+      position=(size_t) (blob_info->offset%BlobSegmentSize);
+      segment_count=Min(length-count,BlobSegmentSize-position);
+      (void) memcpy(blob_info->segments[index]+position,
+                    (const unsigned char *) data+count,segment_count);
+      blob_info->offset+=segment_count;
+      count+=segment_count;
+    }
+  if (blob_info->offset > (magick_off_t) blob_info->length)
+    blob_info->length=blob_info->offset;
+  return length;
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -352,6 +629,8 @@ MagickExport void AttachBlob(BlobInfo *blob_info,const void *blob,
   blob_info->quantum=DefaultBlobQuantum;
   blob_info->offset=0;
   blob_info->type=BlobStream;
+  blob_info->read_buffer.next=(const unsigned char *) NULL;
+  blob_info->read_buffer.end=(const unsigned char *) NULL;
   blob_info->handle.std=(FILE *) NULL;
 #if defined(HasBZLIB)
   blob_info->handle.bz=(BZFILE *) NULL;
@@ -392,7 +671,8 @@ MagickExport MagickBool BlobIsSeekable(const Image *image)
   assert(image->blob != (const BlobInfo *) NULL);
 
   return ((image->blob->type == FileStream) ||
-          (image->blob->type == BlobStream));
+          (image->blob->type == BlobStream) ||
+          (image->blob->type == SegmentStream));
 }
 
 /*
@@ -431,6 +711,7 @@ MagickExport MagickPassFail BlobReserveSize(Image *image, magick_off_t size)
 
   status=MagickPass;
 
+  DrainBlobReadBuffer(image->blob);
   if ((FileStream == image->blob->type) ||
       ((BlobStream == image->blob->type) &&
        (image->blob->mapped) && (image->blob->handle.std != (FILE *) NULL)))
@@ -451,7 +732,8 @@ MagickExport MagickPassFail BlobReserveSize(Image *image, magick_off_t size)
 #endif /* HAVE_POSIX_FALLOCATE */
     }
 
-  if (BlobStream == image->blob->type)
+  if ((BlobStream == image->blob->type) && !image->blob->mapped &&
+      ((size_t) size > image->blob->extent))
   {
     /*
       In-memory blob
@@ -469,6 +751,19 @@ MagickExport MagickPassFail BlobReserveSize(Image *image, magick_off_t size)
         status=MagickFail;
       }
   }
+
+  if (SegmentStream == image->blob->type)
+    {
+      /*
+        Segmented in-memory blob
+      */
+      if (!ExtendBlobSegments(image->blob,size))
+        {
+          ThrowException(&image->exception,ResourceLimitError,
+                         MemoryAllocationFailed,NULL);
+          status=MagickFail;
+        }
+    }
   if (image->logging)
     (void) LogMagickEvent(BlobEvent,GetMagickModule(),
                           "Request to reserve %" MAGICK_OFF_F "u output bytes %s",
@@ -601,6 +896,32 @@ MagickExport MagickPassFail BlobToFile(const char *filename,const void *blob,
     }
   return status;
 }
+
+/*
+  A memory file is private to this process, so it can not be passed to
+  a coder which invokes a delegate program to read or write the format.
+  Such coders are recognized by a delegate which decodes or encodes the
+  format, or the name of the coder module (e.g. "MPEG" for "M2V").
+*/
+static MagickBool IsDelegateCoder(const MagickInfo *magick_info,
+                                  const char *magick)
+{
+  ExceptionInfo
+    exception;
+
+  MagickBool
+    delegate_coder;
+
+  GetExceptionInfo(&exception);
+  delegate_coder=
+    ((GetDelegateInfo(magick,(char *) NULL,&exception) != 0) ||
+     (GetDelegateInfo((char *) NULL,magick,&exception) != 0) ||
+     ((magick_info->module != (const char *) NULL) &&
+      ((GetDelegateInfo(magick_info->module,(char *) NULL,&exception) != 0) ||
+       (GetDelegateInfo((char *) NULL,magick_info->module,&exception) != 0))));
+  DestroyExceptionInfo(&exception);
+  return delegate_coder;
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -696,21 +1017,39 @@ MagickExport Image *BlobToImage(const ImageInfo *image_info,const void *blob,
       return(image);
     }
   /*
-    Write blob to a temporary file on disk.
+    Write blob to a memory file, or to a temporary file on disk if
+    memory files are not supported or a delegate program reads the
+    format.
   */
   {
     char
       temporary_file[MaxTextExtent];
 
-      (void) LogMagickEvent(BlobEvent,GetMagickModule(),
-			    "Using temporary file");
+    int
+      memory_file;
+
     clone_info->blob=(void *) NULL;
     clone_info->length=0;
-    
-    if(!AcquireTemporaryFileName(temporary_file))
+
+    memory_file=-1;
+    if (!IsDelegateCoder(magick_info,clone_info->magick))
+      memory_file=AcquireTemporaryMemoryFile(temporary_file);
+    if (memory_file != -1)
+      {
+        (void) LogMagickEvent(BlobEvent,GetMagickModule(),
+                              "Using memory file");
+      }
+    else
       {
-	ThrowException(exception,FileOpenError,UnableToCreateTemporaryFile,
-		       clone_info->filename);
+        (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+                              "No BLOB support for \"%s\" format: "
+                              "falling back to temporary file",
+                              clone_info->magick);
+      }
+    if ((memory_file == -1) && !AcquireTemporaryFileName(temporary_file))
+      {
+        ThrowException(exception,FileOpenError,UnableToCreateTemporaryFile,
+                       clone_info->filename);
       }
     else
       {
@@ -742,7 +1081,10 @@ MagickExport Image *BlobToImage(const ImageInfo *image_info,const void *blob,
 		  }
 	      }
 	  }
-	(void) LiberateTemporaryFile(temporary_file);
+	if (memory_file != -1)
+	  (void) LiberateTemporaryMemoryFile(memory_file,temporary_file);
+	else
+	  (void) LiberateTemporaryFile(temporary_file);
       }
   }
   DestroyImageInfo(clone_info);
@@ -789,6 +1131,7 @@ MagickExport BlobInfo *CloneBlobInfo(const BlobInfo *blob_info)
   GetBlobInfo(clone_info);
   if (blob_info == (BlobInfo *) NULL)
     return(clone_info);
+  DrainBlobReadBuffer((BlobInfo *) blob_info);
   clone_info->length=blob_info->length;
   clone_info->extent=blob_info->extent;
   clone_info->quantum=blob_info->quantum;
@@ -802,6 +1145,7 @@ MagickExport BlobInfo *CloneBlobInfo(const BlobInfo *blob_info)
   clone_info->type=blob_info->type;
   clone_info->handle=blob_info->handle;
   clone_info->data=blob_info->data;
+  clone_info->segmented=blob_info->segmented;
   LockSemaphoreInfo(clone_info->semaphore);
   clone_info->reference_count=1;
   UnlockSemaphoreInfo(clone_info->semaphore);
@@ -858,6 +1202,9 @@ MagickExport void CloseBlob(Image *image)
                           BlobStreamTypeToString(image->blob->type),
                           &image->blob);
 
+  DrainBlobReadBuffer(image->blob);
+  MagickFreeMemory(image->blob->read_buffer_data);
+  image->blob->read_buffered=MagickFalse;
   status=0;
   switch (image->blob->type)
     {
@@ -890,6 +1237,7 @@ MagickExport void CloseBlob(Image *image)
         break;
       }
     case BlobStream:
+    case SegmentStream:
       break;
     }
   errno=0;
@@ -940,6 +1288,7 @@ MagickExport void CloseBlob(Image *image)
             break;
           }
         case BlobStream:
+        case SegmentStream:
           {
             break;
           }
@@ -1006,6 +1355,8 @@ MagickExport void DestroyBlob(Image *image)
             CloseBlob(image);
           if (image->blob->mapped)
             (void) UnmapBlob(image->blob->data,image->blob->length);
+          DestroyBlobSegmentTable(image->blob);
+          MagickFreeMemory(image->blob->read_buffer_data);
 	  DestroySemaphoreInfo(&image->blob->semaphore);
           (void) memset((void *) image->blob,0xbf,sizeof(BlobInfo));
           MagickFreeMemory(image->blob);
@@ -1059,6 +1410,8 @@ MagickExport void DestroyBlobInfo(BlobInfo *blob)
         {
           if (blob->mapped)
             (void) UnmapBlob(blob->data,blob->length);
+          DestroyBlobSegmentTable(blob);
+          MagickFreeMemory(blob->read_buffer_data);
 	  DestroySemaphoreInfo(&blob->semaphore);
           (void) memset((void *)blob,0xbf,sizeof(BlobInfo));
           MagickFreeMemory(blob);
@@ -1066,6 +1419,45 @@ MagickExport void DestroyBlobInfo(BlobInfo *blob)
     }
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   D e s t r o y B l o b S e g m e n t s                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  DestroyBlobSegments() deallocates the segments returned by
+%  ImageToBlobSegments().
+%
+%  The format of the DestroyBlobSegments method is:
+%
+%      void DestroyBlobSegments(BlobSegment *segments,const size_t count)
+%
+%  A description of each parameter follows:
+%
+%    o segments: The segments to deallocate.
+%
+%    o count: The number of segments.
+%
+%
+*/
+MagickExport void DestroyBlobSegments(BlobSegment *segments,
+                                      const size_t count)
+{
+  size_t
+    i;
+
+  if (segments == (BlobSegment *) NULL)
+    return;
+  for (i=0; i < count; i++)
+    MagickFreeMemory(segments[i].data);
+  MagickFreeMemory(segments);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1098,10 +1490,14 @@ MagickExport void DetachBlob(BlobInfo *blob_info)
       LiberateMagickResource(MapResource,blob_info->length);
     }
   blob_info->mapped=MagickFalse;
+  DestroyBlobSegmentTable(blob_info);
   blob_info->length=0;
   blob_info->offset=0;
   blob_info->eof=MagickFalse;
   blob_info->exempt=MagickFalse;
+  blob_info->read_buffer.next=(const unsigned char *) NULL;
+  blob_info->read_buffer.end=(const unsigned char *) NULL;
+  blob_info->read_buffered=MagickFalse;
   blob_info->type=UndefinedStream;
   blob_info->handle.std=(FILE *) NULL;
 #if defined(HasBZLIB)
@@ -1146,6 +1542,8 @@ MagickExport int EOFBlob(const Image *image)
   assert(image->signature == MagickSignature);
   assert(image->blob != (BlobInfo *) NULL);
   assert(image->blob->type != UndefinedStream);
+  if (BlobReadBufferCount(image->blob) != 0)
+    return(MagickFalse);
   switch (image->blob->type)
   {
     case UndefinedStream:
@@ -1174,6 +1572,7 @@ MagickExport int EOFBlob(const Image *image)
       break;
     }
     case BlobStream:
+    case SegmentStream:
       break;
   }
   return(image->blob->eof);
@@ -1353,6 +1752,7 @@ MagickExport FILE *GetBlobFileHandle(const Image *image)
 {
   assert(image != (const Image *) NULL);
   assert(image->blob != (const BlobInfo *) NULL);
+  DrainBlobReadBuffer(image->blob);
   return (image->blob->handle.std);
 }
 
@@ -1488,6 +1888,7 @@ MagickExport magick_off_t GetBlobSize(const Image *image)
 	break;
       }
     case BlobStream:
+    case SegmentStream:
       {
 	offset=image->blob->length;
 	break;
@@ -1557,6 +1958,7 @@ MagickExport unsigned char *GetBlobStreamData(const Image *image)
   assert(image->signature == MagickSignature);
   if (image->blob->type != BlobStream)
     return 0;
+  DrainBlobReadBuffer(image->blob);
   return(image->blob->data);
 }
 
@@ -1920,6 +2322,7 @@ MagickExport void *GetConfigureBlob(const char *filename,char *path,
 
   return 0;
 }
+
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -1975,6 +2378,9 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,Image *image,
   unsigned int
     status;
 
+  int
+    memory_file;
+
   assert(image_info != (const ImageInfo *) NULL);
   assert(image_info->signature == MagickSignature);
   assert(image != (Image *) NULL);
@@ -2049,25 +2455,41 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,Image *image,
       return(blob);
     }
   /*
-    Write file to disk in blob image format.
+    Write file to a memory file, or to disk if memory files are not
+    supported or a delegate program writes the format, in blob image
+    format.
   */
   (void) strlcpy(filename,image->filename,MaxTextExtent);
-  if (!AcquireTemporaryFileName(unique))
+  memory_file=-1;
+  if (!IsDelegateCoder(magick_info,clone_info->magick))
+    memory_file=AcquireTemporaryMemoryFile(unique);
+  if (memory_file == -1)
     {
-      ThrowException(exception,FileOpenError,UnableToCreateTemporaryFile,
-		     unique);
-      DestroyImageInfo(clone_info);
-      return((void *) NULL);
+      (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+                            "No BLOB support for \"%s\" format: "
+                            "falling back to temporary file",
+                            clone_info->magick);
+      if (!AcquireTemporaryFileName(unique))
+        {
+          ThrowException(exception,FileOpenError,UnableToCreateTemporaryFile,
+                         unique);
+          DestroyImageInfo(clone_info);
+          return((void *) NULL);
+        }
     }
   if (image->logging)
     (void) LogMagickEvent(BlobEvent,GetMagickModule(),
-			  "Allocated temporary file \"%s\"",unique);
+			  "Allocated %s file \"%s\"",
+                          (memory_file != -1 ? "memory" : "temporary"),unique);
   FormatString(image->filename,"%.1024s:%.1024s",image->magick,unique);
   status=WriteImage(clone_info,image);
   DestroyImageInfo(clone_info);
   if (status == MagickFail)
     {
-      (void) LiberateTemporaryFile(unique);
+      if (memory_file != -1)
+        (void) LiberateTemporaryMemoryFile(memory_file,unique);
+      else
+        (void) LiberateTemporaryFile(unique);
       ThrowException(exception,BlobError,UnableToWriteBlob,image->filename);
       if (image->logging)
         (void) LogMagickEvent(BlobEvent,GetMagickModule(),
@@ -2077,11 +2499,15 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,Image *image,
   /*
     Read image from disk as blob.
   */
-  blob=(unsigned char *) FileToBlob(image->filename,length,exception);
+  blob=(unsigned char *) FileToBlob(unique,length,exception);
   if (image->logging)
     (void) LogMagickEvent(BlobEvent,GetMagickModule(),
-			  "Liberating temporary file \"%s\"",image->filename);
-  (void) LiberateTemporaryFile(image->filename);
+			  "Liberating %s file \"%s\"",
+                          (memory_file != -1 ? "memory" : "temporary"),unique);
+  if (memory_file != -1)
+    (void) LiberateTemporaryMemoryFile(memory_file,unique);
+  else
+    (void) LiberateTemporaryFile(unique);
   (void) strlcpy(image->filename,filename,MaxTextExtent);
   if (blob == (unsigned char *) NULL)
     {
@@ -2097,6 +2523,175 @@ MagickExport void *ImageToBlob(const ImageInfo *image_info,Image *image,
   return(blob);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   I m a g e T o B l o b S e g m e n t s                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ImageToBlobSegments() implements direct to memory image formats like
+%  ImageToBlob(), but returns the formatted image as a list of segments
+%  rather than as one contiguous buffer.  The output is accumulated in
+%  fixed-size segments so that it is never copied as it grows, and the
+%  segments may be passed directly to writev() (or sent one at a time)
+%  without first assembling them.  Formats which do not support BLOB I/O
+%  are returned as a single segment.  The segments must be deallocated
+%  with DestroyBlobSegments().
+%
+%  The format of the ImageToBlobSegments method is:
+%
+%      BlobSegment *ImageToBlobSegments(const ImageInfo *image_info,
+%        Image *image,size_t *count,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image_info: The image info.
+%
+%    o image: The image.
+%
+%    o count: The number of segments returned.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+%
+*/
+MagickExport BlobSegment *ImageToBlobSegments(const ImageInfo *image_info,
+                                              Image *image,size_t *count,
+                                              ExceptionInfo *exception)
+{
+  const MagickInfo
+    *magick_info;
+
+  BlobInfo
+    *blob_info;
+
+  BlobSegment
+    *segments;
+
+  ImageInfo
+    *clone_info;
+
+  size_t
+    i,
+    length;
+
+  unsigned int
+    status;
+
+  assert(image_info != (const ImageInfo *) NULL);
+  assert(image_info->signature == MagickSignature);
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(count != (size_t *) NULL);
+  assert(exception != (ExceptionInfo *) NULL);
+
+  *count=0;
+  magick_info=GetMagickInfo(image->magick,exception);
+  if ((magick_info == (const MagickInfo *) NULL) ||
+      !magick_info->blob_support)
+    {
+      void
+        *blob;
+
+      /*
+        Return the output of ImageToBlob() as one segment.
+      */
+      blob=ImageToBlob(image_info,image,&length,exception);
+      if (blob == (void *) NULL)
+        return((BlobSegment *) NULL);
+      segments=MagickAllocateMemory(BlobSegment *,sizeof(BlobSegment));
+      if (segments == (BlobSegment *) NULL)
+        {
+          MagickFreeMemory(blob);
+          ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                         MagickMsg(BlobError,UnableToCreateBlob));
+          return((BlobSegment *) NULL);
+        }
+      segments[0].data=blob;
+      segments[0].length=length;
+      *count=1;
+      return(segments);
+    }
+
+  if (image->logging)
+    (void) LogMagickEvent(BlobEvent,GetMagickModule(),
+                          "Entering ImageToBlobSegments");
+  clone_info=CloneImageInfo(image_info);
+  (void) strlcpy(clone_info->magick,image->magick,MaxTextExtent);
+  /* Writes are directed to a SegmentStream by OpenBlob() */
+  clone_info->blob=(void *) NULL;
+  clone_info->length=0;
+  image->blob->segmented=MagickTrue;
+  /* Blob segments should not be released by CloseBlob() */
+  image->blob->exempt=MagickTrue;
+  /* There is no filename for a memory blob */
+  *image->filename='\0';
+  status=WriteImage(clone_info,image);
+  DestroyImageInfo(clone_info);
+
+  blob_info=image->blob;
+  blob_info->segmented=MagickFalse;
+  segments=(BlobSegment *) NULL;
+  if (status != MagickFail)
+    {
+      length=blob_info->length;
+      *count=(length+BlobSegmentSize-1)/BlobSegmentSize;
+      segments=MagickAllocateArray(BlobSegment *,Max(*count,1),
+                                   sizeof(BlobSegment));
+      if (segments == (BlobSegment *) NULL)
+        {
+          ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                         MagickMsg(BlobError,UnableToCreateBlob));
+          *count=0;
+        }
+      else
+        {
+          /*
+            Transfer ownership of the used segments to the caller.
+          */
+          for (i=0; i < *count; i++)
+            {
+              segments[i].data=blob_info->segments[i];
+              segments[i].length=Min(length-i*BlobSegmentSize,
+                                     BlobSegmentSize);
+              blob_info->segments[i]=(unsigned char *) NULL;
+            }
+          /* Release unused memory in the final segment */
+          if ((*count > 0) && (segments[*count-1].length < BlobSegmentSize))
+            {
+              MagickReallocMemory(void *,segments[*count-1].data,
+                                  segments[*count-1].length);
+              if (segments[*count-1].data == (void *) NULL)
+                {
+                  ThrowException(exception,ResourceLimitError,
+                                 MemoryAllocationFailed,
+                                 MagickMsg(BlobError,UnableToCreateBlob));
+                  DestroyBlobSegments(segments,*count);
+                  segments=(BlobSegment *) NULL;
+                  *count=0;
+                }
+            }
+        }
+    }
+  else
+    {
+      /* Only assert our own exception if an exception was not already reported. */
+      if (image->exception.severity == UndefinedException)
+        ThrowException(exception,BlobError,UnableToWriteBlob,image->magick);
+    }
+  /* Reset BlobInfo to original state, releasing any remaining segments */
+  DetachBlob(blob_info);
+  if (image->logging)
+    (void) LogMagickEvent(BlobEvent,GetMagickModule(),
+                          "Exiting ImageToBlobSegments");
+  return(segments);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -2476,11 +3071,30 @@ MagickExport MagickPassFail OpenBlob(const ImageInfo *image_info,Image *image,
   if (image_info->blob != (void *) NULL)
     {
       AttachBlob(image->blob,image_info->blob,image_info->length);
+      SetBlobReadAhead(image->blob,mode);
       if (image->logging)
         (void) LogMagickEvent(BlobEvent,GetMagickModule(),
                               "  attached image_info->blob to blob %p",&image->blob);
       return(MagickPass);
     }
+  /*
+    Write to a segmented in-memory blob (see ImageToBlobSegments()).
+  */
+  if ((image->blob->segmented) &&
+      ((mode == WriteBlobMode) || (mode == WriteBinaryBlobMode)))
+    {
+      DestroyBlobSegmentTable(image->blob);
+      image->blob->length=0;
+      image->blob->offset=0;
+      image->blob->eof=MagickFalse;
+      image->blob->data=(unsigned char *) NULL;
+      image->blob->mode=mode;
+      image->blob->type=SegmentStream;
+      if (image->logging)
+        (void) LogMagickEvent(BlobEvent,GetMagickModule(),
+                              "  using SegmentStream blob %p",&image->blob);
+      return(MagickPass);
+    }
   /*
     Reset BlobInfo to defaults.
   */
@@ -2751,14 +3365,18 @@ MagickExport MagickPassFail OpenBlob(const ImageInfo *image_info,Image *image,
             if (*type == 'r')
               {
                 /*
-                  Support reading from a file using memory mapping.
-                  
+                  Support reading from a file using memory mapping so
+                  that coders may access the file data in place (see
+                  ReadBlobZC()).
+
                   This code was used for years and definitely speeds
                   re-reading of the same file, but it has been
                   discovered that some operating systems (e.g. FreeBSD
                   and Apple's OS-X) fail to perform automatic
-                  read-ahead for network files.  It will be disabled
-                  by default until we add a way to force read-ahead.
+                  read-ahead for network files.  A mapped file which
+                  is truncated by another process while it is being
+                  read also results in SIGBUS rather than a read
+                  error.  It is therefore disabled by default.
                 */
                 if (((env_val = getenv("MAGICK_MMAP_READ")) != NULL) &&
                     (LocaleCompare(env_val,"TRUE") == 0))
@@ -2774,6 +3392,7 @@ MagickExport MagickPassFail OpenBlob(const ImageInfo *image_info,Image *image,
                         magick_info->blob_support)
                       {
                         if ((MagickFstat(fileno(image->blob->handle.std),&attributes) >= 0) &&
+                            S_ISREG(attributes.st_mode) &&
                             (attributes.st_size > MinBlobExtent) &&
                             (attributes.st_size == (off_t) ((size_t) attributes.st_size)))
                           {
@@ -2814,6 +3433,7 @@ MagickExport MagickPassFail OpenBlob(const ImageInfo *image_info,Image *image,
               }
           }
       }
+  SetBlobReadAhead(image->blob,mode);
   image->blob->status=MagickFalse;
   if (image->blob->type != UndefinedStream)
     image->blob->size=GetBlobSize(image);
@@ -2929,7 +3549,20 @@ MagickExport size_t ReadBlob(Image *image,const size_t length,void *data)
   assert(image->blob->type != UndefinedStream);
   assert(data != (void *) NULL);
 
-  count=0;
+  count=BlobReadBufferCount(image->blob);
+  if (count != 0)
+    {
+      /*
+        Consume read-ahead input first.
+      */
+      if (count > length)
+        count=length;
+      (void) memcpy(data,image->blob->read_buffer.next,count);
+      image->blob->read_buffer.next+=count;
+      if (count < length)
+        count+=ReadBlob(image,length-count,(unsigned char *) data+count);
+      return(count);
+    }
   switch (image->blob->type)
   {
     case UndefinedStream:
@@ -3046,6 +3679,11 @@ MagickExport size_t ReadBlob(Image *image,const size_t length,void *data)
         (void) memcpy(data,source,count);
       break;
     }
+    case SegmentStream:
+    {
+      count=ReadSegmentStream(image,length,data);
+      break;
+    }
   }
   return(count);
 }
@@ -3063,27 +3701,35 @@ MagickExport size_t ReadBlob(Image *image,const size_t length,void *data)
 %
 %  ReadBlobZC() reads data from the blob or image file and returns it.  It
 %  returns the number of bytes read.  Provision is made for a "zero-copy"
-%  transfer if the blob data is already in memory.
+%  transfer if the blob data is already in memory (including memory mapped
+%  input files).
 %
-%  This method is currently EXPERIMENTAL!
+%  The caller should supply a buffer large enough to hold the requested
+%  data.  If fewer bytes than requested are available from an in-memory
+%  blob, then the available bytes are copied to the supplied buffer and
+%  the pointer is not updated, so that the returned pointer always
+%  addresses at least 'length' bytes.  Since the pointer may be updated,
+%  it must be reset to the buffer before each call.  A NULL pointer is
+%  only accepted when reading from an in-memory blob, in which case the
+%  pointer is always updated and the caller must check the count.
 %
-%  The format of the ReadBlob method is:
+%  The format of the ReadBlobZC method is:
 %
-%      size_t ReadBlob(Image *image,const size_t length,void *data)
+%      size_t ReadBlobZC(Image *image,const size_t length,void **data)
 %
 %  A description of each parameter follows:
 %
-%    o count:  Method ReadBlob returns the number of bytes read.
+%    o count:  Method ReadBlobZC returns the number of bytes read.
 %
 %    o image: The image.
 %
 %    o length:  Specifies an integer representing the number of bytes
 %      to read from the file.
 %
-%    o data:  Specifies an area to place the information requested from
-%      the file.  If the data may be accessed without a copy, then
-%      the provided pointer is updated to point to the location of
-%      the data in memory, and no copy is performed.
+%    o data:  Specifies the address of a pointer to an area to place the
+%      information requested from the file.  If the data may be accessed
+%      without a copy, then the provided pointer is updated to point to
+%      the location of the data in memory, and no copy is performed.
 %
 %
 */
@@ -3096,11 +3742,81 @@ MagickExport  size_t ReadBlobZC(Image *image,const size_t length,void **data)
   assert(data != (void *) NULL);
 
   if (image->blob->type == BlobStream)
-    return (ReadBlobStream(image,length,data));
+    {
+      void
+        *blob_data;
+
+      size_t
+        count;
+
+      DrainBlobReadBuffer(image->blob);
+      if (*data == (void *) NULL)
+        return (ReadBlobStream(image,length,data));
+      blob_data=*data;
+      count=ReadBlobStream(image,length,&blob_data);
+      if (count == length)
+        *data=blob_data;
+      else if (count != 0)
+        (void) memcpy(*data,blob_data,count);
+      return count;
+    }
 
   assert(*data != (void *) NULL);
   return ReadBlob(image,length,*data);
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++  R e a d B l o b Z C B u f f e r                                            %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ReadBlobZCBuffer() is a convenience form of ReadBlobZC() for reading
+%  consecutive records (such as scanlines) into a reused buffer.  The
+%  returned pointer addresses the data in the in-memory (or memory mapped)
+%  blob if possible, and otherwise the supplied buffer.
+%
+%  The format of the ReadBlobZCBuffer method is:
+%
+%      size_t ReadBlobZCBuffer(Image *image,const size_t length,
+%                              unsigned char *buffer,unsigned char **data)
+%
+%  A description of each parameter follows:
+%
+%    o count:  Method ReadBlobZCBuffer returns the number of bytes read.
+%
+%    o image: The image.
+%
+%    o length:  Specifies an integer representing the number of bytes
+%      to read from the file.
+%
+%    o buffer:  A buffer of at least length bytes.
+%
+%    o data:  Set to the location of the data which was read.
+%
+%
+*/
+MagickExport size_t ReadBlobZCBuffer(Image *image,const size_t length,
+                                     unsigned char *buffer,
+                                     unsigned char **data)
+{
+  void
+    *blob_data;
+
+  size_t
+    count;
+
+  assert(data != (unsigned char **) NULL);
+  blob_data=buffer;
+  count=ReadBlobZC(image,length,&blob_data);
+  *data=(unsigned char *) blob_data;
+  return count;
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -3131,29 +3847,51 @@ MagickExport  size_t ReadBlobZC(Image *image,const size_t length,void **data)
 */
 MagickExport int ReadBlobByte(Image *image)
 {
+  BlobInfo
+    *blob;
+
   unsigned char
     c;
   
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
-  
-  switch (image->blob->type)
+
+  blob=image->blob;
+  if (blob->read_buffer.next != blob->read_buffer.end)
+    return(*blob->read_buffer.next++);
+  switch (blob->type)
     {
     case FileStream:
+      {
+        if (blob->read_buffered)
+          {
+            if (FillBlobReadBuffer(blob))
+              return(*blob->read_buffer.next++);
+            if (blob->read_buffered)
+              break;
+          }
+        return getc(blob->handle.std);
+      }
     case StandardStream:
     case PipeStream:
       {
-        return getc(image->blob->handle.std);
+        return getc(blob->handle.std);
       }
     case BlobStream:
       {
-        if (image->blob->offset < (magick_off_t) image->blob->length)
+        if (blob->offset < (magick_off_t) blob->length)
           {
-            c=*((unsigned char *)image->blob->data+image->blob->offset);
-            image->blob->offset++;
-            return (c);
+            if (!blob->read_buffered)
+              return(blob->data[blob->offset++]);
+            /*
+              Buffer the remainder of the blob.
+            */
+            blob->read_buffer.next=blob->data+blob->offset;
+            blob->read_buffer.end=blob->data+blob->length;
+            blob->offset=(magick_off_t) blob->length;
+            return(*blob->read_buffer.next++);
           }
-        image->blob->eof=True;
+        blob->eof=True;
         break;
       }
     default:
@@ -3301,19 +4039,22 @@ MagickExport magick_uint32_t ReadBlobLSBLong(Image *image)
   unsigned char
     buffer[4];
 
+  const unsigned char
+    *octets;
+
   magick_uint32_t
     value;
 
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
 
-  if (ReadBlob(image,4,buffer) != 4)
+  if ((octets=ReadBlobOctets(image,4,buffer)) == (const unsigned char *) NULL)
     return(0U);
 
-  value=buffer[3] << 24;
-  value|=buffer[2] << 16;
-  value|=buffer[1] << 8;
-  value|=buffer[0];
+  value=octets[3] << 24;
+  value|=octets[2] << 16;
+  value|=octets[1] << 8;
+  value|=octets[0];
   return(value & 0xffffffff);
 }
 
@@ -3403,17 +4144,20 @@ MagickExport magick_uint16_t ReadBlobLSBShort(Image *image)
   unsigned char
     buffer[2];
 
+  const unsigned char
+    *octets;
+
   magick_uint16_t
     value;
 
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
 
-  if (ReadBlob(image,2,buffer) != 2)
+  if ((octets=ReadBlobOctets(image,2,buffer)) == (const unsigned char *) NULL)
     return(0U);
 
-  value=buffer[1] << 8;
-  value|=buffer[0];
+  value=octets[1] << 8;
+  value|=octets[0];
   return(value & 0xffff);
 }
 
@@ -3755,19 +4499,22 @@ MagickExport magick_uint32_t ReadBlobMSBLong(Image *image)
   unsigned char
     buffer[4];
 
+  const unsigned char
+    *octets;
+
   magick_uint32_t
     value;
 
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
 
-  if (ReadBlob(image,4,buffer) != 4)
+  if ((octets=ReadBlobOctets(image,4,buffer)) == (const unsigned char *) NULL)
     return(0U);
 
-  value=buffer[0] << 24;
-  value|=buffer[1] << 16;
-  value|=buffer[2] << 8;
-  value|=buffer[3];
+  value=octets[0] << 24;
+  value|=octets[1] << 16;
+  value|=octets[2] << 8;
+  value|=octets[3];
   return(value & 0xffffffff);
 }
 
@@ -3805,17 +4552,20 @@ MagickExport magick_uint16_t ReadBlobMSBShort(Image *image)
   unsigned char
     buffer[2];
 
+  const unsigned char
+    *octets;
+
   magick_uint16_t
     value;
 
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
 
-  if (ReadBlob(image,2,buffer) != 2)
+  if ((octets=ReadBlobOctets(image,2,buffer)) == (const unsigned char *) NULL)
     return(0U);
 
-  value=buffer[0] << 8;
-  value|=buffer[1];
+  value=octets[0] << 8;
+  value|=octets[1];
   return(value & 0xffff);
 }
 
@@ -3912,7 +4662,7 @@ MagickExport char *ReadBlobString(Image *image,char *string)
   assert(image->signature == MagickSignature);
   for (i=0; i < (MaxTextExtent-1); i++)
   {
-    c=ReadBlobByte(image);
+    c=ReadBlobByteInline(image);
     if (c == EOF)
       {
         if (i == 0)
@@ -4005,6 +4755,7 @@ MagickExport magick_off_t SeekBlob(Image *image,const magick_off_t offset,
   assert(image->signature == MagickSignature);
   assert(image->blob != (BlobInfo *) NULL);
   assert(image->blob->type != UndefinedStream);
+  DrainBlobReadBuffer(image->blob);
   switch (image->blob->type)
   {
     case UndefinedStream:
@@ -4076,6 +4827,41 @@ MagickExport magick_off_t SeekBlob(Image *image,const magick_off_t offset,
           }
       break;
     }
+    case SegmentStream:
+    {
+      /*
+        Segments are allocated (and any gap is zero filled) when
+        data is next written.
+      */
+      switch (whence)
+      {
+        case SEEK_SET:
+        default:
+        {
+          if (offset < 0)
+            return(-1);
+          image->blob->offset=offset;
+          break;
+        }
+        case SEEK_CUR:
+        {
+          if ((image->blob->offset+offset) < 0)
+            return(-1);
+          image->blob->offset+=offset;
+          break;
+        }
+        case SEEK_END:
+        {
+          if ((magick_off_t) (image->blob->length+offset) < 0)
+            return(-1);
+          image->blob->offset=image->blob->length+offset;
+          break;
+        }
+      }
+      if (image->blob->offset <= (magick_off_t) image->blob->length)
+        image->blob->eof=MagickFalse;
+      break;
+    }
   }
   return(image->blob->offset);
 }
@@ -4200,6 +4986,7 @@ static int SyncBlob(Image *image)
   }
 #endif
 
+  DrainBlobReadBuffer(image->blob);
   status=0;
   switch (image->blob->type)
   {
@@ -4227,6 +5014,7 @@ static int SyncBlob(Image *image)
       break;
     }
     case BlobStream:
+    case SegmentStream:
       break;
   }
   return(status);
@@ -4290,11 +5078,14 @@ MagickExport magick_off_t TellBlob(const Image *image)
     case BZipStream:
       break;
     case BlobStream:
+    case SegmentStream:
     {
       offset=image->blob->offset;
       break;
     }
   }
+  if (offset >= 0)
+    offset-=(magick_off_t) BlobReadBufferCount(image->blob);
   return(offset);
 }
 
@@ -4386,6 +5177,7 @@ MagickExport size_t WriteBlob(Image *image,const size_t length,const void *data)
   assert(data != (const char *) NULL);
   assert(image->blob != (BlobInfo *) NULL);
   assert(image->blob->type != UndefinedStream);
+  DrainBlobReadBuffer(image->blob);
   count=length;
   switch (image->blob->type)
   {
@@ -4471,6 +5263,11 @@ MagickExport size_t WriteBlob(Image *image,const size_t length,const void *data)
       count=WriteBlobStream(image,length,data);
       break;
     }
+    case SegmentStream:
+    {
+      count=WriteSegmentStream(image,length,data);
+      break;
+    }
   }
   return(count);
 }
@@ -4511,6 +5308,7 @@ MagickExport size_t WriteBlobByte(Image *image,const magick_uint8_t value)
   assert(image != (Image *) NULL);
   assert(image->signature == MagickSignature);
 
+  DrainBlobReadBuffer(image->blob);
   switch (image->blob->type)
     {
     case FileStream:
@@ -114,6 +114,36 @@ extern "C" {
                                         size_t *length,
                                         ExceptionInfo *exception);
 
+  /*
+    A segment of a formatted in-memory image, as returned by
+    ImageToBlobSegments().  Segments may be used to populate an iovec
+    array for writev().
+  */
+  typedef struct _BlobSegment
+  {
+    void
+      *data;                /* Segment data */
+
+    size_t
+      length;               /* Segment length */
+  } BlobSegment;
+
+  /*
+    Writes an Image to a formatted in-memory representation which is
+    returned as a list of segments rather than as one contiguous
+    buffer.
+  */
+  extern MagickExport BlobSegment *ImageToBlobSegments(const ImageInfo *image_info,
+                                                       Image *image,
+                                                       size_t *count,
+                                                       ExceptionInfo *exception);
+
+  /*
+    Deallocate segments returned by ImageToBlobSegments().
+  */
+  extern MagickExport void DestroyBlobSegments(BlobSegment *segments,
+                                               const size_t count);
+
   /*
    *
    * Core File or BLOB I/O functions.
@@ -162,6 +192,15 @@ extern "C" {
                                         const size_t length,
                                         void **data);
 
+  /*
+    Read data using ReadBlobZC(), returning a pointer to either the
+    in-memory data or the supplied buffer.
+  */
+  extern MagickExport size_t ReadBlobZCBuffer(Image *image,
+                                              const size_t length,
+                                              unsigned char *buffer,
+                                              unsigned char **data);
+
   /*
     Write data from a buffer to the file or BLOB.
   */
@@ -231,6 +270,34 @@ extern "C" {
   */
   extern MagickExport int ReadBlobByte(Image *image);
 
+  /*
+    Read-ahead buffer which is the first member of every BlobInfo
+    structure.  It describes input which has already been obtained from
+    the underlying file or BLOB but not yet consumed.  ReadBlobByte()
+    and the other read functions consume it first and refill it when
+    it is exhausted.  It is only public so that ReadBlobByteInline()
+    may be expanded in place.
+  */
+  typedef struct _BlobReadBuffer
+  {
+    const unsigned char
+      *next,                /* Next unconsumed byte */
+      *end;                 /* End of buffered bytes */
+  } BlobReadBuffer;
+
+  /*
+    Read a single byte from the file or BLOB, like ReadBlobByte(), but
+    expanded in place so that the function is only called when the
+    read-ahead buffer is exhausted.  Intended for the inner loops of
+    decoders which read their input a byte at a time.  The image
+    argument is evaluated more than once.
+  */
+#define ReadBlobByteInline(image) \
+  ((((BlobReadBuffer *) (image)->blob)->next != \
+    ((BlobReadBuffer *) (image)->blob)->end) ? \
+   (int) *((BlobReadBuffer *) (image)->blob)->next++ : \
+   ReadBlobByte(image))
+
   /*
     Read a 16-bit little-endian unsigned "short" value from the file
     or BLOB.
@@ -15,8 +15,10 @@
 */
 #include "magick/studio.h"
 #include "magick/blob.h"
+#include "magick/config_snapshot.h"
 #include "magick/color.h"
 #include "magick/color_lookup.h"
+#include "magick/magick.h"
 #include "magick/monitor.h"
 #include "magick/pixel_cache.h"
 #include "magick/semaphore.h"
@@ -26,6 +28,22 @@
   Define declarations.
 */
 #define ColorFilename  "colors.mgk"
+
+/*
+  Fields of a color snapshot entry, and the snapshot version (which
+  changes with the quantum depth and the static color table).
+*/
+#define ColorSnapshotName        0U
+#define ColorSnapshotPath        1U
+#define ColorSnapshotCompliance  2U
+#define ColorSnapshotRed         3U
+#define ColorSnapshotGreen       4U
+#define ColorSnapshotBlue        5U
+#define ColorSnapshotOpacity     6U
+#define ColorSnapshotStealth     7U
+#define ColorSnapshotFields      8U
+#define ColorSnapshotVersion \
+  ((QuantumDepth << 16) | (sizeof(StaticColors)/sizeof(StaticColors[0])))
 
 /*
   Declare color map.
@@ -631,6 +649,19 @@ static SemaphoreInfo
 
 static ColorInfo
   *color_list = (ColorInfo *) NULL;
+
+/*
+  Colors loaded from a snapshot are allocated as one block, and their
+  strings are in the snapshot.
+*/
+static ColorInfo
+  *color_block = (ColorInfo *) NULL;
+
+static unsigned long
+  color_block_length = 0;
+
+static ConfigureSnapshot
+  color_snapshot;
 
 /*
   Forward declarations.
@@ -666,6 +697,8 @@ DestroyColorInfoEntry(ColorInfo *entry)
     entry->next->previous=entry->previous;
   if (entry == color_list)
     color_list=entry->next;
+  if ((entry >= color_block) && (entry < color_block+color_block_length))
+    return;
   if ((entry->path[0] != BuiltInPath[0]) &&
       (LocaleCompare(entry->path,BuiltInPath) != 0))
     {
@@ -690,6 +723,9 @@ DestroyColorInfo(void)
     DestroyColorInfoEntry(color_info);
   }
   color_list=(ColorInfo *) NULL;
+  MagickFreeMemory(color_block);
+  color_block_length=0;
+  DestroyConfigureSnapshot(&color_snapshot);
   DestroySemaphoreInfo(&color_semaphore);
 }
 
@@ -736,7 +772,14 @@ GetColorInfo(const char *name,ExceptionInfo *exception)
 
   LockSemaphoreInfo(color_semaphore);
   if (color_list == (ColorInfo *) NULL)
-    (void) ReadColorConfigureFile(ColorFilename,0,exception);
+    {
+      double
+        start;
+
+      start=MagickStartupClock();
+      (void) ReadColorConfigureFile(ColorFilename,0,exception);
+      MagickRecordStartupTime(ColorFilename,start);
+    }
   UnlockSemaphoreInfo(color_semaphore);
   if ((name == (const char *) NULL) || (LocaleCompare(name,"*") == 0))
     return((const ColorInfo *) color_list);
@@ -1368,6 +1411,86 @@ QueryColorname(const Image *image,const PixelPacket *color,
   return(False);
 }
 
+/*
+  Build the color list from the snapshot of the color configuration
+  file (found at path) if it is up to date.
+*/
+static MagickPassFail
+ReadColorSnapshot(const char *path)
+{
+  unsigned long
+    entries,
+    i;
+
+  if (!OpenConfigureSnapshot(&color_snapshot,ColorFilename,path,
+                             ColorSnapshotVersion,ColorSnapshotFields))
+    return(MagickFail);
+  entries=GetConfigureSnapshotEntries(&color_snapshot);
+  color_block=MagickAllocateArray(ColorInfo *,entries,sizeof(ColorInfo));
+  if ((entries == 0) || (color_block == (ColorInfo *) NULL))
+    {
+      MagickFreeMemory(color_block);
+      DestroyConfigureSnapshot(&color_snapshot);
+      return(MagickFail);
+    }
+  color_block_length=entries;
+  for (i=0; i < entries; i++)
+    {
+      ColorInfo
+        *color_info;
+
+      color_info=color_block+i;
+      color_info->path=(char *)
+        GetConfigureSnapshotString(&color_snapshot,i,ColorSnapshotPath);
+      color_info->name=(char *)
+        GetConfigureSnapshotString(&color_snapshot,i,ColorSnapshotName);
+      color_info->compliance=(ComplianceType)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotCompliance);
+      color_info->color.red=(Quantum)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotRed);
+      color_info->color.green=(Quantum)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotGreen);
+      color_info->color.blue=(Quantum)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotBlue);
+      color_info->color.opacity=(Quantum)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotOpacity);
+      color_info->stealth=(unsigned int)
+        GetConfigureSnapshotValue(&color_snapshot,i,ColorSnapshotStealth);
+      color_info->signature=MagickSignature;
+      color_info->previous=(i == 0 ? (ColorInfo *) NULL : color_info-1);
+      color_info->next=(i+1 == entries ? (ColorInfo *) NULL : color_info+1);
+    }
+  color_list=color_block;
+  return(MagickPass);
+}
+
+/*
+  Write a snapshot of the color list once the color configuration file
+  has been read.
+*/
+static void
+WriteColorSnapshot(void)
+{
+  register const ColorInfo
+    *p;
+
+  if (!color_snapshot.enabled)
+    return;
+  for (p=color_list; p != (const ColorInfo *) NULL; p=p->next)
+    {
+      AddConfigureSnapshotString(&color_snapshot,p->name);
+      AddConfigureSnapshotString(&color_snapshot,p->path);
+      AddConfigureSnapshotValue(&color_snapshot,p->compliance);
+      AddConfigureSnapshotValue(&color_snapshot,p->color.red);
+      AddConfigureSnapshotValue(&color_snapshot,p->color.green);
+      AddConfigureSnapshotValue(&color_snapshot,p->color.blue);
+      AddConfigureSnapshotValue(&color_snapshot,p->color.opacity);
+      AddConfigureSnapshotValue(&color_snapshot,p->stealth);
+    }
+  (void) WriteConfigureSnapshot(&color_snapshot,ColorFilename);
+  DestroyConfigureSnapshot(&color_snapshot);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1380,7 +1503,10 @@ QueryColorname(const Image *image,const PixelPacket *color,
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
 %  Method ReadColorConfigureFile reads the color configuration file which maps
-%  color strings with a particular image format.
+%  color strings with a particular image format.  If configuration
+%  snapshots are enabled, the color list is loaded from the snapshot of
+%  the file if it is up to date, and otherwise the snapshot is written
+%  once the file has been read.
 %
 %  The format of the ReadColorConfigureFile method is:
 %
@@ -1412,13 +1538,38 @@ ReadColorConfigureFile(const char *basename,
     path[MaxTextExtent],
     *xml;
 
+  /*
+    Read the color configure file (if any).
+  */
+  (void) strlcpy(path,basename,sizeof(path));
+  if (depth == 0)
+    {
+      ExceptionInfo
+	exception_local;
+
+      GetExceptionInfo(&exception_local);
+      xml=(char *) GetConfigureBlob(basename,path,&length,&exception_local);
+      if (exception_local.severity != ConfigureError)
+	CopyException(exception,&exception_local);
+      DestroyExceptionInfo(&exception_local);
+      if ((xml != (char *) NULL) && ReadColorSnapshot(path))
+	{
+	  MagickFreeMemory(xml);
+	  return(MagickPass);
+	}
+    }
+  else
+    {
+      xml=(char *) FileToBlob(basename,&length,exception);
+    }
   if (depth == 0)
     {
       size_t
 	i;
 
       /*
-	Load default set of colors from the static color table.
+	Load default set of colors from the static color table (which a
+	snapshot already includes).
       */
       for (i=0 ; i < sizeof(StaticColors)/sizeof(StaticColors[0]); i++)
 	{
@@ -1450,26 +1601,6 @@ ReadColorConfigureFile(const char *basename,
 	  color_list=color_list->next;
 	}
     }
-
-  /*
-    Read the color configure file (if any).
-  */
-  (void) strlcpy(path,basename,sizeof(path));
-  if (depth == 0)
-    {
-      ExceptionInfo
-	exception_local;
-
-      GetExceptionInfo(&exception_local);
-      xml=(char *) GetConfigureBlob(basename,path,&length,&exception_local);
-      if (exception_local.severity != ConfigureError)
-	CopyException(exception,&exception_local);
-      DestroyExceptionInfo(&exception_local);
-    }
-  else
-    {
-      xml=(char *) FileToBlob(basename,&length,exception);
-    }
   if (xml != (char *) NULL)
     {
       char
@@ -1480,6 +1611,7 @@ ReadColorConfigureFile(const char *basename,
       MagickBool
 	in_entry;
 
+      AddConfigureSnapshotSource(&color_snapshot,path);
       token=AcquireString(xml);
       in_entry=MagickFalse;
       for (q=xml; *q != '\0'; )
@@ -1688,7 +1820,11 @@ ReadColorConfigureFile(const char *basename,
     }
   if (color_list == (ColorInfo *) NULL)
     return(MagickFail);
-  while (color_list->previous != (ColorInfo *) NULL)
-    color_list=color_list->previous;
+  if (depth == 0)
+    {
+      while (color_list->previous != (ColorInfo *) NULL)
+	color_list=color_list->previous;
+      WriteColorSnapshot();
+    }
   return(MagickPass);
 }
@@ -69,19 +69,29 @@
 #include "magick/montage.h"
 #include "magick/operator.h"
 #include "magick/paint.h"
+#include "magick/parallel.h"
 #include "magick/pixel_cache.h"
 #include "magick/profile.h"
 #include "magick/quantize.h"
+#include "magick/random.h"
 #include "magick/registry.h"
 #include "magick/render.h"
 #include "magick/resize.h"
 #include "magick/resource.h"
 #include "magick/shear.h"
 #include "magick/semaphore.h"
+#include "magick/signature.h"
+#include "magick/tempfile.h"
 #include "magick/transform.h"
 #include "magick/utility.h"
 #include "magick/version.h"
 #include "magick/xwindow.h"
+#if defined(POSIX) && defined(HAVE_POLL)
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include "magick/tsd.h"
+#  define HasUnixSockets
+#endif /* defined(POSIX) && defined(HAVE_POLL) */
 
 /*
   Typedef declarations.
@@ -132,13 +142,34 @@ typedef int (*CommandLineParser)(FILE *in, int acmax, char **av);
 typedef struct _BatchOptions {
   MagickBool        stop_on_error,
                     is_feedback_enabled,
-                    is_echo_enabled;
+                    is_echo_enabled,
+                    is_timing_enabled;
+  unsigned int      parallel;
   char              prompt[SIZE_OPTION_VALUE],
                     pass[SIZE_OPTION_VALUE],
                     fail[SIZE_OPTION_VALUE];
   CommandLineParser command_line_parser;
 } BatchOptions;
 
+/*
+  One command line read by the batch command, along with the results of
+  executing it.  Results are held until they may be written in input order.
+*/
+typedef struct _BatchTask {
+  int               ac;             /* Parser result (argument count) */
+  char            **av;             /* Copy of arguments, av[0] unused */
+  int               argc;           /* Subcommand arguments within av */
+  char            **argv;
+  MagickBool        run,            /* Command is to be executed */
+                    executed,       /* Command was executed */
+                    serial,         /* Command may not run concurrently */
+                    echoed,         /* Command was already echoed */
+                    status;
+  char             *text;           /* Metadata text returned by command */
+  double            elapsed_time;
+  ExceptionInfo     exception;
+} BatchTask;
+
 typedef unsigned int (*CommandVectorHandler)(ImageInfo *image_info,
   int argc,char **argv,char **metadata,ExceptionInfo *exception);
 
@@ -156,6 +187,7 @@ typedef struct _CommandInfo
 
 static void InitializeBatchOptions(MagickBool);
 static MagickBool GMCommandSingle(int argc, char **argv);
+static int GetGMSubCommand(int *argc, char ***argv);
 static int ProcessBatchOptions(int argc, char **argv, BatchOptions *options);
 static int ParseUnixCommandLine(FILE *in, int acmax, char **av);
 static int ParseWindowsCommandLine(FILE *in, int acmax, char **av);
@@ -166,6 +198,9 @@ static void
 #endif /* HasX11 */
   BatchUsage(void),
   BenchmarkUsage(void),
+#if defined(HasUnixSockets)
+  ClientUsage(void),
+#endif /* HasUnixSockets */
   CompositeUsage(void),
   CompareUsage(void),
   ConjureUsage(void),
@@ -181,10 +216,19 @@ static void
   LiberateArgumentList(const int argc,char **argv),
   MogrifyUsage(void),
   MontageUsage(void),
+#if defined(HasUnixSockets)
+  ServeUsage(void),
+#endif /* HasUnixSockets */
   SetUsage(void),
   TimeUsage(void);
 
 static unsigned int
+#if defined(HasUnixSockets)
+  ClientCommand(ImageInfo *image_info,int argc,char **argv,
+                char **metadata,ExceptionInfo *exception),
+  ServeCommand(ImageInfo *image_info,int argc,char **argv,
+               char **metadata,ExceptionInfo *exception),
+#endif /* HasUnixSockets */
   HelpCommand(ImageInfo *image_info,int argc,char **argv,
               char **metadata,ExceptionInfo *exception),
 #if defined(MSWINDOWS)
@@ -206,6 +250,10 @@ static const CommandInfo commands[] =
       0, BatchUsage, 1, SingleMode },
     { "benchmark", "benchmark one of the other commands",
       BenchmarkImageCommand, BenchmarkUsage, 1, SingleMode | BatchMode },
+#if defined(HasUnixSockets)
+    { "client", "execute a command using a 'gm serve' server",
+      ClientCommand, ClientUsage, 1, SingleMode },
+#endif /* HasUnixSockets */
     { "compare", "compare two images",
       CompareImageCommand, CompareUsage, 0, SingleMode | BatchMode },
     { "composite", "composite images together",
@@ -230,6 +278,10 @@ static const CommandInfo commands[] =
       MogrifyImageCommand, MogrifyUsage, 0, SingleMode | BatchMode },
     { "montage", "create a composite image (in a grid) from separate images",
       MontageImageCommand, MontageUsage, 0, SingleMode | BatchMode },
+#if defined(HasUnixSockets)
+    { "serve", "execute commands sent by 'gm client' in one process",
+      ServeCommand, ServeUsage, 0, SingleMode },
+#endif /* HasUnixSockets */
     { "set", "change batch mode option",
       SetCommand, SetUsage, 1, BatchMode },
     { "time", "time one of the other commands",
@@ -256,6 +308,7 @@ static const char *escape_option_values[3] = { "unix", "windows", (char *)NULL }
 
 #define MAX_PARAM_CHAR 4096
 #define MAX_PARAM 256
+#define MAX_PARALLEL 256
 static char commandline[MAX_PARAM_CHAR+2];
 
 #define PrintVersionAndCopyright() { \
@@ -1451,6 +1504,403 @@ MagickExport unsigned int AnimateImageCommand(ImageInfo *image_info,
 }
 
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   I s S t a n d a r d S t r e a m F i l e n a m e                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  IsStandardStreamFilename() returns True if an argument names the standard
+%  input or output, either as "-" or with an explicit format (e.g. "PNG:-").
+%  IsStandardOutputFilename() also returns True for the standard output
+%  named as a file descriptor ("fd:1", optionally with a format).
+%
+%  The format of the IsStandardStreamFilename method is:
+%
+%      MagickBool IsStandardStreamFilename(const char *argument)
+%
+%  A description of each parameter follows:
+%
+%    o argument: The command line argument.
+%
+*/
+static MagickBool IsStandardStreamFilename(const char *argument)
+{
+  size_t
+    length;
+
+  length=strlen(argument);
+  if ((length == 1) && (argument[0] == '-'))
+    return(MagickTrue);
+  if ((length > 2) && (argument[length-2] == ':') &&
+      (argument[length-1] == '-'))
+    return(MagickTrue);
+  return(MagickFalse);
+}
+
+static MagickBool IsStandardOutputFilename(const char *argument)
+{
+  size_t
+    length;
+
+  if (IsStandardStreamFilename(argument))
+    return(MagickTrue);
+  length=strlen(argument);
+  if ((length >= 4) && (LocaleCompare(argument+length-4,"fd:1") == 0) &&
+      ((length == 4) || (argument[length-5] == ':')))
+    return(MagickTrue);
+  return(MagickFalse);
+}
+
+/*
+  Options which change process-wide settings, and so affect other commands
+  executing at the same time.
+*/
+static const char
+  *process_options[] =
+  {
+    "debug",
+    "limit",
+    "log",
+    "monitor",
+    "stepthreads",
+    (char *) NULL
+  };
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   R e a d B a t c h T a s k                                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ReadBatchTask() reads the next command line from standard input (after
+%  writing the prompt, if any) and initializes a batch task to execute it.
+%  The arguments are copied since the command line parser reuses its
+%  buffer.  Commands are marked to be executed alone if they change the
+%  batch options (set), use an option which changes process-wide settings
+%  (such as -limit), or write directly to standard output (help, version,
+%  identify without -format, compare with -metric, -verbose, or an
+%  argument naming the standard input or output).  False is returned at
+%  end of input.
+%
+%  The format of the ReadBatchTask method is:
+%
+%      MagickBool ReadBatchTask(BatchTask *task,char *program)
+%
+%  A description of each parameter follows:
+%
+%    o task: The batch task to initialize.
+%
+%    o program: The program name (argv[0] of the batch command).
+%
+*/
+static MagickBool ReadBatchTask(BatchTask *task,char *program)
+{
+  static const char
+    *serial_commands[] =
+    {
+      "help",
+      "set",
+      "version",
+      (char *) NULL
+    };
+
+  char
+    *av[MAX_PARAM+1];
+
+  int
+    i;
+
+  (void) memset(task,0,sizeof(BatchTask));
+  task->status=MagickTrue;
+  if (batch_options.prompt[0])
+    {
+      (void) fputs(batch_options.prompt, stdout);
+      (void) fflush(stdout);
+    }
+
+  av[0]=program;
+  av[MAX_PARAM]=(char *) NULL;
+  task->ac=(batch_options.command_line_parser)(stdin, MAX_PARAM, av);
+  if (task->ac < 0)
+    return(MagickFalse);
+
+  GetExceptionInfo(&task->exception);
+  if ((task->ac == 0) || (task->ac > MAX_PARAM))
+    {
+      task->status=MagickFalse;
+      return(MagickTrue);
+    }
+  task->av=MagickAllocateArray(char **,task->ac+1,sizeof(char *));
+  if (task->av == (char **) NULL)
+    MagickFatalError(ResourceLimitFatalError,MemoryAllocationFailed,
+      (char *) NULL);
+  task->av[0]=program;
+  for (i=1; i < task->ac; i++)
+    task->av[i]=AcquireString(av[i]);
+  task->av[task->ac]=(char *) NULL;
+  if (task->ac == 1)
+    return(MagickTrue);
+
+  task->argc=task->ac;
+  task->argv=task->av;
+  i=GetGMSubCommand(&task->argc,&task->argv);
+  if (task->argv == task->av)
+    {
+      /*
+        The program name was not skipped, and may have been replaced with
+        the client name buffer (which other commands update), so copy it.
+      */
+      task->av[0]=AcquireString(task->av[0]);
+    }
+  switch (i)
+    {
+    case -1:
+      task->status=MagickFalse;
+      break;
+    case 1:
+      {
+        const char
+          *command = task->argv[0];
+
+        int
+          j;
+
+        MagickBool
+          format = MagickFalse,
+          metric = MagickFalse;
+
+        if (*command == '-')
+          command++;
+        for (i=0; serial_commands[i] != (char *) NULL; i++)
+          if (LocaleCompare(command,serial_commands[i]) == 0)
+            task->serial=MagickTrue;
+        for (i=1; i < task->argc; i++)
+          {
+            const char
+              *argument = task->argv[i];
+
+            if (IsStandardOutputFilename(argument))
+              task->serial=MagickTrue;
+            if ((*argument != '-') && (*argument != '+'))
+              continue;
+            for (j=0; process_options[j] != (char *) NULL; j++)
+              if (LocaleCompare(argument+1,process_options[j]) == 0)
+                task->serial=MagickTrue;
+            if (LocaleCompare(argument+1,"verbose") == 0)
+              task->serial=MagickTrue;
+            else if (LocaleCompare(argument+1,"format") == 0)
+              format=MagickTrue;
+            else if (LocaleCompare(argument+1,"metric") == 0)
+              metric=MagickTrue;
+          }
+        if (((LocaleCompare(command,"identify") == 0) && !format) ||
+            ((LocaleCompare(command,"compare") == 0) && metric))
+          task->serial=MagickTrue;
+        task->run=MagickTrue;
+        break;
+      }
+    }
+  return(MagickTrue);
+}
+
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   E x e c u t e B a t c h T a s k                                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ExecuteBatchTask() is the ExecuteParallelTasks() callback which executes
+%  one batch command using its own ImageInfo and exception structure.  The
+%  metadata text, status, exception, and elapsed time are stored in the
+%  task to be written later.  MagickFail is returned if the command failed
+%  and batch execution is to stop on error.
+%
+%  The format of the ExecuteBatchTask method is:
+%
+%      MagickPassFail ExecuteBatchTask(void *mutable_data,
+%        const void *immutable_data,const unsigned long task,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o mutable_data: The array of batch tasks.
+%
+%    o immutable_data: Not used.
+%
+%    o task: Index of the task to execute.
+%
+%    o exception: Not used (the task has its own exception structure).
+%
+*/
+static MagickPassFail ExecuteBatchTask(void *mutable_data,
+  const void *immutable_data,const unsigned long task,
+  ExceptionInfo *exception)
+{
+  BatchTask
+    *batch_task;
+
+  ImageInfo
+    *image_info;
+
+  TimerInfo
+    timer;
+
+  ARG_NOT_USED(immutable_data);
+  ARG_NOT_USED(exception);
+
+  batch_task=((BatchTask *) mutable_data)+task;
+  if (!batch_task->run)
+    return(MagickPass);
+
+  GetTimerInfo(&timer);
+  image_info=CloneImageInfo((ImageInfo *) NULL);
+  batch_task->status=MagickCommand(image_info,batch_task->argc,
+    batch_task->argv,&batch_task->text,&batch_task->exception);
+  DestroyImageInfo(image_info);
+  batch_task->elapsed_time=GetElapsedTime(&timer);
+  batch_task->executed=MagickTrue;
+
+  if (!batch_task->status && batch_options.stop_on_error)
+    return(MagickFail);
+  return(MagickPass);
+}
+
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   W r i t e B a t c h T a s k                                               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  WriteBatchTask() writes the results of a batch task: the echoed command
+%  (unless already written), any metadata text, exception, feedback and
+%  timing.  When echo is enabled and the task is written before it is
+%  executed (as is done when commands are executed one at a time), only
+%  the command is echoed.
+%
+%  The format of the WriteBatchTask method is:
+%
+%      void WriteBatchTask(BatchTask *task)
+%
+%  A description of each parameter follows:
+%
+%    o task: The batch task.
+%
+*/
+static void WriteBatchTask(BatchTask *task)
+{
+  if (batch_options.is_echo_enabled && !task->echoed)
+    {
+      int i;
+      for (i = 1; (task->av != (char **) NULL) && (i < task->ac); i++)
+        {
+          (void) fputs(task->av[i], stdout);
+          (void) putchar(' ');
+        }
+      (void) putchar('\n');
+      (void) fflush(stdout);
+      task->echoed=MagickTrue;
+    }
+  if ((task->run && !task->executed) || (task->ac == 1))
+    return;
+
+  if (task->ac == 0)
+    (void) fprintf(stderr,
+                   "Error: command line exceeded %d characters.\n",
+                   MAX_PARAM_CHAR);
+  else if (task->ac > MAX_PARAM)
+    (void) fprintf(stderr,
+                   "Error: command line exceeded %d parameters.\n",
+                   MAX_PARAM);
+  if ((task->text != (char *) NULL) && (strlen(task->text)))
+    {
+      (void) fputs(task->text,stdout);
+      (void) fputc('\n',stdout);
+    }
+  if (task->exception.severity != UndefinedException)
+    {
+      /*
+        Exceptions are reported using the client name, which commands
+        executed since this one may have changed.
+      */
+      if (task->run)
+        (void) SetClientName(task->argv[0][0] == '-' ? task->argv[0]+1 :
+                             task->argv[0]);
+      (void) fflush(stdout);
+      CatchException(&task->exception);
+    }
+  if (batch_options.is_feedback_enabled)
+    {
+      (void) fputs(task->status ? batch_options.pass : batch_options.fail, stdout);
+      (void) fputc('\n', stdout);
+    }
+  if (batch_options.is_timing_enabled && task->executed)
+    (void) fprintf(stdout,"elapsed: %.3fs\n",task->elapsed_time);
+  (void) fflush(stderr);
+  (void) fflush(stdout);
+}
+
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   D e s t r o y B a t c h T a s k                                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  DestroyBatchTask() deallocates memory associated with a batch task.
+%
+%  The format of the DestroyBatchTask method is:
+%
+%      void DestroyBatchTask(BatchTask *task)
+%
+%  A description of each parameter follows:
+%
+%    o task: The batch task.
+%
+*/
+static void DestroyBatchTask(BatchTask *task)
+{
+  int
+    i;
+
+  if (task->av != (char **) NULL)
+    {
+      for (i=(task->argv == task->av ? 0 : 1); i < task->ac; i++)
+        MagickFreeMemory(task->av[i]);
+      MagickFreeMemory(task->av);
+    }
+  MagickFreeMemory(task->text);
+  DestroyExceptionInfo(&task->exception);
+}
+
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1464,6 +1914,13 @@ MagickExport unsigned int AnimateImageCommand(ImageInfo *image_info,
 %
 %  BatchCommand runs multiple commands in interactive or batch mode.
 %
+%  With the -parallel option (and no prompt), blocks of command lines are
+%  read and executed concurrently using ExecuteParallelTasks(), each with
+%  its own ImageInfo and exception, and their results are then written in
+%  input order.  Commands which change the batch options or process-wide
+%  settings, or which write directly to standard output, are executed
+%  alone (see ReadBatchTask()).
+%
 %  The format of the BatchCommand method is:
 %
 %      unsigned int BatchCommand(ImageInfo *image_info,const int argc,
@@ -1486,8 +1943,10 @@ static MagickBool BatchCommand(int argc, char **argv)
 {
   int result;
   MagickBool hasInputFile;
-  int ac;
-  char *av[MAX_PARAM+1];
+  MagickBool eof = MagickFalse;
+  MagickBool pending = MagickFalse;
+  BatchTask next;
+  ExceptionInfo exception;
 
   {
     char client_name[MaxTextExtent];
@@ -1530,67 +1989,93 @@ static MagickBool BatchCommand(int argc, char **argv)
   InitializeMagick(argv[0]);
 #endif
 
-  av[0] = argv[0];
-  av[MAX_PARAM] = (char *)NULL;
+  (void) setlocale(LC_ALL,"");
+  (void) setlocale(LC_NUMERIC,"C");
+
   if (batch_options.prompt[0])
     {
       PrintVersionAndCopyright();
       (void) fflush(stdout);
     }
 
-  for (;;)
+  GetExceptionInfo(&exception);
+  result = MagickTrue;
+  while (!eof)
     {
-      if (batch_options.prompt[0])
-        {
-          (void) fputs(batch_options.prompt, stdout);
-          (void) fflush(stdout);
-        }
+      BatchTask
+        *tasks;
+
+      MagickBool
+        stop = MagickFalse;
 
-      ac = (batch_options.command_line_parser)(stdin, MAX_PARAM, av);
-      if (ac < 0)
+      unsigned long
+        capacity = 1,
+        i,
+        ntasks = 0;
+
+      /*
+        Read a block of commands which may execute concurrently, ending
+        before any command which must execute alone.
+      */
+      if ((batch_options.parallel > 1) && !batch_options.prompt[0])
+        capacity = 4*batch_options.parallel;
+      tasks = MagickAllocateArray(BatchTask *,capacity,sizeof(BatchTask));
+      if (tasks == (BatchTask *) NULL)
+        MagickFatalError(ResourceLimitFatalError,MemoryAllocationFailed,
+          (char *) NULL);
+      if (pending)
         {
-          result = MagickTrue;
-          break;
-        };
-      if (batch_options.is_echo_enabled)
+          tasks[ntasks++] = next;
+          pending = MagickFalse;
+        }
+      while ((ntasks < capacity) && !((ntasks > 0) && tasks[0].serial))
         {
-          int i;
-          for (i = 1; i < ac; i++)
+          if (!ReadBatchTask(&next, argv[0]))
             {
-              (void) fputs(av[i], stdout);
-              (void) putchar(' ');
+              eof = MagickTrue;
+              break;
             }
-          (void) putchar('\n');
-          (void) fflush(stdout);
+          if (next.serial && (ntasks > 0))
+            {
+              pending = MagickTrue;
+              break;
+            }
+          tasks[ntasks++] = next;
         }
-      if (ac == 1)
-        continue;
-      if (ac > 0 && ac <= MAX_PARAM)
-        result = GMCommandSingle(ac, av);
-      else
+
+      /*
+        Execute the block, and write the results in order.
+      */
+      if ((ntasks == 1) && tasks[0].run)
+        WriteBatchTask(&tasks[0]);
+      if (ntasks > 0)
+        (void) ExecuteParallelTasks(ExecuteBatchTask,
+                                    tasks[0].serial ? 1 : batch_options.parallel,
+                                    (const char *) NULL,tasks,(const void *) NULL,
+                                    ntasks,&exception);
+      for (i = 0; i < ntasks; i++)
         {
-          if (ac == 0)
-            (void) fprintf(stderr,
-                           "Error: command line exceeded %d characters.\n",
-                           MAX_PARAM_CHAR);
-          else
-            (void) fprintf(stderr,
-                           "Error: command line exceeded %d parameters.\n",
-                           MAX_PARAM);
-          result = MagickFalse;
+          if (!stop)
+            {
+              WriteBatchTask(&tasks[i]);
+              if (tasks[i].ac != 1)
+                result = tasks[i].status;
+              if (batch_options.stop_on_error && !result)
+                stop = MagickTrue;
+            }
+          DestroyBatchTask(&tasks[i]);
         }
-
-      if (batch_options.is_feedback_enabled)
+      MagickFreeMemory(tasks);
+      if (stop)
         {
-          (void) fputs(result ? batch_options.pass : batch_options.fail, stdout);
-          (void) fputc('\n', stdout);
+          if (pending)
+            DestroyBatchTask(&next);
+          break;
         }
-      (void) fflush(stderr);
-      (void) fflush(stdout);
-
-      if (batch_options.stop_on_error && !result)
-        break;
+      if (eof)
+        result = MagickTrue;
     }
+  DestroyExceptionInfo(&exception);
 
   if (batch_options.prompt[0])
     {
@@ -1633,6 +2118,8 @@ static void BatchOptionUsage(void)
       "-feedback on|off     print text (see -pass and -fail options) feedback after",
       "                     each command to indicate the result, default is off",
       "-help                print program options",
+      "-parallel threads    execute up to this many commands at once, writing their",
+      "                     output in command order, default is 1",
       "-pass text           when feedback is on, output the designated text if the",
       "                     command executed successfully, default is 'PASS'",
       "-prompt text         use the given text as command prompt. use text 'off' or",
@@ -1641,6 +2128,8 @@ static void BatchOptionUsage(void)
       "-stop-on-error on|off",
       "                     when turned on, batch execution quits prematurely when",
       "                     any command returns error",
+      "-timing on|off       print the elapsed time of each command after it",
+      "                     completes, default is off",
       (char *) NULL
     };
 
@@ -2742,6 +3231,25 @@ CompareImageCommand(ImageInfo *image_info,
 	    ThrowException(exception,ImageError,ImageDifferenceExceedsLimit,message);
 	  }
       }
+    else if ((metric == StructuralSimilarityMetric) ||
+             (metric == MultiScaleStructuralSimilarityMetric))
+      {
+        fprintf(stdout, "           Similarity\n");
+        fprintf(stdout, "          ============\n");
+        fprintf(stdout,"     Red: %#-12.10f\n",statistics.red);
+        fprintf(stdout,"   Green: %#-12.10f\n",statistics.green);
+        fprintf(stdout,"    Blue: %#-12.10f\n",statistics.blue);
+        if (reference_image->matte)
+          fprintf(stdout," Opacity: %#-12.10f\n",statistics.opacity);
+        fprintf(stdout,"   Total: %#-12.10f\n",statistics.combined);
+
+	if ((maximum_error >= 0.0) && (statistics.combined < maximum_error))
+	  {
+	    status &= MagickFail;
+	    FormatString(message,"%g < %g",statistics.combined, maximum_error);
+	    ThrowException(exception,ImageError,ImageDifferenceExceedsLimit,message);
+	  }
+      }
     else
       {
         fprintf(stdout, "           Normalized    Absolute\n");
@@ -2840,7 +3348,8 @@ static void CompareUsage(void)
       "-log format          format of debugging information",
       "-matte               store matte channel if the image has one",
       "-maximum-error       maximum total difference before returning error",
-      "-metric              comparison metric (MAE, MSE, PAE, PSNR, RMSE)",
+      "-metric              comparison metric (MAE, MSE, PAE, PSNR, RMSE,",
+      "                     SSIM, MSSSIM)",
       "-monitor             show progress indication",
       "-sampling-factor HxV[,...]",
       "                     horizontal and vertical sampling factors",
@@ -4240,18 +4749,590 @@ static unsigned int ConcatenateImages(const int argc,char **argv,
   return(True);
 }
 
-#define NotInitialized  (unsigned int) (~0)
+/*
+  Optional on-disk cache of 'convert' results.  When MAGICK_RESULT_CACHE
+  names a directory, the output file of a convert command is stored
+  there under the SHA-256 digest of the command.  The digest covers the
+  contents of every argument which names a regular file (the input
+  images, but also profiles, fonts, or maps) and of every @file
+  argument, the remaining arguments as text, the output file name
+  without its directory, the MAGICK_* environment variables, the
+  contents of the configuration files, and the library version.  A
+  later command with the same digest copies the stored result to its
+  output file without decoding anything.  Commands are not cached if
+  they read standard input or URLs, write standard output, several
+  output files, or extra files via -write, or if they may read files
+  which are not named on the command line (drawing primitives, MVG,
+  SVG, or MSL inputs).  The result is staged in a temporary file (see
+  MAGICK_TMPDIR) and linked into the cache, so it is only stored if the
+  cache directory is on the same file system.  The cache is never
+  pruned by GraphicsMagick.
+*/
+#define ResultCacheBufferSize 65536
 
-#define ThrowConvertException(code,reason,description) \
-{ \
-  status = MagickFail; \
-  ThrowException(exception,code,reason,description); \
-  goto convert_cleanup_and_return; \
-}
-#define ThrowConvertException3(code,reason,description) \
-{ \
-  status = MagickFail; \
-  ThrowException3(exception,code,reason,description); \
+/*
+  Modification time of a file in nanoseconds, where the system records
+  it.
+*/
+#if defined(__APPLE__)
+#  define ResultCacheModifyNanoseconds(attributes) \
+  ((attributes).st_mtimespec.tv_nsec)
+#elif defined(__linux__) || defined(__CYGWIN__) || defined(__FreeBSD__) || \
+  defined(__NetBSD__) || defined(__OpenBSD__) || defined(__sun)
+#  define ResultCacheModifyNanoseconds(attributes) \
+  ((attributes).st_mtim.tv_nsec)
+#else
+#  define ResultCacheModifyNanoseconds(attributes) 0
+#endif
+
+/*
+  The identity of an output file, used to decide whether a command
+  actually wrote it.
+*/
+typedef struct _ResultCacheIdentity
+{
+  MagickBool
+    exists;
+
+  dev_t
+    device;
+
+  ino_t
+    inode;
+
+  magick_int64_t
+    size;
+
+  time_t
+    modify_seconds;
+
+  long
+    modify_nanoseconds;
+} ResultCacheIdentity;
+
+/*
+  Copy an open file to another, closing both.
+*/
+static MagickPassFail ResultCacheCopyStream(FILE *in,FILE *out)
+{
+  unsigned char
+    *buffer;
+
+  size_t
+    count;
+
+  MagickPassFail
+    status=MagickPass;
+
+  buffer=MagickAllocateMemory(unsigned char *,ResultCacheBufferSize);
+  if (buffer == (unsigned char *) NULL)
+    {
+      (void) fclose(in);
+      (void) fclose(out);
+      return MagickFail;
+    }
+  while ((count=fread(buffer,1,ResultCacheBufferSize,in)) != 0)
+    if (fwrite(buffer,1,count,out) != count)
+      {
+        status=MagickFail;
+        break;
+      }
+  if (ferror(in))
+    status=MagickFail;
+  (void) fclose(in);
+  if (fclose(out) != 0)
+    status=MagickFail;
+  MagickFreeMemory(buffer);
+  return status;
+}
+
+static MagickPassFail ResultCacheCopyFile(const char *source,
+  const char *destination)
+{
+  FILE
+    *in,
+    *out;
+
+  in=fopen(source,"rb");
+  if (in == (FILE *) NULL)
+    return MagickFail;
+  out=fopen(destination,"wb");
+  if (out == (FILE *) NULL)
+    {
+      (void) fclose(in);
+      return MagickFail;
+    }
+  return ResultCacheCopyStream(in,out);
+}
+
+static MagickBool ResultCacheIsFile(const char *path)
+{
+  MagickStatStruct_t
+    attributes;
+
+  return ((MagickStat(path,&attributes) == 0) &&
+          S_ISREG(attributes.st_mode));
+}
+
+static void ResultCacheGetIdentity(const char *path,
+  ResultCacheIdentity *identity)
+{
+  MagickStatStruct_t
+    attributes;
+
+  (void) memset(identity,0,sizeof(ResultCacheIdentity));
+  if ((MagickStat(path,&attributes) != 0) || !S_ISREG(attributes.st_mode))
+    return;
+  identity->exists=MagickTrue;
+  identity->device=attributes.st_dev;
+  identity->inode=attributes.st_ino;
+  identity->size=(magick_int64_t) attributes.st_size;
+  identity->modify_seconds=attributes.st_mtime;
+  identity->modify_nanoseconds=(long) ResultCacheModifyNanoseconds(attributes);
+}
+
+/*
+  Return the length of a leading "magick:" format prefix, or zero.
+*/
+static size_t ResultCachePrefixLength(const char *argument)
+{
+  size_t
+    length;
+
+  for (length=0; isalnum((int) ((unsigned char) argument[length])); length++)
+    ;
+  if ((length > 1) && (argument[length] == ':'))
+    return length+1;
+  return 0;
+}
+
+/*
+  Formats whose content may name further files to read.
+*/
+static MagickBool ResultCacheIsScriptFormat(const char *format,
+  const size_t length)
+{
+  static const char
+    *script_formats[] = { "MSL", "MVG", "SVG", "SVGZ", (const char *) NULL };
+
+  unsigned int
+    i;
+
+  for (i=0; script_formats[i] != (const char *) NULL; i++)
+    if ((strlen(script_formats[i]) == length) &&
+        (LocaleNCompare(format,script_formats[i],length) == 0))
+      return MagickTrue;
+  return MagickFalse;
+}
+
+/*
+  Return MagickTrue if the start of a file looks like an MVG drawing or
+  an XML document (SVG or MSL).
+*/
+static MagickBool ResultCacheIsScriptHeader(const unsigned char *header,
+  const size_t length)
+{
+  size_t
+    i;
+
+  if ((length >= 7) && (LocaleNCompare((const char *) header,"viewbox",7) == 0))
+    return MagickTrue;
+  for (i=0; (i < length) && isspace((int) header[i]); i++)
+    ;
+  return ((i < length) && (header[i] == '<'));
+}
+
+static void ResultCacheUpdateString(SignatureInfo *signature_info,
+  const char *text)
+{
+  UpdateSignature(signature_info,(const unsigned char *) text,strlen(text)+1);
+}
+
+/*
+  Add the digest of a file's contents to the signature.  Returns
+  MagickFail if the file may not be read, or if check_script is set and
+  the file looks like a drawing script.
+*/
+static MagickPassFail ResultCacheUpdateFile(SignatureInfo *signature_info,
+  const char *path,const MagickBool check_script)
+{
+  FILE
+    *file;
+
+  SignatureInfo
+    file_signature;
+
+  unsigned char
+    *buffer;
+
+  size_t
+    count;
+
+  MagickPassFail
+    status=MagickPass;
+
+  buffer=MagickAllocateMemory(unsigned char *,ResultCacheBufferSize);
+  if (buffer == (unsigned char *) NULL)
+    return MagickFail;
+  file=fopen(path,"rb");
+  if (file == (FILE *) NULL)
+    {
+      MagickFreeMemory(buffer);
+      return MagickFail;
+    }
+  GetSignatureInfo(&file_signature);
+  count=fread(buffer,1,ResultCacheBufferSize,file);
+  if (check_script && ResultCacheIsScriptHeader(buffer,count))
+    status=MagickFail;
+  while ((status == MagickPass) && (count != 0))
+    {
+      UpdateSignature(&file_signature,buffer,count);
+      count=fread(buffer,1,ResultCacheBufferSize,file);
+    }
+  if (ferror(file))
+    status=MagickFail;
+  FinalizeSignature(&file_signature);
+  (void) fclose(file);
+  MagickFreeMemory(buffer);
+  UpdateSignature(signature_info,(const unsigned char *) file_signature.digest,
+                  sizeof(file_signature.digest));
+  return status;
+}
+
+/*
+  Add one convert argument to the signature.  An argument which names a
+  regular file, optionally with a format prefix or a subimage suffix,
+  contributes its decorations and the contents of the file.  An @file
+  argument (as accepted by -comment, -label, or -draw text) contributes
+  the contents of the file.
+*/
+static MagickPassFail ResultCacheUpdateArgument(SignatureInfo *signature_info,
+  const char *argument,const MagickBool hash_paths)
+{
+  char
+    decoration[MaxTextExtent],
+    path[MaxTextExtent];
+
+  const char
+    *extension;
+
+  size_t
+    prefix;
+
+  if (((argument[0] == '-') || (argument[0] == '+')) &&
+      isalpha((int) ((unsigned char) argument[1])))
+    {
+      /*
+        Option names are not case sensitive.
+      */
+      (void) strlcpy(path,argument,MaxTextExtent);
+      LocaleLower(path);
+      ResultCacheUpdateString(signature_info,path);
+      return MagickPass;
+    }
+  if (argument[0] == '@')
+    {
+      if (!ResultCacheIsFile(argument+1))
+        return MagickFail;
+      ResultCacheUpdateString(signature_info,"@file");
+      if (hash_paths)
+        ResultCacheUpdateString(signature_info,argument+1);
+      return ResultCacheUpdateFile(signature_info,argument+1,MagickFalse);
+    }
+
+  prefix=ResultCachePrefixLength(argument);
+  if ((prefix != 0) && ResultCacheIsScriptFormat(argument,prefix-1))
+    return MagickFail;
+  (void) strlcpy(decoration,argument,Min(prefix+1,MaxTextExtent));
+  (void) strlcpy(path,argument+prefix,MaxTextExtent);
+  if ((strcmp(path,"-") == 0) || (strstr(argument,"://") != (char *) NULL))
+    return MagickFail;
+  if (!ResultCacheIsFile(path))
+    {
+      char
+        *subimage;
+
+      subimage=strrchr(path,'[');
+      if ((subimage != (char *) NULL) && (path[strlen(path)-1] == ']'))
+        {
+          (void) strlcat(decoration,subimage,MaxTextExtent);
+          *subimage='\0';
+        }
+      if (!ResultCacheIsFile(path))
+        {
+          ResultCacheUpdateString(signature_info,argument);
+          return MagickPass;
+        }
+    }
+  extension=strrchr(path,'.');
+  if ((prefix == 0) && (extension != (const char *) NULL) &&
+      ResultCacheIsScriptFormat(extension+1,strlen(extension+1)))
+    return MagickFail;
+  ResultCacheUpdateString(signature_info,"file");
+  ResultCacheUpdateString(signature_info,decoration);
+  if (hash_paths)
+    ResultCacheUpdateString(signature_info,path);
+  return ResultCacheUpdateFile(signature_info,path,MagickTrue);
+}
+
+#if defined(POSIX)
+extern char
+  **environ;
+
+static int ResultCacheCompareStrings(const void *x,const void *y)
+{
+  return strcmp(*((const char * const *) x),*((const char * const *) y));
+}
+#endif /* defined(POSIX) */
+
+/*
+  Add the MAGICK_* environment variables, which select configuration
+  files, modules, fonts, and resource limits, to the signature.  They
+  are sorted so that their order in the environment does not matter.
+*/
+static MagickPassFail ResultCacheUpdateEnvironment(SignatureInfo *signature_info)
+{
+#if defined(POSIX)
+  const char
+    **variables;
+
+  size_t
+    count,
+    i;
+
+  count=0;
+  for (i=0; environ[i] != (char *) NULL; i++)
+    if (strncmp(environ[i],"MAGICK_",7) == 0)
+      count++;
+  variables=MagickAllocateArray(const char **,count+1,sizeof(const char *));
+  if (variables == (const char **) NULL)
+    return MagickFail;
+  count=0;
+  for (i=0; environ[i] != (char *) NULL; i++)
+    if (strncmp(environ[i],"MAGICK_",7) == 0)
+      variables[count++]=environ[i];
+  qsort((void *) variables,count,sizeof(const char *),
+        ResultCacheCompareStrings);
+  for (i=0; i < count; i++)
+    ResultCacheUpdateString(signature_info,variables[i]);
+  MagickFreeMemory(variables);
+  return MagickPass;
+#else
+  ARG_NOT_USED(signature_info);
+  return MagickFail;
+#endif /* defined(POSIX) */
+}
+
+/*
+  Add the contents of the configuration files which may affect a result
+  (named colors, delegate programs, fonts, and modules) to the
+  signature.
+*/
+static void ResultCacheUpdateConfiguration(SignatureInfo *signature_info)
+{
+  static const char
+    *configure_files[] =
+    {
+      "colors.mgk",
+      "delegates.mgk",
+      "modules.mgk",
+      "type.mgk",
+      (const char *) NULL
+    };
+
+  char
+    path[MaxTextExtent];
+
+  ExceptionInfo
+    exception;
+
+  SignatureInfo
+    file_signature;
+
+  size_t
+    length;
+
+  unsigned int
+    i;
+
+  void
+    *blob;
+
+  for (i=0; configure_files[i] != (const char *) NULL; i++)
+    {
+      GetExceptionInfo(&exception);
+      blob=GetConfigureBlob(configure_files[i],path,&length,&exception);
+      DestroyExceptionInfo(&exception);
+      ResultCacheUpdateString(signature_info,configure_files[i]);
+      if (blob == (void *) NULL)
+        continue;
+      GetSignatureInfo(&file_signature);
+      UpdateSignature(&file_signature,(const unsigned char *) blob,length);
+      FinalizeSignature(&file_signature);
+      MagickFreeMemory(blob);
+      UpdateSignature(signature_info,
+                      (const unsigned char *) file_signature.digest,
+                      sizeof(file_signature.digest));
+    }
+}
+
+/*
+  Compute the cache file name for a convert command.  Returns MagickFail
+  if the result cache is disabled or the command may not be cached.
+*/
+static MagickPassFail ResultCacheFileName(const ImageInfo *image_info,
+  int argc,char **argv,char *cache_file)
+{
+  const char
+    *cache_directory,
+    *output,
+    *tail;
+
+  MagickBool
+    hash_paths;
+
+  SignatureInfo
+    signature_info;
+
+  int
+    i;
+
+  cache_directory=getenv("MAGICK_RESULT_CACHE");
+  if ((cache_directory == (const char *) NULL) || (*cache_directory == '\0'))
+    return MagickFail;
+  output=argv[argc-1];
+  if ((strcmp(output+ResultCachePrefixLength(output),"-") == 0) ||
+      (strchr(output,'%') != (char *) NULL))
+    return MagickFail;
+
+  /*
+    Definitions made by the caller rather than on the command line are
+    not part of the digest.
+  */
+  if (image_info->definitions != (MagickMap) NULL)
+    return MagickFail;
+
+  /*
+    Arguments using the %d, %e, %f, %i, %o, or %t escapes may embed file
+    names in the result.
+  */
+  hash_paths=MagickFalse;
+  for (i=1; i < (argc-1); i++)
+    {
+      const char
+        *p;
+
+      if ((LocaleCompare("-write",argv[i]) == 0) ||
+          (LocaleCompare("-draw",argv[i]) == 0))
+        return MagickFail;
+      for (p=strchr(argv[i],'%'); p != (const char *) NULL;
+           p=strchr(p+1,'%'))
+        if ((p[1] != '\0') && (strchr("defiot",p[1]) != (char *) NULL))
+          hash_paths=MagickTrue;
+    }
+
+  GetSignatureInfo(&signature_info);
+  ResultCacheUpdateString(&signature_info,MagickVersion);
+  if (ResultCacheUpdateEnvironment(&signature_info) == MagickFail)
+    return MagickFail;
+  ResultCacheUpdateConfiguration(&signature_info);
+  for (i=1; i < (argc-1); i++)
+    if (ResultCacheUpdateArgument(&signature_info,argv[i],hash_paths) ==
+        MagickFail)
+      return MagickFail;
+  tail=strrchr(output,'/');
+#if defined(MSWINDOWS)
+  if (strrchr(output,'\\') > tail)
+    tail=strrchr(output,'\\');
+#endif
+  tail=(tail != (const char *) NULL ? tail+1 : output);
+  UpdateSignature(&signature_info,(const unsigned char *) output,
+                  ResultCachePrefixLength(output));
+  ResultCacheUpdateString(&signature_info,tail);
+  FinalizeSignature(&signature_info);
+
+  FormatString(cache_file,"%.1024s%s%08lx%08lx%08lx%08lx%08lx%08lx%08lx%08lx",
+    cache_directory,DirectorySeparator,
+    signature_info.digest[0],signature_info.digest[1],signature_info.digest[2],
+    signature_info.digest[3],signature_info.digest[4],signature_info.digest[5],
+    signature_info.digest[6],signature_info.digest[7]);
+  return MagickPass;
+}
+
+/*
+  Copy the result written to output into the cache, provided that the
+  output file differs from the one identified before the command ran.
+  The result is first written to a temporary file which is then linked
+  into place, so concurrent commands never see a partial result.
+*/
+static void ResultCacheStore(const char *cache_file,const char *output,
+  const ResultCacheIdentity *previous)
+{
+  char
+    temporary_file[MaxTextExtent];
+
+  ResultCacheIdentity
+    identity;
+
+  const char
+    *path;
+
+  FILE
+    *in,
+    *out;
+
+  MagickPassFail
+    status;
+
+  path=output+ResultCachePrefixLength(output);
+  ResultCacheGetIdentity(path,&identity);
+  if (!identity.exists ||
+      (previous->exists &&
+       (identity.device == previous->device) &&
+       (identity.inode == previous->inode) &&
+       (identity.size == previous->size) &&
+       (identity.modify_seconds == previous->modify_seconds) &&
+       (identity.modify_nanoseconds == previous->modify_nanoseconds)))
+    return;
+  in=fopen(path,"rb");
+  if (in == (FILE *) NULL)
+    return;
+  out=AcquireTemporaryFileStream(temporary_file,BinaryFileIOMode);
+  if (out == (FILE *) NULL)
+    {
+      (void) fclose(in);
+      return;
+    }
+  status=ResultCacheCopyStream(in,out);
+  if (status == MagickPass)
+#if defined(POSIX)
+    status=(link(temporary_file,cache_file) == 0 ? MagickPass : MagickFail);
+#else
+    status=(rename(temporary_file,cache_file) == 0 ? MagickPass : MagickFail);
+#endif /* defined(POSIX) */
+  if (status == MagickPass)
+    (void) LogMagickEvent(CacheEvent,GetMagickModule(),
+                          "Stored result of %.1024s in %.1024s",path,
+                          cache_file);
+  else
+    (void) LogMagickEvent(CacheEvent,GetMagickModule(),
+                          "Unable to store result of %.1024s in %.1024s",
+                          path,cache_file);
+  (void) LiberateTemporaryFile(temporary_file);
+}
+
+#define NotInitialized  (unsigned int) (~0)
+
+#define ThrowConvertException(code,reason,description) \
+{ \
+  status = MagickFail; \
+  ThrowException(exception,code,reason,description); \
+  goto convert_cleanup_and_return; \
+}
+#define ThrowConvertException3(code,reason,description) \
+{ \
+  status = MagickFail; \
+  ThrowException3(exception,code,reason,description); \
   goto convert_cleanup_and_return; \
 }
 
@@ -4259,6 +5340,7 @@ MagickExport unsigned int ConvertImageCommand(ImageInfo *image_info,
   int argc,char **argv,char **metadata,ExceptionInfo *exception)
 {
   char
+    cache_file[MaxTextExtent],
     *filename,
     *format,
     *option;
@@ -4279,6 +5361,9 @@ MagickExport unsigned int ConvertImageCommand(ImageInfo *image_info,
   register int
     i;
 
+  ResultCacheIdentity
+    output_identity;
+
   unsigned int
     ping,
     status = 0;
@@ -4326,6 +5411,26 @@ MagickExport unsigned int ConvertImageCommand(ImageInfo *image_info,
   */
   if ((argc > 2) && (LocaleCompare("-concatenate",argv[1]) == 0))
     return(ConcatenateImages(argc,argv,exception));
+  if ((metadata == (char **) NULL) &&
+      (ResultCacheFileName(image_info,argc,argv,cache_file) == MagickPass))
+    {
+      const char
+        *output=argv[argc-1]+ResultCachePrefixLength(argv[argc-1]);
+
+      if (ResultCacheIsFile(cache_file) &&
+          (ResultCacheCopyFile(cache_file,output) == MagickPass))
+        {
+          (void) LogMagickEvent(CacheEvent,GetMagickModule(),
+                                "Result cache hit %.1024s",cache_file);
+          LiberateArgumentList(argc,argv);
+          return(MagickPass);
+        }
+      (void) LogMagickEvent(CacheEvent,GetMagickModule(),
+                            "Result cache miss %.1024s",cache_file);
+      ResultCacheGetIdentity(output,&output_identity);
+    }
+  else
+    cache_file[0]='\0';
   j=1;
   k=0;
   for (i=1; i < (argc-1); i++)
@@ -6085,6 +7190,8 @@ MagickExport unsigned int ConvertImageCommand(ImageInfo *image_info,
       AppendImageToList(&image_list,image);
     }
   status&=WriteImages(image_info,image_list,argv[argc-1],exception);
+  if ((status != MagickFail) && (cache_file[0] != '\0'))
+    ResultCacheStore(cache_file,argv[argc-1],&output_identity);
   if (metadata != (char **) NULL)
     {
       char
@@ -8728,6 +9835,7 @@ static void InitializeBatchOptions(MagickBool prompt)
 {
   strcpy(batch_options.pass, "PASS");
   strcpy(batch_options.fail, "FAIL");
+  batch_options.parallel = 1;
 #if defined(MSWINDOWS)
   batch_options.command_line_parser = ParseWindowsCommandLine;
 #else
@@ -16504,7 +17612,23 @@ static int ProcessBatchOptions(int argc, char **argv, BatchOptions *options)
 
         case 'p':
         case 'P':
-          if (LocaleCompare(option = "-pass", p) == 0)
+          if (LocaleCompare(option = "-parallel", p) == 0)
+            {
+              char *value = NULL;
+              status = GetOptionValue(option, argv[++i], &value);
+              if (OptionSuccess == status)
+                {
+                  long threads = MagickAtoL(value);
+                  if ((threads < 1) || (threads > MAX_PARALLEL))
+                    {
+                      fprintf(stderr, "Error: Invalid value for %s option: %s\n", option, value);
+                      status = OptionInvalidValue;
+                    }
+                  else
+                    options->parallel = (unsigned int) threads;
+                }
+            }
+          else if (LocaleCompare(option = "-pass", p) == 0)
             {
               char *value = NULL;
               status = GetOptionValue(option, argv[++i], &value);
@@ -16526,6 +17650,12 @@ static int ProcessBatchOptions(int argc, char **argv, BatchOptions *options)
           if (LocaleCompare(option = "-stop-on-error", p) == 0)
             status = GetOnOffOptionValue(option, argv[++i], &options->stop_on_error);
           break;
+
+        case 't':
+        case 'T':
+          if (LocaleCompare(option = "-timing", p) == 0)
+            status = GetOnOffOptionValue(option, argv[++i], &options->is_timing_enabled);
+          break;
         }
       if (status == OptionSuccess)
         continue;
@@ -16537,6 +17667,1376 @@ static int ProcessBatchOptions(int argc, char **argv, BatchOptions *options)
 }
 
 
+#if defined(HasUnixSockets)
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e R e a d                                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeRead() and ServeWrite() transfer a number of bytes over a 'gm serve'
+%  connection, retrying partial transfers.  ServeReadLength() and
+%  ServeWriteLength() transfer a 32-bit length in native byte order (the
+%  client and the server run on the same host), and ServeWriteString()
+%  transfers a length followed by that many bytes.  ServeWriteLength()
+%  fails if the length does not fit in 32 bits.
+%
+%  The format of the ServeRead method is:
+%
+%      MagickPassFail ServeRead(const int fd,void *data,size_t length)
+%
+%  A description of each parameter follows:
+%
+%    o fd: The connected socket.
+%
+%    o data: The data to transfer.
+%
+%    o length: The number of bytes to transfer.
+%
+*/
+static MagickPassFail ServeRead(const int fd,void *data,size_t length)
+{
+  char
+    *p = (char *) data;
+
+  while (length > 0)
+    {
+      ssize_t
+        count;
+
+      count=read(fd,p,length);
+      if (count < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return(MagickFail);
+        }
+      if (count == 0)
+        return(MagickFail);
+      p+=count;
+      length-=count;
+    }
+  return(MagickPass);
+}
+
+static MagickPassFail ServeWrite(const int fd,const void *data,size_t length)
+{
+  const char
+    *p = (const char *) data;
+
+  while (length > 0)
+    {
+      ssize_t
+        count;
+
+      count=write(fd,p,length);
+      if (count < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return(MagickFail);
+        }
+      p+=count;
+      length-=count;
+    }
+  return(MagickPass);
+}
+
+static MagickPassFail ServeReadLength(const int fd,magick_uint32_t *length)
+{
+  return(ServeRead(fd,length,sizeof(*length)));
+}
+
+#define ServeMaxLength ((size_t) 0xffffffffUL)
+
+static MagickPassFail ServeWriteLength(const int fd,const size_t length)
+{
+  magick_uint32_t
+    value = (magick_uint32_t) length;
+
+  if (length > ServeMaxLength)
+    return(MagickFail);
+  return(ServeWrite(fd,&value,sizeof(value)));
+}
+
+static MagickPassFail ServeWriteString(const int fd,const void *data,
+  const size_t length)
+{
+  if (!ServeWriteLength(fd,length))
+    return(MagickFail);
+  return(ServeWrite(fd,data,length));
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e C h e c k O w n e r                                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeCheckOwner() verifies that a 'gm serve' socket, or the directory
+%  holding it, is of the expected type (and not a symbolic link) and is
+%  owned by the user running this process.  A directory must also not be
+%  accessible by other users.
+%
+%  ServeCheckPeer() verifies that the process at the other end of a
+%  connected socket is run by the same user as this process.  If the
+%  system does not report the credentials of the peer then the socket
+%  permissions are relied upon instead.
+%
+%  The format of the ServeCheckOwner method is:
+%
+%      MagickPassFail ServeCheckOwner(const char *path,const mode_t type,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o path: The socket or directory path.
+%
+%    o type: The expected file type (S_IFSOCK or S_IFDIR).
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+static MagickPassFail ServeCheckOwner(const char *path,const mode_t type,
+  ExceptionInfo *exception)
+{
+  struct stat
+    attributes;
+
+  if (lstat(path,&attributes) != 0)
+    {
+      ThrowException2(exception,FileOpenError,path,strerror(errno));
+      return(MagickFail);
+    }
+  if (((attributes.st_mode & S_IFMT) != type) ||
+      (attributes.st_uid != geteuid()) ||
+      ((type == S_IFDIR) && ((attributes.st_mode & 077) != 0)))
+    {
+      errno=0;
+      ThrowException2(exception,FileOpenError,
+                      "Socket is not private to this user",path);
+      return(MagickFail);
+    }
+  return(MagickPass);
+}
+
+static MagickPassFail ServeCheckPeer(const int fd)
+{
+#if defined(SO_PEERCRED)
+  struct ucred
+    credentials;
+
+  socklen_t
+    length = sizeof(credentials);
+
+  if ((getsockopt(fd,SOL_SOCKET,SO_PEERCRED,&credentials,&length) != 0) ||
+      (credentials.uid != geteuid()))
+    return(MagickFail);
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+  defined(__OpenBSD__) || defined(__DragonFly__)
+  gid_t
+    gid;
+
+  uid_t
+    uid;
+
+  if ((getpeereid(fd,&uid,&gid) != 0) || (uid != geteuid()))
+    return(MagickFail);
+#else
+  ARG_NOT_USED(fd);
+#endif
+  return(MagickPass);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e S o c k e t A d d r e s s                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeSocketAddress() fills in the Unix domain socket address for the
+%  'gm serve' socket path.  If the path is NULL then the default path is
+%  used, which is gm.socket in the directory specified by the
+%  XDG_RUNTIME_DIR environment variable or, if it is not set, in a
+%  gm-<uid> directory within the directory specified by the TMPDIR
+%  environment variable (or /tmp).  The server creates the gm-<uid>
+%  directory if necessary.  The directory must be owned by the user and
+%  not be accessible by other users.
+%
+%  The format of the ServeSocketAddress method is:
+%
+%      MagickPassFail ServeSocketAddress(const char *path,
+%        const MagickBool server,struct sockaddr_un *address,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o path: The socket path, or NULL.
+%
+%    o server: True if called by the server, which may create the socket
+%      directory.
+%
+%    o address: The socket address is returned here.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+static MagickPassFail ServeSocketAddress(const char *path,
+  const MagickBool server,struct sockaddr_un *address,
+  ExceptionInfo *exception)
+{
+  char
+    default_path[MaxTextExtent];
+
+  if (path == (const char *) NULL)
+    {
+      char
+        directory[MaxTextExtent];
+
+      const char
+        *runtime_directory;
+
+      runtime_directory=getenv("XDG_RUNTIME_DIR");
+      if ((runtime_directory != (const char *) NULL) &&
+          (*runtime_directory != '\0'))
+        {
+          (void) strlcpy(directory,runtime_directory,sizeof(directory));
+        }
+      else
+        {
+          const char
+            *temporary_directory;
+
+          temporary_directory=getenv("TMPDIR");
+          if ((temporary_directory == (const char *) NULL) ||
+              (*temporary_directory == '\0'))
+            temporary_directory="/tmp";
+          FormatString(directory,"%.1024s/gm-%lu",temporary_directory,
+                       (unsigned long) geteuid());
+          if (server && (mkdir(directory,0700) != 0) && (errno != EEXIST))
+            {
+              ThrowException2(exception,FileOpenError,directory,
+                              strerror(errno));
+              return(MagickFail);
+            }
+        }
+      if (!ServeCheckOwner(directory,S_IFDIR,exception))
+        return(MagickFail);
+      FormatString(default_path,"%.1024s/gm.socket",directory);
+      path=default_path;
+    }
+  (void) memset(address,0,sizeof(*address));
+  address->sun_family=AF_UNIX;
+  if (strlen(path) >= sizeof(address->sun_path))
+    {
+      ThrowException2(exception,OptionError,"Socket path is too long",path);
+      return(MagickFail);
+    }
+  (void) strlcpy(address->sun_path,path,sizeof(address->sun_path));
+  return(MagickPass);
+}
+
+/*
+  Server state shared by the worker threads.
+*/
+typedef struct _ServeInfo
+{
+  int
+    socket;                     /* Listening socket */
+
+  unsigned int
+    workers;                    /* Number of worker threads */
+
+  unsigned long
+    time_limit;                 /* Seconds per request, or zero */
+
+  magick_int64_t
+    max_request;                /* Bytes per request */
+
+  MagickTsdKey_t
+    deadline_key;               /* Deadline of each worker's request */
+
+  volatile MagickBool
+    quit;
+} ServeInfo;
+
+static time_t
+  serve_deadline = 0;           /* Deadline when there is one worker */
+
+static ServeInfo
+  *serve_info = (ServeInfo *) NULL;
+
+#define ServeMagick "GMS1"
+#define ServeShutdownFlag 0x01U
+#define ServeReceiveTimeout 60      /* Seconds, unless -time-limit is set */
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e M o n i t o r                                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeMonitor() is the progress monitor installed by 'gm serve' to enforce
+%  the per-request time limit.  The deadline of the request executing in
+%  the calling worker thread is found via thread specific data (or, with a
+%  single worker whose operations may execute in other OpenMP threads, in a
+%  global).  When it has passed, the operation is cancelled.
+%
+%  With more than one worker, the OpenMP threads which an operation uses
+%  have no thread specific deadline, so only the progress reported by the
+%  worker thread itself (the master thread of its OpenMP team) is checked.
+%  The operation is still cancelled, but possibly later than the deadline
+%  by as long as the worker thread takes to report progress again.  A
+%  process-wide deadline can not be used since the OpenMP threads may be
+%  executing operations of several requests.
+%
+%  The format of the ServeMonitor method is:
+%
+%      MagickPassFail ServeMonitor(const char *text,
+%        const magick_int64_t quantum,const magick_uint64_t span,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o text: Description of the task being performed.
+%
+%    o quantum: The position relative to the span parameter.
+%
+%    o span: The span relative to completing a task.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+static MagickPassFail ServeMonitor(const char *text,
+  const magick_int64_t quantum,const magick_uint64_t span,
+  ExceptionInfo *exception)
+{
+  const time_t
+    *deadline;
+
+  ARG_NOT_USED(quantum);
+  ARG_NOT_USED(span);
+
+  if (serve_info == (ServeInfo *) NULL)
+    return(MagickPass);
+  if (serve_info->workers == 1)
+    deadline=&serve_deadline;
+  else
+    deadline=(const time_t *) MagickTsdGetSpecific(serve_info->deadline_key);
+  if ((deadline != (const time_t *) NULL) && (*deadline != 0) &&
+      (time((time_t *) NULL) > *deadline))
+    {
+      errno=0;
+      ThrowException2(exception,ResourceLimitError,
+                      "Request time limit exceeded",text);
+      return(MagickFail);
+    }
+  return(MagickPass);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e R e q u e s t                                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeRequest() reads one request from a 'gm client' connection, executes
+%  it, and writes the reply.  A request consists of a header (magick,
+%  flags, and the length of the body), which the server accepts or
+%  rejects before the body is sent.  The body holds the argument vector,
+%  the index of the argument naming the standard output (if any), and the
+%  data to be read from the standard input.  Arguments naming the standard
+%  input and output are replaced with temporary files.  The reply holds
+%  the command status, exception (severity, errno, reason and
+%  description), metadata text, and output data.  True is
+%  returned if the client requested that the server shut down.
+%
+%  The format of the ServeRequest method is:
+%
+%      MagickBool ServeRequest(const int fd,ServeInfo *info)
+%
+%  A description of each parameter follows:
+%
+%    o fd: The connected socket.
+%
+%    o info: The server state.
+%
+*/
+static MagickBool ServeRequest(const int fd,ServeInfo *info)
+{
+  char
+    **argv = (char **) NULL,
+    *body = (char *) NULL,
+    input_filename[MaxTextExtent],
+    magick[4],
+    output_filename[MaxTextExtent],
+    *text = (char *) NULL;
+
+  const char
+    *input = (const char *) NULL,
+    *p;
+
+  ExceptionInfo
+    exception;
+
+  ImageInfo
+    *image_info;
+
+  magick_uint32_t
+    argc = 0,
+    flags,
+    i,
+    input_length = 0,
+    length,
+    output_index;
+
+  MagickBool
+    quit = MagickFalse,
+    status = MagickFalse;
+
+  size_t
+    output_length = 0;
+
+  time_t
+    deadline = 0;
+
+  void
+    *output = (void *) NULL;
+
+  GetExceptionInfo(&exception);
+  input_filename[0]='\0';
+  output_filename[0]='\0';
+
+  /*
+    Read the request header, and accept or reject the request.
+  */
+  if (!ServeRead(fd,magick,sizeof(magick)) ||
+      (memcmp(magick,ServeMagick,sizeof(magick)) != 0) ||
+      !ServeReadLength(fd,&flags) || !ServeReadLength(fd,&length))
+    goto serve_request_exit;
+  if (flags & ServeShutdownFlag)
+    {
+      quit=MagickTrue;
+      status=MagickTrue;
+      (void) ServeWriteLength(fd,0);
+      goto serve_request_reply;
+    }
+  if ((magick_int64_t) length > info->max_request)
+    {
+      char
+        limit[MaxTextExtent];
+
+      FormatString(limit,"%lu > %" MAGICK_INT64_F "d",(unsigned long) length,
+                   info->max_request);
+      errno=0;
+      ThrowException2(&exception,ResourceLimitError,
+                      "Request size limit exceeded",limit);
+      (void) ServeWriteLength(fd,0);
+      goto serve_request_reply;
+    }
+  if (!ServeWriteLength(fd,1))
+    goto serve_request_exit;
+
+  /*
+    Read and parse the request body.
+  */
+  body=MagickAllocateMemory(char *,(size_t) length+1);
+  if ((body == (char *) NULL) || !ServeRead(fd,body,length))
+    goto serve_request_exit;
+  p=body;
+#define ServeRemaining() ((size_t) (body+length-p))
+#define ServeParseLength(value_) \
+  { \
+    if (ServeRemaining() < sizeof(magick_uint32_t)) \
+      goto serve_request_exit; \
+    (void) memcpy(&(value_),p,sizeof(magick_uint32_t)); \
+    p+=sizeof(magick_uint32_t); \
+  }
+  ServeParseLength(argc);
+  if ((argc == 0) || (argc > MAX_PARAM))
+    goto serve_request_exit;
+  argv=MagickAllocateArray(char **,(size_t) argc+1,sizeof(char *));
+  if (argv == (char **) NULL)
+    goto serve_request_exit;
+  (void) memset(argv,0,((size_t) argc+1)*sizeof(char *));
+  for (i=0; i < argc; i++)
+    {
+      magick_uint32_t
+        argument_length;
+
+      ServeParseLength(argument_length);
+      if ((argument_length > MAX_PARAM_CHAR) ||
+          (ServeRemaining() < argument_length))
+        goto serve_request_exit;
+      argv[i]=MagickAllocateMemory(char *,(size_t) argument_length+
+                                   MaxTextExtent);
+      if (argv[i] == (char *) NULL)
+        goto serve_request_exit;
+      (void) memcpy(argv[i],p,argument_length);
+      argv[i][argument_length]='\0';
+      p+=argument_length;
+    }
+  ServeParseLength(output_index);
+  ServeParseLength(input_length);
+  if (ServeRemaining() != input_length)
+    goto serve_request_exit;
+  input=p;
+#undef ServeParseLength
+#undef ServeRemaining
+
+  /*
+    Options which would affect the requests of other clients are not
+    permitted.
+  */
+  for (i=1; i < argc; i++)
+    {
+      unsigned int
+        j;
+
+      if ((argv[i][0] != '-') && (argv[i][0] != '+'))
+        continue;
+      for (j=0; process_options[j] != (char *) NULL; j++)
+        if (LocaleCompare(process_options[j],argv[i]+1) == 0)
+          break;
+      if (process_options[j] != (char *) NULL)
+        {
+          ThrowException2(&exception,OptionError,
+                          "Option is not permitted by the server",argv[i]);
+          goto serve_request_reply;
+        }
+    }
+
+  /*
+    Replace standard input and output filenames with temporary files.
+  */
+  for (i=1; i < argc; i++)
+    {
+      char
+        *filename;
+
+      if (!IsStandardStreamFilename(argv[i]))
+        continue;
+      if (i == output_index)
+        filename=output_filename;
+      else
+        filename=input_filename;
+      if (*filename == '\0')
+        {
+          if (!AcquireTemporaryFileName(filename))
+            {
+              *filename='\0';
+              ThrowException(&exception,FileOpenError,
+                             UnableToCreateTemporaryFile,(char *) NULL);
+              goto serve_request_reply;
+            }
+          if ((filename == input_filename) &&
+              !BlobToFile(filename,input,input_length,&exception))
+            goto serve_request_reply;
+        }
+      (void) strlcpy(argv[i]+strlen(argv[i])-1,filename,MaxTextExtent);
+    }
+
+  /*
+    Execute the command.
+  */
+  if (info->time_limit != 0)
+    {
+      deadline=time((time_t *) NULL)+(time_t) info->time_limit;
+      if (info->workers == 1)
+        serve_deadline=deadline;
+      else
+        {
+          time_t
+            *worker_deadline;
+
+          worker_deadline=(time_t *) MagickTsdGetSpecific(info->deadline_key);
+          if (worker_deadline != (time_t *) NULL)
+            *worker_deadline=deadline;
+        }
+    }
+  image_info=CloneImageInfo((ImageInfo *) NULL);
+  status=MagickCommand(image_info,(int) argc,argv,&text,&exception);
+  DestroyImageInfo(image_info);
+  if (info->workers == 1)
+    serve_deadline=0;
+  else
+    {
+      time_t
+        *worker_deadline;
+
+      worker_deadline=(time_t *) MagickTsdGetSpecific(info->deadline_key);
+      if (worker_deadline != (time_t *) NULL)
+        *worker_deadline=0;
+    }
+  if ((deadline != 0) && (time((time_t *) NULL) > deadline) &&
+      (exception.severity < ErrorException))
+    {
+      /*
+        Commands do not necessarily fail when an operation is cancelled.
+      */
+      errno=0;
+      ThrowException2(&exception,ResourceLimitError,
+                      "Request time limit exceeded",argv[0]);
+      status=MagickFalse;
+    }
+  if (status && (*output_filename != '\0'))
+    {
+      output=FileToBlob(output_filename,&output_length,&exception);
+      if (output == (void *) NULL)
+        {
+          output_length=0;
+          status=MagickFalse;
+        }
+      else if (output_length > ServeMaxLength)
+        {
+          MagickFreeMemory(output);
+          output_length=0;
+          errno=0;
+          ThrowException2(&exception,ResourceLimitError,
+                          "Reply size limit exceeded",argv[0]);
+          status=MagickFalse;
+        }
+    }
+
+ serve_request_reply:
+  /*
+    Write the reply.
+  */
+  (void) (ServeWriteLength(fd,status) &&
+          ServeWriteLength(fd,exception.severity) &&
+          ServeWriteLength(fd,exception.error_number) &&
+          ServeWriteString(fd,exception.reason ? exception.reason : "",
+                           exception.reason ? strlen(exception.reason) : 0) &&
+          ServeWriteString(fd,exception.description ?
+                           exception.description : "",
+                           exception.description ?
+                           strlen(exception.description) : 0) &&
+          ServeWriteString(fd,text ? text : "",text ? strlen(text) : 0) &&
+          ServeWriteString(fd,output,output_length));
+
+ serve_request_exit:
+  if (*input_filename != '\0')
+    (void) LiberateTemporaryFile(input_filename);
+  if (*output_filename != '\0')
+    (void) LiberateTemporaryFile(output_filename);
+  if (argv != (char **) NULL)
+    {
+      for (i=0; i < argc; i++)
+        MagickFreeMemory(argv[i]);
+      MagickFreeMemory(argv);
+    }
+  MagickFreeMemory(body);
+  MagickFreeMemory(text);
+  MagickFreeMemory(output);
+  DestroyExceptionInfo(&exception);
+  return(quit);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S e r v e W o r k e r                                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeWorker() is the ExecuteParallelTasks() callback for each 'gm serve'
+%  worker.  It accepts and executes requests one at a time until the server
+%  is shut down.  The listening socket is polled with a timeout so that
+%  all of the workers notice when another worker has received a request to
+%  shut down.
+%
+%  The format of the ServeWorker method is:
+%
+%      MagickPassFail ServeWorker(void *mutable_data,
+%        const void *immutable_data,const unsigned long task,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o mutable_data: The server state.
+%
+%    o immutable_data: Not used.
+%
+%    o task: The worker number.
+%
+%    o exception: Not used (each request has its own exception).
+%
+*/
+static MagickPassFail ServeWorker(void *mutable_data,
+  const void *immutable_data,const unsigned long task,
+  ExceptionInfo *exception)
+{
+  ServeInfo
+    *info = (ServeInfo *) mutable_data;
+
+  time_t
+    deadline = 0;
+
+  ARG_NOT_USED(immutable_data);
+  ARG_NOT_USED(task);
+  ARG_NOT_USED(exception);
+
+  (void) MagickTsdSetSpecific(info->deadline_key,&deadline);
+  while (!info->quit)
+    {
+      struct pollfd
+        poll_fd;
+
+      int
+        fd;
+
+      poll_fd.fd=info->socket;
+      poll_fd.events=POLLIN;
+      poll_fd.revents=0;
+      if (poll(&poll_fd,1,1000) <= 0)
+        continue;
+      fd=accept(info->socket,(struct sockaddr *) NULL,(socklen_t *) NULL);
+      if (fd < 0)
+        continue;
+      if (!ServeCheckPeer(fd))
+        {
+          (void) LogMagickEvent(UserEvent,GetMagickModule(),
+                                "Rejected connection from another user");
+          (void) close(fd);
+          continue;
+        }
+      /*
+        The listening socket is non-blocking, which the accepted socket
+        may inherit.
+      */
+      (void) fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) & ~O_NONBLOCK);
+      {
+        /*
+          Do not let an idle client occupy a worker indefinitely.
+        */
+        struct timeval
+          timeout;
+
+        timeout.tv_sec=(time_t) (info->time_limit != 0 ? info->time_limit :
+                                 ServeReceiveTimeout);
+        timeout.tv_usec=0;
+        (void) setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&timeout,
+                          sizeof(timeout));
+      }
+      if (ServeRequest(fd,info))
+        info->quit=MagickTrue;
+      (void) close(fd);
+    }
+  (void) MagickTsdSetSpecific(info->deadline_key,(const void *) NULL);
+  return(MagickPass);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S e r v e C o m m a n d                                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeCommand() implements 'gm serve', which listens on a Unix domain
+%  socket and executes the commands sent by 'gm client' using a pool of
+%  worker threads, so that the cost of initializing GraphicsMagick is only
+%  paid once.  Each request is executed with its own ImageInfo and
+%  exception, subject to a time limit and a request size limit.  Resource
+%  limits (-limit) apply to the server process as a whole.
+%
+%  The format of the ServeCommand method is:
+%
+%      unsigned int ServeCommand(ImageInfo *image_info,const int argc,
+%        char **argv,char **metadata,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image_info: The image info.
+%
+%    o argc: The number of elements in the argument vector.
+%
+%    o argv: A text array containing the command line arguments.
+%
+%    o metadata: any metadata is returned here.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+static unsigned int ServeCommand(ImageInfo *image_info,
+  int argc,char **argv,char **metadata,ExceptionInfo *exception)
+{
+  const char
+    *socket_path = (const char *) NULL;
+
+  int
+    i;
+
+  MonitorHandler
+    monitor_handler;
+
+  ServeInfo
+    info;
+
+  struct sockaddr_un
+    address;
+
+  unsigned int
+    status;
+
+  ARG_NOT_USED(image_info);
+  ARG_NOT_USED(metadata);
+
+  (void) memset(&info,0,sizeof(info));
+  info.socket=-1;
+  info.workers=GetParallelTaskThreads(0,MAX_PARALLEL);
+  info.max_request=MagickSizeStrToInt64("64MB",1024);
+  for (i=1; i < argc; i++)
+    {
+      const char
+        *option = argv[i];
+
+      if ((LocaleCompare("-help",option) == 0) ||
+          (LocaleCompare("-?",option) == 0))
+        {
+          ServeUsage();
+          return(MagickPass);
+        }
+      if (LocaleCompare("-limit",option) == 0)
+        {
+          ResourceType
+            resource_type;
+
+          if (i+2 >= argc)
+            {
+              ThrowException(exception,OptionError,MissingArgument,option);
+              return(MagickFail);
+            }
+          resource_type=StringToResourceType(argv[++i]);
+          if (resource_type == UndefinedResource)
+            {
+              ThrowException(exception,OptionError,UnrecognizedResourceType,
+                             argv[i]);
+              return(MagickFail);
+            }
+          (void) SetMagickResourceLimit(resource_type,
+                                        MagickSizeStrToInt64(argv[++i],1024));
+          continue;
+        }
+      if (i+1 >= argc)
+        {
+          ThrowException(exception,OptionError,MissingArgument,option);
+          return(MagickFail);
+        }
+      if (LocaleCompare("-debug",option) == 0)
+        (void) SetLogEventMask(argv[++i]);
+      else if (LocaleCompare("-max-request",option) == 0)
+        info.max_request=MagickSizeStrToInt64(argv[++i],1024);
+      else if (LocaleCompare("-socket",option) == 0)
+        socket_path=argv[++i];
+      else if (LocaleCompare("-time-limit",option) == 0)
+        info.time_limit=(unsigned long) MagickAtoL(argv[++i]);
+      else if (LocaleCompare("-workers",option) == 0)
+        {
+          long
+            workers;
+
+          workers=MagickAtoL(argv[++i]);
+          if ((workers < 1) || (workers > MAX_PARALLEL))
+            {
+              ThrowException2(exception,OptionError,
+                              "Invalid number of workers",argv[i]);
+              return(MagickFail);
+            }
+          info.workers=(unsigned int) workers;
+        }
+      else
+        {
+          ThrowException(exception,OptionError,UnrecognizedOption,option);
+          return(MagickFail);
+        }
+    }
+  if (info.max_request <= 0)
+    info.max_request=MagickSizeStrToInt64("64MB",1024);
+  info.workers=GetParallelTaskThreads(info.workers,info.workers);
+
+  if (!ServeSocketAddress(socket_path,MagickTrue,&address,exception))
+    return(MagickFail);
+
+  /*
+    Remove a stale socket left by a server which has exited, but not the
+    socket of a running server or of another user.
+  */
+  {
+    struct stat
+      attributes;
+
+    if ((lstat(address.sun_path,&attributes) == 0) &&
+        S_ISSOCK(attributes.st_mode))
+      {
+        int
+          fd;
+
+        fd=socket(AF_UNIX,SOCK_STREAM,0);
+        if ((fd >= 0) &&
+            (connect(fd,(struct sockaddr *) &address,sizeof(address)) == 0))
+          {
+            (void) close(fd);
+            ThrowException2(exception,FileOpenError,
+                            "Server is already running",address.sun_path);
+            return(MagickFail);
+          }
+        if (fd >= 0)
+          (void) close(fd);
+        if (!ServeCheckOwner(address.sun_path,S_IFSOCK,exception))
+          return(MagickFail);
+        (void) unlink(address.sun_path);
+      }
+  }
+
+  info.socket=socket(AF_UNIX,SOCK_STREAM,0);
+  if (info.socket >= 0)
+    {
+      mode_t
+        mask;
+
+      /*
+        Only the user running the server may connect to it.
+      */
+      mask=umask(0077);
+      if ((bind(info.socket,(struct sockaddr *) &address,sizeof(address))
+           != 0) ||
+          (listen(info.socket,SOMAXCONN) != 0))
+        {
+          (void) close(info.socket);
+          info.socket=-1;
+        }
+      (void) umask(mask);
+    }
+  if (info.socket < 0)
+    {
+      ThrowException2(exception,FileOpenError,address.sun_path,
+                      strerror(errno));
+      return(MagickFail);
+    }
+  (void) fcntl(info.socket,F_SETFL,fcntl(info.socket,F_GETFL) | O_NONBLOCK);
+#if defined(SIGPIPE)
+  (void) signal(SIGPIPE,SIG_IGN);
+#endif
+  (void) LogMagickEvent(UserEvent,GetMagickModule(),
+                        "Serving on %s with %u workers",address.sun_path,
+                        info.workers);
+
+  /*
+    Requests are executed as in batch mode.
+  */
+  (void) MagickTsdKeyCreate(&info.deadline_key);
+  serve_info=&info;
+  monitor_handler=SetMonitorHandler(ServeMonitor);
+  run_mode=BatchMode;
+  status=ExecuteParallelTasks(ServeWorker,info.workers,(const char *) NULL,
+                              &info,(const void *) NULL,info.workers,
+                              exception);
+  run_mode=SingleMode;
+  (void) SetMonitorHandler(monitor_handler);
+  serve_info=(ServeInfo *) NULL;
+  (void) MagickTsdKeyDelete(info.deadline_key);
+
+  (void) close(info.socket);
+  (void) unlink(address.sun_path);
+  return(status);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S e r v e U s a g e                                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ServeUsage() displays the program command syntax.
+%
+%  The format of the ServeUsage method is:
+%
+%      void ServeUsage()
+%
+*/
+static void ServeUsage(void)
+{
+  static const char
+    *options[]=
+    {
+      "-debug events        display copious debugging information",
+      "-limit type value    pixel cache resource limit (for the server process)",
+      "-max-request size    maximum size of a request, default is 64MB",
+      "-socket path         Unix domain socket to listen on, default is",
+      "                     $XDG_RUNTIME_DIR/gm.socket or $TMPDIR/gm-<uid>/gm.socket",
+      "-time-limit seconds  cancel requests which take longer than this",
+      "-workers count       number of requests to execute at once, default is",
+      "                     the number of threads",
+      (char *) NULL
+    };
+
+  const char
+    **p;
+
+  PrintUsageHeader();
+  (void) printf("Usage: %.1024s [options ...]\n",GetClientName());
+  (void) printf("\nWhere options include:\n");
+  for (p=options; *p != (char *) NULL; p++)
+    (void) printf("  %.1024s\n",*p);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   C l i e n t C o m m a n d                                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ClientCommand() implements 'gm client', which sends a command to be
+%  executed by 'gm serve'.  If the command reads the standard input ("-"),
+%  the standard input is sent with the request.  If the last argument of a
+%  convert, composite, or montage command is the standard output, the
+%  output is returned and written to the standard output.  Metadata text
+%  and exceptions are reported as if the command was executed locally.
+%  Since the server may have a different working directory, relative
+%  filenames should be avoided.
+%
+%  The format of the ClientCommand method is:
+%
+%      unsigned int ClientCommand(ImageInfo *image_info,const int argc,
+%        char **argv,char **metadata,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image_info: The image info.
+%
+%    o argc: The number of elements in the argument vector.
+%
+%    o argv: A text array containing the command line arguments.
+%
+%    o metadata: any metadata is returned here.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+static char *ClientReadString(const int fd,size_t *length)
+{
+  char
+    *data;
+
+  magick_uint32_t
+    value;
+
+  if (!ServeReadLength(fd,&value))
+    return((char *) NULL);
+  data=MagickAllocateMemory(char *,(size_t) value+1);
+  if (data == (char *) NULL)
+    return((char *) NULL);
+  if (!ServeRead(fd,data,value))
+    {
+      MagickFreeMemory(data);
+      return((char *) NULL);
+    }
+  data[value]='\0';
+  *length=value;
+  return(data);
+}
+
+static unsigned int ClientCommand(ImageInfo *image_info,
+  int argc,char **argv,char **metadata,ExceptionInfo *exception)
+{
+  static const char
+    *output_commands[] =
+    {
+      "composite",
+      "convert",
+      "montage",
+      (char *) NULL
+    };
+
+  char
+    *body = (char *) NULL,
+    *description = (char *) NULL,
+    *input = (char *) NULL,
+    *output = (char *) NULL,
+    *q,
+    *reason = (char *) NULL,
+    *text = (char *) NULL;
+
+  const char
+    *socket_path = (const char *) NULL;
+
+  int
+    fd = -1,
+    first,
+    i;
+
+  magick_uint32_t
+    accepted,
+    error_number = 0,
+    flags = 0,
+    output_index = ~((magick_uint32_t) 0),
+    severity = UndefinedException,
+    status = MagickFail;
+
+  size_t
+    body_length,
+    input_length = 0,
+    length,
+    output_length = 0;
+
+  struct sockaddr_un
+    address;
+
+  ARG_NOT_USED(image_info);
+
+  for (i=1; (i < argc) && (argv[i][0] == '-'); i++)
+    {
+      if ((LocaleCompare("-help",argv[i]) == 0) ||
+          (LocaleCompare("-?",argv[i]) == 0))
+        {
+          ClientUsage();
+          return(MagickPass);
+        }
+      if (LocaleCompare("-shutdown",argv[i]) == 0)
+        flags|=ServeShutdownFlag;
+      else if ((LocaleCompare("-socket",argv[i]) == 0) && (i+1 < argc))
+        socket_path=argv[++i];
+      else
+        {
+          ThrowException(exception,OptionError,UnrecognizedOption,argv[i]);
+          return(MagickFail);
+        }
+    }
+  first=i;
+  if ((first == argc) && !(flags & ServeShutdownFlag))
+    {
+      ClientUsage();
+      ThrowException(exception,OptionError,UsageError,NULL);
+      return(MagickFail);
+    }
+  if (!ServeSocketAddress(socket_path,MagickFalse,&address,exception) ||
+      !ServeCheckOwner(address.sun_path,S_IFSOCK,exception))
+    return(MagickFail);
+
+  /*
+    Build the request body.
+  */
+  body_length=3*sizeof(magick_uint32_t);
+  if (first < argc)
+    {
+      const char
+        *command = argv[first];
+
+      if (*command == '-')
+        command++;
+      for (i=0; output_commands[i] != (char *) NULL; i++)
+        if ((LocaleCompare(command,output_commands[i]) == 0) &&
+            (argc-first > 1) && IsStandardStreamFilename(argv[argc-1]))
+          output_index=(magick_uint32_t) (argc-1-first);
+      for (i=first; i < argc; i++)
+        {
+          body_length+=sizeof(magick_uint32_t)+strlen(argv[i]);
+          if ((i > first) && ((magick_uint32_t) (i-first) != output_index) &&
+              IsStandardStreamFilename(argv[i]) && (input == (char *) NULL))
+            {
+              size_t
+                extent = 0;
+
+              /*
+                Read the standard input.
+              */
+              do
+                {
+                  extent+=65536;
+                  MagickReallocMemory(char *,input,extent);
+                  if (input == (char *) NULL)
+                    {
+                      ThrowException3(exception,ResourceLimitError,
+                                      MemoryAllocationFailed,
+                                      UnableToAllocateString);
+                      return(MagickFail);
+                    }
+                  input_length+=fread(input+input_length,1,
+                                      extent-input_length,stdin);
+                } while (input_length == extent);
+            }
+        }
+      body_length+=input_length;
+    }
+  if (body_length > ServeMaxLength)
+    {
+      MagickFreeMemory(input);
+      errno=0;
+      ThrowException2(exception,ResourceLimitError,
+                      "Request size limit exceeded",argv[first]);
+      return(MagickFail);
+    }
+  body=MagickAllocateMemory(char *,body_length);
+  if (body == (char *) NULL)
+    {
+      MagickFreeMemory(input);
+      ThrowException3(exception,ResourceLimitError,MemoryAllocationFailed,
+                      UnableToAllocateString);
+      return(MagickFail);
+    }
+  q=body;
+#define ClientAppendLength(value_) \
+  { \
+    magick_uint32_t value = (magick_uint32_t) (value_); \
+    (void) memcpy(q,&value,sizeof(value)); \
+    q+=sizeof(value); \
+  }
+  ClientAppendLength(argc-first);
+  for (i=first; i < argc; i++)
+    {
+      length=strlen(argv[i]);
+      ClientAppendLength(length);
+      (void) memcpy(q,argv[i],length);
+      q+=length;
+    }
+  ClientAppendLength(output_index);
+  ClientAppendLength(input_length);
+#undef ClientAppendLength
+  if (input_length != 0)
+    (void) memcpy(q,input,input_length);
+  MagickFreeMemory(input);
+
+  /*
+    Send the request and read the reply.
+  */
+#if defined(SIGPIPE)
+  (void) signal(SIGPIPE,SIG_IGN);
+#endif
+  fd=socket(AF_UNIX,SOCK_STREAM,0);
+  if ((fd < 0) ||
+      (connect(fd,(struct sockaddr *) &address,sizeof(address)) != 0))
+    {
+      ThrowException2(exception,FileOpenError,address.sun_path,
+                      strerror(errno));
+      goto client_exit;
+    }
+  if (!ServeCheckPeer(fd))
+    {
+      errno=0;
+      ThrowException2(exception,FileOpenError,
+                      "Server is run by another user",address.sun_path);
+      goto client_exit;
+    }
+  if (!ServeWrite(fd,ServeMagick,4) || !ServeWriteLength(fd,flags) ||
+      !ServeWriteLength(fd,body_length) || !ServeReadLength(fd,&accepted) ||
+      (accepted && !ServeWrite(fd,body,body_length)) ||
+      !ServeReadLength(fd,&status) || !ServeReadLength(fd,&severity) ||
+      !ServeReadLength(fd,&error_number) ||
+      ((reason=ClientReadString(fd,&length)) == (char *) NULL) ||
+      ((description=ClientReadString(fd,&length)) == (char *) NULL) ||
+      ((text=ClientReadString(fd,&length)) == (char *) NULL) ||
+      ((output=ClientReadString(fd,&output_length)) == (char *) NULL))
+    {
+      ThrowException2(exception,StreamError,
+                      "Connection to server failed",address.sun_path);
+      status=MagickFail;
+      goto client_exit;
+    }
+
+  if (output_length != 0)
+    {
+      (void) fwrite(output,1,output_length,stdout);
+      (void) fflush(stdout);
+    }
+  if ((metadata != (char **) NULL) && (*text != '\0'))
+    {
+      *metadata=text;
+      text=(char *) NULL;
+    }
+  if (severity != UndefinedException)
+    {
+      if (first < argc)
+        (void) SetClientName(argv[first][0] == '-' ? argv[first]+1 :
+                             argv[first]);
+      errno=(int) error_number;
+      ThrowException2(exception,(ExceptionType) severity,reason,
+                      *description != '\0' ? description : (char *) NULL);
+    }
+
+ client_exit:
+  if (fd >= 0)
+    (void) close(fd);
+  MagickFreeMemory(body);
+  MagickFreeMemory(reason);
+  MagickFreeMemory(description);
+  MagickFreeMemory(text);
+  MagickFreeMemory(output);
+  return(status);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   C l i e n t U s a g e                                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ClientUsage() displays the program command syntax.
+%
+%  The format of the ClientUsage method is:
+%
+%      void ClientUsage()
+%
+*/
+static void ClientUsage(void)
+{
+  PrintUsageHeader();
+  (void) printf("Usage: %.1024s [-socket path] [-shutdown] [command ...]\n",
+                GetClientName());
+  (void) printf("where 'command' is some other GraphicsMagick command, "
+                "which is executed\nby 'gm serve'\n");
+}
+#endif /* defined(HasUnixSockets) */
+
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -16600,8 +19100,10 @@ static unsigned int SetCommand(ImageInfo *image_info,
   printf("fail          : %s\n", batch_options.fail);
   printf("feedback      : %s\n", on_off_option_values[batch_options.is_feedback_enabled]);
   printf("stop-on-error : %s\n", on_off_option_values[batch_options.stop_on_error]);
+  printf("parallel      : %u\n", batch_options.parallel);
   printf("pass          : %s\n", batch_options.pass);
   printf("prompt        : %s\n", batch_options.prompt);
+  printf("timing        : %s\n", on_off_option_values[batch_options.is_timing_enabled]);
   return MagickTrue;
 }
 
@@ -17217,6 +19719,93 @@ static unsigned int RegisterCommand(ImageInfo *image_info,
 #endif
 
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   G e t G M S u b C o m m a n d                                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetGMSubCommand() sets the client name from the program name of a 'gm'
+%  command line, and adjusts the argument vector so that it starts with the
+%  subcommand name.  The return value is -1 if usage was printed because no
+%  subcommand was given, 0 for the "ping" subcommand (which does nothing),
+%  or 1 if the subcommand is to be executed.
+%
+%  The format of the GetGMSubCommand method is:
+%
+%      int GetGMSubCommand(int *argc,char ***argv)
+%
+%  A description of each parameter follows:
+%
+%    o argc: The number of elements in the argument vector.
+%
+%    o argv: The argument vector.
+%
+%
+*/
+static int GetGMSubCommand(int *argc,char ***argv)
+{
+  char
+    command[MaxTextExtent];
+
+  /*
+    Support traditional alternate names for GraphicsMagick subcommands.
+  */
+  static const char *command_names [] =
+    {
+      "animate",
+      "composite",
+      "conjure",
+      "convert",
+      "display",
+      "identify",
+      "import",
+      "mogrify",
+      "montage",
+      NULL
+    };
+
+  unsigned int
+    i;
+
+  (void) SetClientName((*argv)[0]);
+  GetPathComponent((*argv)[0],BasePath,command);
+  for (i=0; command_names[i]; i++)
+    if (LocaleCompare(command,command_names[i]) == 0)
+      break;
+
+  if (command_names[i])
+    {
+      /*
+        Set command name to alternate name.
+      */
+      (*argv)[0]=(char *) SetClientName(command);
+    }
+  else
+    {
+      if (*argc < 2)
+        {
+          GMUsage();
+          return(-1);
+        }
+
+      /*
+        Skip to subcommand name.
+      */
+      (*argc)--;
+      (*argv)++;
+    }
+  if (!strcmp((*argv)[0], "ping"))
+    return(0);
+  return(1);
+}
+
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -17246,7 +19835,6 @@ static unsigned int RegisterCommand(ImageInfo *image_info,
 static MagickBool GMCommandSingle(int argc,char **argv)
 {
   char
-    command[MaxTextExtent],
     *text;
 
   ExceptionInfo
@@ -17280,57 +19868,13 @@ static MagickBool GMCommandSingle(int argc,char **argv)
 
   ReadCommandlLine(argc,&argv);
 
-  (void) SetClientName(argv[0]);
-  {
-    /*
-      Support traditional alternate names for GraphicsMagick subcommands.
-    */
-    static const char *command_names [] =
-      {
-        "animate",
-        "composite",
-        "conjure",
-        "convert",
-        "display",
-        "identify",
-        "import",
-        "mogrify",
-        "montage",
-        NULL
-      };
-
-    unsigned int
-      i;
-
-    GetPathComponent(argv[0],BasePath,command);
-    for (i=0; command_names[i]; i++)
-      if (LocaleCompare(command,command_names[i]) == 0)
-        break;
-
-    if (command_names[i])
-      {
-        /*
-          Set command name to alternate name.
-        */
-        argv[0]=(char *) SetClientName(command);
-      }
-    else
-      {
-        if (argc < 2)
-          {
-            GMUsage();
-            return(MagickFalse);
-          }
-
-        /*
-          Skip to subcommand name.
-        */
-        argc--;
-        argv++;
-      }
-    if (!strcmp(argv[0], "ping"))
-      return MagickTrue;
-  }
+  switch (GetGMSubCommand(&argc,&argv))
+    {
+    case -1:
+      return(MagickFalse);
+    case 0:
+      return(MagickTrue);
+    }
 
   GetExceptionInfo(&exception);
   image_info=CloneImageInfo((ImageInfo *) NULL);
@@ -40,6 +40,252 @@
 #include "magick/pixel_iterator.h"
 #include "magick/utility.h"
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   C h e c k I m a g e D i f f e r e n c e                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  CheckImageDifference() determines if the difference between two images,
+%  computed according to the specified comparison metric, exceeds a limit.
+%  This is the same test as performed by 'gm compare -maximum-error', but
+%  rows are compared in parallel and the comparison stops as soon as the
+%  accumulated error is known to exceed the limit (or as soon as the first
+%  pixel exceeding a peak absolute error limit is found).  Identical rows
+%  are detected using memcmp().  For the PSNR and structural similarity
+%  metrics, the difference exceeds the limit if the metric value is less
+%  than the limit.  The structural similarity metrics are always computed
+%  in full.
+%
+%  The format of the CheckImageDifference method is:
+%
+%      MagickPassFail CheckImageDifference(const Image *reference_image,
+%                                          const Image *compare_image,
+%                                          const MetricType metric,
+%                                          const double maximum_error,
+%                                          MagickBool *exceeded,
+%                                          ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o reference_image: the reference image.
+%
+%    o compare_image: the comparison image.
+%
+%    o metric: metric to use when differencing.
+%
+%    o maximum_error: the limit for the (totalized) metric value.
+%
+%    o exceeded: updated with MagickTrue if the difference exceeds the
+%      limit.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+typedef struct _DifferenceLimit
+{
+  MetricType
+    metric;             /* Comparison metric */
+
+  double
+    limit,              /* Limit on accumulated (or peak) error */
+    total;              /* Accumulated error */
+
+  MagickBool
+    exceeded;           /* Limit has been exceeded */
+} DifferenceLimit;
+
+static MagickPassFail
+ComputeDifferenceLimit(void *mutable_data,
+                       const void *immutable_data,
+                       const Image *first_image,
+                       const PixelPacket *first_pixels,
+                       const IndexPacket *first_indexes,
+                       const Image *second_image,
+                       const PixelPacket *second_pixels,
+                       const IndexPacket *second_indexes,
+                       const long npixels,
+                       ExceptionInfo *exception)
+{
+  DifferenceLimit
+    *context = (DifferenceLimit *) mutable_data;
+
+  double
+    difference,
+    row_total=0.0;
+
+  MagickBool
+    exceeded=MagickFalse;
+
+  register long
+    i;
+
+  ARG_NOT_USED(immutable_data);
+  ARG_NOT_USED(first_indexes);
+  ARG_NOT_USED(second_image);
+  ARG_NOT_USED(second_indexes);
+  ARG_NOT_USED(exception);
+
+  if (memcmp(first_pixels,second_pixels,npixels*sizeof(PixelPacket)) == 0)
+    return (MagickPass);
+
+  switch (context->metric)
+    {
+    case MeanAbsoluteErrorMetric:
+      for (i=0; i < npixels; i++)
+        {
+          row_total += fabs(first_pixels[i].red-(double) second_pixels[i].red);
+          row_total += fabs(first_pixels[i].green-(double) second_pixels[i].green);
+          row_total += fabs(first_pixels[i].blue-(double) second_pixels[i].blue);
+          if (first_image->matte)
+            row_total += fabs(first_pixels[i].opacity-(double) second_pixels[i].opacity);
+        }
+      row_total /= MaxRGBDouble;
+      break;
+    case MeanSquaredErrorMetric:
+    case PeakSignalToNoiseRatioMetric:
+    case RootMeanSquaredErrorMetric:
+      for (i=0; i < npixels; i++)
+        {
+          difference=(first_pixels[i].red-(double) second_pixels[i].red)/MaxRGBDouble;
+          row_total += difference*difference;
+          difference=(first_pixels[i].green-(double) second_pixels[i].green)/MaxRGBDouble;
+          row_total += difference*difference;
+          difference=(first_pixels[i].blue-(double) second_pixels[i].blue)/MaxRGBDouble;
+          row_total += difference*difference;
+          if (first_image->matte)
+            {
+              difference=(first_pixels[i].opacity-(double) second_pixels[i].opacity)/MaxRGBDouble;
+              row_total += difference*difference;
+            }
+        }
+      break;
+    default:
+      for (i=0; (i < npixels) && !exceeded; i++)
+        {
+          exceeded=
+            ((fabs(first_pixels[i].red-(double) second_pixels[i].red)/MaxRGBDouble > context->limit) ||
+             (fabs(first_pixels[i].green-(double) second_pixels[i].green)/MaxRGBDouble > context->limit) ||
+             (fabs(first_pixels[i].blue-(double) second_pixels[i].blue)/MaxRGBDouble > context->limit) ||
+             ((first_image->matte) &&
+              (fabs(first_pixels[i].opacity-(double) second_pixels[i].opacity)/MaxRGBDouble > context->limit)));
+        }
+      break;
+    }
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ComputeDifferenceLimit)
+#endif
+  {
+    context->total += row_total;
+    if (exceeded || (context->total > context->limit))
+      context->exceeded=MagickTrue;
+    exceeded=context->exceeded;
+  }
+
+  /*
+    Returning failure stops the pixel iterator from processing more rows.
+  */
+  return (exceeded ? MagickFail : MagickPass);
+}
+
+MagickExport MagickPassFail
+CheckImageDifference(const Image *reference_image,
+                     const Image *compare_image,
+                     const MetricType metric,
+                     const double maximum_error,
+                     MagickBool *exceeded,
+                     ExceptionInfo *exception)
+{
+  DifferenceLimit
+    context;
+
+  double
+    number_samples;
+
+  MagickPassFail
+    status;
+
+  assert(reference_image != (const Image *) NULL);
+  assert(reference_image->signature == MagickSignature);
+  assert(compare_image != (const Image *) NULL);
+  assert(compare_image->signature == MagickSignature);
+  assert(exceeded != (MagickBool *) NULL);
+  assert(exception != (ExceptionInfo *) NULL);
+
+  *exceeded=MagickFalse;
+  if ((reference_image->columns != compare_image->columns) ||
+      (reference_image->rows != compare_image->rows))
+    {
+      ThrowException3(exception,ImageError,UnableToCompareImages,
+                      ImageSizeDiffers);
+      return MagickFail;
+    }
+
+  if ((StructuralSimilarityMetric == metric) ||
+      (MultiScaleStructuralSimilarityMetric == metric))
+    {
+      DifferenceStatistics
+        statistics;
+
+      status=GetImageChannelDifference(reference_image,compare_image,metric,
+                                       &statistics,exception);
+      if (status != MagickFail)
+        *exceeded=(statistics.combined < maximum_error);
+      return status;
+    }
+
+  /*
+    Convert the limit on the metric to a limit on the accumulated error.
+  */
+  number_samples=(double) reference_image->columns*reference_image->rows*
+    (3.0 + (reference_image->matte ? 1.0 : 0.0));
+  context.metric=metric;
+  context.total=0.0;
+  context.exceeded=MagickFalse;
+  switch (metric)
+    {
+    case MeanAbsoluteErrorMetric:
+    case MeanSquaredErrorMetric:
+      context.limit=maximum_error*number_samples;
+      break;
+    case PeakSignalToNoiseRatioMetric:
+      context.limit=pow(10.0,-maximum_error/10.0)*number_samples;
+      break;
+    case RootMeanSquaredErrorMetric:
+      context.limit=maximum_error*maximum_error*number_samples;
+      if (maximum_error < 0.0)
+        context.limit=-context.limit;
+      break;
+    default:
+      context.metric=PeakAbsoluteErrorMetric;
+      context.limit=maximum_error;
+      break;
+    }
+
+  status=PixelIterateDualRead(ComputeDifferenceLimit,
+                              NULL,
+                              "[%s]*[%s] Compare images...",
+                              &context,NULL,
+                              reference_image->columns,reference_image->rows,
+                              reference_image,0,0,
+                              compare_image,0,0,
+                              exception);
+  if ((context.metric != PeakAbsoluteErrorMetric) &&
+      (context.total > context.limit))
+    context.exceeded=MagickTrue;
+  if (context.exceeded && (exception->severity < ErrorException))
+    status=MagickPass;
+  *exceeded=context.exceeded;
+
+  return status;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -273,7 +519,9 @@ DifferenceImage(const Image *reference_image,const Image *compare_image,
 %
 %  GetImageChannelDifference() updates a user provided statistics structure
 %  with per-channel, and totalized, difference statistics corresponding
-%  to a specified comparison metric.
+%  to a specified comparison metric.  The structural similarity metrics
+%  (SSIM and MS-SSIM) report similarity rather than difference, so 1.0
+%  indicates identical images.
 %
 %  The format of the GetImageChannelDifference method is:
 %
@@ -485,6 +733,517 @@ ComputeSquaredError(void *mutable_data,
 
   return (MagickPass);
 }
+
+/*
+  Post-process accumulated difference statistics into the final values
+  for a metric.
+*/
+static void
+FinalizeDifferenceStatistics(const Image *reference_image,
+                             const MetricType metric,
+                             DifferenceStatistics *statistics)
+{
+  double
+    number_channels,
+    number_pixels;
+
+  number_channels=3.0 + (reference_image->matte ? 1.0 : 0.0);
+  number_pixels=(double) reference_image->columns*reference_image->rows;
+
+  if ((MeanAbsoluteErrorMetric == metric) ||
+      (MeanSquaredErrorMetric == metric) ||
+      (PeakSignalToNoiseRatioMetric == metric)||
+      (RootMeanSquaredErrorMetric == metric))
+    {
+      /*
+        Compute mean values.
+      */
+      statistics->combined=((statistics->red+statistics->green+
+                             statistics->blue+
+                             (reference_image->matte ? statistics->opacity : 0.0))/
+                            (number_pixels*number_channels));
+      statistics->red /= number_pixels;
+      statistics->green /= number_pixels;
+      statistics->blue /= number_pixels;
+      statistics->opacity /= number_pixels;
+    }
+
+  if (PeakAbsoluteErrorMetric == metric)
+    {
+      /*
+        Determine peak channel value
+      */
+      if (statistics->red > statistics->combined)
+        statistics->combined=statistics->red;
+
+      if (statistics->green > statistics->combined)
+        statistics->combined=statistics->green;
+
+      if (statistics->blue > statistics->combined)
+        statistics->combined=statistics->blue;
+
+      if ((reference_image->matte) && (statistics->opacity > statistics->combined))
+        statistics->combined=statistics->opacity;
+    }
+
+  if (PeakSignalToNoiseRatioMetric == metric)
+    {
+      /*
+        Compute PSNR.
+      */
+      statistics->red=(20.0 * log10(1.0/sqrt(statistics->red)));
+      statistics->green=(20.0 * log10(1.0/sqrt(statistics->green)));
+      statistics->blue=(20.0 * log10(1.0/sqrt(statistics->blue)));
+      statistics->opacity=(20.0 * log10(1.0/sqrt(statistics->opacity)));
+      statistics->combined=(20.0 * log10(1.0/sqrt(statistics->combined)));
+    }
+
+  if (RootMeanSquaredErrorMetric == metric)
+    {
+      /*
+        Compute RMSE.
+      */
+      statistics->red=sqrt(statistics->red);
+      statistics->green=sqrt(statistics->green);
+      statistics->blue=sqrt(statistics->blue);
+      statistics->opacity=sqrt(statistics->opacity);
+      statistics->combined=sqrt(statistics->combined);
+    }
+}
+
+/*
+  Compute the structural similarity (SSIM) of two images.
+
+  The local means, variances, and covariance are computed over uniform
+  square windows using running sums, so the cost per pixel does not
+  depend on the window size.  Column sums are maintained for a band of
+  output rows at a time, and bands are processed in parallel.  Each
+  channel is first exported to normalized floating point planes, which
+  are successively halved in size for the multi-scale variant
+  (MS-SSIM) using the scale weights of Wang, Simoncelli, and Bovik.
+*/
+#define SimilarityWindow 8
+#define SimilarityBandRows 32
+#define SimilarityScales 5
+#define SimilarityC1 (0.01*0.01)
+#define SimilarityC2 (0.03*0.03)
+
+static const double
+  SimilarityScaleWeights[SimilarityScales] =
+  {
+    0.0448, 0.2856, 0.3001, 0.2363, 0.1333
+  };
+
+static MagickPassFail
+ExportSimilarityPlane(const Image *image,const ChannelType channel,
+                      float *plane,ExceptionInfo *exception)
+{
+  long
+    y;
+
+  MagickPassFail
+    status=MagickPass;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for schedule(static,16) shared(status)
+#endif
+  for (y=0; y < (long) image->rows; y++)
+    {
+      const PixelPacket
+        *p;
+
+      register float
+        *q;
+
+      register long
+        x;
+
+      MagickPassFail
+        thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ExportSimilarityPlane)
+#endif
+      thread_status=status;
+      if (thread_status == MagickFail)
+        continue;
+
+      p=AcquireImagePixels(image,0,y,image->columns,1,exception);
+      if (p == (const PixelPacket *) NULL)
+        thread_status=MagickFail;
+
+      if (thread_status != MagickFail)
+        {
+          q=plane+y*(long) image->columns;
+          switch (channel)
+            {
+            case RedChannel:
+              for (x=0; x < (long) image->columns; x++)
+                q[x]=(float) (p[x].red/MaxRGBDouble);
+              break;
+            case GreenChannel:
+              for (x=0; x < (long) image->columns; x++)
+                q[x]=(float) (p[x].green/MaxRGBDouble);
+              break;
+            case BlueChannel:
+              for (x=0; x < (long) image->columns; x++)
+                q[x]=(float) (p[x].blue/MaxRGBDouble);
+              break;
+            default:
+              for (x=0; x < (long) image->columns; x++)
+                q[x]=(float) (p[x].opacity/MaxRGBDouble);
+              break;
+            }
+        }
+
+      if (thread_status == MagickFail)
+        {
+          status=MagickFail;
+#if defined(HAVE_OPENMP)
+#  pragma omp flush (status)
+#endif
+        }
+    }
+
+  return status;
+}
+
+/*
+  Halve the size of a plane in place by averaging 2x2 blocks.
+*/
+static void
+ReduceSimilarityPlane(float *plane,long *columns,long *rows)
+{
+  long
+    reduced_columns,
+    reduced_rows,
+    x,
+    y;
+
+  reduced_columns=(*columns)/2;
+  reduced_rows=(*rows)/2;
+  for (y=0; y < reduced_rows; y++)
+    {
+      const float
+        *p;
+
+      p=plane+2*y*(*columns);
+      for (x=0; x < reduced_columns; x++)
+        plane[y*reduced_columns+x]=
+          0.25f*(p[2*x]+p[2*x+1]+p[*columns+2*x]+p[*columns+2*x+1]);
+    }
+  *columns=reduced_columns;
+  *rows=reduced_rows;
+}
+
+/*
+  Compute the mean SSIM, and the mean contrast-structure term, over all
+  window positions.
+*/
+static MagickPassFail
+ComputeSimilarity(const float *first,const float *second,const long columns,
+                  const long rows,double *similarity,
+                  double *contrast_structure)
+{
+  double
+    contrast_structure_sum=0.0,
+    similarity_sum=0.0;
+
+  long
+    band,
+    bands,
+    output_columns,
+    output_rows,
+    window;
+
+  MagickPassFail
+    status=MagickPass;
+
+  window=Min(SimilarityWindow,Min(columns,rows));
+  output_columns=columns-window+1;
+  output_rows=rows-window+1;
+  bands=(output_rows+SimilarityBandRows-1)/SimilarityBandRows;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for schedule(static,1) shared(contrast_structure_sum, similarity_sum, status)
+#endif
+  for (band=0; band < bands; band++)
+    {
+      double
+        band_contrast_structure=0.0,
+        band_similarity=0.0,
+        *sums;
+
+      register double
+        *sum_x,
+        *sum_xx,
+        *sum_xy,
+        *sum_y,
+        *sum_yy;
+
+      long
+        first_row,
+        last_row,
+        row,
+        x;
+
+      first_row=band*SimilarityBandRows;
+      last_row=Min(first_row+SimilarityBandRows,output_rows);
+      sums=MagickAllocateArray(double *,5*(size_t) columns,sizeof(double));
+      if (sums == (double *) NULL)
+        {
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ComputeSimilarity)
+#endif
+          status=MagickFail;
+          continue;
+        }
+      (void) memset(sums,0,5*(size_t) columns*sizeof(double));
+      sum_x=sums;
+      sum_y=sum_x+columns;
+      sum_xx=sum_y+columns;
+      sum_yy=sum_xx+columns;
+      sum_xy=sum_yy+columns;
+
+      /*
+        Column sums over the first window of rows in the band.
+      */
+      for (row=first_row; row < first_row+window; row++)
+        {
+          const float
+            *p=first+row*columns,
+            *q=second+row*columns;
+
+          for (x=0; x < columns; x++)
+            {
+              sum_x[x]+=p[x];
+              sum_y[x]+=q[x];
+              sum_xx[x]+=(double) p[x]*p[x];
+              sum_yy[x]+=(double) q[x]*q[x];
+              sum_xy[x]+=(double) p[x]*q[x];
+            }
+        }
+      for (row=first_row; row < last_row; row++)
+        {
+          double
+            window_x=0.0,
+            window_xx=0.0,
+            window_xy=0.0,
+            window_y=0.0,
+            window_yy=0.0;
+
+          const double
+            scale=1.0/((double) window*window);
+
+          if (row != first_row)
+            {
+              /*
+                Slide the column sums down by one row.
+              */
+              const float
+                *p=first+(row-1)*columns,
+                *q=second+(row-1)*columns,
+                *r=first+(row+window-1)*columns,
+                *s=second+(row+window-1)*columns;
+
+              for (x=0; x < columns; x++)
+                {
+                  sum_x[x]+=(double) r[x]-p[x];
+                  sum_y[x]+=(double) s[x]-q[x];
+                  sum_xx[x]+=(double) r[x]*r[x]-(double) p[x]*p[x];
+                  sum_yy[x]+=(double) s[x]*s[x]-(double) q[x]*q[x];
+                  sum_xy[x]+=(double) r[x]*s[x]-(double) p[x]*q[x];
+                }
+            }
+          for (x=0; x < window; x++)
+            {
+              window_x+=sum_x[x];
+              window_y+=sum_y[x];
+              window_xx+=sum_xx[x];
+              window_yy+=sum_yy[x];
+              window_xy+=sum_xy[x];
+            }
+          for (x=0; x < output_columns; x++)
+            {
+              double
+                covariance,
+                mean_x,
+                mean_y,
+                structure,
+                variance_x,
+                variance_y;
+
+              if (x != 0)
+                {
+                  window_x+=sum_x[x+window-1]-sum_x[x-1];
+                  window_y+=sum_y[x+window-1]-sum_y[x-1];
+                  window_xx+=sum_xx[x+window-1]-sum_xx[x-1];
+                  window_yy+=sum_yy[x+window-1]-sum_yy[x-1];
+                  window_xy+=sum_xy[x+window-1]-sum_xy[x-1];
+                }
+              mean_x=window_x*scale;
+              mean_y=window_y*scale;
+              variance_x=window_xx*scale-mean_x*mean_x;
+              variance_y=window_yy*scale-mean_y*mean_y;
+              covariance=window_xy*scale-mean_x*mean_y;
+              structure=(2.0*covariance+SimilarityC2)/
+                (variance_x+variance_y+SimilarityC2);
+              band_contrast_structure+=structure;
+              band_similarity+=structure*(2.0*mean_x*mean_y+SimilarityC1)/
+                (mean_x*mean_x+mean_y*mean_y+SimilarityC1);
+            }
+        }
+      MagickFreeMemory(sums);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ComputeSimilarity)
+#endif
+      {
+        contrast_structure_sum+=band_contrast_structure;
+        similarity_sum+=band_similarity;
+      }
+    }
+
+  *similarity=similarity_sum/((double) output_columns*output_rows);
+  *contrast_structure=contrast_structure_sum/
+    ((double) output_columns*output_rows);
+
+  return status;
+}
+
+/*
+  Compute SSIM or MS-SSIM for one channel.
+*/
+static MagickPassFail
+GetChannelSimilarity(const Image *reference_image,const Image *compare_image,
+                     const ChannelType channel,const MetricType metric,
+                     float *first,float *second,double *similarity,
+                     ExceptionInfo *exception)
+{
+  double
+    contrast_structure,
+    scale_similarity,
+    weight_sum=0.0;
+
+  long
+    columns,
+    rows,
+    scale,
+    scales=1;
+
+  MagickPassFail
+    status;
+
+  *similarity=0.0;
+  columns=(long) reference_image->columns;
+  rows=(long) reference_image->rows;
+  status=ExportSimilarityPlane(reference_image,channel,first,exception);
+  if (status != MagickFail)
+    status=ExportSimilarityPlane(compare_image,channel,second,exception);
+  if (status == MagickFail)
+    return status;
+
+  if (metric == StructuralSimilarityMetric)
+    return ComputeSimilarity(first,second,columns,rows,similarity,
+                             &contrast_structure);
+
+  /*
+    Use as many scales as the image size allows, renormalizing the
+    weights of the scales used.
+  */
+  while ((scales < SimilarityScales) &&
+         ((columns >> scales) >= SimilarityWindow) &&
+         ((rows >> scales) >= SimilarityWindow))
+    scales++;
+  for (scale=0; scale < scales; scale++)
+    weight_sum+=SimilarityScaleWeights[scale];
+  *similarity=1.0;
+  for (scale=0; scale < scales; scale++)
+    {
+      status=ComputeSimilarity(first,second,columns,rows,&scale_similarity,
+                               &contrast_structure);
+      if (status == MagickFail)
+        break;
+      if (scale == scales-1)
+        {
+          *similarity*=pow(Max(scale_similarity,0.0),
+                           SimilarityScaleWeights[scale]/weight_sum);
+        }
+      else
+        {
+          long
+            reduced_columns=columns,
+            reduced_rows=rows;
+
+          *similarity*=pow(Max(contrast_structure,0.0),
+                           SimilarityScaleWeights[scale]/weight_sum);
+          ReduceSimilarityPlane(first,&reduced_columns,&reduced_rows);
+          ReduceSimilarityPlane(second,&columns,&rows);
+        }
+    }
+
+  return status;
+}
+
+static MagickPassFail
+GetImageSimilarity(const Image *reference_image,const Image *compare_image,
+                   const MetricType metric,DifferenceStatistics *statistics,
+                   ExceptionInfo *exception)
+{
+  float
+    *first,
+    *second;
+
+  size_t
+    number_pixels;
+
+  MagickPassFail
+    status=MagickPass;
+
+  if ((reference_image->columns != compare_image->columns) ||
+      (reference_image->rows != compare_image->rows))
+    {
+      ThrowException3(exception,ImageError,UnableToCompareImages,
+                      ImageSizeDiffers);
+      return MagickFail;
+    }
+  number_pixels=(size_t) reference_image->columns*reference_image->rows;
+  first=MagickAllocateArray(float *,number_pixels,sizeof(float));
+  second=MagickAllocateArray(float *,number_pixels,sizeof(float));
+  if ((first == (float *) NULL) || (second == (float *) NULL))
+    {
+      MagickFreeMemory(first);
+      MagickFreeMemory(second);
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     reference_image->filename);
+      return MagickFail;
+    }
+
+  status=GetChannelSimilarity(reference_image,compare_image,RedChannel,
+                              metric,first,second,&statistics->red,exception);
+  if (status != MagickFail)
+    status=GetChannelSimilarity(reference_image,compare_image,GreenChannel,
+                                metric,first,second,&statistics->green,
+                                exception);
+  if (status != MagickFail)
+    status=GetChannelSimilarity(reference_image,compare_image,BlueChannel,
+                                metric,first,second,&statistics->blue,
+                                exception);
+  statistics->opacity=1.0;
+  if ((status != MagickFail) && (reference_image->matte))
+    status=GetChannelSimilarity(reference_image,compare_image,OpacityChannel,
+                                metric,first,second,&statistics->opacity,
+                                exception);
+  statistics->combined=(statistics->red+statistics->green+statistics->blue+
+                        (reference_image->matte ? statistics->opacity : 0.0))/
+    (3.0 + (reference_image->matte ? 1.0 : 0.0));
+
+  MagickFreeMemory(first);
+  MagickFreeMemory(second);
+
+  return status;
+}
+
 MagickExport MagickPassFail
 GetImageChannelDifference(const Image *reference_image,
                           const Image *compare_image,
@@ -507,6 +1266,11 @@ GetImageChannelDifference(const Image *reference_image,
 
   InitializeDifferenceStatistics(statistics,exception);
 
+  if ((StructuralSimilarityMetric == metric) ||
+      (MultiScaleStructuralSimilarityMetric == metric))
+    return GetImageSimilarity(reference_image,compare_image,metric,
+                              statistics,exception);
+
   /*
     Select basic differencing function to use.
   */
@@ -529,14 +1293,13 @@ GetImageChannelDifference(const Image *reference_image,
     case RootMeanSquaredErrorMetric:
       call_back=ComputeSquaredError;
       break;
+    case StructuralSimilarityMetric:
+    case MultiScaleStructuralSimilarityMetric:
+      break;
     }
 
   if (call_back != (PixelIteratorDualReadCallback) NULL)
     {
-      double
-        number_channels,
-        number_pixels;
-
       char
         description[MaxTextExtent];
       
@@ -551,72 +1314,7 @@ GetImageChannelDifference(const Image *reference_image,
                                   reference_image,0,0,
                                   compare_image,0,0,
                                   exception);
-      /*
-        Post-process statistics (as required)
-      */
-
-      number_channels=3.0 + (reference_image->matte ? 1.0 : 0.0);
-      number_pixels=(double) reference_image->columns*reference_image->rows;
-
-      if ((MeanAbsoluteErrorMetric == metric) ||
-          (MeanSquaredErrorMetric == metric) ||
-          (PeakSignalToNoiseRatioMetric == metric)||
-          (RootMeanSquaredErrorMetric == metric))
-        {
-          /*
-            Compute mean values.
-          */
-          statistics->combined=((statistics->red+statistics->green+
-                                 statistics->blue+
-                                 (reference_image->matte ? statistics->opacity : 0.0))/
-                                (number_pixels*number_channels));
-          statistics->red /= number_pixels;
-          statistics->green /= number_pixels;
-          statistics->blue /= number_pixels;
-          statistics->opacity /= number_pixels;
-        }
-
-      if (PeakAbsoluteErrorMetric == metric)
-        {
-          /*
-            Determine peak channel value
-          */
-          if (statistics->red > statistics->combined)
-            statistics->combined=statistics->red;
-
-          if (statistics->green > statistics->combined)
-            statistics->combined=statistics->green;
-
-          if (statistics->blue > statistics->combined)
-            statistics->combined=statistics->blue;
-
-          if ((reference_image->matte) && (statistics->opacity > statistics->combined))
-            statistics->combined=statistics->opacity;
-        }
-
-      if (PeakSignalToNoiseRatioMetric == metric)
-        {
-          /*
-            Compute PSNR.
-          */
-          statistics->red=(20.0 * log10(1.0/sqrt(statistics->red)));
-          statistics->green=(20.0 * log10(1.0/sqrt(statistics->green)));
-          statistics->blue=(20.0 * log10(1.0/sqrt(statistics->blue)));
-          statistics->opacity=(20.0 * log10(1.0/sqrt(statistics->opacity)));
-          statistics->combined=(20.0 * log10(1.0/sqrt(statistics->combined)));
-        }
-
-      if (RootMeanSquaredErrorMetric == metric)
-        {
-          /*
-            Compute RMSE.
-          */
-          statistics->red=sqrt(statistics->red);
-          statistics->green=sqrt(statistics->green);
-          statistics->blue=sqrt(statistics->blue);
-          statistics->opacity=sqrt(statistics->opacity);
-          statistics->combined=sqrt(statistics->combined);
-        }
+      FinalizeDifferenceStatistics(reference_image,metric,statistics);
     }
 
   return status;
@@ -709,6 +1407,201 @@ GetImageChannelDistortion(const Image *reference_image,
     return status;
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   G e t I m a g e C o m p a r i s o n S t a t i s t i c s                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetImageComparisonStatistics() computes the statistics of both images
+%  (as returned by GetImageStatistics()) along with the per-channel, and
+%  totalized, difference statistics for every comparison metric.  All of
+%  the values are gathered during a single pass over the two images, which
+%  is much faster than requesting each of them separately.
+%
+%  The format of the GetImageComparisonStatistics method is:
+%
+%      MagickPassFail GetImageComparisonStatistics(const Image *reference_image,
+%                                     const Image *compare_image,
+%                                     ImageComparisonStatistics *statistics,
+%                                     ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o reference_image: the reference image.
+%
+%    o compare_image: the comparison image.
+%
+%    o statistics: the statistics structure to populate.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+typedef struct _ComparisonAccumulator
+{
+  StatisticsAccumulator
+    reference,
+    compare;
+
+  DifferenceStatistics
+    absolute,
+    peak,
+    squared;
+} ComparisonAccumulator;
+
+static MagickPassFail
+ComputeComparisonStatistics(void *mutable_data,
+                            const void *immutable_data,
+                            const Image *first_image,
+                            const PixelPacket *first_pixels,
+                            const IndexPacket *first_indexes,
+                            const Image *second_image,
+                            const PixelPacket *second_pixels,
+                            const IndexPacket *second_indexes,
+                            const long npixels,
+                            ExceptionInfo *exception)
+{
+  ComparisonAccumulator
+    laccumulator,
+    *accumulator = (ComparisonAccumulator *) mutable_data;
+
+  double
+    difference;
+
+  register long
+    i;
+
+  ARG_NOT_USED(immutable_data);
+  ARG_NOT_USED(first_image);
+  ARG_NOT_USED(first_indexes);
+  ARG_NOT_USED(second_image);
+  ARG_NOT_USED(second_indexes);
+
+  InitializeStatisticsAccumulator(&laccumulator.reference,
+                                  accumulator->reference.process_opacity);
+  InitializeStatisticsAccumulator(&laccumulator.compare,
+                                  accumulator->compare.process_opacity);
+  AccumulateImageStatistics(&laccumulator.reference,first_pixels,npixels);
+  AccumulateImageStatistics(&laccumulator.compare,second_pixels,npixels);
+
+  InitializeDifferenceStatistics(&laccumulator.absolute,exception);
+  InitializeDifferenceStatistics(&laccumulator.peak,exception);
+  InitializeDifferenceStatistics(&laccumulator.squared,exception);
+#define AccumulateChannelDifference(member)                             \
+  difference=fabs(first_pixels[i].member-(double) second_pixels[i].member)/MaxRGBDouble; \
+  laccumulator.absolute.member += difference;                           \
+  laccumulator.squared.member += difference*difference;                 \
+  if (difference > laccumulator.peak.member)                            \
+    laccumulator.peak.member=difference;
+
+  for (i=0; i < npixels; i++)
+    {
+      AccumulateChannelDifference(red);
+      AccumulateChannelDifference(green);
+      AccumulateChannelDifference(blue);
+      AccumulateChannelDifference(opacity);
+    }
+#undef AccumulateChannelDifference
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ComputeComparisonStatistics)
+#endif
+  {
+    MergeStatisticsAccumulators(&accumulator->reference,
+                                &laccumulator.reference);
+    MergeStatisticsAccumulators(&accumulator->compare,
+                                &laccumulator.compare);
+
+    accumulator->absolute.red += laccumulator.absolute.red;
+    accumulator->absolute.green += laccumulator.absolute.green;
+    accumulator->absolute.blue += laccumulator.absolute.blue;
+    accumulator->absolute.opacity += laccumulator.absolute.opacity;
+
+    accumulator->squared.red += laccumulator.squared.red;
+    accumulator->squared.green += laccumulator.squared.green;
+    accumulator->squared.blue += laccumulator.squared.blue;
+    accumulator->squared.opacity += laccumulator.squared.opacity;
+
+    if (laccumulator.peak.red > accumulator->peak.red)
+      accumulator->peak.red=laccumulator.peak.red;
+    if (laccumulator.peak.green > accumulator->peak.green)
+      accumulator->peak.green=laccumulator.peak.green;
+    if (laccumulator.peak.blue > accumulator->peak.blue)
+      accumulator->peak.blue=laccumulator.peak.blue;
+    if (laccumulator.peak.opacity > accumulator->peak.opacity)
+      accumulator->peak.opacity=laccumulator.peak.opacity;
+  }
+
+  return (MagickPass);
+}
+
+MagickExport MagickPassFail
+GetImageComparisonStatistics(const Image *reference_image,
+                             const Image *compare_image,
+                             ImageComparisonStatistics *statistics,
+                             ExceptionInfo *exception)
+{
+  ComparisonAccumulator
+    accumulator;
+
+  MagickPassFail
+    status;
+
+  assert(reference_image != (const Image *) NULL);
+  assert(reference_image->signature == MagickSignature);
+  assert(compare_image != (const Image *) NULL);
+  assert(compare_image->signature == MagickSignature);
+  assert(statistics != (ImageComparisonStatistics *) NULL);
+  assert(exception != (ExceptionInfo *) NULL);
+
+  InitializeStatisticsAccumulator(&accumulator.reference,
+                                  ((reference_image->matte) ||
+                                   (reference_image->colorspace ==
+                                    CMYKColorspace)));
+  InitializeStatisticsAccumulator(&accumulator.compare,
+                                  ((compare_image->matte) ||
+                                   (compare_image->colorspace ==
+                                    CMYKColorspace)));
+  InitializeDifferenceStatistics(&accumulator.absolute,exception);
+  InitializeDifferenceStatistics(&accumulator.peak,exception);
+  InitializeDifferenceStatistics(&accumulator.squared,exception);
+
+  status=PixelIterateDualRead(ComputeComparisonStatistics,
+                              NULL,
+                              "[%s]*[%s] Compute image comparison statistics...",
+                              &accumulator,NULL,
+                              reference_image->columns,reference_image->rows,
+                              reference_image,0,0,
+                              compare_image,0,0,
+                              exception);
+
+  FinalizeStatisticsAccumulator(&accumulator.reference,&statistics->reference);
+  FinalizeStatisticsAccumulator(&accumulator.compare,&statistics->compare);
+
+  statistics->mean_absolute_error=accumulator.absolute;
+  FinalizeDifferenceStatistics(reference_image,MeanAbsoluteErrorMetric,
+                               &statistics->mean_absolute_error);
+  statistics->peak_absolute_error=accumulator.peak;
+  FinalizeDifferenceStatistics(reference_image,PeakAbsoluteErrorMetric,
+                               &statistics->peak_absolute_error);
+  statistics->mean_squared_error=accumulator.squared;
+  FinalizeDifferenceStatistics(reference_image,MeanSquaredErrorMetric,
+                               &statistics->mean_squared_error);
+  statistics->peak_signal_to_noise_ratio=accumulator.squared;
+  FinalizeDifferenceStatistics(reference_image,PeakSignalToNoiseRatioMetric,
+                               &statistics->peak_signal_to_noise_ratio);
+  statistics->root_mean_squared_error=accumulator.squared;
+  FinalizeDifferenceStatistics(reference_image,RootMeanSquaredErrorMetric,
+                               &statistics->root_mean_squared_error);
+
+  return status;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -841,6 +1734,9 @@ ComputePixelError(void *mutable_data,
   ARG_NOT_USED(second_indexes);
   ARG_NOT_USED(exception);
 
+  if (memcmp(first_pixels,second_pixels,npixels*sizeof(PixelPacket)) == 0)
+    return (MagickPass);
+
   stats_maximum=0.0;
   stats_total=0.0;
 
@@ -10,6 +10,8 @@
 #ifndef _MAGICK_COMPARE_H
 #define _MAGICK_COMPARE_H
 
+#include "magick/statistics.h"
+
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
 #endif /* defined(__cplusplus) || defined(c_plusplus) */
@@ -52,7 +54,9 @@ typedef enum
   MeanSquaredErrorMetric,
   PeakAbsoluteErrorMetric,
   PeakSignalToNoiseRatioMetric,
-  RootMeanSquaredErrorMetric
+  RootMeanSquaredErrorMetric,
+  StructuralSimilarityMetric,
+  MultiScaleStructuralSimilarityMetric
 } MetricType;
 
 /*
@@ -73,6 +77,12 @@ extern MagickExport void
                                  ExceptionInfo *exception);
 
 extern MagickExport MagickPassFail
+  CheckImageDifference(const Image *reference_image,
+                       const Image *compare_image,
+                       const MetricType metric,
+                       const double maximum_error,
+                       MagickBool *exceeded,
+                       ExceptionInfo *exception),
   GetImageChannelDifference(const Image *reference_image,
                             const Image *compare_image,
                             const MetricType metric,
@@ -90,6 +100,30 @@ extern MagickExport MagickPassFail
                      double *distortion,
                      ExceptionInfo *exception);
 
+/*
+  Statistics of both images, and all difference metrics, as computed in
+  a single pass by GetImageComparisonStatistics().
+*/
+typedef struct _ImageComparisonStatistics
+{
+  ImageStatistics
+    reference,                  /* Reference image statistics */
+    compare;                    /* Comparison image statistics */
+
+  DifferenceStatistics
+    mean_absolute_error,        /* MAE */
+    mean_squared_error,         /* MSE */
+    peak_absolute_error,        /* PAE */
+    peak_signal_to_noise_ratio, /* PSNR */
+    root_mean_squared_error;    /* RMSE */
+} ImageComparisonStatistics;
+
+extern MagickExport MagickPassFail
+  GetImageComparisonStatistics(const Image *reference_image,
+                               const Image *compare_image,
+                               ImageComparisonStatistics *statistics,
+                               ExceptionInfo *exception);
+
 extern MagickExport MagickBool
   IsImagesEqual(Image *,const Image *);
 
@@ -0,0 +1,492 @@
+/*
+  Copyright (C) 2026 GraphicsMagick Group
+ 
+  This program is covered by multiple licenses, which are described in
+  Copyright.txt. You should have received a copy of Copyright.txt with this
+  package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ 
+  GraphicsMagick Configuration File Snapshot Methods.
+*/
+
+/*
+  Include declarations.
+*/
+#include "magick/studio.h"
+#include "magick/blob.h"
+#include "magick/config_snapshot.h"
+#include "magick/log.h"
+#include "magick/utility.h"
+#include "magick/version.h"
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   C o n f i g u r e   S n a p s h o t s                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  A configuration snapshot saves the entries which were parsed from a
+%  configuration file (such as type.mgk), and from the files it includes,
+%  so that later processes may memory map the entries rather than parse
+%  the files again.  Snapshots are kept in the directory specified by the
+%  MAGICK_CONFIGURE_SNAPSHOT_PATH environment variable, and are not used
+%  if it is not set.  A snapshot is used only if it was written by the
+%  same library release, and if the configuration file is found at the
+%  same path and none of its source files have changed size or
+%  modification time since.  Otherwise the files are parsed and the
+%  snapshot is replaced.
+%
+%  A snapshot file contains magick_uint32_t values in native byte order:
+%  a header (magick, library version, entry format version, fields per
+%  entry, number of entries, number of sources, and string table length),
+%  the path, size, and modification time of each source, the fields of
+%  each entry, and finally the string table.  Size and modification time
+%  are stored as two values (low then high 32 bits).  A string is stored
+%  as one plus its offset in the string table, or zero for NULL.
+%
+*/
+#define ConfigureSnapshotMagick 0x534d4347U
+#define ConfigureSnapshotHeaderValues 7U
+#define ConfigureSnapshotSourceValues 5U
+
+/*
+  Form the path of the snapshot of a configuration file, returning
+  MagickFalse if snapshots are not enabled.
+*/
+static MagickBool GetConfigureSnapshotPath(const char *filename,char *path)
+{
+  const char
+    *directory;
+
+  size_t
+    length;
+
+  directory=getenv("MAGICK_CONFIGURE_SNAPSHOT_PATH");
+  if ((directory == (const char *) NULL) || (*directory == '\0'))
+    return(MagickFalse);
+  length=strlen(directory);
+  FormatString(path,"%.1024s%s%.1024s.snapshot",directory,
+               directory[length-1] == *DirectorySeparator ? "" :
+               DirectorySeparator,filename);
+  return(MagickTrue);
+}
+
+/*
+  Append a value to a snapshot which is being built.
+*/
+static void AppendConfigureSnapshotValue(ConfigureSnapshot *snapshot,
+  const magick_uint32_t value)
+{
+  if (snapshot->values_length == snapshot->values_allocated)
+    {
+      snapshot->values_allocated=Max(256,2*snapshot->values_allocated);
+      MagickReallocMemory(magick_uint32_t *,snapshot->values,
+                          MagickArraySize(snapshot->values_allocated,
+                                          sizeof(magick_uint32_t)));
+      if (snapshot->values == (magick_uint32_t *) NULL)
+        MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+                          UnableToAllocateString);
+    }
+  snapshot->values[snapshot->values_length++]=value;
+}
+
+/*
+  Append a string to the string table of a snapshot which is being built,
+  returning the value which refers to it.
+*/
+static magick_uint32_t AppendConfigureSnapshotString(ConfigureSnapshot *snapshot,
+  const char *string)
+{
+  magick_uint32_t
+    offset;
+
+  size_t
+    length;
+
+  if (string == (const char *) NULL)
+    return(0U);
+  length=strlen(string)+1;
+  if (snapshot->strings_length+length > snapshot->strings_allocated)
+    {
+      snapshot->strings_allocated=Max(4096,2*(snapshot->strings_length+length));
+      MagickReallocMemory(char *,snapshot->strings,
+                          snapshot->strings_allocated);
+      if (snapshot->strings == (char *) NULL)
+        MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+                          UnableToAllocateString);
+    }
+  offset=(magick_uint32_t) snapshot->strings_length;
+  (void) memcpy(snapshot->strings+offset,string,length);
+  snapshot->strings_length+=length;
+  return(offset+1U);
+}
+
+/*
+  Return the string referred to by a value, or NULL.
+*/
+static const char *ConfigureSnapshotValueString(const ConfigureSnapshot *snapshot,
+  const magick_uint32_t value)
+{
+  if ((value == 0U) || (value > snapshot->strings_length))
+    return((const char *) NULL);
+  return(snapshot->strings+value-1);
+}
+
+/*
+  Initialize an empty snapshot.
+*/
+static void InitializeConfigureSnapshot(ConfigureSnapshot *snapshot,
+  const unsigned int version,const unsigned int fields,
+  const MagickBool enabled)
+{
+  assert(fields > 0);
+  (void) memset(snapshot,0,sizeof(ConfigureSnapshot));
+  snapshot->version=version;
+  snapshot->fields=fields;
+  snapshot->enabled=enabled;
+}
+
+void AddConfigureSnapshotSource(ConfigureSnapshot *snapshot,const char *path)
+{
+  MagickStatStruct_t
+    attributes;
+
+  magick_uint64_t
+    modified = 0,
+    size = 0;
+
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  if (!snapshot->enabled)
+    return;
+  assert(snapshot->values_length ==
+         snapshot->sources*ConfigureSnapshotSourceValues);
+  if (MagickStat(path,&attributes) == 0)
+    {
+      size=(magick_uint64_t) attributes.st_size;
+      modified=(magick_uint64_t) attributes.st_mtime;
+    }
+  AppendConfigureSnapshotValue(snapshot,
+                               AppendConfigureSnapshotString(snapshot,path));
+  AppendConfigureSnapshotValue(snapshot,(magick_uint32_t) size);
+  AppendConfigureSnapshotValue(snapshot,(magick_uint32_t) (size >> 32));
+  AppendConfigureSnapshotValue(snapshot,(magick_uint32_t) modified);
+  AppendConfigureSnapshotValue(snapshot,(magick_uint32_t) (modified >> 32));
+  snapshot->sources++;
+}
+
+void AddConfigureSnapshotString(ConfigureSnapshot *snapshot,const char *string)
+{
+  size_t
+    previous;
+
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  if (!snapshot->enabled)
+    return;
+  /*
+    Share the string with the same field of the previous entry (e.g. the
+    path of the file the entry is from) if it is the same.
+  */
+  previous=snapshot->values_length-snapshot->fields;
+  if ((string != (const char *) NULL) &&
+      (snapshot->values_length >=
+       snapshot->sources*ConfigureSnapshotSourceValues+snapshot->fields))
+    {
+      const char
+        *previous_string;
+
+      previous_string=ConfigureSnapshotValueString(snapshot,
+                                                   snapshot->values[previous]);
+      if ((previous_string != (const char *) NULL) &&
+          (strcmp(previous_string,string) == 0))
+        {
+          AppendConfigureSnapshotValue(snapshot,snapshot->values[previous]);
+          return;
+        }
+    }
+  AppendConfigureSnapshotValue(snapshot,
+                               AppendConfigureSnapshotString(snapshot,string));
+}
+
+void AddConfigureSnapshotValue(ConfigureSnapshot *snapshot,
+  const magick_uint32_t value)
+{
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  if (snapshot->enabled)
+    AppendConfigureSnapshotValue(snapshot,value);
+}
+
+MagickPassFail WriteConfigureSnapshot(ConfigureSnapshot *snapshot,
+  const char *filename)
+{
+  char
+    path[MaxTextExtent],
+    temporary_path[MaxTextExtent];
+
+  int
+    file;
+
+  magick_uint32_t
+    header[ConfigureSnapshotHeaderValues];
+
+  MagickPassFail
+    status;
+
+  size_t
+    entry_values,
+    length,
+    offset;
+
+  ssize_t
+    count;
+
+  unsigned char
+    *blob;
+
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  if (!snapshot->enabled || !GetConfigureSnapshotPath(filename,path))
+    return(MagickFail);
+  entry_values=snapshot->values_length-
+    snapshot->sources*ConfigureSnapshotSourceValues;
+  header[0]=ConfigureSnapshotMagick;
+  header[1]=MagickLibVersion;
+  header[2]=snapshot->version;
+  header[3]=snapshot->fields;
+  header[4]=(magick_uint32_t) (entry_values/snapshot->fields);
+  header[5]=snapshot->sources;
+  header[6]=(magick_uint32_t) snapshot->strings_length;
+  length=sizeof(header)+snapshot->values_length*sizeof(magick_uint32_t)+
+    snapshot->strings_length;
+  blob=MagickAllocateMemory(unsigned char *,length);
+  if (blob == (unsigned char *) NULL)
+    return(MagickFail);
+  (void) memcpy(blob,header,sizeof(header));
+  (void) memcpy(blob+sizeof(header),snapshot->values,
+                snapshot->values_length*sizeof(magick_uint32_t));
+  (void) memcpy(blob+sizeof(header)+
+                snapshot->values_length*sizeof(magick_uint32_t),
+                snapshot->strings,snapshot->strings_length);
+  /*
+    Write to a temporary file which replaces the snapshot, so that a
+    concurrent process never maps a partially written snapshot.  The
+    snapshot is data, so it is not created executable.
+  */
+  FormatString(temporary_path,"%.1024s.%ld",path,(long) getpid());
+  status=MagickFail;
+  file=open(temporary_path,O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,0644);
+  if (file != -1)
+    {
+      status=MagickPass;
+      for (offset=0; offset < length; offset+=(size_t) count)
+        {
+          count=write(file,blob+offset,
+                      (MAGICK_POSIX_IO_SIZE_T) (length-offset));
+          if (count <= 0)
+            {
+              status=MagickFail;
+              break;
+            }
+        }
+      if (close(file) != 0)
+        status=MagickFail;
+      if ((status != MagickFail) && (rename(temporary_path,path) != 0))
+        status=MagickFail;
+      if (status == MagickFail)
+        (void) remove(temporary_path);
+    }
+  MagickFreeMemory(blob);
+  (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                        "%s configuration snapshot \"%s\" (%lu entries)",
+                        status != MagickFail ? "Wrote" : "Failed to write",
+                        path,(unsigned long) header[4]);
+  return(status);
+}
+
+MagickPassFail OpenConfigureSnapshot(ConfigureSnapshot *snapshot,
+  const char *filename,const char *path,const unsigned int version,
+  const unsigned int fields)
+{
+  char
+    snapshot_path[MaxTextExtent];
+
+  const magick_uint32_t
+    *header;
+
+  const char
+    *reason;
+
+  int
+    file;
+
+  MagickStatStruct_t
+    attributes;
+
+  magick_uint32_t
+    i;
+
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  InitializeConfigureSnapshot(snapshot,version,fields,MagickFalse);
+  if (!GetConfigureSnapshotPath(filename,snapshot_path))
+    return(MagickFail);
+  snapshot->enabled=MagickTrue;
+  file=open(snapshot_path,O_RDONLY | O_BINARY);
+  if (file == -1)
+    return(MagickFail);
+  if ((MagickFstat(file,&attributes) != 0) ||
+      ((size_t) attributes.st_size <
+       ConfigureSnapshotHeaderValues*sizeof(magick_uint32_t)))
+    {
+      (void) close(file);
+      return(MagickFail);
+    }
+  snapshot->map_length=(size_t) attributes.st_size;
+  snapshot->map=MapBlob(file,ReadMode,0,snapshot->map_length);
+  snapshot->mapped=(snapshot->map != (void *) NULL);
+  if (!snapshot->mapped)
+    {
+      snapshot->map=MagickAllocateMemory(void *,snapshot->map_length);
+      if ((snapshot->map != (void *) NULL) &&
+          (read(file,snapshot->map,snapshot->map_length) !=
+           (ssize_t) snapshot->map_length))
+        MagickFreeMemory(snapshot->map);
+    }
+  (void) close(file);
+  if (snapshot->map == (void *) NULL)
+    {
+      snapshot->map_length=0;
+      return(MagickFail);
+    }
+
+  /*
+    Validate the header and the length of the snapshot.
+  */
+  reason=(const char *) NULL;
+  header=(const magick_uint32_t *) snapshot->map;
+  if ((header[0] != ConfigureSnapshotMagick) ||
+      (header[1] != MagickLibVersion) || (header[2] != version) ||
+      (header[3] != fields))
+    reason="it is from a different release";
+  else
+    {
+      magick_uint64_t
+        expected_length;
+
+      snapshot->sources=header[5];
+      snapshot->values_length=(size_t) header[5]*ConfigureSnapshotSourceValues+
+        (size_t) header[4]*fields;
+      snapshot->strings_length=header[6];
+      expected_length=(magick_uint64_t) sizeof(magick_uint32_t)*
+        ((magick_uint64_t) ConfigureSnapshotHeaderValues+
+         (magick_uint64_t) header[5]*ConfigureSnapshotSourceValues+
+         (magick_uint64_t) header[4]*fields)+header[6];
+      if ((expected_length != snapshot->map_length) ||
+          (header[5] == 0U) || (header[6] == 0U))
+        reason="it is corrupt";
+      else
+        {
+          snapshot->values=(magick_uint32_t *) header+
+            ConfigureSnapshotHeaderValues;
+          snapshot->strings=(char *) snapshot->map+snapshot->map_length-
+            snapshot->strings_length;
+          if (snapshot->strings[snapshot->strings_length-1] != '\0')
+            reason="it is corrupt";
+        }
+    }
+
+  /*
+    Verify that the source files are unchanged.
+  */
+  for (i=0; (reason == (const char *) NULL) && (i < snapshot->sources); i++)
+    {
+      const magick_uint32_t
+        *source;
+
+      const char
+        *source_path;
+
+      magick_uint64_t
+        modified,
+        size;
+
+      source=snapshot->values+i*ConfigureSnapshotSourceValues;
+      source_path=ConfigureSnapshotValueString(snapshot,source[0]);
+      size=((magick_uint64_t) source[2] << 32) | source[1];
+      modified=((magick_uint64_t) source[4] << 32) | source[3];
+      if ((source_path == (const char *) NULL) ||
+          ((i == 0) && (strcmp(source_path,path) != 0)))
+        reason="the configuration file was found elsewhere";
+      else if ((MagickStat(source_path,&attributes) != 0) ||
+               ((magick_uint64_t) attributes.st_size != size) ||
+               ((magick_uint64_t) attributes.st_mtime != modified))
+        reason="a configuration file has changed";
+    }
+  if (reason != (const char *) NULL)
+    {
+      (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                            "Ignoring configuration snapshot \"%s\" since %s",
+                            snapshot_path,reason);
+      DestroyConfigureSnapshot(snapshot);
+      InitializeConfigureSnapshot(snapshot,version,fields,MagickTrue);
+      return(MagickFail);
+    }
+  (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                        "%s configuration snapshot \"%s\" (%lu entries)",
+                        snapshot->mapped ? "Mapped" : "Read",snapshot_path,
+                        GetConfigureSnapshotEntries(snapshot));
+  return(MagickPass);
+}
+
+unsigned long GetConfigureSnapshotEntries(const ConfigureSnapshot *snapshot)
+{
+  assert(snapshot != (const ConfigureSnapshot *) NULL);
+  return((unsigned long) ((snapshot->values_length-snapshot->sources*
+                           ConfigureSnapshotSourceValues)/snapshot->fields));
+}
+
+const char *GetConfigureSnapshotString(const ConfigureSnapshot *snapshot,
+  const unsigned long entry,const unsigned int field)
+{
+  assert(snapshot != (const ConfigureSnapshot *) NULL);
+  assert(field < snapshot->fields);
+  return(ConfigureSnapshotValueString(snapshot,
+    snapshot->values[snapshot->sources*ConfigureSnapshotSourceValues+
+                     entry*snapshot->fields+field]));
+}
+
+magick_uint32_t GetConfigureSnapshotValue(const ConfigureSnapshot *snapshot,
+  const unsigned long entry,const unsigned int field)
+{
+  assert(snapshot != (const ConfigureSnapshot *) NULL);
+  assert(field < snapshot->fields);
+  return(snapshot->values[snapshot->sources*ConfigureSnapshotSourceValues+
+                          entry*snapshot->fields+field]);
+}
+
+void DestroyConfigureSnapshot(ConfigureSnapshot *snapshot)
+{
+  assert(snapshot != (ConfigureSnapshot *) NULL);
+  if (snapshot->map != (void *) NULL)
+    {
+      if (snapshot->mapped)
+        (void) UnmapBlob(snapshot->map,snapshot->map_length);
+      else
+        MagickFreeMemory(snapshot->map);
+    }
+  else
+    {
+      MagickFreeMemory(snapshot->values);
+      MagickFreeMemory(snapshot->strings);
+    }
+  (void) memset(snapshot,0,sizeof(ConfigureSnapshot));
+}
+
+/*
+ * Local Variables:
+ * mode: c
+ * c-basic-offset: 2
+ * fill-column: 78
+ * End:
+ */
@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2026 GraphicsMagick Group
+ 
+  This program is covered by multiple licenses, which are described in
+  Copyright.txt. You should have received a copy of Copyright.txt with this
+  package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ 
+  GraphicsMagick Configuration File Snapshot Methods.
+*/
+#ifndef _MAGICK_CONFIG_SNAPSHOT_H
+#define _MAGICK_CONFIG_SNAPSHOT_H
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+  /*
+    A precompiled snapshot of the entries parsed from a configuration
+    file (and the files it includes), which a later process may memory
+    map rather than parse the files again.  Snapshots are only used if
+    the MAGICK_CONFIGURE_SNAPSHOT_PATH environment variable specifies the
+    directory to keep them in.  Each entry has the same number of fields,
+    each of which is a string (possibly NULL) or an unsigned integer.
+  */
+  typedef struct _ConfigureSnapshot
+  {
+    magick_uint32_t
+      version,              /* version of the entry format */
+      fields,               /* fields per entry */
+      sources;              /* number of source files */
+
+    magick_uint32_t
+      *values;              /* source file stamps, then entry fields */
+
+    size_t
+      values_length,        /* number of values */
+      values_allocated;
+
+    char
+      *strings;             /* string table */
+
+    size_t
+      strings_length,       /* string table length in bytes */
+      strings_allocated;
+
+    void
+      *map;                 /* snapshot file which was opened */
+
+    size_t
+      map_length;
+
+    MagickBool
+      mapped,               /* map is memory mapped rather than read */
+      enabled;              /* snapshots are enabled */
+  } ConfigureSnapshot;
+
+  /*
+    Record a file which the entries were read from.  All sources must
+    be added before any entry fields.  The Add functions do nothing
+    unless snapshots are enabled.
+  */
+  extern void AddConfigureSnapshotSource(ConfigureSnapshot *snapshot,
+                                         const char *path);
+
+  /*
+    Append a string (or NULL) field to the entries.
+  */
+  extern void AddConfigureSnapshotString(ConfigureSnapshot *snapshot,
+                                         const char *string);
+
+  /*
+    Append an unsigned integer field to the entries.
+  */
+  extern void AddConfigureSnapshotValue(ConfigureSnapshot *snapshot,
+                                        const magick_uint32_t value);
+
+  /*
+    Write a snapshot of the named configuration file.
+  */
+  extern MagickPassFail WriteConfigureSnapshot(ConfigureSnapshot *snapshot,
+                                               const char *filename);
+
+  /*
+    Open the snapshot of the named configuration file, which was found
+    at path, if it is up to date.  Otherwise the snapshot is left empty,
+    ready for the entries to be added and the snapshot written.
+  */
+  extern MagickPassFail OpenConfigureSnapshot(ConfigureSnapshot *snapshot,
+                                              const char *filename,
+                                              const char *path,
+                                              const unsigned int version,
+                                              const unsigned int fields);
+
+  /*
+    Number of entries in a snapshot.
+  */
+  extern unsigned long GetConfigureSnapshotEntries(const ConfigureSnapshot *snapshot);
+
+  /*
+    Return a string field of an entry in an opened snapshot.
+  */
+  extern const char *GetConfigureSnapshotString(const ConfigureSnapshot *snapshot,
+                                                const unsigned long entry,
+                                                const unsigned int field);
+
+  /*
+    Return an unsigned integer field of an entry in an opened snapshot.
+  */
+  extern magick_uint32_t GetConfigureSnapshotValue(const ConfigureSnapshot *snapshot,
+                                                   const unsigned long entry,
+                                                   const unsigned int field);
+
+  /*
+    Release the resources used by a snapshot.
+  */
+  extern void DestroyConfigureSnapshot(ConfigureSnapshot *snapshot);
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+#endif /* _MAGICK_CONFIG_SNAPSHOT_H */
+
+/*
+ * Local Variables:
+ * mode: c
+ * c-basic-offset: 2
+ * fill-column: 78
+ * End:
+ */
@@ -83,8 +83,91 @@ typedef enum {
   IDispatchType
 } DispatchType;
 
-static SemaphoreInfo
-  *constitute_semaphore = (SemaphoreInfo *) NULL;
+/*
+  Row-streaming encoder context (see OpenImageRowEncoder()).
+*/
+struct _ImageRowEncoder
+{
+  const MagickInfo
+    *magick_info;       /* Coder used to encode the rows */
+
+  ImageInfo
+    *image_info;        /* Private clone of user's ImageInfo */
+
+  Image
+    *image,             /* Output image description (user owned) */
+    *row_image;         /* Single row staging image, NULL if buffering */
+
+  void
+    *state;             /* Coder private state */
+
+  unsigned long
+    row;                /* Next row to be written */
+
+  unsigned int
+    coder_lock;         /* Coder concurrency slot held (0 if none) */
+
+  MagickPassFail
+    status;             /* Accumulated status */
+
+  unsigned long
+    signature;
+};
+
+/*
+  Typed pixel row iterator context (see OpenPixelRowIterator()).
+*/
+struct _PixelRowIterator
+{
+  Image
+    *image;             /* Image being accessed (user owned) */
+
+  ViewInfo
+    *view;              /* Cache view used to access the rows */
+
+  MapQuantumType
+    *quantum_map;       /* Parsed map */
+
+  size_t
+    length,             /* Number of samples in map */
+    sample_size,        /* Size of one sample (per storage type) */
+    buffer_size;        /* Allocated size of row buffer */
+
+  StorageType
+    type;               /* Sample storage type */
+
+  unsigned int
+    offset,             /* Offset of first sample in PixelPacket (direct) */
+    stride;             /* Distance between pixels, in samples */
+
+  MagickBool
+    direct,             /* Rows are returned directly from the cache */
+    writable,           /* Rows may be modified and synced */
+    pending,            /* A writable row is waiting to be synced */
+    failed;             /* Region selection or a row fetch failed */
+
+  long
+    x,                  /* Region left ordinate */
+    y;                  /* Region top ordinate */
+
+  unsigned long
+    columns,            /* Region width */
+    rows,               /* Region height */
+    row;                /* Next region row to be returned */
+
+  void
+    *buffer;            /* Converted row (if not direct) */
+
+  unsigned long
+    signature;
+};
+
+/*
+  Specialized ExportViewPixelArea()/ImportViewPixelArea() kernels may
+  be disabled by setting MAGICK_PIXEL_AREA_KERNELS=0 in the environment.
+*/
+static MagickBool
+  pixel_area_kernels = MagickTrue;
 
 /*
   Forward declarations.
@@ -92,6 +175,9 @@ static SemaphoreInfo
 static Image
   *ReadImages(const ImageInfo *,ExceptionInfo *);
 
+static void
+  DestroyImageRowEncoder(ImageRowEncoder *);
+
 
 /*
   Macros
@@ -586,7 +672,9 @@ MagickExport Image *ConstituteImage(const unsigned long width,
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  DestroyConstitute() destroys the constitute environment.
+%  DestroyConstitute() destroys the constitute environment, restoring the
+%  defaults so that InitializeConstitute() reads MAGICK_PIXEL_AREA_KERNELS
+%  again if GraphicsMagick is initialized again.
 %
 %  The format of the DestroyConstitute method is:
 %
@@ -596,9 +684,331 @@ MagickExport Image *ConstituteImage(const unsigned long width,
 */
 MagickExport void DestroyConstitute(void)
 {
-  DestroySemaphoreInfo(&constitute_semaphore);
+  pixel_area_kernels=MagickTrue;
 }
 
+/*
+  Parse a DispatchImage() pixel map into quantum_map (which has room for
+  max_length entries), validating it against the image.  The number of
+  map entries is returned via length.
+*/
+static MagickPassFail ParseDispatchMap(const Image *image,const char *map,
+  MapQuantumType *quantum_map,const size_t max_length,size_t *length,
+  ExceptionInfo *exception)
+{
+  register size_t
+    i;
+
+  *length=Min(strlen(map),max_length);
+  for (i=0; i < *length; i++)
+    {
+      switch ((int) toupper((int) map[i]))
+        {
+        case 'R':
+          {
+            quantum_map[i]=RedMapQuantum;
+            break;
+          }
+        case 'G':
+          {
+            quantum_map[i]=GreenMapQuantum;
+            break;
+          }
+        case 'B':
+          {
+            quantum_map[i]=BlueMapQuanum;
+            break;
+          }
+        case 'A':
+        case 'T':
+          {
+            quantum_map[i]=TransparencyMapQuantum;
+            break;
+          }
+        case 'C':
+          {
+            quantum_map[i]=RedMapQuantum;
+            if (image->colorspace == CMYKColorspace)
+              break;
+            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
+            return(MagickFail);
+          }
+        case 'M':
+          {
+            quantum_map[i]=GreenMapQuantum;
+            if (image->colorspace == CMYKColorspace)
+              break;
+            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
+            return(MagickFail);
+          }
+        case 'Y':
+          {
+            quantum_map[i]=BlueMapQuanum;
+            if (image->colorspace == CMYKColorspace)
+              break;
+            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
+            return(MagickFail);
+          }
+        case 'K':
+          {
+            quantum_map[i]=OpacityMapQuantum;
+            if (image->colorspace == CMYKColorspace)
+              break;
+            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
+            return(MagickFail);
+          }
+        case 'I':
+          {
+            quantum_map[i]=IntensityMapQuantum;
+            break;
+          }
+        case 'O':
+          {
+            quantum_map[i]=OpacityMapQuantum;
+            break;
+          }
+        case 'P':
+          {
+            quantum_map[i]=PadMapQuantum;
+            break;
+          }
+        default:
+          {
+            ThrowException(exception,OptionError,UnrecognizedPixelMap,map);
+            return(MagickFail);
+          }
+        }
+    }
+  return(MagickPass);
+}
+
+/*
+  Obtain the value of one mapped quantum of a pixel.
+*/
+static inline Quantum GetMapQuantum(const Image *image,const PixelPacket *p,
+  const MapQuantumType quantum_type)
+{
+  Quantum
+    quantum=0U;
+
+  switch (quantum_type)
+    {
+    case RedMapQuantum:
+      {
+        quantum=GetRedSample(p);
+        break;
+      }
+    case GreenMapQuantum:
+      {
+        quantum=GetGreenSample(p);
+        break;
+      }
+    case BlueMapQuanum:
+      {
+        quantum=GetBlueSample(p);
+        break;
+      }
+    case IntensityMapQuantum:
+      {
+        if (image->is_grayscale)
+          {
+            quantum=GetRedSample(p);
+          }
+        else
+          {
+            double intensity = PixelIntensity(p);
+            quantum=RoundDoubleToQuantum(intensity);
+          }
+        break;
+      }
+    case TransparencyMapQuantum:
+      {
+        if (image->matte)
+          quantum=GetOpacitySample(p);
+        quantum=MaxRGB-quantum;
+        break;
+      }
+    case OpacityMapQuantum:
+      {
+        if ((image->matte) ||
+            (image->colorspace == CMYKColorspace))
+          quantum=GetOpacitySample(p);
+        break;
+      }
+    case PadMapQuantum:
+      {
+        /* Zero quantum */
+        break;
+      }
+    }
+  return(quantum);
+}
+
+/*
+  Update one mapped quantum of a pixel.
+*/
+static inline void SetMapQuantum(PixelPacket *q,
+  const MapQuantumType quantum_type,const Quantum quantum)
+{
+  switch (quantum_type)
+    {
+    case RedMapQuantum:
+      {
+        SetRedSample(q,quantum);
+        break;
+      }
+    case GreenMapQuantum:
+      {
+        SetGreenSample(q,quantum);
+        break;
+      }
+    case BlueMapQuanum:
+      {
+        SetBlueSample(q,quantum);
+        break;
+      }
+    case OpacityMapQuantum:
+      {
+        SetOpacitySample(q,quantum);
+        break;
+      }
+    case TransparencyMapQuantum:
+      {
+        SetOpacitySample(q,MaxRGB-quantum);
+        break;
+      }
+    case IntensityMapQuantum:
+      {
+        SetGraySample(q,quantum);
+        break;
+      }
+    case PadMapQuantum:
+      {
+        /* Discard quantum */
+        break;
+      }
+    }
+}
+
+#define FloatQuantum(quantum) ((float) ((double) (quantum)/MaxRGB))
+#define DoubleQuantum(quantum) ((double) (quantum)/MaxRGB)
+#define ExportMappedSamples(sample_type,scale)                          \
+  {                                                                     \
+    register sample_type                                                \
+      * restrict q = (sample_type *) pixels;                            \
+                                                                        \
+    for (x=columns; x != 0; x--)                                        \
+      {                                                                 \
+        for (i=0; i < length; i++)                                      \
+          {                                                             \
+            quantum=GetMapQuantum(image,p,quantum_map[i]);              \
+            *q++=scale(quantum);                                        \
+          }                                                             \
+        p++;                                                            \
+      }                                                                 \
+    pixels=(void *) q;                                                  \
+  }
+
+/*
+  Export a row of pixels as mapped samples of the specified storage type.
+  A pointer just past the last sample written is returned.
+*/
+static void *ExportMappedPixels(const Image *image,
+  const PixelPacket * restrict p,const unsigned long columns,
+  const MapQuantumType *quantum_map,const size_t length,
+  const StorageType type,void *pixels)
+{
+  register unsigned long
+    x;
+
+  register size_t
+    i;
+
+  register Quantum
+    quantum;
+
+  switch (type)
+    {
+    case CharPixel:
+      ExportMappedSamples(unsigned char,ScaleQuantumToChar);
+      break;
+    case ShortPixel:
+      ExportMappedSamples(unsigned short,ScaleQuantumToShort);
+      break;
+    case IntegerPixel:
+      ExportMappedSamples(unsigned int,ScaleQuantumToLong);
+      break;
+    case LongPixel:
+      ExportMappedSamples(unsigned long,ScaleQuantumToLong);
+      break;
+    case FloatPixel:
+      ExportMappedSamples(float,FloatQuantum);
+      break;
+    case DoublePixel:
+      ExportMappedSamples(double,DoubleQuantum);
+      break;
+    }
+  return(pixels);
+}
+
+#define ScaleFloatToQuantum(sample) \
+  RoundDoubleToQuantum((double) MaxRGB*(sample))
+#define ImportMappedSamples(sample_type,scale)                          \
+  {                                                                     \
+    register const sample_type                                          \
+      * restrict p = (const sample_type *) pixels;                      \
+                                                                        \
+    sample_type                                                         \
+      sample;                                                           \
+                                                                        \
+    for (x=columns; x != 0; x--)                                        \
+      {                                                                 \
+        for (i=0; i < length; i++)                                      \
+          {                                                             \
+            sample=*p++;                                                \
+            SetMapQuantum(q,quantum_map[i],scale(sample));              \
+          }                                                             \
+        q++;                                                            \
+      }                                                                 \
+  }
+
+/*
+  Import a row of mapped samples of the specified storage type into
+  pixels.  Samples which are not mapped are left unchanged.
+*/
+static void ImportMappedPixels(PixelPacket * restrict q,
+  const unsigned long columns,const MapQuantumType *quantum_map,
+  const size_t length,const StorageType type,const void *pixels)
+{
+  register unsigned long
+    x;
+
+  register size_t
+    i;
+
+  switch (type)
+    {
+    case CharPixel:
+      ImportMappedSamples(unsigned char,ScaleCharToQuantum);
+      break;
+    case ShortPixel:
+      ImportMappedSamples(unsigned short,ScaleShortToQuantum);
+      break;
+    case IntegerPixel:
+      ImportMappedSamples(unsigned int,ScaleLongToQuantum);
+      break;
+    case LongPixel:
+      ImportMappedSamples(unsigned long,ScaleLongToQuantum);
+      break;
+    case FloatPixel:
+      ImportMappedSamples(float,ScaleFloatToQuantum);
+      break;
+    case DoublePixel:
+      ImportMappedSamples(double,ScaleFloatToQuantum);
+      break;
+    }
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -670,15 +1080,11 @@ MagickExport MagickPassFail DispatchImage(const Image *image,const long x_offset
     y;
 
   register long
-    i,
     x;
 
   register const PixelPacket
     * restrict p;
 
-  register Quantum
-    quantum;
-
   MapQuantumType
     switch_map[MaxTextExtent/sizeof(MapQuantumType)];
 
@@ -815,210 +1221,24 @@ MagickExport MagickPassFail DispatchImage(const Image *image,const long x_offset
         }
     }
 
-  length=strlen(map);
-  length=Min(length,sizeof(switch_map)/sizeof(MapQuantumType));
-
   /*
     Prepare a validated and more efficient version of the map.
   */
-  for (i=0; i < (long) length; i++)
+  if (ParseDispatchMap(image,map,switch_map,
+                       sizeof(switch_map)/sizeof(MapQuantumType),&length,
+                       exception) == MagickFail)
+    return(MagickFail);
+
+  for (y=0; y < (long) rows; y++)
     {
-      switch ((int) toupper((int) map[i]))
-        {
-        case 'R':
-          {
-            switch_map[i]=RedMapQuantum;
-            break;
-          }
-        case 'G':
-          {
-            switch_map[i]=GreenMapQuantum;
-            break;
-          }
-        case 'B':
-          {
-            switch_map[i]=BlueMapQuanum;
-            break;
-          }
-        case 'A':
-        case 'T':
-          {
-            switch_map[i]=TransparencyMapQuantum;
-            break;
-          }
-        case 'C':
-          {
-            switch_map[i]=RedMapQuantum;
-            if (image->colorspace == CMYKColorspace)
-              break;
-            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
-            return(MagickFail);
-          }
-        case 'M':
-          {
-            switch_map[i]=GreenMapQuantum;
-            if (image->colorspace == CMYKColorspace)
-              break;
-            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
-            return(MagickFail);
-          }
-        case 'Y':
-          {
-            switch_map[i]=BlueMapQuanum;
-            if (image->colorspace == CMYKColorspace)
-              break;
-            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
-            return(MagickFail);
-          }
-        case 'K':
-          {
-            switch_map[i]=OpacityMapQuantum;
-            if (image->colorspace == CMYKColorspace)
-              break;
-            ThrowException(exception,OptionError,ColorSeparatedImageRequired,map);
-            return(MagickFail);
-          }
-        case 'I':
-          {
-            switch_map[i]=IntensityMapQuantum;
-            break;
-          }
-        case 'O':
-          {
-            switch_map[i]=OpacityMapQuantum;
-            break;
-          }
-        case 'P':
-          {
-            switch_map[i]=PadMapQuantum;
-            break;
-          }
-        default:
-          {
-            ThrowException(exception,OptionError,UnrecognizedPixelMap,map);
-            return(MagickFail);
-          }
-        }
-    }
-  
-  for (y=0; y < (long) rows; y++)
-    {
-      p=AcquireImagePixels(image,x_offset,y_offset+y,columns,1,exception);
-      if (p == (const PixelPacket *) NULL)
+      p=AcquireImagePixels(image,x_offset,y_offset+y,columns,1,exception);
+      if (p == (const PixelPacket *) NULL)
         {
           status=MagickFail;
           break;
         }
-      for (x=0; x < (long) columns; x++)
-        {
-          for (i=0; i < (long) length; i++)
-            {
-              /*
-                Obtain quantum value
-              */
-              quantum=0U;
-              switch (switch_map[i])
-                {
-                case RedMapQuantum:
-                  {
-                    quantum=GetRedSample(p);
-                    break;
-                  }
-                case GreenMapQuantum:
-                  {
-                    quantum=GetGreenSample(p);
-                    break;
-                  }
-                case BlueMapQuanum:
-                  {
-                    quantum=GetBlueSample(p);
-                    break;
-                  }
-                case IntensityMapQuantum:
-                  {
-                    if (image->is_grayscale)
-                      {
-                        quantum=GetRedSample(p);
-                      }
-                    else
-                      {
-                        double intensity = PixelIntensity(p);
-                        quantum=RoundDoubleToQuantum(intensity);
-                      }
-                    break;
-                  }
-                case TransparencyMapQuantum:
-                  {
-                    if (image->matte)
-                      quantum=GetOpacitySample(p);
-                    quantum=MaxRGB-quantum;
-                    break;
-                  }
-                case OpacityMapQuantum:
-                  {
-                    if ((image->matte) ||
-			(image->colorspace == CMYKColorspace))
-                      quantum=GetOpacitySample(p);
-                    break;
-                  }
-                case PadMapQuantum:
-                  {
-                    /* Zero quantum */
-                    break;
-                  }
-                }
-
-              /*
-                Output quantum
-              */
-              switch (type)
-                {
-                case CharPixel:
-                  {
-                    register unsigned char *q = (unsigned char*) pixels;
-                    *q++=ScaleQuantumToChar(quantum);
-                    pixels=(void *) q;
-                    break;
-                  }
-                case ShortPixel:
-                  {
-                    register unsigned short *q = (unsigned short*) pixels;
-                    *q++=ScaleQuantumToShort(quantum);
-                    pixels=(void *) q;
-                    break;
-                  }
-                case IntegerPixel:
-                  {
-                    register unsigned int *q = (unsigned int*) pixels;
-                    *q++=ScaleQuantumToLong(quantum);
-                    pixels=(void *) q;
-                    break;
-                  }
-                case LongPixel:
-                  {
-                    register unsigned long *q = (unsigned long*) pixels;
-                    *q++=ScaleQuantumToLong(quantum);
-                    pixels=(void *) q;
-                    break;
-                  }
-                case FloatPixel:
-                  {
-                    register float *q = (float*) pixels;
-                    *q++=(float) ((double) quantum/MaxRGB);
-                    pixels=(void *) q;
-                    break;
-                  }
-                case DoublePixel:
-                  {
-                    register double *q = (double*) pixels;
-                    *q++=(double) quantum/MaxRGB;
-                    pixels=(void *) q;
-                    break;
-                  }
-                }
-            }
-          p++;
-        }
+      pixels=ExportMappedPixels(image,p,columns,switch_map,length,type,
+                                pixels);
     }
   return(status);
 }
@@ -1202,6 +1422,34 @@ MagickFindRawImageMinMax(Image *image, EndianType endian,
   return status;
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   M a g i c k P i x e l A r e a K e r n e l s E n a b l e d                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickPixelAreaKernelsEnabled() returns MagickTrue if ExportViewPixelArea()
+%  and ImportViewPixelArea() may use their specialized kernels for common
+%  sample layouts.  The kernels are disabled by setting the environment
+%  variable MAGICK_PIXEL_AREA_KERNELS to 0, which is useful for comparing
+%  against the generic conversion code.
+%
+%  The format of the MagickPixelAreaKernelsEnabled method is:
+%
+%      MagickBool MagickPixelAreaKernelsEnabled(void)
+%
+*/
+MagickBool
+MagickPixelAreaKernelsEnabled(void)
+{
+  return pixel_area_kernels;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1318,8 +1566,12 @@ MagickGetQuantumSamplesPerPixel(const QuantumType quantum_type)
 MagickPassFail
 InitializeConstitute(void)
 {
-  assert(constitute_semaphore == (SemaphoreInfo *) NULL);
-  constitute_semaphore=AllocateSemaphoreInfo();
+  const char
+    *p;
+
+  if (((p=getenv("MAGICK_PIXEL_AREA_KERNELS")) != (const char *) NULL) &&
+      ((LocaleCompare(p,"0") == 0) || (LocaleCompare(p,"FALSE") == 0)))
+    pixel_area_kernels=MagickFalse;
   return MagickPass;
 }
 
@@ -1466,6 +1718,9 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
   ImageInfo
     *clone_info;
 
+  unsigned int
+    coder_lock;
+
   /*
     Determine image type from filename prefix or suffix (e.g. image.jpg).
   */
@@ -1577,6 +1832,9 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
           /*
             Coder requires a random access stream.
           */
+          (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+                                "Input is not seekable: falling back to "
+                                "temporary file");
           if(!AcquireTemporaryFileName(clone_info->filename))
             {
               ThrowException(exception,FileOpenError,
@@ -1596,8 +1854,7 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
   if ((magick_info != (const MagickInfo *) NULL) &&
       (magick_info->decoder != NULL))
     {
-      if (!magick_info->thread_support)
-        LockSemaphoreInfo(constitute_semaphore);
+      coder_lock=LockMagickCoder(magick_info);
       (void) LogMagickEvent(CoderEvent,GetMagickModule(),
         "Invoking \"%.1024s\" decoder (%.1024s) subimage=%lu subrange=%lu",
 			    magick_info->name,
@@ -1605,8 +1862,7 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
 			    clone_info->subimage,
 			    clone_info->subrange);
       image=(magick_info->decoder)(clone_info,exception);
-      if (!magick_info->thread_support)
-        UnlockSemaphoreInfo(constitute_semaphore);
+      UnlockMagickCoder(magick_info,coder_lock);
 
       if (image != (Image *) NULL)
         (void) LogMagickEvent(CoderEvent,GetMagickModule(),
@@ -1697,8 +1953,7 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
       /*
         Invoke decoder for format
       */
-      if (!magick_info->thread_support)
-        LockSemaphoreInfo(constitute_semaphore);
+      coder_lock=LockMagickCoder(magick_info);
       (void) LogMagickEvent(CoderEvent,GetMagickModule(),
         "Invoking \"%.1024s\" decoder (%.1024s) subimage=%lu subrange=%lu",
 			    magick_info->name,
@@ -1706,8 +1961,7 @@ MagickExport Image *ReadImage(const ImageInfo *image_info,
 			    clone_info->subimage,
 			    clone_info->subrange);
       image=(magick_info->decoder)(clone_info,exception);
-      if (!magick_info->thread_support)
-        UnlockSemaphoreInfo(constitute_semaphore);
+      UnlockMagickCoder(magick_info,coder_lock);
 
       if (image != (Image *) NULL)
         (void) LogMagickEvent(CoderEvent,GetMagickModule(),
@@ -2095,6 +2349,7 @@ MagickExport unsigned int WriteImage(const ImageInfo *image_info,Image *image)
     *clone_info;
 
   unsigned int
+    coder_lock,
     status;
 
   /*
@@ -2168,6 +2423,9 @@ MagickExport unsigned int WriteImage(const ImageInfo *image_info,Image *image)
 	    {
 	      if (!BlobIsSeekable(image))
 		{
+		  (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+					"Output is not seekable: falling back "
+					"to temporary file");
 		  if(!AcquireTemporaryFileName(tempfile))
 		    {
 		      ThrowException(&image->exception,FileOpenError,
@@ -2188,8 +2446,7 @@ MagickExport unsigned int WriteImage(const ImageInfo *image_info,Image *image)
 	    }
 	}
 
-      if (!magick_info->thread_support)
-        LockSemaphoreInfo(constitute_semaphore);
+      coder_lock=LockMagickCoder(magick_info);
       if (image->logging)
 	(void) LogMagickEvent(CoderEvent,GetMagickModule(),
 			      "Invoking \"%.1024s\" encoder (%.1024s): "
@@ -2208,8 +2465,7 @@ MagickExport unsigned int WriteImage(const ImageInfo *image_info,Image *image)
       status=(magick_info->encoder)(clone_info,image);
       (void) LogMagickEvent(CoderEvent,GetMagickModule(),
 			    "Returned from \"%.1024s\" encoder",magick_info->name);
-      if (!magick_info->thread_support)
-        UnlockSemaphoreInfo(constitute_semaphore);
+      UnlockMagickCoder(magick_info,coder_lock);
 
       if (tempfile[0] != '\0')
 	{
@@ -2260,11 +2516,9 @@ MagickExport unsigned int WriteImage(const ImageInfo *image_info,Image *image)
 			       NoEncodeDelegateForThisImageFormat,
 			       image->filename)
 	    }
-      if (!magick_info->thread_support)
-        LockSemaphoreInfo(constitute_semaphore);
+      coder_lock=LockMagickCoder(magick_info);
       status=(magick_info->encoder)(clone_info,image);
-      if (!magick_info->thread_support)
-        UnlockSemaphoreInfo(constitute_semaphore);
+      UnlockMagickCoder(magick_info,coder_lock);
     }
   (void) strlcpy(image->magick,clone_info->magick,MaxTextExtent);
   DestroyImageInfo(clone_info);
@@ -2442,3 +2696,821 @@ MagickExport MagickPassFail WriteImagesFile(const ImageInfo *image_info,Image *i
     }
   return(status);
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   O p e n I m a g e R o w E n c o d e r                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  OpenImageRowEncoder() opens an encoder which accepts image rows in
+%  top-to-bottom order as they are produced.  The supplied image
+%  describes the output (columns, rows, depth, matte, colorspace, image
+%  attributes, and the output filename/magick) but need not (and
+%  should not) have its pixels populated.  Rows are supplied via
+%  SetImageRowEncoderPixels() and SyncImageRowEncoderPixels() and the
+%  output is completed by CloseImageRowEncoder().
+%
+%  If the selected coder supports row streaming, then each row is
+%  encoded and written as soon as it is synced so that memory
+%  consumption is bounded by one row, regardless of the image size.
+%  Otherwise the rows are accumulated in the image's pixel cache and
+%  the image is written via WriteImage() when the encoder is closed.
+%  The image is always treated as DirectClass.
+%
+%  The format of the OpenImageRowEncoder method is:
+%
+%      ImageRowEncoder *OpenImageRowEncoder(const ImageInfo *image_info,
+%        Image *image,ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image_info: The image info.
+%
+%    o image: The image describing the output.  It must remain valid
+%      until CloseImageRowEncoder() is called.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+MagickExport ImageRowEncoder *OpenImageRowEncoder(const ImageInfo *image_info,
+  Image *image,ExceptionInfo *exception)
+{
+  ImageRowEncoder
+    *encoder;
+
+  assert(image_info != (ImageInfo *) NULL);
+  assert(image_info->signature == MagickSignature);
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(exception != (ExceptionInfo *) NULL);
+
+  if ((image->columns == 0) || (image->rows == 0))
+    {
+      ThrowException(exception,OptionError,NonzeroWidthAndHeightRequired,
+                     image->filename);
+      return (ImageRowEncoder *) NULL;
+    }
+  encoder=MagickAllocateMemory(ImageRowEncoder *,sizeof(ImageRowEncoder));
+  if (encoder == (ImageRowEncoder *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      return (ImageRowEncoder *) NULL;
+    }
+  (void) memset(encoder,0,sizeof(ImageRowEncoder));
+  encoder->image=image;
+  encoder->status=MagickPass;
+  encoder->signature=MagickSignature;
+
+  GetTimerInfo(&image->timer);
+  image->logging=IsEventLogging();
+  image->storage_class=DirectClass;
+  encoder->image_info=CloneImageInfo(image_info);
+  (void) strlcpy(encoder->image_info->filename,image->filename,MaxTextExtent);
+  (void) strlcpy(encoder->image_info->magick,image->magick,MaxTextExtent);
+  (void) SetImageInfo(encoder->image_info,SETMAGICK_WRITE,exception);
+  (void) strlcpy(image->filename,encoder->image_info->filename,MaxTextExtent);
+  (void) strlcpy(image->magick,encoder->image_info->magick,MaxTextExtent);
+  encoder->magick_info=GetMagickInfo(encoder->image_info->magick,exception);
+
+  if ((encoder->magick_info != (const MagickInfo *) NULL) &&
+      (encoder->magick_info->row_encoder_begin != NULL) &&
+      (encoder->magick_info->row_encoder_row != NULL) &&
+      (encoder->magick_info->row_encoder_end != NULL))
+    {
+      encoder->row_image=CloneImage(image,image->columns,1,True,exception);
+      if (encoder->row_image == (Image *) NULL)
+        {
+          DestroyImageRowEncoder(encoder);
+          return (ImageRowEncoder *) NULL;
+        }
+      encoder->row_image->storage_class=DirectClass;
+      DisassociateBlob(image);
+      encoder->coder_lock=LockMagickCoder(encoder->magick_info);
+      if ((encoder->magick_info->row_encoder_begin)(encoder->image_info,image,
+                                                     &encoder->state)
+          == MagickFail)
+        {
+          UnlockMagickCoder(encoder->magick_info,encoder->coder_lock);
+          encoder->coder_lock=0;
+          DestroyImage(encoder->row_image);
+          encoder->row_image=(Image *) NULL;
+          encoder->state=(void *) NULL;
+          if (image->exception.severity != UndefinedException)
+            {
+              CopyException(exception,&image->exception);
+              DestroyImageRowEncoder(encoder);
+              return (ImageRowEncoder *) NULL;
+            }
+        }
+    }
+
+  if (encoder->row_image != (Image *) NULL)
+    (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                          "Streaming %lux%lu rows to \"%.1024s\" row encoder",
+                          image->columns,image->rows,
+                          encoder->magick_info->name);
+  else
+    (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                          "No \"%.1024s\" row encoder, buffering %lux%lu "
+                          "rows for WriteImage()",
+                          encoder->image_info->magick,
+                          image->columns,image->rows);
+  return encoder;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S e t I m a g e R o w E n c o d e r P i x e l s                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetImageRowEncoderPixels() returns a pointer to image->columns pixels
+%  which are to be filled with the content of the next output row.  The
+%  row is committed to the encoder by SyncImageRowEncoderPixels().  A
+%  null pointer is returned if all rows have already been written or an
+%  error occured.
+%
+%  The format of the SetImageRowEncoderPixels method is:
+%
+%      PixelPacket *SetImageRowEncoderPixels(ImageRowEncoder *encoder)
+%
+%  A description of each parameter follows:
+%
+%    o encoder: The row encoder returned by OpenImageRowEncoder().
+%
+*/
+MagickExport PixelPacket *SetImageRowEncoderPixels(ImageRowEncoder *encoder)
+{
+  Image
+    *image;
+
+  assert(encoder != (ImageRowEncoder *) NULL);
+  assert(encoder->signature == MagickSignature);
+  image=encoder->image;
+  if (encoder->status == MagickFail)
+    return (PixelPacket *) NULL;
+  if (encoder->row >= image->rows)
+    {
+      ThrowException(&image->exception,StreamError,
+                     ImageDoesNotContainTheStreamGeometry,image->filename);
+      return (PixelPacket *) NULL;
+    }
+  if (encoder->row_image != (Image *) NULL)
+    return SetImagePixelsEx(encoder->row_image,0,0,image->columns,1,
+                            &image->exception);
+  return SetImagePixelsEx(image,0,encoder->row,image->columns,1,
+                          &image->exception);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S y n c I m a g e R o w E n c o d e r P i x e l s                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SyncImageRowEncoderPixels() commits the row most recently obtained
+%  via SetImageRowEncoderPixels().  When the coder supports row
+%  streaming the row is encoded and written immediately.
+%
+%  The format of the SyncImageRowEncoderPixels method is:
+%
+%      MagickPassFail SyncImageRowEncoderPixels(ImageRowEncoder *encoder)
+%
+%  A description of each parameter follows:
+%
+%    o encoder: The row encoder returned by OpenImageRowEncoder().
+%
+*/
+MagickExport MagickPassFail SyncImageRowEncoderPixels(ImageRowEncoder *encoder)
+{
+  Image
+    *image;
+
+  assert(encoder != (ImageRowEncoder *) NULL);
+  assert(encoder->signature == MagickSignature);
+  image=encoder->image;
+  if (encoder->status == MagickFail)
+    return MagickFail;
+  if (encoder->row >= image->rows)
+    {
+      ThrowException(&image->exception,StreamError,
+                     ImageDoesNotContainTheStreamGeometry,image->filename);
+      encoder->status=MagickFail;
+      return MagickFail;
+    }
+  if (encoder->row_image != (Image *) NULL)
+    {
+      if (!SyncImagePixelsEx(encoder->row_image,&image->exception))
+        encoder->status=MagickFail;
+      else
+        encoder->status=(encoder->magick_info->row_encoder_row)
+          (image,encoder->row_image,encoder->row,encoder->state);
+    }
+  else
+    {
+      if (!SyncImagePixelsEx(image,&image->exception))
+        encoder->status=MagickFail;
+    }
+  if (encoder->status != MagickFail)
+    {
+      if (QuantumTick(encoder->row,image->rows))
+        if (!MagickMonitorFormatted(encoder->row,image->rows,&image->exception,
+                                    SaveImageText,image->filename,
+                                    image->columns,image->rows))
+          encoder->status=MagickFail;
+      encoder->row++;
+    }
+  return encoder->status;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   C l o s e I m a g e R o w E n c o d e r                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  CloseImageRowEncoder() completes the output started by
+%  OpenImageRowEncoder() and destroys the encoder.  It is an error to
+%  close the encoder before all image rows have been supplied.  Any
+%  error is reported via the exception member of the image.
+%
+%  The format of the CloseImageRowEncoder method is:
+%
+%      MagickPassFail CloseImageRowEncoder(ImageRowEncoder *encoder)
+%
+%  A description of each parameter follows:
+%
+%    o encoder: The row encoder returned by OpenImageRowEncoder().
+%
+*/
+MagickExport MagickPassFail CloseImageRowEncoder(ImageRowEncoder *encoder)
+{
+  Image
+    *image;
+
+  MagickPassFail
+    status;
+
+  assert(encoder != (ImageRowEncoder *) NULL);
+  assert(encoder->signature == MagickSignature);
+  image=encoder->image;
+  status=encoder->status;
+  if ((status != MagickFail) && (encoder->row != image->rows))
+    {
+      ThrowException(&image->exception,StreamError,
+                     ImageDoesNotContainTheStreamGeometry,image->filename);
+      status=MagickFail;
+    }
+  if (encoder->row_image != (Image *) NULL)
+    {
+      status=(encoder->magick_info->row_encoder_end)(image,encoder->state,
+                                                     status);
+      encoder->state=(void *) NULL;
+      (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                            "Returned from \"%.1024s\" row encoder",
+                            encoder->magick_info->name);
+    }
+  else if (status != MagickFail)
+    {
+      status=WriteImage(encoder->image_info,image);
+    }
+  DestroyImageRowEncoder(encoder);
+  return status;
+}
+
+/*
+  Release resources held by a row encoder.
+*/
+static void DestroyImageRowEncoder(ImageRowEncoder *encoder)
+{
+  if (encoder->coder_lock != 0)
+    UnlockMagickCoder(encoder->magick_info,encoder->coder_lock);
+  if (encoder->row_image != (Image *) NULL)
+    DestroyImage(encoder->row_image);
+  if (encoder->image_info != (ImageInfo *) NULL)
+    DestroyImageInfo(encoder->image_info);
+  (void) memset((void *) encoder,0xbf,sizeof(ImageRowEncoder));
+  MagickFreeMemory(encoder);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   O p e n P i x e l R o w I t e r a t o r                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  OpenPixelRowIterator() opens an iterator which returns the rows of an
+%  image region as arrays of typed samples, ordered as specified by a
+%  DispatchImage() style map.  The map is parsed and validated once, when
+%  the iterator is opened, so the iterator may be used to access many
+%  regions (see SetPixelRowIteratorRegion()) without further overhead.
+%
+%  When the map and storage type describe samples which are stored
+%  consecutively in the PixelPacket structure (e.g. "BGR" or "BGRO"
+%  CharPixel samples for a Q8 build on a little-endian CPU), rows are
+%  returned directly from the pixel cache, and successive pixels are
+%  GetPixelRowIteratorStride() samples apart.  Otherwise, each row is
+%  converted into a buffer owned by the iterator, and the stride is the
+%  number of samples in the map.
+%
+%  If writable is true, then rows may be modified and are committed to
+%  the image by SyncPixelRowIteratorRow().  A PseudoClass image is
+%  converted to DirectClass, and if the map includes transparency or
+%  opacity samples, then an opaque matte channel is added to an image
+%  which does not have one.
+%
+%  Errors which occur after the iterator is opened are reported via the
+%  exception member of the image.
+%
+%  The format of the OpenPixelRowIterator method is:
+%
+%      PixelRowIterator *OpenPixelRowIterator(Image *image,const char *map,
+%        const StorageType type,const MagickBool writable,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image: The image.  It must remain valid until the iterator is
+%      closed.
+%
+%    o map: The sample order, as described for DispatchImage().
+%
+%    o type: The sample storage type: CharPixel, ShortPixel, IntegerPixel,
+%      LongPixel, FloatPixel, or DoublePixel.
+%
+%    o writable: If true, rows may be modified and synced.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+MagickExport PixelRowIterator *OpenPixelRowIterator(Image *image,
+  const char *map,const StorageType type,const MagickBool writable,
+  ExceptionInfo *exception)
+{
+  PixelRowIterator
+    *iterator;
+
+  PixelPacket
+    packet;
+
+  size_t
+    i;
+
+  int
+    offset;
+
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(map != (const char *) NULL);
+  assert(exception != (ExceptionInfo *) NULL);
+
+  if (*map == '\0')
+    {
+      ThrowException(exception,OptionError,UnrecognizedPixelMap,map);
+      return (PixelRowIterator *) NULL;
+    }
+  iterator=MagickAllocateMemory(PixelRowIterator *,sizeof(PixelRowIterator));
+  if (iterator == (PixelRowIterator *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      return (PixelRowIterator *) NULL;
+    }
+  (void) memset(iterator,0,sizeof(PixelRowIterator));
+  iterator->image=image;
+  iterator->type=type;
+  iterator->writable=writable;
+  iterator->signature=MagickSignature;
+  iterator->quantum_map=
+    MagickAllocateArray(MapQuantumType *,strlen(map),sizeof(MapQuantumType));
+  if (iterator->quantum_map == (MapQuantumType *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      ClosePixelRowIterator(iterator);
+      return (PixelRowIterator *) NULL;
+    }
+  if (ParseDispatchMap(image,map,iterator->quantum_map,strlen(map),
+                       &iterator->length,exception) == MagickFail)
+    {
+      ClosePixelRowIterator(iterator);
+      return (PixelRowIterator *) NULL;
+    }
+  switch (type)
+    {
+    case CharPixel:
+      iterator->sample_size=sizeof(unsigned char);
+      break;
+    case ShortPixel:
+      iterator->sample_size=sizeof(unsigned short);
+      break;
+    case IntegerPixel:
+      iterator->sample_size=sizeof(unsigned int);
+      break;
+    case LongPixel:
+      iterator->sample_size=sizeof(unsigned long);
+      break;
+    case FloatPixel:
+      iterator->sample_size=sizeof(float);
+      break;
+    case DoublePixel:
+      iterator->sample_size=sizeof(double);
+      break;
+    }
+  if (iterator->sample_size == 0)
+    {
+      ThrowException(exception,OptionError,UnrecognizedPixelMap,
+                     StorageTypeToString(type));
+      ClosePixelRowIterator(iterator);
+      return (PixelRowIterator *) NULL;
+    }
+
+  if (writable)
+    {
+      for (i=0; i < iterator->length; i++)
+        if (((iterator->quantum_map[i] == TransparencyMapQuantum) ||
+             (iterator->quantum_map[i] == OpacityMapQuantum)) &&
+            !image->matte && (image->colorspace != CMYKColorspace))
+          {
+            SetImageOpacity(image,OpaqueOpacity);
+            break;
+          }
+      image->storage_class=DirectClass;
+      image->is_grayscale=MagickFalse;
+      image->is_monochrome=MagickFalse;
+    }
+
+  /*
+    Rows may be returned directly from the pixel cache if the samples
+    are stored consecutively in PixelPacket, and without scaling.
+  */
+  iterator->direct=((iterator->sample_size == sizeof(Quantum)) &&
+                    ((type == CharPixel) || (type == ShortPixel) ||
+                     (type == IntegerPixel)));
+  for (i=0; (i < iterator->length) && iterator->direct; i++)
+    {
+      switch (iterator->quantum_map[i])
+        {
+        case RedMapQuantum:
+          offset=(int) (&packet.red-(Quantum *) &packet);
+          break;
+        case GreenMapQuantum:
+          offset=(int) (&packet.green-(Quantum *) &packet);
+          break;
+        case BlueMapQuanum:
+          offset=(int) (&packet.blue-(Quantum *) &packet);
+          break;
+        case OpacityMapQuantum:
+          offset=(int) (&packet.opacity-(Quantum *) &packet);
+          if (!image->matte && (image->colorspace != CMYKColorspace))
+            offset=-1;
+          break;
+        case IntensityMapQuantum:
+          offset=(int) (&packet.red-(Quantum *) &packet);
+          if (writable || !image->is_grayscale)
+            offset=-1;
+          break;
+        default:
+          offset=-1;
+          break;
+        }
+      if (i == 0)
+        iterator->offset=(unsigned int) offset;
+      if ((offset < 0) || ((unsigned int) offset != iterator->offset+i))
+        iterator->direct=MagickFalse;
+    }
+  if (iterator->direct)
+    iterator->stride=sizeof(PixelPacket)/sizeof(Quantum);
+  else
+    iterator->stride=(unsigned int) iterator->length;
+
+  iterator->view=OpenCacheView(image);
+  if (iterator->view == (ViewInfo *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      ClosePixelRowIterator(iterator);
+      return (PixelRowIterator *) NULL;
+    }
+  return iterator;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S e t P i x e l R o w I t e r a t o r R e g i o n                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SetPixelRowIteratorRegion() selects the image region whose rows are
+%  returned by subsequent calls to NextPixelRowIteratorRow(), starting
+%  with the top row.  For a read-only iterator, the region may extend
+%  beyond the image bounds, in which case virtual pixels are returned.
+%
+%  The format of the SetPixelRowIteratorRegion method is:
+%
+%      MagickPassFail SetPixelRowIteratorRegion(PixelRowIterator *iterator,
+%        const long x,const long y,const unsigned long columns,
+%        const unsigned long rows)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+%    o x, y, columns, rows: The region.
+%
+*/
+MagickExport MagickPassFail SetPixelRowIteratorRegion(
+  PixelRowIterator *iterator,const long x,const long y,
+  const unsigned long columns,const unsigned long rows)
+{
+  size_t
+    buffer_size;
+
+  assert(iterator != (PixelRowIterator *) NULL);
+  assert(iterator->signature == MagickSignature);
+  iterator->x=x;
+  iterator->y=y;
+  iterator->columns=columns;
+  iterator->rows=rows;
+  iterator->row=0;
+  iterator->pending=MagickFalse;
+  iterator->failed=MagickFalse;
+  if ((columns == 0) || (rows == 0))
+    {
+      iterator->rows=0;
+      iterator->failed=MagickTrue;
+      ThrowException(&iterator->image->exception,OptionError,
+                     NonzeroWidthAndHeightRequired,iterator->image->filename);
+      return MagickFail;
+    }
+  if (!iterator->direct)
+    {
+      buffer_size=MagickArraySize(MagickArraySize(columns,iterator->length),
+                                  iterator->sample_size);
+      if (buffer_size > iterator->buffer_size)
+        {
+          MagickReallocMemory(void *,iterator->buffer,buffer_size);
+          iterator->buffer_size=(iterator->buffer == (void *) NULL ? 0 :
+                                 buffer_size);
+        }
+      if ((buffer_size == 0) || (iterator->buffer == (void *) NULL))
+        {
+          iterator->rows=0;
+          iterator->failed=MagickTrue;
+          ThrowException(&iterator->image->exception,ResourceLimitError,
+                         MemoryAllocationFailed,iterator->image->filename);
+          return MagickFail;
+        }
+    }
+  return MagickPass;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   N e x t P i x e l R o w I t e r a t o r R o w                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  NextPixelRowIteratorRow() returns the samples of the next row of the
+%  region selected by SetPixelRowIteratorRegion(), as an array of the
+%  storage type specified when the iterator was opened.  The first
+%  sample of pixel x is at offset x*GetPixelRowIteratorStride().  The
+%  row remains valid until the next call to NextPixelRowIteratorRow()
+%  or SetPixelRowIteratorRegion(), and must not be modified unless the
+%  iterator is writable.  A null pointer is returned after the last row
+%  of the region, or if an error occurs.  GetPixelRowIteratorStatus()
+%  distinguishes the two cases.
+%
+%  The format of the NextPixelRowIteratorRow method is:
+%
+%      void *NextPixelRowIteratorRow(PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+*/
+MagickExport void *NextPixelRowIteratorRow(PixelRowIterator *iterator)
+{
+  const PixelPacket
+    *p;
+
+  long
+    y;
+
+  assert(iterator != (PixelRowIterator *) NULL);
+  assert(iterator->signature == MagickSignature);
+  if (iterator->row >= iterator->rows)
+    return (void *) NULL;
+  y=iterator->y+(long) iterator->row;
+  if (iterator->writable)
+    p=GetCacheViewPixels(iterator->view,iterator->x,y,iterator->columns,1,
+                         &iterator->image->exception);
+  else
+    p=AcquireCacheViewPixels(iterator->view,iterator->x,y,iterator->columns,
+                             1,&iterator->image->exception);
+  if (p == (const PixelPacket *) NULL)
+    {
+      iterator->rows=0;
+      iterator->failed=MagickTrue;
+      return (void *) NULL;
+    }
+  iterator->row++;
+  iterator->pending=iterator->writable;
+  if (iterator->direct)
+    return (void *) ((Quantum *) p+iterator->offset);
+  (void) ExportMappedPixels(iterator->image,p,iterator->columns,
+                            iterator->quantum_map,iterator->length,
+                            iterator->type,iterator->buffer);
+  return iterator->buffer;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   S y n c P i x e l R o w I t e r a t o r R o w                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  SyncPixelRowIteratorRow() commits the row most recently returned by
+%  NextPixelRowIteratorRow() of a writable iterator to the image.  Only
+%  the samples named by the map are updated.
+%
+%  The format of the SyncPixelRowIteratorRow method is:
+%
+%      MagickPassFail SyncPixelRowIteratorRow(PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+*/
+MagickExport MagickPassFail SyncPixelRowIteratorRow(PixelRowIterator *iterator)
+{
+  PixelPacket
+    *q;
+
+  assert(iterator != (PixelRowIterator *) NULL);
+  assert(iterator->signature == MagickSignature);
+  if (!iterator->pending)
+    {
+      ThrowException(&iterator->image->exception,CacheError,
+                     UnableToSyncCache,iterator->image->filename);
+      return MagickFail;
+    }
+  iterator->pending=MagickFalse;
+  q=AccessCacheViewPixels(iterator->view);
+  if (q == (PixelPacket *) NULL)
+    return MagickFail;
+  if (!iterator->direct)
+    ImportMappedPixels(q,iterator->columns,iterator->quantum_map,
+                       iterator->length,iterator->type,iterator->buffer);
+  return SyncCacheViewPixels(iterator->view,&iterator->image->exception);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   G e t P i x e l R o w I t e r a t o r S t r i d e                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetPixelRowIteratorStride() returns the distance, in samples, between
+%  the first samples of successive pixels in the rows returned by
+%  NextPixelRowIteratorRow().  This is the number of samples in the map,
+%  unless rows are returned directly from the pixel cache.
+%
+%  The format of the GetPixelRowIteratorStride method is:
+%
+%      unsigned int GetPixelRowIteratorStride(const PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+*/
+MagickExport unsigned int GetPixelRowIteratorStride(
+  const PixelRowIterator *iterator)
+{
+  assert(iterator != (const PixelRowIterator *) NULL);
+  assert(iterator->signature == MagickSignature);
+  return iterator->stride;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   G e t P i x e l R o w I t e r a t o r S t a t u s                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetPixelRowIteratorStatus() returns MagickFail if selecting the current
+%  region, or fetching one of its rows, has failed.  The error is reported
+%  via the exception member of the image.  Since a warning may already be
+%  recorded there, this is the way to tell whether a null pointer returned
+%  by NextPixelRowIteratorRow() indicates an error, or the end of the
+%  region.
+%
+%  The format of the GetPixelRowIteratorStatus method is:
+%
+%      MagickPassFail GetPixelRowIteratorStatus(
+%        const PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+*/
+MagickExport MagickPassFail GetPixelRowIteratorStatus(
+  const PixelRowIterator *iterator)
+{
+  assert(iterator != (const PixelRowIterator *) NULL);
+  assert(iterator->signature == MagickSignature);
+  return (iterator->failed ? MagickFail : MagickPass);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   C l o s e P i x e l R o w I t e r a t o r                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ClosePixelRowIterator() destroys an iterator returned by
+%  OpenPixelRowIterator().  A modified row which has not been synced is
+%  discarded.
+%
+%  The format of the ClosePixelRowIterator method is:
+%
+%      void ClosePixelRowIterator(PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o iterator: The iterator returned by OpenPixelRowIterator().
+%
+*/
+MagickExport void ClosePixelRowIterator(PixelRowIterator *iterator)
+{
+  if (iterator == (PixelRowIterator *) NULL)
+    return;
+  assert(iterator->signature == MagickSignature);
+  if (iterator->view != (ViewInfo *) NULL)
+    CloseCacheView(iterator->view);
+  MagickFreeMemory(iterator->quantum_map);
+  MagickFreeMemory(iterator->buffer);
+  (void) memset((void *) iterator,0xbf,sizeof(PixelRowIterator));
+  MagickFreeMemory(iterator);
+}
@@ -138,6 +138,16 @@ typedef struct _ImportPixelAreaInfo
 
 } ImportPixelAreaInfo;
 
+/*
+  Opaque row-streaming encoder handle (see OpenImageRowEncoder()).
+*/
+typedef struct _ImageRowEncoder ImageRowEncoder;
+
+/*
+  Opaque typed pixel row iterator handle (see OpenPixelRowIterator()).
+*/
+typedef struct _PixelRowIterator PixelRowIterator;
+
 extern MagickExport const char
   *StorageTypeToString(const StorageType storage_type),
   *QuantumSampleTypeToString(const QuantumSampleType sample_type),
@@ -191,6 +201,34 @@ extern MagickExport MagickPassFail
 extern MagickExport unsigned int
   MagickGetQuantumSamplesPerPixel(const QuantumType quantum_type);
 
+extern MagickExport ImageRowEncoder
+  *OpenImageRowEncoder(const ImageInfo *image_info,Image *image,
+    ExceptionInfo *exception);
+
+extern MagickExport PixelPacket
+  *SetImageRowEncoderPixels(ImageRowEncoder *encoder);
+
+extern MagickExport MagickPassFail
+  CloseImageRowEncoder(ImageRowEncoder *encoder),
+  SyncImageRowEncoderPixels(ImageRowEncoder *encoder);
+
+extern MagickExport PixelRowIterator
+  *OpenPixelRowIterator(Image *image,const char *map,const StorageType type,
+    const MagickBool writable,ExceptionInfo *exception);
+
+extern MagickExport void
+  *NextPixelRowIteratorRow(PixelRowIterator *iterator),
+  ClosePixelRowIterator(PixelRowIterator *iterator);
+
+extern MagickExport MagickPassFail
+  SetPixelRowIteratorRegion(PixelRowIterator *iterator,const long x,
+    const long y,const unsigned long columns,const unsigned long rows),
+  SyncPixelRowIteratorRow(PixelRowIterator *iterator),
+  GetPixelRowIteratorStatus(const PixelRowIterator *iterator);
+
+extern MagickExport unsigned int
+  GetPixelRowIteratorStride(const PixelRowIterator *iterator);
+
 #if defined(MAGICK_IMPLEMENTATION)
 
 extern MagickExport void
@@ -199,6 +237,9 @@ extern MagickExport void
 extern MagickPassFail
   InitializeConstitute(void);
 
+extern MagickBool
+  MagickPixelAreaKernelsEnabled(void);
+
 #endif /* defined(MAGICK_IMPLEMENTATION) */
 
 #if defined(__cplusplus) || defined(c_plusplus)
@@ -44,6 +44,7 @@
 #include "magick/enhance.h"
 #include "magick/enum_strings.h"
 #include "magick/gem.h"
+#include "magick/integral.h"
 #include "magick/log.h"
 #include "magick/monitor.h"
 #include "magick/omp_data_view.h"
@@ -74,7 +75,7 @@
 %  The format of the AdaptiveThresholdImage method is:
 %
 %      Image *AdaptiveThresholdImage(Image *image,const unsigned long width,
-%        const unsigned long height,const unsigned long unsigned long,
+%        const unsigned long height,const double offset,
 %        ExceptionInfo *exception)
 %
 %  A description of each parameter follows:
@@ -92,21 +93,33 @@
 %
 */
 #define AdaptiveThresholdImageText "[%s] Adaptive threshold..."
-/* Macros for accessing dynamic preprocess buffer */
-#define PRE(X,Y) ((Y + height + 2) % (height + 2)) * (image->columns + (width << 1)) + X
+/* Minimum number of rows thresholded from each integral image band */
+#define AdaptiveThresholdBandRows 64
+/* Maximum bytes of integral image bands in use at once */
+#define AdaptiveThresholdBandMemory 268435456.0
 
-MagickExport Image *AdaptiveThresholdImage(const Image * image,
-					   const unsigned long width,
-					   const unsigned long height,
-					   const double offset,
-					   ExceptionInfo * exception)
+/*
+  Adaptive threshold an image using a single summed-area table of
+  height+2 rows which is updated as it slides down the image.  This is
+  slower than thresholding bands of rows in parallel, but bounds the
+  memory used for a large neighborhood or a very wide image.  The
+  results are the same, except for the first column when the
+  neighborhood is one pixel wide.
+*/
+#define PRE(X,Y) ((Y + height + 2) % (height + 2)) * (image->columns + (width << 1)) + X
+static MagickPassFail
+AdaptiveThresholdImageWindow(const Image * image,
+                             Image * threshold_image,
+                             const unsigned long width,
+                             const unsigned long height,
+                             const long long_offset,
+                             const MagickBool is_grayscale,
+                             const MagickBool matte,
+                             ExceptionInfo * exception)
 {
   const PixelPacket * restrict
     p = (const PixelPacket *) NULL;
 
-  Image
-    * restrict threshold_image;
-
   LongPixelPacket
     * restrict dyn_process;
 
@@ -114,7 +127,7 @@ MagickExport Image *AdaptiveThresholdImage(const Image * image,
     local_area = width * height;
 
   unsigned long
-    int i;
+    i;
 
   /*
    *  allocates pre processing buffer,
@@ -134,60 +147,22 @@ MagickExport Image *AdaptiveThresholdImage(const Image * image,
   const LongPixelPacket
     long_zero = { 0UL, 0UL, 0UL, 0UL };
 
-  const long
-    long_offset = (long) (offset*MaxMap/MaxRGB + 0.5);
-
-  const MagickBool
-    is_monochrome = image->is_monochrome,
-    is_grayscale = image->is_grayscale;
-
-  MagickPassFail
-    status;
-
-  const MagickBool
-    matte = ((image->matte)
-             || (image->colorspace == CMYKColorspace));
-
   unsigned long
     overflow_mask = 0x1UL << (sizeof(dyn_process[0].red)*8-1);
 
   MagickBool
     overflow_eminent;
 
-  /*
-    Initialize thresholded image attributes.
-  */
-  assert(image != (const Image *) NULL);
-  assert(image->signature == MagickSignature);
-  assert(exception != (ExceptionInfo *) NULL);
-  assert(exception->signature == MagickSignature);
-
-  if ((image->columns < width) || (image->rows < height))
-    ThrowImageException3(OptionError, UnableToThresholdImage,
-			 ImageSmallerThanRadius);
-
-  threshold_image = CloneImage(image, 0, 0, MagickTrue, exception);
-  if (threshold_image == (Image *) NULL)
-    return ((Image *) NULL);
-  if (is_monochrome)
-    return threshold_image;
-  (void) SetImageType(threshold_image, TrueColorType);
-  status = MagickPass;
+  MagickPassFail
+    status = MagickPass;
 
-#if 0
-  fprintf(stderr,"overflow_mask=%lx\n",overflow_mask);
-  fprintf(stderr,"overflow pixels=%lu\n",(((~0UL) >> 1)/MaxMap));
-#endif
-  /*
-    Adaptive threshold image.
-  */
   dyn_process = MagickAllocateArray(LongPixelPacket *,dyn_process_size,
                                     sizeof(LongPixelPacket));
   if (dyn_process == (LongPixelPacket *) NULL)
     {
-      DestroyImage(threshold_image);
-      ThrowImageException3(ResourceLimitError,MemoryAllocationFailed,
-                           UnableToThresholdImage);
+      ThrowException3(exception,ResourceLimitError,MemoryAllocationFailed,
+                      UnableToThresholdImage);
+      return MagickFail;
     }
   (void) memset(dyn_process,0,dyn_process_size*sizeof(LongPixelPacket));
 
@@ -445,6 +420,235 @@ MagickExport Image *AdaptiveThresholdImage(const Image * image,
 
   MagickFreeMemory(dyn_process);
 
+  return status;
+}
+#undef PRE
+
+MagickExport Image *AdaptiveThresholdImage(const Image * image,
+					   const unsigned long width,
+					   const unsigned long height,
+					   const double offset,
+					   ExceptionInfo * exception)
+{
+  Image
+    * restrict threshold_image;
+
+  const magick_uint64_t
+    local_area = (magick_uint64_t) width * height;
+
+  const long
+    long_offset = (long) (offset*MaxMap/MaxRGB + 0.5);
+
+  const MagickBool
+    is_monochrome = image->is_monochrome,
+    is_grayscale = image->is_grayscale;
+
+  const MagickBool
+    matte = ((image->matte)
+             || (image->colorspace == CMYKColorspace));
+
+  unsigned int
+    channels;
+
+  unsigned long
+    band_rows,
+    row_count = 0UL;
+
+  double
+    band_bytes;
+
+  long
+    band,
+    bands;
+
+#if defined(HAVE_OPENMP)
+  int
+    max_bands;
+#endif
+
+  MagickPassFail
+    status;
+
+  /*
+    Initialize thresholded image attributes.
+  */
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(exception != (ExceptionInfo *) NULL);
+  assert(exception->signature == MagickSignature);
+
+  if ((image->columns < width) || (image->rows < height))
+    ThrowImageException3(OptionError, UnableToThresholdImage,
+			 ImageSmallerThanRadius);
+
+  threshold_image = CloneImage(image, 0, 0, MagickTrue, exception);
+  if (threshold_image == (Image *) NULL)
+    return ((Image *) NULL);
+  if (is_monochrome)
+    return threshold_image;
+  (void) SetImageType(threshold_image, TrueColorType);
+  status = MagickPass;
+
+  /*
+    Select the summed channels: gray, gray and opacity, RGB, or RGB
+    and opacity.
+  */
+  channels = (is_grayscale ? 1U : 3U) + (matte ? 1U : 0U);
+
+  /*
+    Adaptive threshold image.  The image is processed in bands of rows,
+    in parallel.  Each band computes an integral image covering its rows
+    plus the neighborhood around them, so the mean of any neighborhood
+    is obtained from four table entries.  The neighborhood of pixel
+    (x,y) spans columns x-(width-1-width/2) to x+width/2 and rows
+    y-(height-1-height/2) to y+height/2.  Pixels outside the image are
+    virtual pixels.
+  */
+  band_rows = Max(AdaptiveThresholdBandRows, height);
+  bands = (long) ((image->rows + band_rows - 1)/band_rows);
+
+  /*
+    Limit the number of bands processed at once so that their integral
+    images fit in AdaptiveThresholdBandMemory.  If even one band does
+    not fit, then use a single sliding summed-area table instead.
+  */
+  band_bytes = ((double) image->columns + width)*
+    ((double) band_rows + height)*channels*sizeof(magick_uint64_t);
+  if (band_bytes > AdaptiveThresholdBandMemory)
+    {
+      if (image->logging)
+        (void) LogMagickEvent(TransformEvent,GetMagickModule(),
+                              "Integral image band requires %.0f bytes, "
+                              "using sliding window",band_bytes);
+      status = AdaptiveThresholdImageWindow(image, threshold_image, width,
+                                            height, long_offset,
+                                            is_grayscale, matte, exception);
+      bands = 0;
+    }
+#if defined(HAVE_OPENMP)
+  max_bands = omp_get_max_threads();
+  if (max_bands*band_bytes > AdaptiveThresholdBandMemory)
+    max_bands = Max((int) (AdaptiveThresholdBandMemory/band_bytes), 1);
+#  pragma omp parallel for if(max_bands > 1) num_threads(max_bands) schedule(dynamic,1) shared(row_count, status)
+#endif
+  for (band = 0; band < bands; band++)
+    {
+      IntegralImage
+        *integral;
+
+      long
+        band_y;
+
+      unsigned long
+        rows,
+        y;
+
+      MagickPassFail
+        thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_AdaptiveThresholdImage)
+#endif
+      thread_status = status;
+      if (thread_status == MagickFail)
+        continue;
+
+      band_y = band*(long) band_rows;
+      rows = Min(band_rows, image->rows - band_y);
+      integral = AllocateIntegralImage(image,
+                                       -(long) (width - 1 - width/2),
+                                       band_y - (long) (height - 1 - height/2),
+                                       image->columns + width - 1,
+                                       rows + height - 1,
+                                       channels, MagickFalse, exception);
+      if (integral == (IntegralImage *) NULL)
+        thread_status = MagickFail;
+
+      for (y = 0; (thread_status != MagickFail) && (y < rows); y++)
+        {
+          PixelPacket
+            *restrict q;
+
+          const magick_uint64_t
+            *restrict bottom,
+            *restrict top;
+
+          unsigned long
+            x;
+
+          q = GetImagePixelsEx(threshold_image, 0, band_y + (long) y,
+                               threshold_image->columns, 1, exception);
+          if (q == (PixelPacket *) NULL)
+            {
+              thread_status = MagickFail;
+              break;
+            }
+
+          top = integral->sums + IntegralImageIndex(integral, 0, y);
+          bottom = integral->sums + IntegralImageIndex(integral, 0, y + height);
+          for (x = 0; x < threshold_image->columns; x++)
+            {
+              long
+                threshold[4];
+
+              unsigned int
+                c;
+
+              /*
+                Threshold each channel against the neighborhood mean plus
+                the offset, clamped to the range 0 to MaxMap.
+              */
+              for (c = 0; c < channels; c++)
+                {
+                  magick_uint64_t
+                    sum;
+
+                  sum = bottom[(x + width)*channels + c]
+                    - top[(x + width)*channels + c]
+                    - bottom[x*channels + c]
+                    + top[x*channels + c];
+                  threshold[c] = (long) ScaleQuantumToMap((Quantum) (sum/local_area))
+                    + long_offset;
+                  if (threshold[c] > (long) MaxMap)
+                    threshold[c] = (long) MaxMap;
+                  else if (threshold[c] < 0L)
+                    threshold[c] = 0L;
+                }
+
+              /* grayscale and red */
+              q[x].red = ((long) ScaleQuantumToMap(q[x].red) <= threshold[0] ? 0U : MaxRGB);
+              if (!is_grayscale)
+                {
+                  q[x].green = ((long) ScaleQuantumToMap(q[x].green) <= threshold[1] ? 0U : MaxRGB);
+                  q[x].blue = ((long) ScaleQuantumToMap(q[x].blue) <= threshold[2] ? 0U : MaxRGB);
+                }
+              if (matte)
+                q[x].opacity =
+                  ((long) ScaleQuantumToMap(q[x].opacity) <= threshold[channels - 1] ? 0U : MaxRGB);
+              if (is_grayscale)
+                q[x].green = q[x].blue = q[x].red;
+            }
+          if (!SyncImagePixelsEx(threshold_image, exception))
+            thread_status = MagickFail;
+        }
+      DestroyIntegralImage(integral);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_AdaptiveThresholdImage)
+#endif
+      {
+        row_count += rows;
+        if (thread_status != MagickFail)
+          if (!MagickMonitorFormatted(row_count, image->rows, exception,
+                                      AdaptiveThresholdImageText,
+                                      image->filename))
+            thread_status = MagickFail;
+
+        if (thread_status == MagickFail)
+          status = MagickFail;
+      }
+    }
+
   if (MagickFail == status)
     {
       DestroyImage(threshold_image);
@@ -1023,6 +1023,12 @@ MagickExport const char *MetricTypeToString(MetricType metric)
     case RootMeanSquaredErrorMetric:
       metric_string="RootMeanSquaredError";
       break;
+    case StructuralSimilarityMetric:
+      metric_string="StructuralSimilarity";
+      break;
+    case MultiScaleStructuralSimilarityMetric:
+      metric_string="MultiScaleStructuralSimilarity";
+      break;
     }
 
   return metric_string;
@@ -1047,6 +1053,13 @@ MagickExport MetricType StringToMetricType(const char *option)
   else if ((LocaleCompare("RMSE",option) == 0) ||
            (LocaleCompare("RootMeanSquaredError",option) == 0))
     metric_type=RootMeanSquaredErrorMetric;
+  else if ((LocaleCompare("SSIM",option) == 0) ||
+           (LocaleCompare("StructuralSimilarity",option) == 0))
+    metric_type=StructuralSimilarityMetric;
+  else if ((LocaleCompare("MSSSIM",option) == 0) ||
+           (LocaleCompare("MS-SSIM",option) == 0) ||
+           (LocaleCompare("MultiScaleStructuralSimilarity",option) == 0))
+    metric_type=MultiScaleStructuralSimilarityMetric;
 
   return metric_type;
 }
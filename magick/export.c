@@ -20,6 +20,7 @@
 #include "magick/floats.h"
 #include "magick/magick.h"
 #include "magick/pixel_cache.h"
+#include "magick/utility.h"
 
 /*
   Type definitions
@@ -3035,6 +3036,617 @@ ExportCMYKAQuantumType(unsigned char * restrict destination,
   return MagickPass;
 }
 
+/*
+  Specialized export kernels.
+
+  The ExportXXXQuantumType() functions above support every sample size,
+  and decide the endianness and scaling for each sample.  The kernels
+  below each implement exactly one common combination of quantum type,
+  sample size, sample type, and endianness, so their inner loops are
+  free of per-sample decisions and may be vectorized.  A kernel is
+  selected once per call by SelectExportKernel().  If there is no
+  kernel for a combination, the generic code is used.  The kernels
+  produce output identical to the generic code.
+*/
+#if defined(HAVE_OPENMP) && defined(_OPENMP) && (_OPENMP >= 201307)
+#  define HAVE_OPENMP_SIMD 1
+#endif
+
+typedef struct _ExportKernelContext
+{
+  double
+    double_minvalue,      /* Minimum value for floating point samples */
+    double_scale;         /* Scale for floating point samples */
+
+#if QuantumDepth == 8
+  unsigned char
+    float16[2*(MaxRGB+1)]; /* Quantum to 16-bit float, in output byte order */
+#endif /* QuantumDepth == 8 */
+} ExportKernelContext;
+
+typedef unsigned long (*ExportKernel)(unsigned char * restrict q,
+                                      const PixelPacket * restrict p,
+                                      const unsigned long number_pixels,
+                                      const ExportKernelContext *context);
+
+#define ExportKernelUInt16(q,msb,value)                 \
+  {                                                     \
+    if (msb)                                            \
+      {                                                 \
+        (q)[0]=(unsigned char) ((value) >> 8);          \
+        (q)[1]=(unsigned char) (value);                 \
+      }                                                 \
+    else                                                \
+      {                                                 \
+        (q)[0]=(unsigned char) (value);                 \
+        (q)[1]=(unsigned char) ((value) >> 8);          \
+      }                                                 \
+  }
+#define ExportKernelFloat32(q,native,value)             \
+  {                                                     \
+    float float_value_=(float) (value);                 \
+                                                        \
+    if (native)                                         \
+      {                                                 \
+        (void) memcpy((q),&float_value_,sizeof(float)); \
+      }                                                 \
+    else                                                \
+      {                                                 \
+        unsigned char c_[sizeof(float)];                \
+                                                        \
+        (void) memcpy(c_,&float_value_,sizeof(float));  \
+        (q)[0]=c_[3];                                   \
+        (q)[1]=c_[2];                                   \
+        (q)[2]=c_[1];                                   \
+        (q)[3]=c_[0];                                   \
+      }                                                 \
+  }
+
+/*
+  8-bit unsigned
+*/
+static unsigned long
+ExportRGBA8Kernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                  const unsigned long number_pixels,
+                  const ExportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if QuantumDepth == 8
+  /*
+    With an 8-bit Quantum, each PixelPacket is a 32-bit word which may
+    be reordered in place.
+  */
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      magick_uint32_t
+        word;
+
+      (void) memcpy(&word,&p[x],sizeof(word));
+#if defined(MAGICK_PIXELS_BGRA)
+      word=((word >> 16) & 0x000000ffU) | (word & 0x0000ff00U) |
+        ((word & 0x000000ffU) << 16) | (~word & 0xff000000U);
+#else
+      word ^= 0x000000ffU;
+#endif
+      (void) memcpy(&q[4*x],&word,sizeof(word));
+    }
+#else
+  for (x=0; x < number_pixels; x++)
+    {
+      q[4*x]=ScaleQuantumToChar(GetRedSample(&p[x]));
+      q[4*x+1]=ScaleQuantumToChar(GetGreenSample(&p[x]));
+      q[4*x+2]=ScaleQuantumToChar(GetBlueSample(&p[x]));
+      q[4*x+3]=ScaleQuantumToChar(MaxRGB-GetOpacitySample(&p[x]));
+    }
+#endif /* QuantumDepth == 8 */
+  return 4*number_pixels;
+}
+
+static unsigned long
+ExportCMYK8Kernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                  const unsigned long number_pixels,
+                  const ExportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if QuantumDepth == 8
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      magick_uint32_t
+        word;
+
+      (void) memcpy(&word,&p[x],sizeof(word));
+#if defined(MAGICK_PIXELS_BGRA)
+      word=((word >> 16) & 0x000000ffU) | (word & 0xff00ff00U) |
+        ((word & 0x000000ffU) << 16);
+#endif
+      (void) memcpy(&q[4*x],&word,sizeof(word));
+    }
+#else
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      q[4*x]=ScaleQuantumToChar(GetCyanSample(&p[x]));
+      q[4*x+1]=ScaleQuantumToChar(GetMagentaSample(&p[x]));
+      q[4*x+2]=ScaleQuantumToChar(GetYellowSample(&p[x]));
+      q[4*x+3]=ScaleQuantumToChar(GetBlackSample(&p[x]));
+    }
+#endif /* QuantumDepth == 8 */
+  return 4*number_pixels;
+}
+
+static unsigned long
+ExportGray8Kernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                  const unsigned long number_pixels,
+                  const ExportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    q[x]=ScaleQuantumToChar(GetGraySample(&p[x]));
+  return number_pixels;
+}
+
+static unsigned long
+ExportGrayMinIsWhite8Kernel(unsigned char * restrict q,
+                            const PixelPacket * restrict p,
+                            const unsigned long number_pixels,
+                            const ExportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    q[x]=ScaleQuantumToChar(MaxRGB-GetGraySample(&p[x]));
+  return number_pixels;
+}
+
+/*
+  16-bit unsigned.  The msb argument is a constant in each caller so
+  that the endian test is resolved at compile time.
+*/
+static inline unsigned long
+ExportRGB16(unsigned char * restrict q,const PixelPacket * restrict p,
+            const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      ExportKernelUInt16(&q[6*x],msb,ScaleQuantumToShort(GetRedSample(&p[x])));
+      ExportKernelUInt16(&q[6*x+2],msb,ScaleQuantumToShort(GetGreenSample(&p[x])));
+      ExportKernelUInt16(&q[6*x+4],msb,ScaleQuantumToShort(GetBlueSample(&p[x])));
+    }
+  return 6*number_pixels;
+}
+
+static inline unsigned long
+ExportRGBA16(unsigned char * restrict q,const PixelPacket * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      ExportKernelUInt16(&q[8*x],msb,ScaleQuantumToShort(GetRedSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+2],msb,ScaleQuantumToShort(GetGreenSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+4],msb,ScaleQuantumToShort(GetBlueSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+6],msb,ScaleQuantumToShort(MaxRGB-GetOpacitySample(&p[x])));
+    }
+  return 8*number_pixels;
+}
+
+static inline unsigned long
+ExportCMYK16(unsigned char * restrict q,const PixelPacket * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      ExportKernelUInt16(&q[8*x],msb,ScaleQuantumToShort(GetCyanSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+2],msb,ScaleQuantumToShort(GetMagentaSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+4],msb,ScaleQuantumToShort(GetYellowSample(&p[x])));
+      ExportKernelUInt16(&q[8*x+6],msb,ScaleQuantumToShort(GetBlackSample(&p[x])));
+    }
+  return 8*number_pixels;
+}
+
+static inline unsigned long
+ExportGray16(unsigned char * restrict q,const PixelPacket * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    ExportKernelUInt16(&q[2*x],msb,ScaleQuantumToShort(GetGraySample(&p[x])));
+  return 2*number_pixels;
+}
+
+static unsigned long
+ExportRGB16MSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                     const unsigned long number_pixels,
+                     const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportRGB16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ExportRGB16LSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                     const unsigned long number_pixels,
+                     const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportRGB16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ExportRGBA16MSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportRGBA16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ExportRGBA16LSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportRGBA16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ExportCMYK16MSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportCMYK16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ExportCMYK16LSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportCMYK16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ExportGray16MSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportGray16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ExportGray16LSBKernel(unsigned char * restrict q,const PixelPacket * restrict p,
+                      const unsigned long number_pixels,
+                      const ExportKernelContext *ARGUNUSED(context))
+{
+  return ExportGray16(q,p,number_pixels,MagickFalse);
+}
+
+/*
+  32-bit float.  Values are computed in double precision and then
+  rounded to float, as is done by the generic code.  The native
+  argument is set if the requested byte order is the CPU's.
+*/
+static inline unsigned long
+ExportRGBFloat32(unsigned char * restrict q,const PixelPacket * restrict p,
+                 const unsigned long number_pixels,
+                 const ExportKernelContext *context,const MagickBool native)
+{
+  const double
+    double_minvalue=context->double_minvalue,
+    double_scale=context->double_scale;
+
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      ExportKernelFloat32(&q[12*x],native,GetRedSample(&p[x])*double_scale+double_minvalue);
+      ExportKernelFloat32(&q[12*x+4],native,GetGreenSample(&p[x])*double_scale+double_minvalue);
+      ExportKernelFloat32(&q[12*x+8],native,GetBlueSample(&p[x])*double_scale+double_minvalue);
+    }
+  return 12*number_pixels;
+}
+
+static inline unsigned long
+ExportRGBAFloat32(unsigned char * restrict q,const PixelPacket * restrict p,
+                  const unsigned long number_pixels,
+                  const ExportKernelContext *context,const MagickBool native)
+{
+  const double
+    double_minvalue=context->double_minvalue,
+    double_scale=context->double_scale;
+
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      ExportKernelFloat32(&q[16*x],native,GetRedSample(&p[x])*double_scale+double_minvalue);
+      ExportKernelFloat32(&q[16*x+4],native,GetGreenSample(&p[x])*double_scale+double_minvalue);
+      ExportKernelFloat32(&q[16*x+8],native,GetBlueSample(&p[x])*double_scale+double_minvalue);
+      ExportKernelFloat32(&q[16*x+12],native,(MaxRGB-GetOpacitySample(&p[x]))*double_scale+double_minvalue);
+    }
+  return 16*number_pixels;
+}
+
+static inline unsigned long
+ExportGrayFloat32(unsigned char * restrict q,const PixelPacket * restrict p,
+                  const unsigned long number_pixels,
+                  const ExportKernelContext *context,const MagickBool native)
+{
+  const double
+    double_minvalue=context->double_minvalue,
+    double_scale=context->double_scale;
+
+  register unsigned long
+    x;
+
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    ExportKernelFloat32(&q[4*x],native,PixelIntensity(&p[x])*double_scale+double_minvalue);
+  return 4*number_pixels;
+}
+
+static unsigned long
+ExportRGBFloat32NativeKernel(unsigned char * restrict q,
+                          const PixelPacket * restrict p,
+                          const unsigned long number_pixels,
+                          const ExportKernelContext *context)
+{
+  return ExportRGBFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ExportRGBFloat32SwappedKernel(unsigned char * restrict q,
+                          const PixelPacket * restrict p,
+                          const unsigned long number_pixels,
+                          const ExportKernelContext *context)
+{
+  return ExportRGBFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ExportRGBAFloat32NativeKernel(unsigned char * restrict q,
+                           const PixelPacket * restrict p,
+                           const unsigned long number_pixels,
+                           const ExportKernelContext *context)
+{
+  return ExportRGBAFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ExportRGBAFloat32SwappedKernel(unsigned char * restrict q,
+                           const PixelPacket * restrict p,
+                           const unsigned long number_pixels,
+                           const ExportKernelContext *context)
+{
+  return ExportRGBAFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ExportGrayFloat32NativeKernel(unsigned char * restrict q,
+                           const PixelPacket * restrict p,
+                           const unsigned long number_pixels,
+                           const ExportKernelContext *context)
+{
+  return ExportGrayFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ExportGrayFloat32SwappedKernel(unsigned char * restrict q,
+                           const PixelPacket * restrict p,
+                           const unsigned long number_pixels,
+                           const ExportKernelContext *context)
+{
+  return ExportGrayFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+#if QuantumDepth == 8
+/*
+  16-bit float.  Converting to 16-bit float is expensive, but with an
+  8-bit Quantum there are only 256 distinct input values, so each call
+  converts them once into a table (see SelectExportKernel()).
+*/
+static unsigned long
+ExportRGBFloat16Kernel(unsigned char * restrict q,
+                       const PixelPacket * restrict p,
+                       const unsigned long number_pixels,
+                       const ExportKernelContext *context)
+{
+  const unsigned char
+    *float16=context->float16;
+
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      (void) memcpy(&q[6*x],&float16[2*GetRedSample(&p[x])],2);
+      (void) memcpy(&q[6*x+2],&float16[2*GetGreenSample(&p[x])],2);
+      (void) memcpy(&q[6*x+4],&float16[2*GetBlueSample(&p[x])],2);
+    }
+  return 6*number_pixels;
+}
+
+static unsigned long
+ExportRGBAFloat16Kernel(unsigned char * restrict q,
+                        const PixelPacket * restrict p,
+                        const unsigned long number_pixels,
+                        const ExportKernelContext *context)
+{
+  const unsigned char
+    *float16=context->float16;
+
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      (void) memcpy(&q[8*x],&float16[2*GetRedSample(&p[x])],2);
+      (void) memcpy(&q[8*x+2],&float16[2*GetGreenSample(&p[x])],2);
+      (void) memcpy(&q[8*x+4],&float16[2*GetBlueSample(&p[x])],2);
+      (void) memcpy(&q[8*x+6],&float16[2*(MaxRGB-GetOpacitySample(&p[x]))],2);
+    }
+  return 8*number_pixels;
+}
+#endif /* QuantumDepth == 8 */
+
+/*
+  Select a kernel for the requested export, or return NULL if the
+  generic code should be used.  The context is initialized as needed
+  by the selected kernel.
+*/
+static ExportKernel
+SelectExportKernel(const Image *image,const QuantumType quantum_type,
+                   const unsigned int quantum_size,
+                   const QuantumSampleType sample_type,
+                   const EndianType endian,
+                   const MagickBool grayscale_miniswhite,
+                   const unsigned long number_pixels,
+                   ExportKernelContext *context)
+{
+  const MagickBool
+    msb=(endian != LSBEndian),
+    native=(endian == MyEndianType);
+
+  if (!MagickPixelAreaKernelsEnabled())
+    return (ExportKernel) NULL;
+
+  if (sample_type == UnsignedQuantumSampleType)
+    {
+      switch (quantum_type)
+        {
+        case RGBQuantum:
+          /*
+            The generic 8-bit loop is already as fast as a kernel.
+          */
+          if (quantum_size == 16)
+            return (msb ? ExportRGB16MSBKernel : ExportRGB16LSBKernel);
+          break;
+        case RGBAQuantum:
+          if (quantum_size == 8)
+            return ExportRGBA8Kernel;
+          if (quantum_size == 16)
+            return (msb ? ExportRGBA16MSBKernel : ExportRGBA16LSBKernel);
+          break;
+        case CMYKQuantum:
+          if (quantum_size == 8)
+            return ExportCMYK8Kernel;
+          if (quantum_size == 16)
+            return (msb ? ExportCMYK16MSBKernel : ExportCMYK16LSBKernel);
+          break;
+        case GrayQuantum:
+          /*
+            Non-gray images require a per-pixel intensity calculation
+            and are left to the generic code.
+          */
+          if (!image->is_grayscale)
+            break;
+          if (quantum_size == 8)
+            return (grayscale_miniswhite ? ExportGrayMinIsWhite8Kernel :
+                    ExportGray8Kernel);
+          if ((quantum_size == 16) && !grayscale_miniswhite)
+            return (msb ? ExportGray16MSBKernel : ExportGray16LSBKernel);
+          break;
+        default:
+          break;
+        }
+    }
+  else if (sample_type == FloatQuantumSampleType)
+    {
+      if (quantum_size == 32)
+        {
+          switch (quantum_type)
+            {
+            case RGBQuantum:
+              return (native ? ExportRGBFloat32NativeKernel :
+                      ExportRGBFloat32SwappedKernel);
+            case RGBAQuantum:
+              return (native ? ExportRGBAFloat32NativeKernel :
+                      ExportRGBAFloat32SwappedKernel);
+            case GrayQuantum:
+              return (native ? ExportGrayFloat32NativeKernel :
+                      ExportGrayFloat32SwappedKernel);
+            default:
+              break;
+            }
+        }
+#if QuantumDepth == 8
+      else if ((quantum_size == 16) &&
+               ((quantum_type == RGBQuantum) ||
+                (quantum_type == RGBAQuantum)) &&
+               (number_pixels >= (MaxRGB+1)/2))
+        {
+          /*
+            Build the Quantum to 16-bit float table in the same way
+            as ExportFloat16Quantum().
+          */
+          unsigned char
+            *r=context->float16;
+
+          unsigned int
+            quantum;
+
+          for (quantum=0; quantum <= MaxRGB; quantum++)
+            {
+              unsigned char
+                *q=r;
+
+              ExportFloat16Quantum(endian,q,quantum*context->double_scale+
+                                   context->double_minvalue);
+              r+=2;
+            }
+          return (quantum_type == RGBQuantum ? ExportRGBFloat16Kernel :
+                  ExportRGBAFloat16Kernel);
+        }
+#endif /* QuantumDepth == 8 */
+    }
+
+  return (ExportKernel) NULL;
+}
+
 MagickExport MagickPassFail
 ExportViewPixelArea(const ViewInfo *view,
 		    const QuantumType quantum_type,
@@ -3083,6 +3695,12 @@ ExportViewPixelArea(const ViewInfo *view,
   EndianType
     endian=MSBEndian;
 
+  ExportKernel
+    kernel;
+
+  ExportKernelContext
+    context;
+
   MagickPassFail
     status=MagickPass;
 
@@ -3162,115 +3780,127 @@ ExportViewPixelArea(const ViewInfo *view,
   pixels=AccessCacheViewPixels(view);
   indexes=AcquireCacheViewIndexes(view);
   q=destination;
-  switch (quantum_type)
+  context.double_minvalue=double_minvalue;
+  context.double_scale=double_scale;
+  kernel=SelectExportKernel(image,quantum_type,quantum_size,sample_type,
+                            endian,grayscale_miniswhite,number_pixels,
+                            &context);
+  if (kernel != (ExportKernel) NULL)
     {
-    case UndefinedQuantum:
-      {
-	status=MagickFail;
-	break;
-      }
-    case IndexQuantum:
-      {
-	status=ExportIndexQuantumType(destination,indexes,number_pixels,
-				      quantum_size,sample_type,endian,
-				      image,&bytes_exported);
-        break;
-      }
-    case IndexAlphaQuantum:
-      {
-	status=ExportIndexAlphaQuantumType(destination,pixels,indexes,number_pixels,
-					   quantum_size,sample_type,endian,unsigned_scale,
-					   image,&bytes_exported);
-        break;
-      }
-    case GrayQuantum:
-      {
-	status=ExportGrayQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
-				     sample_type,endian,unsigned_scale,grayscale_miniswhite,
-				     sample_bits,double_minvalue,double_scale,image,
-				     &bytes_exported);
-        break;
-      }
-    case GrayAlphaQuantum:
-      {
-	status=ExportGrayAlphaQuantumType(destination,pixels,number_pixels,quantum_size,
-					  sample_type,endian,unsigned_scale,grayscale_miniswhite,
-					  sample_bits,double_minvalue,double_scale,
-					  image,&bytes_exported);
-        break;
-      }
-    case RedQuantum:
-    case CyanQuantum:
-      {
-	status=ExportRedQuantumType(destination,pixels,number_pixels,quantum_size,
-				    sample_type,endian,unsigned_scale,sample_bits,
-				    double_minvalue,double_scale,&bytes_exported);
-        break;
-      }
-    case GreenQuantum:
-    case MagentaQuantum:
-      {
-	status=ExportGreenQuantumType(destination,pixels,number_pixels,quantum_size,
-				      sample_type,endian,unsigned_scale,sample_bits,
-				      double_minvalue,double_scale,&bytes_exported);
-        break;
-      }
-    case BlueQuantum:
-    case YellowQuantum:
-      {
-	status=ExportBlueQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
-				     endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
-				     &bytes_exported);
-        break;
-      }
-    case AlphaQuantum:
+      bytes_exported=(kernel)(destination,pixels,number_pixels,&context);
+    }
+  else
+    {
+      switch (quantum_type)
 	{
-	  status=ExportAlphaQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
+	case UndefinedQuantum:
+	  {
+	    status=MagickFail;
+	    break;
+	  }
+	case IndexQuantum:
+	  {
+	    status=ExportIndexQuantumType(destination,indexes,number_pixels,
+					  quantum_size,sample_type,endian,
+					  image,&bytes_exported);
+	    break;
+	  }
+	case IndexAlphaQuantum:
+	  {
+	    status=ExportIndexAlphaQuantumType(destination,pixels,indexes,number_pixels,
+					       quantum_size,sample_type,endian,unsigned_scale,
+					       image,&bytes_exported);
+	    break;
+	  }
+	case GrayQuantum:
+	  {
+	    status=ExportGrayQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
+					 sample_type,endian,unsigned_scale,grayscale_miniswhite,
+					 sample_bits,double_minvalue,double_scale,image,
+					 &bytes_exported);
+	    break;
+	  }
+	case GrayAlphaQuantum:
+	  {
+	    status=ExportGrayAlphaQuantumType(destination,pixels,number_pixels,quantum_size,
+					      sample_type,endian,unsigned_scale,grayscale_miniswhite,
+					      sample_bits,double_minvalue,double_scale,
+					      image,&bytes_exported);
+	    break;
+	  }
+	case RedQuantum:
+	case CyanQuantum:
+	  {
+	    status=ExportRedQuantumType(destination,pixels,number_pixels,quantum_size,
 					sample_type,endian,unsigned_scale,sample_bits,
-					double_minvalue,double_scale,image,&bytes_exported);
-	  break;
+					double_minvalue,double_scale,&bytes_exported);
+	    break;
+	  }
+	case GreenQuantum:
+	case MagentaQuantum:
+	  {
+	    status=ExportGreenQuantumType(destination,pixels,number_pixels,quantum_size,
+					  sample_type,endian,unsigned_scale,sample_bits,
+					  double_minvalue,double_scale,&bytes_exported);
+	    break;
+	  }
+	case BlueQuantum:
+	case YellowQuantum:
+	  {
+	    status=ExportBlueQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
+					 endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
+					 &bytes_exported);
+	    break;
+	  }
+	case AlphaQuantum:
+	    {
+	      status=ExportAlphaQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
+					    sample_type,endian,unsigned_scale,sample_bits,
+					    double_minvalue,double_scale,image,&bytes_exported);
+	      break;
+	    }
+	case BlackQuantum:
+	  {
+	    status=ExportBlackQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
+					  endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
+					  &bytes_exported);
+	    break;
+	  }
+	case RGBQuantum:
+	  {
+	    status=ExportRGBQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
+					endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
+					&bytes_exported);
+	    break;
+	  }
+	case RGBAQuantum:
+	  {
+	    status=ExportRGBAQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
+					 endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
+					 &bytes_exported);
+	    break;
+	  }
+	case CMYKQuantum:
+	  {
+	    status=ExportCMYKQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
+					 endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
+					 &bytes_exported);
+	    break;
+	  }
+	case CMYKAQuantum:
+	  {
+	    status=ExportCMYKAQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
+					  sample_type,endian,unsigned_scale,sample_bits,double_minvalue,
+					  double_scale,&bytes_exported);
+	    break;
+	  }
+	case CIEYQuantum:
+	case CIEXYZQuantum:
+	  {
+	    status=MagickFail;
+	    break;
+	  }
 	}
-    case BlackQuantum:
-      {
-	status=ExportBlackQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
-				      endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
-				      &bytes_exported);
-        break;
-      }
-    case RGBQuantum:
-      {
-	status=ExportRGBQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
-				    endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
-				    &bytes_exported);
-        break;
-      }
-    case RGBAQuantum:
-      {
-	status=ExportRGBAQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
-				     endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
-				     &bytes_exported);
-        break;
-      }
-    case CMYKQuantum:
-      {
-	status=ExportCMYKQuantumType(destination,pixels,number_pixels,quantum_size,sample_type,
-				     endian,unsigned_scale,sample_bits,double_minvalue,double_scale,
-				     &bytes_exported);
-        break;
-      }
-    case CMYKAQuantum:
-      {
-	status=ExportCMYKAQuantumType(destination,pixels,indexes,number_pixels,quantum_size,
-				      sample_type,endian,unsigned_scale,sample_bits,double_minvalue,
-				      double_scale,&bytes_exported);
-        break;
-      }
-    case CIEYQuantum:
-    case CIEXYZQuantum:
-      {
-	status=MagickFail;
-	break;
-      }
     }
 
   /*
@@ -181,7 +181,10 @@ int _Gm_convert_fp32_to_fp16 (const float *fp32, fp_16bits *fp16, const int mode
 
   /* For zero, all bits except possibly sbit are zero */
   if (*fp32 == 0)
-    *dst = 0;
+    {
+      *dst = 0;
+      *(dst + 1) = 0;
+    }
   else
     {
 #if !defined(WORDS_BIGENDIAN)
@@ -20,6 +20,7 @@
 #include "magick/floats.h"
 #include "magick/magick.h"
 #include "magick/pixel_cache.h"
+#include "magick/utility.h"
 
 /*
   Type definitions
@@ -2863,7 +2864,7 @@ ImportCMYKQuantumType(const unsigned char *source,
 		ImportUInt16Quantum(endian,unsigned_value,p);
 		SetYellowSample(q,ScaleShortToQuantum(unsigned_value));
 		ImportUInt16Quantum(endian,unsigned_value,p);
-		SetBlackSample(q,unsigned_value);
+		SetBlackSample(q,ScaleShortToQuantum(unsigned_value));
 		q++;
 	      }
 	    break;
@@ -2879,7 +2880,7 @@ ImportCMYKQuantumType(const unsigned char *source,
 		ImportUInt32Quantum(endian,unsigned_value,p);
 		SetYellowSample(q,ScaleLongToQuantum(unsigned_value));
 		ImportUInt32Quantum(endian,unsigned_value,p);
-		SetBlackSample(q,unsigned_value);
+		SetBlackSample(q,ScaleLongToQuantum(unsigned_value));
 		q++;
 	      }
 	    break;
@@ -2895,7 +2896,7 @@ ImportCMYKQuantumType(const unsigned char *source,
 		ImportUInt64Quantum(endian,unsigned_value,p);
 		SetYellowSample(q,ScaleLongToQuantum(unsigned_value));
 		ImportUInt64Quantum(endian,unsigned_value,p);
-		SetBlackSample(q,unsigned_value);
+		SetBlackSample(q,ScaleLongToQuantum(unsigned_value));
 		q++;
 	      }
 	    break;
@@ -3453,6 +3454,688 @@ ImportCIEYQuantumType(const unsigned char *source,
   return MagickPass;
 }
 
+/*
+  Specialized import kernels.
+
+  These are the counterparts of the export kernels in export.c.  Each
+  kernel implements exactly one common combination of quantum type,
+  sample size, sample type, and endianness, so that its inner loop is
+  free of per-sample decisions and may be vectorized.  A kernel is
+  selected once per call by SelectImportKernel(), and the generic
+  ImportXXXQuantumType() functions above are used otherwise.  The
+  kernels produce pixels identical to the generic code.
+*/
+#if defined(HAVE_OPENMP) && defined(_OPENMP) && (_OPENMP >= 201307)
+#  define HAVE_OPENMP_SIMD 1
+#endif
+
+typedef struct _ImportKernelContext
+{
+  double
+    double_minvalue,      /* Minimum value for floating point samples */
+    double_scale;         /* Scale for floating point samples */
+} ImportKernelContext;
+
+typedef unsigned long (*ImportKernel)(PixelPacket * restrict q,
+                                      const unsigned char * restrict p,
+                                      const unsigned long number_pixels,
+                                      const ImportKernelContext *context);
+
+#define ImportKernelUInt16(p,msb)                       \
+  ((msb) ?                                              \
+   (((unsigned int) (p)[0] << 8) | (unsigned int) (p)[1]) :     \
+   ((unsigned int) (p)[0] | ((unsigned int) (p)[1] << 8)))
+#define ImportKernelFloat32(value,p,native)             \
+  {                                                     \
+    float float_value_;                                 \
+                                                        \
+    if (native)                                         \
+      {                                                 \
+        (void) memcpy(&float_value_,(p),sizeof(float)); \
+      }                                                 \
+    else                                                \
+      {                                                 \
+        unsigned char c_[sizeof(float)];                \
+                                                        \
+        c_[0]=(p)[3];                                   \
+        c_[1]=(p)[2];                                   \
+        c_[2]=(p)[1];                                   \
+        c_[3]=(p)[0];                                   \
+        (void) memcpy(&float_value_,c_,sizeof(float));  \
+      }                                                 \
+    value=float_value_;                                 \
+  }
+/*
+  Convert 16-bit float bits to a value in the same way as
+  _Gm_convert_fp16_to_fp32(), but without a function call per sample.
+*/
+#define ImportKernelFloat16(value,p,msb)                                \
+  {                                                                     \
+    magick_uint32_t h_, bits_;                                          \
+    unsigned int expt_;                                                 \
+    float float_value_;                                                 \
+                                                                        \
+    h_=ImportKernelUInt16(p,msb);                                       \
+    expt_=(h_ >> 10) & 0x1fU;                                           \
+    bits_=((h_ & 0x8000U) << 16) |                                      \
+      ((magick_uint32_t) (expt_ != 0 ? expt_ - 15U + 127U : 0U) << 23) | \
+      ((h_ & 0x3ffU) << 13);                                            \
+    (void) memcpy(&float_value_,&bits_,sizeof(float));                  \
+    value=float_value_;                                                 \
+  }
+#define ImportKernelDoubleToQuantum(value,context)                      \
+  RoundDoubleToQuantum(((value)-(context)->double_minvalue)*            \
+                       (context)->double_scale)
+
+/*
+  8-bit unsigned
+*/
+static unsigned long
+ImportRGBA8Kernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if QuantumDepth == 8
+  /*
+    With an 8-bit Quantum, each PixelPacket is a 32-bit word which may
+    be reordered in place.
+  */
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      magick_uint32_t
+        word;
+
+      (void) memcpy(&word,&p[4*x],sizeof(word));
+#if defined(MAGICK_PIXELS_BGRA)
+      word=((word >> 16) & 0x000000ffU) | (word & 0x0000ff00U) |
+        ((word & 0x000000ffU) << 16) | (~word & 0xff000000U);
+#else
+      word ^= 0x000000ffU;
+#endif
+      (void) memcpy(&q[x],&word,sizeof(word));
+    }
+#else
+  for (x=0; x < number_pixels; x++)
+    {
+      SetRedSample(&q[x],ScaleCharToQuantum(p[4*x]));
+      SetGreenSample(&q[x],ScaleCharToQuantum(p[4*x+1]));
+      SetBlueSample(&q[x],ScaleCharToQuantum(p[4*x+2]));
+      SetOpacitySample(&q[x],MaxRGB-ScaleCharToQuantum(p[4*x+3]));
+    }
+#endif /* QuantumDepth == 8 */
+  return 4*number_pixels;
+}
+
+static unsigned long
+ImportCMYK8Kernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+#if QuantumDepth == 8
+#if defined(HAVE_OPENMP_SIMD)
+#  pragma omp simd
+#endif
+  for (x=0; x < number_pixels; x++)
+    {
+      magick_uint32_t
+        word;
+
+      (void) memcpy(&word,&p[4*x],sizeof(word));
+#if defined(MAGICK_PIXELS_BGRA)
+      word=((word >> 16) & 0x000000ffU) | (word & 0xff00ff00U) |
+        ((word & 0x000000ffU) << 16);
+#endif
+      (void) memcpy(&q[x],&word,sizeof(word));
+    }
+#else
+  for (x=0; x < number_pixels; x++)
+    {
+      SetCyanSample(&q[x],ScaleCharToQuantum(p[4*x]));
+      SetMagentaSample(&q[x],ScaleCharToQuantum(p[4*x+1]));
+      SetYellowSample(&q[x],ScaleCharToQuantum(p[4*x+2]));
+      SetBlackSample(&q[x],ScaleCharToQuantum(p[4*x+3]));
+    }
+#endif /* QuantumDepth == 8 */
+  return 4*number_pixels;
+}
+
+static unsigned long
+ImportGray8Kernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetGraySample(&q[x],ScaleCharToQuantum(p[x]));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return number_pixels;
+}
+
+static unsigned long
+ImportGrayMinIsWhite8Kernel(PixelPacket * restrict q,
+                            const unsigned char * restrict p,
+                            const unsigned long number_pixels,
+                            const ImportKernelContext *ARGUNUSED(context))
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetGraySample(&q[x],MaxRGB-ScaleCharToQuantum(p[x]));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return number_pixels;
+}
+
+/*
+  16-bit unsigned.  The msb argument is a constant in each caller so
+  that the endian test is resolved at compile time.
+*/
+static inline unsigned long
+ImportRGB16(PixelPacket * restrict q,const unsigned char * restrict p,
+            const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetRedSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[6*x],msb)));
+      SetGreenSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[6*x+2],msb)));
+      SetBlueSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[6*x+4],msb)));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return 6*number_pixels;
+}
+
+static inline unsigned long
+ImportRGBA16(PixelPacket * restrict q,const unsigned char * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetRedSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x],msb)));
+      SetGreenSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+2],msb)));
+      SetBlueSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+4],msb)));
+      SetOpacitySample(&q[x],MaxRGB-ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+6],msb)));
+    }
+  return 8*number_pixels;
+}
+
+static inline unsigned long
+ImportCMYK16(PixelPacket * restrict q,const unsigned char * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetCyanSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x],msb)));
+      SetMagentaSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+2],msb)));
+      SetYellowSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+4],msb)));
+      SetBlackSample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[8*x+6],msb)));
+    }
+  return 8*number_pixels;
+}
+
+static inline unsigned long
+ImportGray16(PixelPacket * restrict q,const unsigned char * restrict p,
+             const unsigned long number_pixels,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      SetGraySample(&q[x],ScaleShortToQuantum(ImportKernelUInt16(&p[2*x],msb)));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return 2*number_pixels;
+}
+
+static unsigned long
+ImportRGB16MSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                     const unsigned long number_pixels,
+                     const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportRGB16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ImportRGB16LSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                     const unsigned long number_pixels,
+                     const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportRGB16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ImportRGBA16MSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportRGBA16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ImportRGBA16LSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportRGBA16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ImportCMYK16MSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportCMYK16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ImportCMYK16LSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportCMYK16(q,p,number_pixels,MagickFalse);
+}
+
+static unsigned long
+ImportGray16MSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportGray16(q,p,number_pixels,MagickTrue);
+}
+
+static unsigned long
+ImportGray16LSBKernel(PixelPacket * restrict q,const unsigned char * restrict p,
+                      const unsigned long number_pixels,
+                      const ImportKernelContext *ARGUNUSED(context))
+{
+  return ImportGray16(q,p,number_pixels,MagickFalse);
+}
+
+/*
+  32-bit float.  The native argument is set if the source byte order
+  is the CPU's.  As with the generic code, the gray kernel leaves
+  opacity untouched.
+*/
+static inline unsigned long
+ImportRGBFloat32(PixelPacket * restrict q,const unsigned char * restrict p,
+                 const unsigned long number_pixels,
+                 const ImportKernelContext *context,const MagickBool native)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        red,
+        green,
+        blue;
+
+      ImportKernelFloat32(red,&p[12*x],native);
+      ImportKernelFloat32(green,&p[12*x+4],native);
+      ImportKernelFloat32(blue,&p[12*x+8],native);
+      SetRedSample(&q[x],ImportKernelDoubleToQuantum(red,context));
+      SetGreenSample(&q[x],ImportKernelDoubleToQuantum(green,context));
+      SetBlueSample(&q[x],ImportKernelDoubleToQuantum(blue,context));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return 12*number_pixels;
+}
+
+static inline unsigned long
+ImportRGBAFloat32(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *context,const MagickBool native)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        red,
+        green,
+        blue,
+        alpha;
+
+      ImportKernelFloat32(red,&p[16*x],native);
+      ImportKernelFloat32(green,&p[16*x+4],native);
+      ImportKernelFloat32(blue,&p[16*x+8],native);
+      ImportKernelFloat32(alpha,&p[16*x+12],native);
+      SetRedSample(&q[x],ImportKernelDoubleToQuantum(red,context));
+      SetGreenSample(&q[x],ImportKernelDoubleToQuantum(green,context));
+      SetBlueSample(&q[x],ImportKernelDoubleToQuantum(blue,context));
+      SetOpacitySample(&q[x],MaxRGB-ImportKernelDoubleToQuantum(alpha,context));
+    }
+  return 16*number_pixels;
+}
+
+static inline unsigned long
+ImportGrayFloat32(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *context,const MagickBool native)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        gray;
+
+      ImportKernelFloat32(gray,&p[4*x],native);
+      SetGraySample(&q[x],ImportKernelDoubleToQuantum(gray,context));
+    }
+  return 4*number_pixels;
+}
+
+static unsigned long
+ImportRGBFloat32NativeKernel(PixelPacket * restrict q,
+                             const unsigned char * restrict p,
+                             const unsigned long number_pixels,
+                             const ImportKernelContext *context)
+{
+  return ImportRGBFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportRGBFloat32SwappedKernel(PixelPacket * restrict q,
+                              const unsigned char * restrict p,
+                              const unsigned long number_pixels,
+                              const ImportKernelContext *context)
+{
+  return ImportRGBFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ImportRGBAFloat32NativeKernel(PixelPacket * restrict q,
+                              const unsigned char * restrict p,
+                              const unsigned long number_pixels,
+                              const ImportKernelContext *context)
+{
+  return ImportRGBAFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportRGBAFloat32SwappedKernel(PixelPacket * restrict q,
+                               const unsigned char * restrict p,
+                               const unsigned long number_pixels,
+                               const ImportKernelContext *context)
+{
+  return ImportRGBAFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ImportGrayFloat32NativeKernel(PixelPacket * restrict q,
+                              const unsigned char * restrict p,
+                              const unsigned long number_pixels,
+                              const ImportKernelContext *context)
+{
+  return ImportGrayFloat32(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportGrayFloat32SwappedKernel(PixelPacket * restrict q,
+                               const unsigned char * restrict p,
+                               const unsigned long number_pixels,
+                               const ImportKernelContext *context)
+{
+  return ImportGrayFloat32(q,p,number_pixels,context,MagickFalse);
+}
+
+/*
+  16-bit float.  The msb argument selects the source byte order.
+*/
+static inline unsigned long
+ImportRGBFloat16(PixelPacket * restrict q,const unsigned char * restrict p,
+                 const unsigned long number_pixels,
+                 const ImportKernelContext *context,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        red,
+        green,
+        blue;
+
+      ImportKernelFloat16(red,&p[6*x],msb);
+      ImportKernelFloat16(green,&p[6*x+2],msb);
+      ImportKernelFloat16(blue,&p[6*x+4],msb);
+      SetRedSample(&q[x],ImportKernelDoubleToQuantum(red,context));
+      SetGreenSample(&q[x],ImportKernelDoubleToQuantum(green,context));
+      SetBlueSample(&q[x],ImportKernelDoubleToQuantum(blue,context));
+      SetOpacitySample(&q[x],OpaqueOpacity);
+    }
+  return 6*number_pixels;
+}
+
+static inline unsigned long
+ImportRGBAFloat16(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *context,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        red,
+        green,
+        blue,
+        alpha;
+
+      ImportKernelFloat16(red,&p[8*x],msb);
+      ImportKernelFloat16(green,&p[8*x+2],msb);
+      ImportKernelFloat16(blue,&p[8*x+4],msb);
+      ImportKernelFloat16(alpha,&p[8*x+6],msb);
+      SetRedSample(&q[x],ImportKernelDoubleToQuantum(red,context));
+      SetGreenSample(&q[x],ImportKernelDoubleToQuantum(green,context));
+      SetBlueSample(&q[x],ImportKernelDoubleToQuantum(blue,context));
+      SetOpacitySample(&q[x],MaxRGB-ImportKernelDoubleToQuantum(alpha,context));
+    }
+  return 8*number_pixels;
+}
+
+static inline unsigned long
+ImportGrayFloat16(PixelPacket * restrict q,const unsigned char * restrict p,
+                  const unsigned long number_pixels,
+                  const ImportKernelContext *context,const MagickBool msb)
+{
+  register unsigned long
+    x;
+
+  for (x=0; x < number_pixels; x++)
+    {
+      double
+        gray;
+
+      ImportKernelFloat16(gray,&p[2*x],msb);
+      SetGraySample(&q[x],ImportKernelDoubleToQuantum(gray,context));
+    }
+  return 2*number_pixels;
+}
+
+static unsigned long
+ImportRGBFloat16MSBKernel(PixelPacket * restrict q,
+                          const unsigned char * restrict p,
+                          const unsigned long number_pixels,
+                          const ImportKernelContext *context)
+{
+  return ImportRGBFloat16(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportRGBFloat16LSBKernel(PixelPacket * restrict q,
+                          const unsigned char * restrict p,
+                          const unsigned long number_pixels,
+                          const ImportKernelContext *context)
+{
+  return ImportRGBFloat16(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ImportRGBAFloat16MSBKernel(PixelPacket * restrict q,
+                           const unsigned char * restrict p,
+                           const unsigned long number_pixels,
+                           const ImportKernelContext *context)
+{
+  return ImportRGBAFloat16(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportRGBAFloat16LSBKernel(PixelPacket * restrict q,
+                           const unsigned char * restrict p,
+                           const unsigned long number_pixels,
+                           const ImportKernelContext *context)
+{
+  return ImportRGBAFloat16(q,p,number_pixels,context,MagickFalse);
+}
+
+static unsigned long
+ImportGrayFloat16MSBKernel(PixelPacket * restrict q,
+                           const unsigned char * restrict p,
+                           const unsigned long number_pixels,
+                           const ImportKernelContext *context)
+{
+  return ImportGrayFloat16(q,p,number_pixels,context,MagickTrue);
+}
+
+static unsigned long
+ImportGrayFloat16LSBKernel(PixelPacket * restrict q,
+                           const unsigned char * restrict p,
+                           const unsigned long number_pixels,
+                           const ImportKernelContext *context)
+{
+  return ImportGrayFloat16(q,p,number_pixels,context,MagickFalse);
+}
+
+/*
+  Select a kernel for the requested import, or return NULL if the
+  generic code should be used.
+*/
+static ImportKernel
+SelectImportKernel(const Image *image,const QuantumType quantum_type,
+                   const unsigned int quantum_size,
+                   const QuantumSampleType sample_type,
+                   const EndianType endian,
+                   const MagickBool grayscale_miniswhite)
+{
+  const MagickBool
+    msb=(endian != LSBEndian),
+    native=(endian == MyEndianType);
+
+  if (!MagickPixelAreaKernelsEnabled())
+    return (ImportKernel) NULL;
+
+  if (sample_type == UnsignedQuantumSampleType)
+    {
+      switch (quantum_type)
+        {
+        case RGBQuantum:
+          /*
+            The generic 8-bit loop is already as fast as a kernel.
+          */
+          if (quantum_size == 16)
+            return (msb ? ImportRGB16MSBKernel : ImportRGB16LSBKernel);
+          break;
+        case RGBAQuantum:
+          if (quantum_size == 8)
+            return ImportRGBA8Kernel;
+          if (quantum_size == 16)
+            return (msb ? ImportRGBA16MSBKernel : ImportRGBA16LSBKernel);
+          break;
+        case CMYKQuantum:
+          if (quantum_size == 8)
+            return ImportCMYK8Kernel;
+          if (quantum_size == 16)
+            return (msb ? ImportCMYK16MSBKernel : ImportCMYK16LSBKernel);
+          break;
+        case GrayQuantum:
+          /*
+            PseudoClass images import colormap indexes and are left to
+            the generic code.
+          */
+          if (image->storage_class != DirectClass)
+            break;
+          if (quantum_size == 8)
+            return (grayscale_miniswhite ? ImportGrayMinIsWhite8Kernel :
+                    ImportGray8Kernel);
+          if ((quantum_size == 16) && !grayscale_miniswhite)
+            return (msb ? ImportGray16MSBKernel : ImportGray16LSBKernel);
+          break;
+        default:
+          break;
+        }
+    }
+  else if (sample_type == FloatQuantumSampleType)
+    {
+      if (quantum_size == 32)
+        {
+          switch (quantum_type)
+            {
+            case RGBQuantum:
+              return (native ? ImportRGBFloat32NativeKernel :
+                      ImportRGBFloat32SwappedKernel);
+            case RGBAQuantum:
+              return (native ? ImportRGBAFloat32NativeKernel :
+                      ImportRGBAFloat32SwappedKernel);
+            case GrayQuantum:
+              return (native ? ImportGrayFloat32NativeKernel :
+                      ImportGrayFloat32SwappedKernel);
+            default:
+              break;
+            }
+        }
+      else if (quantum_size == 16)
+        {
+          switch (quantum_type)
+            {
+            case RGBQuantum:
+              return (msb ? ImportRGBFloat16MSBKernel :
+                      ImportRGBFloat16LSBKernel);
+            case RGBAQuantum:
+              return (msb ? ImportRGBAFloat16MSBKernel :
+                      ImportRGBAFloat16LSBKernel);
+            case GrayQuantum:
+              return (msb ? ImportGrayFloat16MSBKernel :
+                      ImportGrayFloat16LSBKernel);
+            default:
+              break;
+            }
+        }
+    }
+
+  return (ImportKernel) NULL;
+}
+
 MagickExport MagickPassFail
 ImportViewPixelArea(ViewInfo *view,
 		    const QuantumType quantum_type,
@@ -3494,6 +4177,12 @@ ImportViewPixelArea(ViewInfo *view,
   EndianType
     endian=MSBEndian;
 
+  ImportKernel
+    kernel;
+
+  ImportKernelContext
+    context;
+
   MagickPassFail
     status=MagickPass;
 
@@ -3571,126 +4260,142 @@ ImportViewPixelArea(ViewInfo *view,
   number_pixels=(long) GetCacheViewArea(view);
   q=AccessCacheViewPixels(view);
   indexes=GetCacheViewIndexes(view);
-  switch (quantum_type)
-    {
-    case UndefinedQuantum:
-      {
-	status=MagickFail;
-	break;
-      }
-    case IndexQuantum:
-      {
-	status=ImportIndexQuantumType(source,q,indexes,number_pixels,quantum_size,
-				      sample_type,unsigned_maxvalue,endian,image,
-				      import_info);
-        break;
-      }
-    case IndexAlphaQuantum:
-      {
-	status=ImportIndexAlphaQuantumType(source,q,indexes,number_pixels,
-					   quantum_size,sample_type,unsigned_scale,
-					   endian,
-					   image,
-					   import_info);
-        break;
-      }
-    case GrayQuantum:
-      {
-	status=ImportGrayQuantumType(source,q,indexes,number_pixels,quantum_size,
-				     sample_type,unsigned_scale,unsigned_maxvalue,
-				     grayscale_miniswhite,double_minvalue,
-				     double_scale,endian,image,import_info);
-        break;
-      }
-    case GrayAlphaQuantum:
-      {
-	status=ImportGrayAlphaQuantumType(source,q,indexes,number_pixels,quantum_size,
-					  sample_type,unsigned_scale,unsigned_maxvalue,
-					  grayscale_miniswhite,double_minvalue,double_scale,
-					  endian,image,import_info);
-        break;
-      }
-    case RedQuantum:
-    case CyanQuantum:
-      {
-	status=ImportRedQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				    unsigned_scale,double_minvalue,double_scale,endian,
-				    import_info);
-
-        break;
-      }
-    case GreenQuantum:
-    case MagentaQuantum:
-      {
-	status=ImportGreenQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				      unsigned_scale,double_minvalue,double_scale,endian,
-				      import_info);
-        break;
-      }
-    case BlueQuantum:
-    case YellowQuantum:
-      {
-	status=ImportBlueQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				     unsigned_scale,double_minvalue,double_scale,endian,
-				     import_info);
-        break;
-      }
-    case AlphaQuantum:
-      {
-	status=ImportAlphaQuantumType(source,q,indexes,number_pixels,quantum_size,
-				      sample_type,unsigned_scale,double_minvalue,
-				      double_scale,endian,image,import_info);
-        break;
-      }
-    case BlackQuantum:
-      {
-	status=ImportBlackQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				      unsigned_scale,double_minvalue,double_scale,endian,
-				      import_info);
-        break;
-      }
-    case RGBQuantum:
-      {
-	status=ImportRGBQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				    unsigned_scale,double_minvalue,double_scale,endian,
-				    import_info);
-        break;
-      }
-    case RGBAQuantum:
-      {
-	status=ImportRGBAQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				     unsigned_scale,double_minvalue,double_scale,endian,
-				     import_info);
-        break;
-      }
-    case CMYKQuantum:
-      {
-	status=ImportCMYKQuantumType(source,q,indexes,number_pixels,quantum_size,
-				     sample_type,unsigned_scale,double_minvalue,
-				     double_scale,endian,import_info);
-        break;
-      }
-    case CMYKAQuantum:
-      {
-	status=ImportCMYKAQuantumType(source,q,indexes,number_pixels,quantum_size,
-				      sample_type,unsigned_scale,double_minvalue,
-				      double_scale,endian,import_info);
-        break;
-      }
-    case CIEXYZQuantum:
-      {
-	status=ImportCIEXYZQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				       endian,import_info);
-        break;
-      }
-    case CIEYQuantum:
-      {
-	status=ImportCIEYQuantumType(source,q,number_pixels,quantum_size,sample_type,
-				     endian,import_info);
-        break;
-      }
+  context.double_minvalue=double_minvalue;
+  context.double_scale=double_scale;
+  kernel=SelectImportKernel(image,quantum_type,quantum_size,sample_type,
+                            endian,grayscale_miniswhite);
+  if (kernel != (ImportKernel) NULL)
+    {
+      size_t
+        bytes_imported;
+
+      bytes_imported=(kernel)(q,source,number_pixels,&context);
+      if (import_info)
+        import_info->bytes_imported=bytes_imported;
     }
+  else
+    {
+      switch (quantum_type)
+	{
+	case UndefinedQuantum:
+	  {
+	    status=MagickFail;
+	    break;
+	  }
+	case IndexQuantum:
+	  {
+	    status=ImportIndexQuantumType(source,q,indexes,number_pixels,quantum_size,
+					  sample_type,unsigned_maxvalue,endian,image,
+					  import_info);
+	    break;
+	  }
+	case IndexAlphaQuantum:
+	  {
+	    status=ImportIndexAlphaQuantumType(source,q,indexes,number_pixels,
+					       quantum_size,sample_type,unsigned_scale,
+					       endian,
+					       image,
+					       import_info);
+	    break;
+	  }
+	case GrayQuantum:
+	  {
+	    status=ImportGrayQuantumType(source,q,indexes,number_pixels,quantum_size,
+					 sample_type,unsigned_scale,unsigned_maxvalue,
+					 grayscale_miniswhite,double_minvalue,
+					 double_scale,endian,image,import_info);
+	    break;
+	  }
+	case GrayAlphaQuantum:
+	  {
+	    status=ImportGrayAlphaQuantumType(source,q,indexes,number_pixels,quantum_size,
+					      sample_type,unsigned_scale,unsigned_maxvalue,
+					      grayscale_miniswhite,double_minvalue,double_scale,
+					      endian,image,import_info);
+	    break;
+	  }
+	case RedQuantum:
+	case CyanQuantum:
+	  {
+	    status=ImportRedQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					unsigned_scale,double_minvalue,double_scale,endian,
+					import_info);
+
+	    break;
+	  }
+	case GreenQuantum:
+	case MagentaQuantum:
+	  {
+	    status=ImportGreenQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					  unsigned_scale,double_minvalue,double_scale,endian,
+					  import_info);
+	    break;
+	  }
+	case BlueQuantum:
+	case YellowQuantum:
+	  {
+	    status=ImportBlueQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					 unsigned_scale,double_minvalue,double_scale,endian,
+					 import_info);
+	    break;
+	  }
+	case AlphaQuantum:
+	  {
+	    status=ImportAlphaQuantumType(source,q,indexes,number_pixels,quantum_size,
+					  sample_type,unsigned_scale,double_minvalue,
+					  double_scale,endian,image,import_info);
+	    break;
+	  }
+	case BlackQuantum:
+	  {
+	    status=ImportBlackQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					  unsigned_scale,double_minvalue,double_scale,endian,
+					  import_info);
+	    break;
+	  }
+	case RGBQuantum:
+	  {
+	    status=ImportRGBQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					unsigned_scale,double_minvalue,double_scale,endian,
+					import_info);
+	    break;
+	  }
+	case RGBAQuantum:
+	  {
+	    status=ImportRGBAQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					 unsigned_scale,double_minvalue,double_scale,endian,
+					 import_info);
+	    break;
+	  }
+	case CMYKQuantum:
+	  {
+	    status=ImportCMYKQuantumType(source,q,indexes,number_pixels,quantum_size,
+					 sample_type,unsigned_scale,double_minvalue,
+					 double_scale,endian,import_info);
+	    break;
+	  }
+	case CMYKAQuantum:
+	  {
+	    status=ImportCMYKAQuantumType(source,q,indexes,number_pixels,quantum_size,
+					  sample_type,unsigned_scale,double_minvalue,
+					  double_scale,endian,import_info);
+	    break;
+	  }
+	case CIEXYZQuantum:
+	  {
+	    status=ImportCIEXYZQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					   endian,import_info);
+	    break;
+	  }
+	case CIEYQuantum:
+	  {
+	    status=ImportCIEYQuantumType(source,q,number_pixels,quantum_size,sample_type,
+					 endian,import_info);
+	    break;
+	  }
+	}
 
+    }
   return(status);
 }
 
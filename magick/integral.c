@@ -0,0 +1,408 @@
+/*
+% Copyright (C) 2026 GraphicsMagick Group
+%
+% This program is covered by multiple licenses, which are described in
+% Copyright.txt. You should have received a copy of Copyright.txt with this
+% package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+%
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%                    GraphicsMagick Integral Image Methods                    %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%
+%
+*/
+
+/*
+  Include declarations.
+*/
+#include "magick/studio.h"
+#include "magick/integral.h"
+#include "magick/pixel_cache.h"
+#include "magick/utility.h"
+
+/*
+  Number of table entries summed down the columns by each thread at a
+  time.
+*/
+#define IntegralColumnChunk 256
+
+/*
+  Store the sample selected by channel index 'c' of an integral image
+  with 'channels' channels.
+*/
+#define IntegralSample(pixel,channels,c) \
+  ((c) == 0 ? (pixel)->red : \
+   (((channels) == 2) || ((c) == 3)) ? (pixel)->opacity : \
+   ((c) == 1) ? (pixel)->green : (pixel)->blue)
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   A l l o c a t e I n t e g r a l I m a g e                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  AllocateIntegralImage() computes the integral image (summed-area table)
+%  of a region of an image.  The region may extend beyond the image bounds,
+%  in which case virtual pixels are summed.  Sums are accumulated in 64-bit
+%  integers so that the table can not overflow, and optionally the sums of
+%  squared samples are accumulated in double precision (for computing local
+%  variance).  The rows are summed in parallel, followed by a parallel pass
+%  down the columns.  If called from within a parallel region (e.g. for
+%  one band of an image processed in parallel), the table is computed by
+%  the calling thread using its own cache view.  The table must be
+%  deallocated with DestroyIntegralImage().
+%
+%  The format of the AllocateIntegralImage method is:
+%
+%      IntegralImage *AllocateIntegralImage(const Image *image,const long x,
+%        const long y,const unsigned long columns,const unsigned long rows,
+%        const unsigned int channels,const MagickBool squares,
+%        ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o image: The image.
+%
+%    o x, y: The origin of the region.
+%
+%    o columns, rows: The dimensions of the region.
+%
+%    o channels: The number of channels to sum (1 for gray, 2 for gray and
+%      opacity, 3 for RGB, and 4 for RGB and opacity).
+%
+%    o squares: If true, also compute the sums of squared samples.
+%
+%    o exception: Return any errors or warnings in this structure.
+%
+*/
+MagickExport IntegralImage *
+AllocateIntegralImage(const Image *image,const long x,const long y,
+                      const unsigned long columns,const unsigned long rows,
+                      const unsigned int channels,const MagickBool squares,
+                      ExceptionInfo *exception)
+{
+  IntegralImage
+    *integral;
+
+  size_t
+    entries,
+    stride;
+
+  long
+    chunk,
+    row;
+
+  MagickPassFail
+    status=MagickPass;
+
+  MagickBool
+    nested=MagickFalse;
+
+  ViewInfo
+    *view=(ViewInfo *) NULL;
+
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(exception != (ExceptionInfo *) NULL);
+  assert(exception->signature == MagickSignature);
+  assert((channels >= 1) && (channels <= 4));
+
+  integral=MagickAllocateMemory(IntegralImage *,sizeof(IntegralImage));
+  if (integral == (IntegralImage *) NULL)
+    {
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      return (IntegralImage *) NULL;
+    }
+  (void) memset(integral,0,sizeof(IntegralImage));
+  integral->x=x;
+  integral->y=y;
+  integral->columns=columns;
+  integral->rows=rows;
+  integral->channels=channels;
+
+  stride=MagickArraySize(columns+1,channels);
+  entries=MagickArraySize(stride,rows+1);
+  if (entries != 0)
+    integral->sums=MagickAllocateArray(magick_uint64_t *,entries,
+                                       sizeof(magick_uint64_t));
+  if ((entries != 0) && squares)
+    integral->squared_sums=MagickAllocateArray(double *,entries,
+                                               sizeof(double));
+  if ((integral->sums == (magick_uint64_t *) NULL) ||
+      (squares && (integral->squared_sums == (double *) NULL)))
+    {
+      DestroyIntegralImage(integral);
+      ThrowException(exception,ResourceLimitError,MemoryAllocationFailed,
+                     image->filename);
+      return (IntegralImage *) NULL;
+    }
+  (void) memset(integral->sums,0,stride*sizeof(magick_uint64_t));
+  if (squares)
+    (void) memset(integral->squared_sums,0,stride*sizeof(double));
+
+  /*
+    Within an enclosing parallel region, every thread of a nested region
+    has thread number zero, and so would share the image's default cache
+    view with the other threads of the enclosing region.  Instead, sum
+    serially using a private cache view.
+  */
+#if defined(HAVE_OPENMP)
+  nested=omp_in_parallel();
+#endif
+  if (nested)
+    view=OpenCacheView((Image *) image);
+
+  /*
+    Sum along each row.
+  */
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for if(!nested) schedule(static,16) shared(status)
+#endif
+  for (row=0; row < (long) rows; row++)
+    {
+      const PixelPacket
+        *p;
+
+      magick_uint64_t
+        *sums;
+
+      double
+        *squared_sums;
+
+      unsigned long
+        column;
+
+      unsigned int
+        c;
+
+      MagickPassFail
+        thread_status;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_AllocateIntegralImage)
+#endif
+      thread_status=status;
+      if (thread_status == MagickFail)
+        continue;
+
+      if (view != (ViewInfo *) NULL)
+        p=AcquireCacheViewPixels(view,x,y+row,columns,1,exception);
+      else
+        p=AcquireImagePixels(image,x,y+row,columns,1,exception);
+      if (p == (const PixelPacket *) NULL)
+        {
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_AllocateIntegralImage)
+#endif
+          status=MagickFail;
+          continue;
+        }
+      sums=integral->sums+(row+1)*stride;
+      for (c=0; c < channels; c++)
+        sums[c]=0;
+      for (column=0; column < columns; column++)
+        {
+          for (c=0; c < channels; c++)
+            sums[channels+c]=sums[c]+IntegralSample(p,channels,c);
+          sums+=channels;
+          p++;
+        }
+      if (squares)
+        {
+          p-=columns;
+          squared_sums=integral->squared_sums+(row+1)*stride;
+          for (c=0; c < channels; c++)
+            squared_sums[c]=0.0;
+          for (column=0; column < columns; column++)
+            {
+              for (c=0; c < channels; c++)
+                {
+                  double
+                    sample;
+
+                  sample=(double) IntegralSample(p,channels,c);
+                  squared_sums[channels+c]=squared_sums[c]+sample*sample;
+                }
+              squared_sums+=channels;
+              p++;
+            }
+        }
+    }
+
+  /*
+    Sum down each column, a chunk of table entries at a time.
+  */
+  if (view != (ViewInfo *) NULL)
+    CloseCacheView(view);
+  if (status != MagickFail)
+    {
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for if(!nested) schedule(static,1)
+#endif
+      for (chunk=0; chunk < (long) ((stride+IntegralColumnChunk-1)/
+                                     IntegralColumnChunk); chunk++)
+        {
+          size_t
+            end,
+            i,
+            start;
+
+          unsigned long
+            y_offset;
+
+          start=(size_t) chunk*IntegralColumnChunk;
+          end=Min(start+IntegralColumnChunk,stride);
+          for (y_offset=2; y_offset <= rows; y_offset++)
+            {
+              magick_uint64_t
+                *sums;
+
+              sums=integral->sums+y_offset*stride;
+              for (i=start; i < end; i++)
+                sums[i]+=sums[i-stride];
+              if (squares)
+                {
+                  double
+                    *squared_sums;
+
+                  squared_sums=integral->squared_sums+y_offset*stride;
+                  for (i=start; i < end; i++)
+                    squared_sums[i]+=squared_sums[i-stride];
+                }
+            }
+        }
+    }
+
+  if (status == MagickFail)
+    {
+      DestroyIntegralImage(integral);
+      integral=(IntegralImage *) NULL;
+    }
+  return integral;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   D e s t r o y I n t e g r a l I m a g e                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  DestroyIntegralImage() deallocates an integral image allocated by
+%  AllocateIntegralImage().
+%
+%  The format of the DestroyIntegralImage method is:
+%
+%      void DestroyIntegralImage(IntegralImage *integral)
+%
+%  A description of each parameter follows:
+%
+%    o integral: The integral image.
+%
+*/
+MagickExport void
+DestroyIntegralImage(IntegralImage *integral)
+{
+  if (integral != (IntegralImage *) NULL)
+    {
+      MagickFreeMemory(integral->sums);
+      MagickFreeMemory(integral->squared_sums);
+      MagickFreeMemory(integral);
+    }
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   G e t I n t e g r a l I m a g e S u m s                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetIntegralImageSums() returns the per-channel sums (and optionally the
+%  sums of squares) of the samples in a rectangle, in constant time.  The
+%  rectangle is specified in image coordinates and must lie within the
+%  region covered by the integral image, otherwise MagickFail is returned.
+%
+%  The format of the GetIntegralImageSums method is:
+%
+%      MagickPassFail GetIntegralImageSums(const IntegralImage *integral,
+%        const long x,const long y,const unsigned long columns,
+%        const unsigned long rows,magick_uint64_t *sums,
+%        double *squared_sums)
+%
+%  A description of each parameter follows:
+%
+%    o integral: The integral image.
+%
+%    o x, y: The origin of the rectangle.
+%
+%    o columns, rows: The dimensions of the rectangle.
+%
+%    o sums: An array of 'channels' entries which is updated with the sums.
+%
+%    o squared_sums: An array of 'channels' entries which is updated with
+%      the sums of squares, or NULL.  Squared sums must have been requested
+%      when the integral image was allocated.
+%
+*/
+MagickExport MagickPassFail
+GetIntegralImageSums(const IntegralImage *integral,const long x,
+                     const long y,const unsigned long columns,
+                     const unsigned long rows,magick_uint64_t *sums,
+                     double *squared_sums)
+{
+  size_t
+    bottom_left,
+    bottom_right,
+    top_left,
+    top_right;
+
+  unsigned int
+    c;
+
+  assert(integral != (const IntegralImage *) NULL);
+  assert(sums != (magick_uint64_t *) NULL);
+  if ((x < integral->x) || (y < integral->y) ||
+      ((unsigned long) (x-integral->x)+columns > integral->columns) ||
+      ((unsigned long) (y-integral->y)+rows > integral->rows) ||
+      ((squared_sums != (double *) NULL) &&
+       (integral->squared_sums == (double *) NULL)))
+    return MagickFail;
+
+  top_left=IntegralImageIndex(integral,x-integral->x,y-integral->y);
+  top_right=IntegralImageIndex(integral,x-integral->x+columns,y-integral->y);
+  bottom_left=IntegralImageIndex(integral,x-integral->x,y-integral->y+rows);
+  bottom_right=IntegralImageIndex(integral,x-integral->x+columns,
+                                  y-integral->y+rows);
+  for (c=0; c < integral->channels; c++)
+    sums[c]=integral->sums[bottom_right+c]-integral->sums[top_right+c]-
+      integral->sums[bottom_left+c]+integral->sums[top_left+c];
+  if (squared_sums != (double *) NULL)
+    for (c=0; c < integral->channels; c++)
+      squared_sums[c]=integral->squared_sums[bottom_right+c]-
+        integral->squared_sums[top_right+c]-
+        integral->squared_sums[bottom_left+c]+
+        integral->squared_sums[top_left+c];
+  return MagickPass;
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 2026 GraphicsMagick Group
+
+  This program is covered by multiple licenses, which are described in
+  Copyright.txt. You should have received a copy of Copyright.txt with this
+  package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+
+  GraphicsMagick Integral Image (Summed-Area Table) Methods.
+*/
+#ifndef _MAGICK_INTEGRAL_H
+#define _MAGICK_INTEGRAL_H
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+  /****
+   *
+   * Integral image (summed-area table) support.  The table covers a
+   * region of an image (which may extend into virtual pixels) and has
+   * one more row and column than the region, where the first row and
+   * column are zero.  Entry (x,y) holds the sum of all region samples
+   * above and to the left of (x,y), so the sum of any rectangle is
+   * obtained from four table entries.  The number of channels selects
+   * which samples are summed:
+   *
+   *   1 - red (gray)
+   *   2 - red (gray), opacity
+   *   3 - red, green, blue
+   *   4 - red, green, blue, opacity
+   *
+   * These interfaces are subject to change.
+   *
+   ****/
+
+  typedef struct _IntegralImage
+  {
+    long
+    x,                            /* Region origin in image */
+    y;
+
+    unsigned long
+    columns,                      /* Region dimensions */
+    rows;
+
+    unsigned int
+    channels;                     /* Samples per table entry */
+
+    magick_uint64_t
+    *sums;                        /* Sums of samples */
+
+    double
+    *squared_sums;                /* Sums of squared samples (optional) */
+  } IntegralImage;
+
+  /*
+    Offset of table entry (x,y), where x and y are in the range 0 to
+    columns and 0 to rows respectively.
+  */
+#define IntegralImageIndex(integral,x,y) \
+  (((size_t) (y)*((integral)->columns+1)+(size_t) (x))*(integral)->channels)
+
+  extern MagickExport IntegralImage
+  *AllocateIntegralImage(const Image *image,const long x,const long y,
+                         const unsigned long columns,const unsigned long rows,
+                         const unsigned int channels,const MagickBool squares,
+                         ExceptionInfo *exception);
+
+  extern MagickExport void
+  DestroyIntegralImage(IntegralImage *integral);
+
+  extern MagickExport MagickPassFail
+  GetIntegralImageSums(const IntegralImage *integral,const long x,
+                       const long y,const unsigned long columns,
+                       const unsigned long rows,magick_uint64_t *sums,
+                       double *squared_sums);
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+#endif /* _MAGICK_INTEGRAL_H */
+
+/*
+ * Local Variables:
+ * mode: c
+ * c-basic-offset: 2
+ * fill-column: 78
+ * End:
+ */
@@ -51,12 +51,14 @@
 #include "magick/module.h"
 #include "magick/monitor.h"
 #include "magick/pixel_cache.h"
+#include "magick/profile.h"
 #include "magick/random.h"
 #include "magick/registry.h"
 #include "magick/resource.h"
 #include "magick/render.h"
 #include "magick/semaphore.h"
 #include "magick/tempfile.h"
+#include "magick/timer.h"
 #include "magick/utility.h"
 #include "magick/version.h"
 #if defined(HasX11)
@@ -80,14 +82,50 @@ static void
 static SemaphoreInfo
   *magick_semaphore = (SemaphoreInfo *) NULL;
 
-#if defined(SupportMagickModules)
 static SemaphoreInfo
   *module_semaphore = (SemaphoreInfo *) NULL;
-#endif /* #if defined(SupportMagickModules) */
 
 static MagickInfo
   *magick_list = (MagickInfo *) NULL;
 
+/*
+  Concurrency limit shared by the coders which use one support library
+  (see MagickInfo library member), and which are not thread safe, or
+  set max_concurrency.  This is a counting semaphore: at most limit
+  decodes or encodes hold it at once, and others wait on the available
+  condition until one releases it.  Wait statistics are logged as coder
+  events.
+*/
+typedef struct _MagickCoderLock
+{
+  char
+    *library;           /* support library (or module or format name) */
+
+  unsigned int
+    limit,              /* maximum number of holders */
+    holders;            /* current number of holders */
+
+  SemaphoreInfo
+    *semaphore;         /* protects holders, limit, and statistics */
+
+  ConditionInfo
+    *available;         /* signaled when a holder releases the lock */
+
+  unsigned long
+    acquisitions,       /* number of times a slot was acquired */
+    contentions;        /* number of times acquisition had to wait */
+
+  double
+    wait_total,         /* total seconds spent waiting */
+    wait_max;           /* longest wait in seconds */
+
+  struct _MagickCoderLock
+    *next;
+} MagickCoderLock;
+
+static MagickCoderLock
+  *coder_lock_list = (MagickCoderLock *) NULL;
+
 static unsigned int panic_signal_handler_call_count = 0;
 static unsigned int quit_signal_handler_call_count = 0;
 
@@ -96,6 +134,7 @@ static CoderClass MinimumCoderClass = UnstableCoderClass;
 
 static void DestroyMagickInfo(MagickInfo** magick_info);
 static void DestroyMagickInfoList(void);
+static void DestroyMagickCoderLocks(void);
 
 static MagickPassFail InitializeMagickInfoList(void);
 
@@ -126,6 +165,108 @@ MagickSetFileSystemBlockSize(const size_t block_size)
   filesystem_blocksize=block_size;
 }
 
+/*
+  Startup timing report.  The time taken by each step of
+  InitializeMagick(), and by startup work which is deferred until it is
+  first needed (registering coders, and reading configuration files), is
+  accumulated by task and logged by DestroyMagick() as configure events.
+*/
+#define MaxStartupTasks 32
+
+static struct
+{
+  const char
+    *task;              /* task name (a string constant) */
+
+  double
+    elapsed;            /* total seconds */
+
+  unsigned long
+    count;              /* number of times performed */
+} startup_tasks[MaxStartupTasks];
+
+static unsigned int
+  startup_task_count = 0;
+
+/*
+  Wall clock time in seconds, for measuring startup tasks.
+*/
+double
+MagickStartupClock(void)
+{
+#if defined(MSWINDOWS)
+  return NTElapsedTime();
+#else
+  struct timeval
+    now;
+
+  (void) gettimeofday(&now,(struct timezone *) NULL);
+  return ((double) now.tv_sec+(double) now.tv_usec/1.0e6);
+#endif
+}
+
+/*
+  Add the time elapsed since start to the named task.
+*/
+void
+MagickRecordStartupTime(const char *task,const double start)
+{
+  double
+    elapsed;
+
+  unsigned int
+    i;
+
+  elapsed=MagickStartupClock()-start;
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_MagickRecordStartupTime)
+#endif
+  {
+    for (i=0; i < startup_task_count; i++)
+      if (strcmp(startup_tasks[i].task,task) == 0)
+        break;
+    if ((i == startup_task_count) && (i < MaxStartupTasks))
+      {
+        startup_tasks[i].task=task;
+        startup_tasks[i].elapsed=0.0;
+        startup_tasks[i].count=0;
+        startup_task_count++;
+      }
+    if (i < startup_task_count)
+      {
+        startup_tasks[i].elapsed+=elapsed;
+        startup_tasks[i].count++;
+      }
+  }
+}
+
+/*
+  Log the startup timing report.
+*/
+static void
+LogMagickStartupTimes(void)
+{
+  double
+    total=0.0;
+
+  unsigned int
+    i;
+
+  if (!IsEventLogging())
+    return;
+  for (i=0; i < startup_task_count; i++)
+    {
+      (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                            "Startup time for %s: %.3f ms (%lu)",
+                            startup_tasks[i].task,
+                            1000.0*startup_tasks[i].elapsed,
+                            startup_tasks[i].count);
+      total+=startup_tasks[i].elapsed;
+    }
+  (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                        "Startup time total: %.3f ms",1000.0*total);
+}
+
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -170,6 +311,8 @@ DestroyMagick(void)
   (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
 			"Destroy Magick");
 
+  LogMagickStartupTimes();
+
   MagickDestroyCommandInfo();   /* Command parser */
 #if defined(HasX11)
   MagickXDestroyX11Resources();
@@ -179,7 +322,8 @@ DestroyMagick(void)
   DestroyTypeInfo();            /* Font information */
   DestroyMagicInfo();           /* File format detection */
   DestroyMagickInfoList();      /* Coder registrations + modules */
-  DestroyConstitute();          /* Constitute semaphore */
+  DestroyConstitute();          /* Constitute environment */
+  DestroyColorTransformCache(); /* ICC color transforms */
   DestroyMagickRegistry();      /* Registered images */
   DestroyMagickResources();     /* Resource semaphore */
   DestroyMagickRandomGenerator(); /* Random number generator */
@@ -203,6 +347,33 @@ DestroyMagick(void)
   Destroy MagickInfo structure.
 */
 
+/*
+  Log the wait statistics of, and destroy, all coder concurrency limits.
+*/
+static void
+DestroyMagickCoderLocks(void)
+{
+  MagickCoderLock
+    *lock;
+
+  while (coder_lock_list != (MagickCoderLock *) NULL)
+    {
+      lock=coder_lock_list;
+      coder_lock_list=lock->next;
+      if (lock->acquisitions != 0)
+        (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                              "Coder lock \"%s\" (limit %u): %lu acquired, "
+                              "%lu waited, %.3fs total wait, %.3fs longest "
+                              "wait",lock->library,lock->limit,
+                              lock->acquisitions,lock->contentions,
+                              lock->wait_total,lock->wait_max);
+      DestroyConditionInfo(&lock->available);
+      DestroySemaphoreInfo(&lock->semaphore);
+      MagickFreeMemory(lock->library);
+      MagickFreeMemory(lock);
+    }
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -295,11 +466,9 @@ DestroyMagickInfoList(void)
     DestroyMagickInfo(&magick_info);
   }
   magick_list=(MagickInfo *) NULL;
+  DestroyMagickCoderLocks();
   DestroySemaphoreInfo(&magick_semaphore);
-
-#if defined(SupportMagickModules)
   DestroySemaphoreInfo(&module_semaphore);
-#endif /* #if defined(SupportMagickModules) */
 }
 
 /*
@@ -332,10 +501,16 @@ DestroyMagickInfoList(void)
 MagickExport const char *
 GetImageMagick(const unsigned char *magick,const size_t length)
 {
+  ExceptionInfo
+    exception;
+
   register MagickInfo
     *p;
 
   assert(magick != (const unsigned char *) NULL);
+  GetExceptionInfo(&exception);
+  (void) GetMagickInfo("*",&exception);
+  DestroyExceptionInfo(&exception);
   LockSemaphoreInfo(magick_semaphore);
   for (p=magick_list; p != (MagickInfo *) NULL; p=p->next)
     if (p->magick && p->magick(magick,length))
@@ -364,6 +539,10 @@ GetImageMagick(const unsigned char *magick,const size_t length)
 %  may be altered while the list is being traversed. If the list must be
 %  traversed, access it via the GetMagickInfoArray function instead.
 %
+%  Coders which are built into the library are registered on demand, when
+%  their format is first requested, and all of them are registered if all
+%  formats are requested (name is NULL or "*").
+%
 %  If GraphicsMagick has not been initialized via InitializeMagick()
 %  then this function will not work.
 %
@@ -422,33 +601,45 @@ GetMagickInfo(const char *name,ExceptionInfo *ARGUNUSED(exception))
   const MagickInfo
     *magick_info=(const MagickInfo *) NULL;
 
-#if defined(SupportMagickModules)
-  if ((name != (const char *) NULL) &&
-      (name[0] != '\0'))
+  if ((name == (const char *) NULL) || (name[0] == '*'))
     {
+      /*
+        If all formats are requested, then register all static modules,
+        and use OpenModules to load all modules.
+      */
       LockSemaphoreInfo(module_semaphore);
-      if (name[0] == '*')
-	{
-	  /*
-	    If all modules are requested, then use OpenModules to load all
-	    modules.
-	  */
-	  (void) OpenModules(exception);
-	}
-      else
-	{
-	  magick_info=GetMagickInfoEntryLocked(name);
-	  if (magick_info == (const MagickInfo *) NULL)
-	    {
-	      /*
-		Try to load a supporting module.
-	      */
-	      (void) OpenModule(name,exception);
-	    }
-	}
+#if !defined(BuildMagickModules)
+      RegisterStaticModules();
+#endif /* !defined(BuildMagickModules) */
+#if defined(SupportMagickModules)
+      if (name != (const char *) NULL)
+        (void) OpenModules(exception);
+#endif /* #if defined(SupportMagickModules) */
       UnlockSemaphoreInfo(module_semaphore);
     }
+  else if (name[0] != '\0')
+    {
+      magick_info=GetMagickInfoEntryLocked(name);
+      if (magick_info == (const MagickInfo *) NULL)
+        {
+          LockSemaphoreInfo(module_semaphore);
+          magick_info=GetMagickInfoEntryLocked(name);
+          if (magick_info == (const MagickInfo *) NULL)
+            {
+              /*
+                Try to register a supporting static module, or else to
+                load a supporting module.
+              */
+#if defined(SupportMagickModules)
+              if (!RegisterStaticModule(name))
+                (void) OpenModule(name,exception);
+#else
+              (void) RegisterStaticModule(name);
 #endif /* #if defined(SupportMagickModules) */
+            }
+          UnlockSemaphoreInfo(module_semaphore);
+        }
+    }
 
   /*
     Return whatever we've got
@@ -1068,6 +1259,19 @@ InitializeMagickSignalHandlers(void)
 #endif
 }
 
+/*
+  Execute a step of InitializeMagick(), adding its time to the named task
+  in the startup timing report.
+*/
+#define StartupStep(task,step)                  \
+  {                                             \
+    double                                      \
+      step_start=MagickStartupClock();          \
+                                                \
+    step;                                       \
+    MagickRecordStartupTime(task,step_start);   \
+  }
+
 MagickExport void
 InitializeMagick(const char *path)
 {
@@ -1092,6 +1296,8 @@ InitializeMagick(const char *path)
       SPINLOCK_RELEASE;
       return;
     }
+
+  startup_task_count=0;
   
 #if defined(MSWINDOWS)
 # if defined(_DEBUG) && !defined(__BORLANDC__)
@@ -1109,13 +1315,13 @@ InitializeMagick(const char *path)
 #endif /* defined(MSWINDOWS) */
 
   /* Initialize semaphores */
-  InitializeSemaphore();
+  StartupStep("semaphores",InitializeSemaphore());
 
   /* Initialize logging */
-  InitializeLogInfo();
+  StartupStep("logging",InitializeLogInfo());
 
   /* Initialize our random number generator */
-  InitializeMagickRandomGenerator();
+  StartupStep("random generator",InitializeMagickRandomGenerator());
 
   (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
 			"Initialize Magick");
@@ -1147,7 +1353,7 @@ InitializeMagick(const char *path)
   /*
     Establish the path, filename, and display name of the client app
   */
-  InitializeMagickClientPathAndName(path);
+  StartupStep("client path",InitializeMagickClientPathAndName(path));
   /*
     If the client name did not get setup for any reason, we take one
     last shot at it using the data the caller passed us.
@@ -1159,7 +1365,7 @@ InitializeMagick(const char *path)
     Initialize any logging configuration which could not complete
     since we did not know the installation directory yet
   */
-  InitializeLogInfoPost();
+  StartupStep("log.mgk",InitializeLogInfoPost());
 
   /*
     Adjust minimum coder class if requested.
@@ -1179,17 +1385,30 @@ InitializeMagick(const char *path)
 #if defined(MSWINDOWS)
   NTInitializeExceptionHandlers();  /* WIN32 Exceptions */
 #endif /* defined(MSWINDOWS) */
-  InitializeMagickSignalHandlers(); /* Signal handlers */
-  InitializeTemporaryFiles();       /* Temporary files */
-  InitializeMagickResources();      /* Resources */
-  InitializeMagickRegistry();       /* Image/blob registry */
-  InitializeConstitute();           /* Constitute semaphore */
-  InitializeMagickInfoList();       /* Coder registrations + modules */
-  InitializeMagicInfo();            /* File format detection */
-  InitializeTypeInfo();             /* Font information */
-  InitializeDelegateInfo();         /* External delegate information */
-  InitializeColorInfo();            /* Color database */
-  MagickInitializeCommandInfo();    /* Command parser */
+  StartupStep("signal handlers",
+              InitializeMagickSignalHandlers()); /* Signal handlers */
+  StartupStep("temporary files",
+              InitializeTemporaryFiles());       /* Temporary files */
+  StartupStep("resources",
+              InitializeMagickResources());      /* Resources */
+  StartupStep("registry",
+              InitializeMagickRegistry());       /* Image/blob registry */
+  StartupStep("constitute",
+              InitializeConstitute());           /* Constitute semaphore */
+  StartupStep("color transforms",
+              InitializeColorTransformCache());  /* ICC color transforms */
+  StartupStep("coder list",
+              InitializeMagickInfoList());       /* Coder registrations + modules */
+  StartupStep("magic",
+              InitializeMagicInfo());            /* File format detection */
+  StartupStep("type",
+              InitializeTypeInfo());             /* Font information */
+  StartupStep("delegates",
+              InitializeDelegateInfo());         /* External delegate information */
+  StartupStep("color",
+              InitializeColorInfo());            /* Color database */
+  StartupStep("command parser",
+              MagickInitializeCommandInfo());    /* Command parser */
 
   /* Let's log the three important setting as we exit this routine */
   (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
@@ -1228,14 +1447,12 @@ InitializeMagickInfoList(void)
   assert(magick_semaphore == (SemaphoreInfo *) NULL);
   magick_semaphore=AllocateSemaphoreInfo();
 
-#if defined(SupportMagickModules)
   assert(module_semaphore == (SemaphoreInfo *) NULL);
   module_semaphore=AllocateSemaphoreInfo();
-#endif /* #if defined(SupportMagickModules) */
 
-#if !defined(BuildMagickModules)
-  RegisterStaticModules();          /* Register all static modules */
-#endif /* !defined(BuildMagickModules) */
+  /*
+    Static modules are registered on demand by GetMagickInfo().
+  */
 
 #if defined(SupportMagickModules)
   InitializeMagickModules();        /* Module loader */
@@ -1517,6 +1734,163 @@ MagickToMime(const char *magick)
   return(AllocateString(media));
 }
 
+/*
+  Return the concurrency limit for a support library, as set by the
+  MAGICK_CODER_CONCURRENCY environment variable, which is a list of
+  library=limit pairs (e.g. "TIFF=2,PNG=4").  The default limit is
+  returned if the library is not listed.
+*/
+static unsigned int
+GetMagickCoderLimit(const char *library,const unsigned int default_limit)
+{
+  const char
+    *p,
+    *q;
+
+  size_t
+    length;
+
+  long
+    limit;
+
+  if ((p=getenv("MAGICK_CODER_CONCURRENCY")) == (const char *) NULL)
+    return default_limit;
+  length=strlen(library);
+  while (*p != '\0')
+    {
+      while ((*p == ',') || isspace((int) ((unsigned char) *p)))
+        p++;
+      q=strchr(p,'=');
+      if (q == (const char *) NULL)
+        break;
+      if (((size_t) (q-p) == length) &&
+          (LocaleNCompare(p,library,length) == 0))
+        {
+          limit=MagickAtoL(q+1);
+          if (limit >= 0)
+            return (unsigned int) limit;
+          (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                                "Ignoring invalid MAGICK_CODER_CONCURRENCY "
+                                "limit for \"%s\"",library);
+          break;
+        }
+      p=strchr(q,',');
+      if (p == (const char *) NULL)
+        break;
+    }
+  return default_limit;
+}
+
+/*
+  Return the concurrency limit for a support library, allocating it if
+  needed.  All coders using a library share one limit, which is the
+  lowest limit requested by any of them.  Must be called with
+  magick_semaphore held.
+*/
+static MagickCoderLock *
+GetMagickCoderLockLocked(const char *library,const unsigned int limit)
+{
+  MagickCoderLock
+    *lock;
+
+  for (lock=coder_lock_list; lock != (MagickCoderLock *) NULL;
+       lock=lock->next)
+    if (LocaleCompare(lock->library,library) == 0)
+      {
+        LockSemaphoreInfo(lock->semaphore);
+        if (limit < lock->limit)
+          lock->limit=limit;
+        UnlockSemaphoreInfo(lock->semaphore);
+        return lock;
+      }
+
+  lock=MagickAllocateMemory(MagickCoderLock *,sizeof(MagickCoderLock));
+  if (lock == (MagickCoderLock *) NULL)
+    MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+      UnableToAllocateMagickInfo);
+  (void) memset(lock,0,sizeof(MagickCoderLock));
+  lock->library=AllocateString(library);
+  lock->limit=limit;
+  lock->holders=0;
+  lock->semaphore=AllocateSemaphoreInfo();
+  lock->available=AllocateConditionInfo();
+  lock->next=coder_lock_list;
+  coder_lock_list=lock;
+  return lock;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   L o c k M a g i c k C o d e r                                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  LockMagickCoder() waits until the coder may run within the concurrency
+%  limit of its support library, and returns a non-zero value.  Zero is
+%  returned (without waiting) for coders which have no limit.  Time spent
+%  waiting is logged as a coder event.  The lock must be released by
+%  passing the returned value to UnlockMagickCoder().
+%
+%  The format of the LockMagickCoder method is:
+%
+%      unsigned int LockMagickCoder(const MagickInfo *magick_info)
+%
+%  A description of each parameter follows:
+%
+%    o magick_info: The coder to be invoked.
+%
+*/
+unsigned int
+LockMagickCoder(const MagickInfo *magick_info)
+{
+  MagickCoderLock
+    *lock;
+
+  TimerInfo
+    timer;
+
+  double
+    wait;
+
+  unsigned int
+    limit;
+
+  lock=magick_info->coder_lock;
+  if (lock == (MagickCoderLock *) NULL)
+    return 0;
+
+  LockSemaphoreInfo(lock->semaphore);
+  lock->acquisitions++;
+  if (lock->holders < lock->limit)
+    {
+      lock->holders++;
+      UnlockSemaphoreInfo(lock->semaphore);
+      return 1;
+    }
+
+  GetTimerInfo(&timer);
+  while (lock->holders >= lock->limit)
+    WaitConditionInfo(lock->available,lock->semaphore);
+  lock->holders++;
+  wait=GetElapsedTime(&timer);
+  lock->contentions++;
+  lock->wait_total+=wait;
+  if (wait > lock->wait_max)
+    lock->wait_max=wait;
+  limit=lock->limit;
+  UnlockSemaphoreInfo(lock->semaphore);
+  (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                        "Waited %.3fs for \"%s\" coder lock (limit %u, "
+                        "format %s)",wait,lock->library,limit,
+                        magick_info->name);
+  return 1;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1562,7 +1936,25 @@ RegisterMagickInfo(MagickInfo *magick_info)
       /*
         Add to front of list.
       */
+      const char
+        *library;
+
+      unsigned int
+        limit;
+
+      library=magick_info->library;
+      if (library == (const char *) NULL)
+        library=magick_info->module;
+      if (library == (const char *) NULL)
+        library=magick_info->name;
+      limit=GetMagickCoderLimit(library,magick_info->max_concurrency);
+      if (!magick_info->thread_support)
+        limit=1;
+
       LockSemaphoreInfo(magick_semaphore);
+      magick_info->coder_lock=(MagickCoderLock *) NULL;
+      if (limit != 0)
+        magick_info->coder_lock=GetMagickCoderLockLocked(library,limit);
       magick_info->previous=(MagickInfo *) NULL;
       magick_info->next=magick_list;
       if (magick_info->next != (MagickInfo *) NULL)
@@ -1718,6 +2110,48 @@ SetMagickInfo(const char *name)
   return(magick_info);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   U n l o c k M a g i c k C o d e r                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  UnlockMagickCoder() releases a concurrency limit acquired by
+%  LockMagickCoder(), waking one waiting coder.
+%
+%  The format of the UnlockMagickCoder method is:
+%
+%      void UnlockMagickCoder(const MagickInfo *magick_info,
+%                             const unsigned int slot)
+%
+%  A description of each parameter follows:
+%
+%    o magick_info: The coder which was invoked.
+%
+%    o locked: The value returned by LockMagickCoder().
+%
+*/
+void
+UnlockMagickCoder(const MagickInfo *magick_info,const unsigned int locked)
+{
+  MagickCoderLock
+    *lock;
+
+  lock=magick_info->coder_lock;
+  if ((lock == (MagickCoderLock *) NULL) || (locked == 0))
+    return;
+
+  LockSemaphoreInfo(lock->semaphore);
+  lock->holders--;
+  SignalConditionInfo(lock->available);
+  UnlockSemaphoreInfo(lock->semaphore);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
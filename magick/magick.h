@@ -23,6 +23,24 @@ typedef unsigned int
   (*EncoderHandler)(const ImageInfo *,Image *),
   (*MagickHandler)(const unsigned char *,const size_t);
 
+/*
+  Optional row-streaming encoder entry points (see OpenImageRowEncoder()).
+  The begin handler opens the output and writes any header, storing its
+  private state in *state.  It may decline to stream (requesting that
+  the rows be buffered and WriteImage() be used instead) by returning
+  MagickFail without opening the blob or reporting an exception.  The
+  row handler encodes the single row held in 'row_image' as row 'y' of
+  'image'.  The end handler completes the output, closes the blob, and
+  releases the state.
+*/
+typedef MagickPassFail
+  (*RowEncoderBeginHandler)(const ImageInfo *image_info,Image *image,
+                            void **state),
+  (*RowEncoderRowHandler)(Image *image,const Image *row_image,
+                          const unsigned long y,void *state),
+  (*RowEncoderEndHandler)(Image *image,void *state,
+                          const MagickPassFail status);
+
 /*
   Stability and usefulness of the coder.
 */
@@ -92,6 +110,32 @@ typedef struct _MagickInfo
   ExtensionTreatment
     extension_treatment; /* How much faith should be placed on file extension? */
 
+  RowEncoderBeginHandler
+    row_encoder_begin;  /* optional row-streaming encoder setup (default NULL) */
+
+  RowEncoderRowHandler
+    row_encoder_row;    /* optional row-streaming encoder row output */
+
+  RowEncoderEndHandler
+    row_encoder_end;    /* optional row-streaming encoder completion */
+
+  unsigned int
+    max_concurrency;    /* maximum concurrent decodes/encodes by the
+                         *   coders using this library, 0 for no limit
+                         *   (default 0).  May be overridden with the
+                         *   MAGICK_CODER_CONCURRENCY environment variable.
+                         *   A coder without thread_support is limited to 1.
+                         */
+
+  const char
+    *library;           /* support library, coders which use the same
+                         *   library share a concurrency limit (default
+                         *   NULL, the module name)
+                         */
+
+  struct _MagickCoderLock
+    *coder_lock;        /* private, concurrency limit shared by the library */
+
   unsigned long
     signature;          /* private, structure validator */
 
@@ -143,6 +187,32 @@ extern MagickExport MagickInfo
   extern void
   MagickSetFileSystemBlockSize(const size_t block_size);
 
+  /*
+    Wait until the coder may run within its concurrency limit,
+    returning the value to pass to UnlockMagickCoder().
+  */
+  extern unsigned int
+  LockMagickCoder(const MagickInfo *magick_info);
+
+  /*
+    Release a concurrency limit acquired by LockMagickCoder().
+  */
+  extern void
+  UnlockMagickCoder(const MagickInfo *magick_info,const unsigned int locked);
+
+  /*
+    Wall clock time in seconds, for measuring startup tasks.
+  */
+  extern double
+  MagickStartupClock(void);
+
+  /*
+    Add the time elapsed since start (as returned by MagickStartupClock())
+    to the named task in the startup timing report.
+  */
+  extern void
+  MagickRecordStartupTime(const char *task,const double start);
+
 #endif /* defined(MAGICK_IMPLEMENTATION) */
 
 
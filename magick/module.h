@@ -57,7 +57,8 @@ extern MagickExport MagickPassFail
   ExecuteStaticModuleProcess(const char *,Image **,const int,char **),
   ListModuleInfo(FILE *file,ExceptionInfo *exception),
   OpenModule(const char *module,ExceptionInfo *exception),
-  OpenModules(ExceptionInfo *exception);
+  OpenModules(ExceptionInfo *exception),
+  RegisterStaticModule(const char *magick);
 
 extern MagickExport void
   DestroyModuleInfo(void),
@@ -0,0 +1,232 @@
+/*
+% Copyright (C) 2026 GraphicsMagick Group
+%
+% This program is covered by multiple licenses, which are described in
+% Copyright.txt. You should have received a copy of Copyright.txt with this
+% package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+%
+% Interfaces to execute a set of independent tasks concurrently.
+%
+*/
+
+#include "magick/studio.h"
+#include "magick/log.h"
+#include "magick/monitor.h"
+#include "magick/parallel.h"
+#include "magick/utility.h"
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   G e t P a r a l l e l T a s k T h r e a d s                               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  GetParallelTaskThreads() returns the number of threads which
+%  ExecuteParallelTasks() will use to execute a number of tasks.  This is
+%  the current thread limit (see the "threads" resource), reduced to
+%  max_threads if it is not zero, and to the number of tasks.  Without
+%  OpenMP support one thread is used.
+%
+%  The format of the GetParallelTaskThreads method is:
+%
+%      unsigned int GetParallelTaskThreads(const unsigned int max_threads,
+%                                          const unsigned long ntasks)
+%
+%  A description of each parameter follows:
+%
+%    o max_threads: Maximum number of threads to use, or zero for no
+%        limit beyond the current thread limit.
+%
+%    o ntasks: Number of tasks.
+%
+*/
+MagickExport unsigned int
+GetParallelTaskThreads(const unsigned int max_threads,
+                       const unsigned long ntasks)
+{
+  unsigned int
+    threads = 1;
+
+#if defined(HAVE_OPENMP)
+  threads=(unsigned int) omp_get_max_threads();
+  if ((max_threads > 0) && (max_threads < threads))
+    threads=max_threads;
+  if (ntasks < threads)
+    threads=(unsigned int) ntasks;
+  if (threads == 0)
+    threads=1;
+#else
+  (void) max_threads;
+  (void) ntasks;
+#endif /* defined(HAVE_OPENMP) */
+
+  return threads;
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   E x e c u t e P a r a l l e l T a s k s                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  ExecuteParallelTasks() invokes a user-provided callback function (of
+%  type ParallelTaskCallback) once for each of a number of independent
+%  tasks, such as processing one frame of an image sequence.  Tasks are
+%  handed out in order to a pool of threads, with each thread taking the
+%  next task as soon as it finishes its previous one.  While a task is
+%  running, operations which it invokes are not further parallelized.
+%
+%  Each task reports to its own exception structure.  The most severe
+%  exception reported by any task (the one from the lowest numbered task
+%  if several are equally severe) is copied to the exception argument,
+%  and every failed task is logged.  If a task returns MagickFail (or
+%  the progress monitor cancels the operation), then MagickFail is
+%  returned.  Every task numbered below the lowest failed task is
+%  executed, and every task which was started is allowed to finish,
+%  but tasks numbered above it which have not yet started when it fails
+%  are not executed.  Callers which must know which tasks were executed
+%  should record this in their mutable data.
+%
+%  Decoders and encoders which are not thread safe (or which limit their
+%  concurrency) are serialized by ReadImage() and WriteImage(), so tasks
+%  may read or write images in any format.
+%
+%  The format of the ExecuteParallelTasks method is:
+%
+%      MagickPassFail ExecuteParallelTasks(ParallelTaskCallback call_back,
+%                                          const unsigned int max_threads,
+%                                          const char *description,
+%                                          void *mutable_data,
+%                                          const void *immutable_data,
+%                                          const unsigned long ntasks,
+%                                          ExceptionInfo *exception)
+%
+%  A description of each parameter follows:
+%
+%    o call_back: A user-provided C callback function which is passed
+%        the task number.
+%
+%    o max_threads: Maximum number of threads to use, or zero for no
+%        limit beyond the current thread limit.
+%
+%    o description: textual description of operation for progress
+%        monitor, or NULL to not report progress.
+%
+%    o mutable_data: User-provided mutable context data.
+%
+%    o immutable_data: User-provided immutable context data.
+%
+%    o ntasks: Number of tasks.
+%
+%    o exception: If an error is reported, this argument is updated
+%        with the reason.
+%
+*/
+MagickExport MagickPassFail
+ExecuteParallelTasks(ParallelTaskCallback call_back,
+                     const unsigned int max_threads,
+                     const char *description,
+                     void *mutable_data,
+                     const void *immutable_data,
+                     const unsigned long ntasks,
+                     ExceptionInfo *exception)
+{
+  MagickPassFail
+    status = MagickPass;
+
+  long
+    task;
+
+  unsigned long
+    exception_task = 0,
+    failed_task,
+    task_count = 0;
+
+#if defined(HAVE_OPENMP)
+  int
+    num_threads;
+
+  num_threads=(int) GetParallelTaskThreads(max_threads,ntasks);
+#else
+  (void) max_threads;
+#endif /* defined(HAVE_OPENMP) */
+
+  /*
+    Tasks are started in order, so every task below the lowest failed
+    task is started before failed_task may be lowered below it.
+  */
+  failed_task=ntasks;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for if(num_threads > 1) num_threads(num_threads) schedule(dynamic,1) shared(exception_task, failed_task, task_count, status)
+#endif
+  for (task=0; task < (long) ntasks; task++)
+    {
+      ExceptionInfo
+        task_exception;
+
+      MagickPassFail
+        thread_status;
+
+      MagickBool
+        skip;
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ExecuteParallelTasks)
+#endif
+      skip=((unsigned long) task > failed_task);
+      if (skip)
+        continue;
+
+      GetExceptionInfo(&task_exception);
+      thread_status=(call_back)(mutable_data,immutable_data,
+                                (unsigned long) task,&task_exception);
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_ExecuteParallelTasks)
+#endif
+      {
+        if ((task_exception.severity > exception->severity) ||
+            ((task_exception.severity != UndefinedException) &&
+             (task_exception.severity == exception->severity) &&
+             ((unsigned long) task < exception_task)))
+          {
+            CopyException(exception,&task_exception);
+            exception_task=(unsigned long) task;
+          }
+
+        if (thread_status == MagickFail)
+          (void) LogMagickEvent(UserEvent,GetMagickModule(),
+                                "Task %ld of %lu failed: %.1024s",task,ntasks,
+                                task_exception.reason != (char *) NULL ?
+                                task_exception.reason : "unknown reason");
+
+        task_count++;
+        if ((description != (const char *) NULL) &&
+            QuantumTick(task_count,ntasks))
+          if (!MagickMonitorFormatted(task_count,ntasks,exception,
+                                      description))
+            thread_status=MagickFail;
+
+        if (thread_status == MagickFail)
+          {
+            status=MagickFail;
+            if ((unsigned long) task < failed_task)
+              failed_task=(unsigned long) task;
+          }
+      }
+      DestroyExceptionInfo(&task_exception);
+    }
+
+  return (status);
+}
@@ -0,0 +1,58 @@
+/*
+  Copyright (C) 2026 GraphicsMagick Group
+
+  This program is covered by multiple licenses, which are described in
+  Copyright.txt. You should have received a copy of Copyright.txt with this
+  package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+
+  Interfaces to execute a set of independent tasks (e.g. one per image
+  frame or per file) concurrently.
+
+  WARNING!  These interfaces are still subject to change. WARNING!
+*/
+#ifndef _MAGICK_PARALLEL_H
+#define _MAGICK_PARALLEL_H
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+  /*
+    Task callback.  Each task receives its own exception structure.  A
+    task which returns MagickFail prevents higher numbered tasks which
+    have not yet started from being executed.
+  */
+  typedef MagickPassFail (*ParallelTaskCallback)
+    (
+     void *mutable_data,                /* User provided mutable data */
+     const void *immutable_data,        /* User provided immutable data */
+     const unsigned long task,          /* Task number (0 to ntasks-1) */
+     ExceptionInfo *exception           /* Exception report */
+     );
+
+  extern MagickExport MagickPassFail
+  ExecuteParallelTasks(ParallelTaskCallback call_back,
+                       const unsigned int max_threads,
+                       const char *description,
+                       void *mutable_data,
+                       const void *immutable_data,
+                       const unsigned long ntasks,
+                       ExceptionInfo *exception);
+
+  extern MagickExport unsigned int
+  GetParallelTaskThreads(const unsigned int max_threads,
+                         const unsigned long ntasks);
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+#endif /* _MAGICK_PARALLEL_H */
+
+/*
+ * Local Variables:
+ * mode: c
+ * c-basic-offset: 2
+ * fill-column: 78
+ * End:
+ */
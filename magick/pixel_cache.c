@@ -195,6 +195,22 @@ typedef struct _CacheInfo
   /* Pixel cache file name */
   char cache_filename[MaxTextExtent];
 
+  /* Rows per band for band digests (0 if there are no band digests,
+     which may be tested without holding band_semaphore) */
+  unsigned long band_rows;
+
+  /* Pixel layout which the band digests were computed for */
+  unsigned long band_variant;
+
+  /* Eight digest words per band of rows */
+  unsigned long *band_digests;
+
+  /* Non-zero for each band which was modified since its digest */
+  unsigned char *band_dirty;
+
+  /* Lock for band_rows, band_digests, and band_dirty */
+  SemaphoreInfo *band_semaphore;
+
   /* Unique number for structure validation */
   unsigned long signature;
 } CacheInfo;
@@ -574,7 +590,150 @@ IsNexusInCore(const CacheInfo *cache_info,const NexusInfo *nexus_info)
 
   return(status);
 }
+
+/*
+  Flag the row bands touched by a synced region as modified (see
+  AccessCacheBandDigests()).
+*/
+static void
+FlagModifiedCacheBands(CacheInfo *cache_info,const NexusInfo *nexus_info)
+{
+  unsigned long
+    band,
+    last_band;
+
+  /*
+    Avoid locking for every row synced when no band digests have been
+    requested.  The unlocked test is safe since the digests must not be
+    requested while other threads modify the image.
+  */
+  if ((cache_info->band_rows == 0) || (nexus_info->region.height == 0) ||
+      (nexus_info->region.y < 0))
+    return;
+  LockSemaphoreInfo(cache_info->band_semaphore);
+  if (cache_info->band_dirty != (unsigned char *) NULL)
+    {
+      last_band=((unsigned long) nexus_info->region.y+
+                 nexus_info->region.height-1)/cache_info->band_rows;
+      if (last_band >= (cache_info->rows+cache_info->band_rows-1)/
+          cache_info->band_rows)
+        last_band=(cache_info->rows-1)/cache_info->band_rows;
+      for (band=(unsigned long) nexus_info->region.y/cache_info->band_rows;
+           band <= last_band; band++)
+        cache_info->band_dirty[band]=1;
+    }
+  UnlockSemaphoreInfo(cache_info->band_semaphore);
+}
+
+/*
+  Flag all row bands as modified, for when the pixels are replaced
+  other than by syncing a region.
+*/
+static void
+FlagAllCacheBands(CacheInfo *cache_info)
+{
+  if (cache_info->band_rows == 0)
+    return;
+  LockSemaphoreInfo(cache_info->band_semaphore);
+  if (cache_info->band_dirty != (unsigned char *) NULL)
+    (void) memset(cache_info->band_dirty,1,
+                  (cache_info->rows+cache_info->band_rows-1)/
+                  cache_info->band_rows);
+  UnlockSemaphoreInfo(cache_info->band_semaphore);
+}
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   A c c e s s C a c h e B a n d D i g e s t s                               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  AccessCacheBandDigests() provides access to storage in the pixel cache
+%  for a digest of each band of band_rows rows, and to a flag for each band
+%  which is set whenever pixels in the band are synced to the cache.  The
+%  digests are reset (and all bands flagged) if band_rows or the caller
+%  defined pixel layout variant differ from the previous call, or if the
+%  cache was re-opened, cloned, or replaced.  The caller is responsible for
+%  computing the digest and clearing the flag of each flagged band, and
+%  must not do so while other threads modify the image.  The number of
+%  bands is returned, or zero if there are no pixels or memory allocation
+%  fails.
+%
+%  The format of the AccessCacheBandDigests() method is:
+%
+%      unsigned long AccessCacheBandDigests(const Image *image,
+%                                           const unsigned long band_rows,
+%                                           const unsigned long variant,
+%                                           unsigned long **digests,
+%                                           unsigned char **dirty)
+%
+%  A description of each parameter follows:
+%
+%    o image: The image.
+%
+%    o band_rows: The number of rows in each band.
+%
+%    o variant: Identifies the pixel layout used to compute the digests.
+%
+%    o digests: Set to the array of eight digest words per band.
+%
+%    o dirty: Set to the array of modified band flags.
+%
+*/
+unsigned long
+AccessCacheBandDigests(const Image *image,const unsigned long band_rows,
+                       const unsigned long variant,unsigned long **digests,
+                       unsigned char **dirty)
+{
+  CacheInfo
+    *cache_info;
+
+  unsigned long
+    bands;
+
+  assert(image != (const Image *) NULL);
+  assert(image->signature == MagickSignature);
+  assert(band_rows != 0);
+  cache_info=(CacheInfo *) image->cache;
+  if ((cache_info == (CacheInfo *) NULL) || (cache_info->rows == 0) ||
+      (cache_info->rows != image->rows) ||
+      (cache_info->columns != image->columns))
+    return 0;
+  bands=(cache_info->rows+band_rows-1)/band_rows;
+  LockSemaphoreInfo(cache_info->band_semaphore);
+  if ((cache_info->band_rows != band_rows) ||
+      (cache_info->band_variant != variant) ||
+      (cache_info->band_digests == (unsigned long *) NULL))
+    {
+      MagickFreeMemory(cache_info->band_digests);
+      MagickFreeMemory(cache_info->band_dirty);
+      cache_info->band_rows=0;
+      cache_info->band_digests=
+        MagickAllocateArray(unsigned long *,bands,8*sizeof(unsigned long));
+      cache_info->band_dirty=MagickAllocateMemory(unsigned char *,bands);
+      if ((cache_info->band_digests == (unsigned long *) NULL) ||
+          (cache_info->band_dirty == (unsigned char *) NULL))
+        {
+          MagickFreeMemory(cache_info->band_digests);
+          MagickFreeMemory(cache_info->band_dirty);
+          UnlockSemaphoreInfo(cache_info->band_semaphore);
+          return 0;
+        }
+      (void) memset(cache_info->band_dirty,1,bands);
+      cache_info->band_rows=band_rows;
+      cache_info->band_variant=variant;
+    }
+  *digests=cache_info->band_digests;
+  *dirty=cache_info->band_dirty;
+  UnlockSemaphoreInfo(cache_info->band_semaphore);
+  return bands;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -1760,6 +1919,7 @@ ClonePixelCache(Image *image,Image *clone_image,ExceptionInfo *exception)
       goto  clone_pixel_cache_done;
     }
  clone_pixel_cache_done:
+  FlagAllCacheBands(clone_info);
   UnlockSemaphoreInfo(cache_info->file_semaphore);
   UnlockSemaphoreInfo(clone_info->file_semaphore);
   return status;
@@ -1878,6 +2038,10 @@ DestroyCacheInfo(Cache cache_info)
         break;
       }
     }
+  MagickFreeMemory(cache_info->band_digests);
+  MagickFreeMemory(cache_info->band_dirty);
+  cache_info->band_rows=0;
+  DestroySemaphoreInfo(&cache_info->band_semaphore);
   DestroySemaphoreInfo(&cache_info->file_semaphore);
   DestroySemaphoreInfo(&cache_info->reference_semaphore);
   (void) LogMagickEvent(CacheEvent,GetMagickModule(),"destroy cache %.1024s",
@@ -2003,6 +2167,10 @@ GetCacheInfo(Cache *cache)
   if (cache_info->file_semaphore == (SemaphoreInfo *) NULL)
     MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
                       UnableToAllocateCacheInfo);
+  cache_info->band_semaphore=AllocateSemaphoreInfo();
+  if (cache_info->band_semaphore == (SemaphoreInfo *) NULL)
+    MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+                      UnableToAllocateCacheInfo);
   cache_info->signature=MagickSignature;
   *cache=cache_info;
 }
@@ -2918,6 +3086,7 @@ ModifyCache(Image *image, ExceptionInfo *exception)
             {
 	      destroy_cache=MagickTrue;
               image->cache=clone_image.cache;
+              FlagAllCacheBands((CacheInfo *) image->cache);
             }
           if (status == MagickFail)
             fprintf(stderr,"ModifyCache failed!\n");
@@ -3059,6 +3228,11 @@ OpenCache(Image *image,const MapMode mode,ExceptionInfo *exception)
                GetImageIndexInList(image));
   cache_info->rows=image->rows;
   cache_info->columns=image->columns;
+  LockSemaphoreInfo(cache_info->band_semaphore);
+  MagickFreeMemory(cache_info->band_digests);
+  MagickFreeMemory(cache_info->band_dirty);
+  cache_info->band_rows=0;
+  UnlockSemaphoreInfo(cache_info->band_semaphore);
   number_pixels=(magick_uint64_t) cache_info->columns*cache_info->rows;
   if (cache_info->storage_class != UndefinedClass)
     {
@@ -4310,10 +4484,12 @@ SyncCacheNexus(Image *image,const NexusInfo *nexus_info,
     }
   else if (nexus_info->in_core)
     {
+      FlagModifiedCacheBands(cache_info,nexus_info);
       status=MagickPass;
     }
   else
     {
+      FlagModifiedCacheBands(cache_info,nexus_info);
       if (image->clip_mask != (Image *) NULL)
 	if (!ClipCacheNexus(image,nexus_info))
 	  status=MagickFail;
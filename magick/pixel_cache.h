@@ -290,6 +290,17 @@ extern "C" {
                              const long x,const long y,
                              ExceptionInfo *exception);
 
+  /*
+    Access per-band digest storage and modified band flags in the
+    pixel cache.
+
+    Used only by TreeSignatureImage().
+  */
+  extern unsigned long
+  AccessCacheBandDigests(const Image *image,const unsigned long band_rows,
+                         const unsigned long variant,unsigned long **digests,
+                         unsigned char **dirty);
+
   /*
     DestroyImagePixels() deallocates memory associated with the pixel cache.
 
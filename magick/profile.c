@@ -48,7 +48,10 @@
 #include "magick/profile.h"
 #include "magick/quantize.h"
 #include "magick/resize.h"
+#include "magick/semaphore.h"
+#include "magick/signature.h"
 #include "magick/transform.h"
+#include "magick/tsd.h"
 #include "magick/utility.h"
 #if defined(HasLCMS)
 #  if defined(HAVE_LCMS2_LCMS2_H)
@@ -430,6 +433,11 @@ NextImageProfile(ImageProfileIterator profile_iterator,
 */
 #if defined(HasLCMS)
 
+/*
+  Maximum number of 16-bit channels per pixel in a row buffer.
+*/
+#define MaxProfileChannels 4
+
 typedef struct _ProfilePacket
 {
   unsigned short
@@ -448,12 +456,21 @@ typedef struct _TransformInfo
   cmsUInt32Number target_type;        /* output pixel format */
   int             intent;             /* rendering intent */
   cmsUInt32Number flags;              /* create transform flags */
-  ThreadViewDataSet *transform;       /* Thread-specific transforms */
+  cmsHTRANSFORM   transform;          /* Transform (shared by all threads) */
+  MagickBool      row_transform;      /* Transform whole rows at once */
   ColorspaceType  source_colorspace;  /* source image transform colorspace */
   ColorspaceType  target_colorspace;  /* target image transform colorspace */
   unsigned long   signature;          /* structure validation signature */
 } TransformInfo;
 
+/*
+  Transforms are created without a context (see AcquireColorTransform())
+  so that they may be shared, so errors while creating a transform are
+  reported to the TransformInfo of the creating thread.
+*/
+static MagickTsdKey_t transform_error_key = (MagickTsdKey_t) 0;
+static MagickBool transform_error_key_initialized = MagickFalse;
+
 static void
 lcmsReplacementErrorHandler(cmsContext ContextID, cmsUInt32Number ErrorCode, const char *ErrorText)
 {
@@ -464,6 +481,8 @@ lcmsReplacementErrorHandler(cmsContext ContextID, cmsUInt32Number ErrorCode, con
     type=TransformError;
 
   xform=(TransformInfo *) ContextID;
+  if ((xform == (TransformInfo *) NULL) && transform_error_key_initialized)
+    xform=(TransformInfo *) MagickTsdGetSpecific(transform_error_key);
 
   switch(ErrorCode)
   {
@@ -510,24 +529,77 @@ ProfileImagePixels(void *mutable_data,         /* User provided mutable data */
     alpha,
     beta;
 
-  ARG_NOT_USED(mutable_data);
+  unsigned short
+    *row_buffer;
+
   ARG_NOT_USED(exception);
 
-  transform=(cmsHTRANSFORM) AccessThreadViewData(xform->transform);
+  transform=xform->transform;
 
   /*
-    TODO: This may be optimized to use PixelPackets instead
-    of moving PixelPacket components to and from ProfilePackets.
-    The transform types below, then, must match #ifdef's in the
-    PixelPacket struct definition and should be optimized
-    based on Quantum size. Some (if not all?) YCbCr and LUV
-    profiles are (TIFF) scanline oriented, so transforming
-    one pixel at a time does not work for those profiles.
-
-    Notice that the performance penalty of transforming only
-    one pixel at a time is very small and probably not worth
-    optimizing.
+    Transform the whole row with one call when a row buffer is
+    available.  The row is packed into the 16-bit interleaved layout of
+    the transform's input format and unpacked from its output format.
+    Some (if not all?) YCbCr and LUV profiles are (TIFF) scanline
+    oriented, so these are still transformed one pixel at a time.
   */
+  row_buffer=(unsigned short *) NULL;
+  if ((mutable_data != (void *) NULL) && (xform->row_transform))
+    row_buffer=(unsigned short *)
+      AccessThreadViewData((ThreadViewDataSet *) mutable_data);
+  if (row_buffer != (unsigned short *) NULL)
+    {
+      const unsigned int
+        source_channels = T_CHANNELS(xform->source_type),
+        target_channels = T_CHANNELS(xform->target_type);
+
+      unsigned short
+        *p,
+        *q;
+
+      p=row_buffer;
+      for (i=0; i < npixels; i++)
+        {
+          *p++=ScaleQuantumToShort(pixels[i].red);
+          if (source_channels > 1)
+            {
+              *p++=ScaleQuantumToShort(pixels[i].green);
+              *p++=ScaleQuantumToShort(pixels[i].blue);
+              if (source_channels > 3)
+                *p++=ScaleQuantumToShort(pixels[i].opacity);
+            }
+        }
+      cmsDoTransform(transform,row_buffer,row_buffer+MaxProfileChannels*npixels,
+                     (cmsUInt32Number) npixels);
+      q=row_buffer+MaxProfileChannels*npixels;
+      for (i=0; i < npixels; i++)
+        {
+          pixels[i].red=ScaleShortToQuantum(*q++);
+          if (target_channels == 1)
+            {
+              pixels[i].green=pixels[i].red;
+              pixels[i].blue=pixels[i].red;
+            }
+          else
+            {
+              pixels[i].green=ScaleShortToQuantum(*q++);
+              pixels[i].blue=ScaleShortToQuantum(*q++);
+            }
+          if (image->matte)
+            {
+              if ((source_colorspace == CMYKColorspace) &&
+                  (target_colorspace != CMYKColorspace))
+                pixels[i].opacity=indexes[i];
+              else
+                if ((source_colorspace != CMYKColorspace) &&
+                    (target_colorspace == CMYKColorspace))
+                  indexes[i]=pixels[i].opacity;
+            }
+          if (target_channels > 3)
+            pixels[i].opacity=ScaleShortToQuantum(*q++);
+        }
+      return MagickPass;
+    }
 
   for (i=0; i < npixels; i++)
     {
@@ -568,13 +640,231 @@ ProfileImagePixels(void *mutable_data,         /* User provided mutable data */
   return MagickPass;
 }
 
-static void MagickFreeCMSTransform(void * cmsTransformVoid)
+/*
+  Process-wide cache of color transforms, most recently used first.
+  Creating a transform often costs more than applying it to a small
+  image, while most images are converted between the same few
+  profiles.  An lcms2 transform may be used by several threads at
+  once, so one transform serves all threads and images.  Cached
+  transforms are created without a context, so lcms errors while they
+  are in use are only logged.
+*/
+typedef struct _ColorTransformCacheEntry
 {
-  cmsHTRANSFORM
-    cmsTransform=(cmsHTRANSFORM) cmsTransformVoid;
+  unsigned long   source_digest[8];   /* SHA-256 of input profile */
+  unsigned long   target_digest[8];   /* SHA-256 of output profile */
+  cmsUInt32Number source_type;        /* input pixel format */
+  cmsUInt32Number target_type;        /* output pixel format */
+  int             intent;             /* rendering intent */
+  cmsUInt32Number flags;              /* create transform flags */
+  cmsHTRANSFORM   transform;          /* cached transform */
+  unsigned long   references;         /* users, including the cache */
+  struct _ColorTransformCacheEntry *previous, *next;
+} ColorTransformCacheEntry;
+
+static SemaphoreInfo
+  *transform_cache_semaphore = (SemaphoreInfo *) NULL;
+
+static ColorTransformCacheEntry
+  *transform_cache = (ColorTransformCacheEntry *) NULL;
+
+static unsigned long
+  transform_cache_entries = 0,
+  transform_cache_limit = 16,
+  transform_cache_hits = 0,
+  transform_cache_misses = 0;
+
+static void
+ProfileDigest(const unsigned char *profile,const size_t length,
+              unsigned long *digest)
+{
+  SignatureInfo
+    signature_info;
+
+  GetSignatureInfo(&signature_info);
+  UpdateSignature(&signature_info,profile,length);
+  FinalizeSignature(&signature_info);
+  (void) memcpy(digest,signature_info.digest,sizeof(signature_info.digest));
+}
+
+/*
+  Drop a reference to a cache entry, destroying it with its last user.
+  Must be called with transform_cache_semaphore held.
+*/
+static void
+DereferenceColorTransformLocked(ColorTransformCacheEntry *entry)
+{
+  entry->references--;
+  if (entry->references == 0)
+    {
+      cmsDeleteTransform(entry->transform);
+      MagickFreeMemory(entry);
+    }
+}
+
+static void
+UnlinkColorTransformLocked(ColorTransformCacheEntry *entry)
+{
+  if (entry->previous != (ColorTransformCacheEntry *) NULL)
+    entry->previous->next=entry->next;
+  else
+    transform_cache=entry->next;
+  if (entry->next != (ColorTransformCacheEntry *) NULL)
+    entry->next->previous=entry->previous;
+  entry->previous=entry->next=(ColorTransformCacheEntry *) NULL;
+  transform_cache_entries--;
+}
+
+static void
+LinkColorTransformLocked(ColorTransformCacheEntry *entry)
+{
+  entry->previous=(ColorTransformCacheEntry *) NULL;
+  entry->next=transform_cache;
+  if (transform_cache != (ColorTransformCacheEntry *) NULL)
+    transform_cache->previous=entry;
+  transform_cache=entry;
+  transform_cache_entries++;
+}
+
+static ColorTransformCacheEntry *
+FindColorTransformLocked(const ColorTransformCacheEntry *key)
+{
+  ColorTransformCacheEntry
+    *entry;
+
+  for (entry=transform_cache; entry != (ColorTransformCacheEntry *) NULL;
+       entry=entry->next)
+    if ((entry->source_type == key->source_type) &&
+        (entry->target_type == key->target_type) &&
+        (entry->intent == key->intent) &&
+        (entry->flags == key->flags) &&
+        (memcmp(entry->source_digest,key->source_digest,
+                sizeof(key->source_digest)) == 0) &&
+        (memcmp(entry->target_digest,key->target_digest,
+                sizeof(key->target_digest)) == 0))
+      return entry;
+  return (ColorTransformCacheEntry *) NULL;
+}
+
+/*
+  Obtain a transform for the profiles, pixel formats, intent, and flags
+  in xform, from the cache if possible.  The returned entry must be
+  released using ReleaseColorTransform().
+*/
+static ColorTransformCacheEntry *
+AcquireColorTransform(const TransformInfo *xform,
+                      const unsigned char *source_profile,
+                      const size_t source_length,
+                      const unsigned char *target_profile,
+                      const size_t target_length)
+{
+  ColorTransformCacheEntry
+    *entry,
+    *found;
+
+  unsigned long
+    hits,
+    misses;
+
+  entry=MagickAllocateMemory(ColorTransformCacheEntry *,
+                             sizeof(ColorTransformCacheEntry));
+  if (entry == (ColorTransformCacheEntry *) NULL)
+    return entry;
+  (void) memset(entry,0,sizeof(ColorTransformCacheEntry));
+  ProfileDigest(source_profile,source_length,entry->source_digest);
+  ProfileDigest(target_profile,target_length,entry->target_digest);
+  entry->source_type=xform->source_type;
+  entry->target_type=xform->target_type;
+  entry->intent=xform->intent;
+  entry->flags=xform->flags;
+
+  LockSemaphoreInfo(transform_cache_semaphore);
+  found=FindColorTransformLocked(entry);
+  if (found != (ColorTransformCacheEntry *) NULL)
+    {
+      UnlinkColorTransformLocked(found);
+      LinkColorTransformLocked(found);
+      found->references++;
+      hits=++transform_cache_hits;
+      misses=transform_cache_misses;
+    }
+  else
+    {
+      hits=transform_cache_hits;
+      misses=++transform_cache_misses;
+    }
+  UnlockSemaphoreInfo(transform_cache_semaphore);
+  if (found != (ColorTransformCacheEntry *) NULL)
+    {
+      MagickFreeMemory(entry);
+      (void) LogMagickEvent(TransformEvent,GetMagickModule(),
+                            "Color transform cache hit (%lu hits, "
+                            "%lu misses)",hits,misses);
+      return found;
+    }
+  (void) LogMagickEvent(TransformEvent,GetMagickModule(),
+                        "Color transform cache miss (%lu hits, "
+                        "%lu misses)",hits,misses);
+
+  (void) MagickTsdSetSpecific(transform_error_key,(const void *) xform);
+  entry->transform=cmsCreateTransformTHR((cmsContext) NULL,
+                                         xform->source_profile,
+                                         xform->source_type,
+                                         xform->target_profile,
+                                         xform->target_type,
+                                         xform->intent,
+                                         xform->flags);
+  (void) MagickTsdSetSpecific(transform_error_key,(const void *) NULL);
+  if (entry->transform == (cmsHTRANSFORM) NULL)
+    {
+      MagickFreeMemory(entry);
+      return entry;
+    }
+  entry->references=1;
+
+  LockSemaphoreInfo(transform_cache_semaphore);
+  if (transform_cache_limit != 0)
+    {
+      found=FindColorTransformLocked(entry);
+      if (found != (ColorTransformCacheEntry *) NULL)
+        {
+          /*
+            Another thread created the same transform meanwhile.
+          */
+          UnlinkColorTransformLocked(found);
+          LinkColorTransformLocked(found);
+          found->references++;
+          DereferenceColorTransformLocked(entry);
+          entry=found;
+        }
+      else
+        {
+          entry->references++;
+          LinkColorTransformLocked(entry);
+          while (transform_cache_entries > transform_cache_limit)
+            {
+              ColorTransformCacheEntry
+                *last;
+
+              for (last=transform_cache;
+                   last->next != (ColorTransformCacheEntry *) NULL;
+                   last=last->next)
+                ;
+              UnlinkColorTransformLocked(last);
+              DereferenceColorTransformLocked(last);
+            }
+        }
+    }
+  UnlockSemaphoreInfo(transform_cache_semaphore);
+  return entry;
+}
 
-  if (cmsTransform != (cmsHTRANSFORM) NULL)
-      cmsDeleteTransform(cmsTransform);
+static void
+ReleaseColorTransform(ColorTransformCacheEntry *entry)
+{
+  LockSemaphoreInfo(transform_cache_semaphore);
+  DereferenceColorTransformLocked(entry);
+  UnlockSemaphoreInfo(transform_cache_semaphore);
 }
 
 static const char *
@@ -811,6 +1101,9 @@ ProfileImage(Image *image,const char *name,unsigned char *profile,
           TransformInfo
             xform;
 
+          ColorTransformCacheEntry
+            *cache_entry;
+
           MagickBool
             transform_colormap;
 
@@ -1044,47 +1337,39 @@ ProfileImage(Image *image,const char *name,unsigned char *profile,
             ((xform.source_colorspace != GRAYColorspace) ||
              (xform.source_colorspace == xform.target_colorspace));
 
+          /*
+            YCbCr, LUV, and LUVK conversions are done one pixel at a time.
+          */
+          xform.row_transform=
+            (T_COLORSPACE(xform.source_type) != PT_YCbCr) &&
+            (T_COLORSPACE(xform.source_type) != PT_YUV) &&
+            (T_COLORSPACE(xform.source_type) != PT_YUVK) &&
+            (T_COLORSPACE(xform.target_type) != PT_YCbCr) &&
+            (T_COLORSPACE(xform.target_type) != PT_YUV) &&
+            (T_COLORSPACE(xform.target_type) != PT_YUVK);
+
 	  /* build pre-computed transforms? */
 	  xform.flags=(transform_colormap ? cmsFLAGS_NOOPTIMIZE : 0);
 
-	  xform.transform=AllocateThreadViewDataSet(MagickFreeCMSTransform,
-						    image,&image->exception);
-	  if (xform.transform == (ThreadViewDataSet *) NULL)
-	    status=MagickFail;
-	  if (status != MagickFail)
-	    {
-	      cmsHTRANSFORM
-		transform;
-
-	      unsigned int
-		index;
-
-	      for (index=0 ; index < GetThreadViewDataSetAllocatedViews(xform.transform); index++)
-		{
-		  transform=cmsCreateTransformTHR((cmsContext) &xform,/* transform handle */
-					       xform.source_profile,  /* input profile */
-					       xform.source_type,     /* input pixel format */
-					       xform.target_profile,  /* output profile */
-					       xform.target_type,     /* output pixel format */
-					       xform.intent,          /* rendering intent */
-					       xform.flags            /* pre-computed transforms? */
-					       );
-		  if (transform == (cmsHTRANSFORM) NULL)
-		    {
-		      status=MagickFail;
-		      break;
-		    }
-		  AssignThreadViewData(xform.transform,index,transform);
-		}
-	    }
+          cache_entry=AcquireColorTransform(&xform,existing_profile,
+                                            existing_profile_length,
+                                            profile,length);
           (void) cmsCloseProfile(xform.source_profile);
           (void) cmsCloseProfile(xform.target_profile);
-	  if (status == MagickFail)
+          if (cache_entry == (ColorTransformCacheEntry *) NULL)
             {
-	      DestroyThreadViewDataSet(xform.transform);
+              /*
+                Keep the reason if lcms reported one.
+              */
+              if (image->exception.severity == TransformWarning)
+                {
+                  image->exception.severity=TransformError;
+                  return MagickFail;
+                }
               ThrowBinaryException3(ResourceLimitError,UnableToManageColor,
                                     UnableToCreateColorTransform);
             }
+          xform.transform=cache_entry->transform;
 
           if (transform_colormap)
             {
@@ -1105,6 +1390,9 @@ ProfileImage(Image *image,const char *name,unsigned char *profile,
             }
           else
             {
+              ThreadViewDataSet
+                *row_buffers;
+
               (void) LogMagickEvent(TransformEvent,GetMagickModule(),
                                     "Performing direct class color conversion");
               if (image->storage_class == PseudoClass)
@@ -1115,11 +1403,20 @@ ProfileImage(Image *image,const char *name,unsigned char *profile,
               if (xform.target_colorspace == CMYKColorspace)
                 image->colorspace=xform.target_colorspace;
 
+              /*
+                Row buffers hold the packed input pixels followed by
+                the packed output pixels.
+              */
+              row_buffers=AllocateThreadViewDataArray(image,&image->exception,
+                                                      image->columns,
+                                                      2*MaxProfileChannels*
+                                                      sizeof(unsigned short));
               status=PixelIterateMonoModify(ProfileImagePixels,
                                             NULL,
                                             ProfileImageText,
-                                            NULL,&xform,0,0,image->columns,image->rows,
+                                            row_buffers,&xform,0,0,image->columns,image->rows,
                                             image,&image->exception);
+              DestroyThreadViewDataSet(row_buffers);
 
               (void) LogMagickEvent(TransformEvent,GetMagickModule(),
                                     "Completed direct class color conversion");
@@ -1132,7 +1429,7 @@ ProfileImage(Image *image,const char *name,unsigned char *profile,
           */
           image->is_grayscale=IsGrayColorspace(xform.target_colorspace);
           image->is_monochrome=False;
-	  DestroyThreadViewDataSet(xform.transform);
+          ReleaseColorTransform(cache_entry);
 
           /*
             Throw away the old profile after conversion before we
@@ -1262,3 +1559,92 @@ SetImageProfile(Image *image,const char *name, const unsigned char *profile,
     }
   return (status);
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%     D e s t r o y C o l o r T r a n s f o r m C a c h e                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  DestroyColorTransformCache() releases the cached color transforms and
+%  logs the cache statistics.
+%
+%  The format of the DestroyColorTransformCache method is:
+%
+%      void DestroyColorTransformCache(void)
+%
+*/
+void
+DestroyColorTransformCache(void)
+{
+#if defined(HasLCMS)
+  if (transform_cache_hits+transform_cache_misses != 0)
+    (void) LogMagickEvent(TransformEvent,GetMagickModule(),
+                          "Color transform cache: %lu hits, %lu misses",
+                          transform_cache_hits,transform_cache_misses);
+  while (transform_cache != (ColorTransformCacheEntry *) NULL)
+    {
+      ColorTransformCacheEntry
+        *entry=transform_cache;
+
+      UnlinkColorTransformLocked(entry);
+      DereferenceColorTransformLocked(entry);
+    }
+  transform_cache_hits=0;
+  transform_cache_misses=0;
+  DestroySemaphoreInfo(&transform_cache_semaphore);
+  if (transform_error_key_initialized)
+    (void) MagickTsdKeyDelete(transform_error_key);
+  transform_error_key=(MagickTsdKey_t) 0;
+  transform_error_key_initialized=MagickFalse;
+#endif /* defined(HasLCMS) */
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%     I n i t i a l i z e C o l o r T r a n s f o r m C a c h e               %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  InitializeColorTransformCache() prepares the color transform cache. The
+%  number of cached transforms may be set via the MAGICK_ICC_TRANSFORM_CACHE
+%  environment variable.
+%
+%  The format of the InitializeColorTransformCache method is:
+%
+%      MagickPassFail InitializeColorTransformCache(void)
+%
+*/
+MagickPassFail
+InitializeColorTransformCache(void)
+{
+#if defined(HasLCMS)
+  const char
+    *env;
+
+  assert(transform_cache_semaphore == (SemaphoreInfo *) NULL);
+  transform_cache_semaphore=AllocateSemaphoreInfo();
+  if (MagickTsdKeyCreate(&transform_error_key) == MagickFail)
+    return MagickFail;
+  transform_error_key_initialized=MagickTrue;
+  if ((env=getenv("MAGICK_ICC_TRANSFORM_CACHE")) != (const char *) NULL)
+    {
+      long
+        limit;
+
+      limit=MagickAtoL(env);
+      transform_cache_limit=(limit > 0 ? (unsigned long) limit : 0);
+    }
+#endif /* defined(HasLCMS) */
+  return MagickPass;
+}
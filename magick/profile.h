@@ -75,6 +75,16 @@ extern MagickExport MagickPassFail
 extern MagickExport void
   DeallocateImageProfileIterator(ImageProfileIterator profile_iterator);
 
+#if defined(MAGICK_IMPLEMENTATION)
+
+extern void
+  DestroyColorTransformCache(void);
+
+extern MagickPassFail
+  InitializeColorTransformCache(void);
+
+#endif /* defined(MAGICK_IMPLEMENTATION) */
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif /* defined(__cplusplus) || defined(c_plusplus) */
@@ -163,6 +163,21 @@ struct _SemaphoreInfo
   unsigned long
     signature;		/* Used to validate structure */
 };
+
+struct _ConditionInfo
+{
+#if defined(USE_PTHREAD_LOCKS)
+  pthread_cond_t
+    condition;		/* POSIX thread condition variable */
+#endif /* if defined(USE_PTHREAD_LOCKS) */
+#if defined(USE_WIN32_LOCKS)
+  CONDITION_VARIABLE
+    condition;		/* Windows condition variable */
+#endif /* defined(USE_WIN32_LOCKS) */
+
+  unsigned long
+    signature;		/* Used to validate structure */
+};
 
 /*
   Static declaractions.
@@ -295,6 +310,53 @@ MagickExport void AcquireSemaphoreInfo(SemaphoreInfo **semaphore_info)
 %                                                                             %
 %                                                                             %
 %                                                                             %
+%   A l l o c a t e C o n d i t i o n I n f o                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  Method AllocateConditionInfo initializes a condition variable, which
+%  threads holding a semaphore may wait on until another thread signals
+%  it.  Where the thread library has no condition variables (OpenMP
+%  locks), waiting just releases and re-acquires the semaphore, so
+%  waiters must test their condition in a loop, as they must anyway
+%  because of spurious wakeups.
+%
+%  The format of the AllocateConditionInfo method is:
+%
+%      ConditionInfo *AllocateConditionInfo(void)
+%
+%
+*/
+ConditionInfo *AllocateConditionInfo(void)
+{
+  ConditionInfo
+    *condition_info;
+
+  condition_info=MagickAllocateMemory(ConditionInfo *,sizeof(ConditionInfo));
+  if (condition_info == (ConditionInfo *) NULL)
+    MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+      UnableToAllocateSemaphoreInfo);
+  (void) memset(condition_info,0,sizeof(ConditionInfo));
+#if defined(USE_PTHREAD_LOCKS)
+  if (pthread_cond_init(&condition_info->condition,
+                        (const pthread_condattr_t *) NULL) != 0)
+    MagickFatalError3(ResourceLimitFatalError,MemoryAllocationFailed,
+      UnableToAllocateSemaphoreInfo);
+#endif /* defined(USE_PTHREAD_LOCKS) */
+#if defined(USE_WIN32_LOCKS)
+  InitializeConditionVariable(&condition_info->condition);
+#endif /* defined(USE_WIN32_LOCKS) */
+  condition_info->signature=MagickSignature;
+  return(condition_info);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 %   A l l o c a t e S e m a p h o r e I n f o                                 %
 %                                                                             %
 %                                                                             %
@@ -369,6 +431,39 @@ MagickExport SemaphoreInfo *AllocateSemaphoreInfo(void)
 %                                                                             %
 %                                                                             %
 %                                                                             %
+%   D e s t r o y C o n d i t i o n I n f o                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  Method DestroyConditionInfo destroys a condition variable, which no
+%  thread may be waiting on.
+%
+%  The format of the DestroyConditionInfo method is:
+%
+%      void DestroyConditionInfo(ConditionInfo **condition_info)
+%
+%
+*/
+void DestroyConditionInfo(ConditionInfo **condition_info)
+{
+  assert(condition_info != (ConditionInfo **) NULL);
+  if (*condition_info == (ConditionInfo *) NULL)
+    return;
+  assert((*condition_info)->signature == MagickSignature);
+#if defined(USE_PTHREAD_LOCKS)
+  (void) pthread_cond_destroy(&(*condition_info)->condition);
+#endif /* defined(USE_PTHREAD_LOCKS) */
+  (void) memset((void *) *condition_info,0xbf,sizeof(ConditionInfo));
+  MagickFreeMemory(*condition_info);
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 %   D e s t r o y S e m a p h o r e                                           %
 %                                                                             %
 %                                                                             %
@@ -616,6 +711,39 @@ MagickExport void LockSemaphoreInfo(SemaphoreInfo *semaphore_info)
 %                                                                             %
 %                                                                             %
 %                                                                             %
+%   S i g n a l C o n d i t i o n I n f o                                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  Method SignalConditionInfo wakes at least one thread waiting on a
+%  condition variable, if any.  It should be called while holding the
+%  semaphore which the waiters pass to WaitConditionInfo().
+%
+%  The format of the SignalConditionInfo method is:
+%
+%      void SignalConditionInfo(ConditionInfo *condition_info)
+%
+%
+*/
+void SignalConditionInfo(ConditionInfo *condition_info)
+{
+  assert(condition_info != (ConditionInfo *) NULL);
+  assert(condition_info->signature == MagickSignature);
+#if defined(USE_PTHREAD_LOCKS)
+  (void) pthread_cond_signal(&condition_info->condition);
+#endif /* defined(USE_PTHREAD_LOCKS) */
+#if defined(USE_WIN32_LOCKS)
+  WakeConditionVariable(&condition_info->condition);
+#endif /* defined(USE_WIN32_LOCKS) */
+}
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
 %   U n l o c k S e m a p h o r e I n f o                                     %
 %                                                                             %
 %                                                                             %
@@ -649,3 +777,52 @@ MagickExport void UnlockSemaphoreInfo(SemaphoreInfo *semaphore_info)
   LeaveCriticalSection(&semaphore_info->mutex);
 #endif /* defined(USE_WIN32_LOCKS) */
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   W a i t C o n d i t i o n I n f o                                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  Method WaitConditionInfo releases a semaphore held by the calling
+%  thread, waits until the condition variable is signaled, and locks the
+%  semaphore again before returning.  The wait may end without a signal,
+%  so the caller must test its condition again.
+%
+%  The format of the WaitConditionInfo method is:
+%
+%      void WaitConditionInfo(ConditionInfo *condition_info,
+%                             SemaphoreInfo *semaphore_info)
+%
+%  A description of each parameter follows:
+%
+%    o condition_info: The condition variable to wait on.
+%
+%    o semaphore_info: The semaphore held by the calling thread.
+%
+%
+*/
+void WaitConditionInfo(ConditionInfo *condition_info,
+                       SemaphoreInfo *semaphore_info)
+{
+  assert(condition_info != (ConditionInfo *) NULL);
+  assert(condition_info->signature == MagickSignature);
+  assert(semaphore_info != (SemaphoreInfo *) NULL);
+  assert(semaphore_info->signature == MagickSignature);
+#if defined(USE_OPENMP_LOCKS)
+  omp_unset_lock(&semaphore_info->mutex);
+  omp_set_lock(&semaphore_info->mutex);
+#endif /* defined(USE_OPENMP_LOCKS) */
+#if defined(USE_PTHREAD_LOCKS)
+  (void) pthread_cond_wait(&condition_info->condition,&semaphore_info->mutex);
+#endif /* defined(USE_PTHREAD_LOCKS) */
+#if defined(USE_WIN32_LOCKS)
+  (void) SleepConditionVariableCS(&condition_info->condition,
+                                  &semaphore_info->mutex,INFINITE);
+#endif /* defined(USE_WIN32_LOCKS) */
+}
@@ -40,6 +40,21 @@ extern MagickExport void
   DestroySemaphore(void),
   InitializeSemaphore(void);
 
+#if defined(MAGICK_IMPLEMENTATION)
+/*
+  Condition variables, waited on while holding a semaphore.
+*/
+typedef struct _ConditionInfo ConditionInfo;
+
+extern ConditionInfo
+  *AllocateConditionInfo(void);
+
+extern void
+  DestroyConditionInfo(ConditionInfo **),
+  SignalConditionInfo(ConditionInfo *),
+  WaitConditionInfo(ConditionInfo *,SemaphoreInfo *);
+#endif /* defined(MAGICK_IMPLEMENTATION) */
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif
@@ -37,7 +37,9 @@
 */
 #include "magick/studio.h"
 #include "magick/attribute.h"
+#include "magick/log.h"
 #include "magick/monitor.h"
+#include "magick/omp_data_view.h"
 #include "magick/pixel_cache.h"
 #include "magick/signature.h"
 #include "magick/utility.h"
@@ -167,6 +169,78 @@ MagickExport void GetSignatureInfo(SignatureInfo *signature_info)
 %
 %
 */
+/*
+  Serialize one row of pixels into the message format used by
+  SignatureImage() and TreeSignatureImage(), returning its length.
+  The message must have room for 20 bytes per pixel.
+*/
+static size_t SignatureImageRow(const Image *image,const PixelPacket *p,
+  const IndexPacket *indexes,unsigned char *message)
+{
+  register long
+    x;
+
+  register unsigned char
+    *q;
+
+  unsigned long
+    quantum;
+
+  q=message;
+  for (x=0; x < (long) image->columns; x++)
+  {
+    quantum=ScaleQuantumToLong(p->red);
+    *q++=(unsigned char) (quantum >> 24);
+    *q++=(unsigned char) (quantum >> 16);
+    *q++=(unsigned char) (quantum >> 8);
+    *q++=(unsigned char) quantum;
+    quantum=ScaleQuantumToLong(p->green);
+    *q++=(unsigned char) (quantum >> 24);
+    *q++=(unsigned char) (quantum >> 16);
+    *q++=(unsigned char) (quantum >> 8);
+    *q++=(unsigned char) quantum;
+    quantum=ScaleQuantumToLong(p->blue);
+    *q++=(unsigned char) (quantum >> 24);
+    *q++=(unsigned char) (quantum >> 16);
+    *q++=(unsigned char) (quantum >> 8);
+    *q++=(unsigned char) quantum;
+    if (!image->matte)
+      {
+        if (image->colorspace == CMYKColorspace)
+          {
+            quantum=ScaleQuantumToLong(p->opacity);
+            *q++=(unsigned char) (quantum >> 24);
+            *q++=(unsigned char) (quantum >> 16);
+            *q++=(unsigned char) (quantum >> 8);
+            *q++=(unsigned char) quantum;
+          }
+        quantum=ScaleQuantumToLong(OpaqueOpacity);
+        *q++=(unsigned char) (quantum >> 24);
+        *q++=(unsigned char) (quantum >> 16);
+        *q++=(unsigned char) (quantum >> 8);
+        *q++=(unsigned char) quantum;
+      }
+    else
+      {
+        quantum=ScaleQuantumToLong(p->opacity);
+        *q++=(unsigned char) (quantum >> 24);
+        *q++=(unsigned char) (quantum >> 16);
+        *q++=(unsigned char) (quantum >> 8);
+        *q++=(unsigned char) quantum;
+        if (image->colorspace == CMYKColorspace)
+          {
+            quantum=ScaleQuantumToLong(indexes[x]);
+            *q++=(unsigned char) (quantum >> 24);
+            *q++=(unsigned char) (quantum >> 16);
+            *q++=(unsigned char) (quantum >> 8);
+            *q++=(unsigned char) quantum;
+          }
+      }
+    p++;
+  }
+  return((size_t) (q-message));
+}
+
 #define SignatureImageText "[%s] Compute SHA-256 signature..."
 MagickExport unsigned int SignatureImage(Image *image)
 {
@@ -182,21 +256,15 @@ MagickExport unsigned int SignatureImage(Image *image)
   register const PixelPacket
     *p;
 
-  register long
-    x;
-
-  register unsigned char
-    *q;
-
   SignatureInfo
     signature_info;
 
+  size_t
+    length;
+
   unsigned char
     *message;
 
-  unsigned long
-    quantum;
-
   /*
     Allocate memory for digital signature.
   */
@@ -216,59 +284,8 @@ MagickExport unsigned int SignatureImage(Image *image)
     if (p == (const PixelPacket *) NULL)
       break;
     indexes=AccessImmutableIndexes(image);
-    q=message;
-    for (x=0; x < (long) image->columns; x++)
-    {
-      quantum=ScaleQuantumToLong(p->red);
-      *q++=(unsigned char) (quantum >> 24);
-      *q++=(unsigned char) (quantum >> 16);
-      *q++=(unsigned char) (quantum >> 8);
-      *q++=(unsigned char) quantum;
-      quantum=ScaleQuantumToLong(p->green);
-      *q++=(unsigned char) (quantum >> 24);
-      *q++=(unsigned char) (quantum >> 16);
-      *q++=(unsigned char) (quantum >> 8);
-      *q++=(unsigned char) quantum;
-      quantum=ScaleQuantumToLong(p->blue);
-      *q++=(unsigned char) (quantum >> 24);
-      *q++=(unsigned char) (quantum >> 16);
-      *q++=(unsigned char) (quantum >> 8);
-      *q++=(unsigned char) quantum;
-      if (!image->matte)
-        {
-          if (image->colorspace == CMYKColorspace)
-            {
-              quantum=ScaleQuantumToLong(p->opacity);
-              *q++=(unsigned char) (quantum >> 24);
-              *q++=(unsigned char) (quantum >> 16);
-              *q++=(unsigned char) (quantum >> 8);
-              *q++=(unsigned char) quantum;
-            }
-          quantum=ScaleQuantumToLong(OpaqueOpacity);
-          *q++=(unsigned char) (quantum >> 24);
-          *q++=(unsigned char) (quantum >> 16);
-          *q++=(unsigned char) (quantum >> 8);
-          *q++=(unsigned char) quantum;
-        }
-      else
-        {
-          quantum=ScaleQuantumToLong(p->opacity);
-          *q++=(unsigned char) (quantum >> 24);
-          *q++=(unsigned char) (quantum >> 16);
-          *q++=(unsigned char) (quantum >> 8);
-          *q++=(unsigned char) quantum;
-          if (image->colorspace == CMYKColorspace)
-            {
-              quantum=ScaleQuantumToLong(indexes[x]);
-              *q++=(unsigned char) (quantum >> 24);
-              *q++=(unsigned char) (quantum >> 16);
-              *q++=(unsigned char) (quantum >> 8);
-              *q++=(unsigned char) quantum;
-            }
-        }
-      p++;
-    }
-    UpdateSignature(&signature_info,message,q-message);
+    length=SignatureImageRow(image,p,indexes,message);
+    UpdateSignature(&signature_info,message,length);
     if (QuantumTick(y,image->rows))
       if (!MagickMonitorFormatted(y,image->rows,&image->exception,
                                   SignatureImageText,image->filename))
@@ -440,6 +457,210 @@ MagickExport void TransformSignature(SignatureInfo *signature_info)
   signature_info->digest[7]=Trunc32(signature_info->digest[7]+H);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   T r e e S i g n a t u r e I m a g e                                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  TreeSignatureImage() computes a tree hash variant of the SHA-256 image
+%  signature and stores it as the "tree-signature" image attribute.  The
+%  image is divided into bands of 64 rows, each band is hashed
+%  independently (in parallel) using the same pixel message format as
+%  SignatureImage(), and the result is the SHA-256 digest of the image
+%  columns, rows, and band height (each as 32-bit big-endian integers)
+%  followed by the band digests in order.  The value therefore differs
+%  from the SignatureImage() signature but does not depend on the number
+%  of threads.
+%
+%  The band digests are kept with the pixel cache, so a later call only
+%  rehashes the bands which were modified since the previous call.
+%
+%  The format of the TreeSignatureImage method is:
+%
+%      unsigned int TreeSignatureImage(Image *image)
+%
+%  A description of each parameter follows:
+%
+%    o image: The image.
+%
+%
+*/
+#define TreeSignatureBandRows 64
+#define TreeSignatureImageText "[%s] Compute SHA-256 tree signature..."
+MagickExport unsigned int TreeSignatureImage(Image *image)
+{
+  char
+    signature[MaxTextExtent];
+
+  long
+    band;
+
+  SignatureInfo
+    signature_info;
+
+  ThreadViewDataSet
+    *messages;
+
+  unsigned char
+    *dirty,
+    header[12];
+
+  unsigned long
+    bands,
+    band_count=0,
+    *digests,
+    dirty_bands=0,
+    variant;
+
+  register unsigned long
+    i;
+
+  MagickPassFail
+    status=MagickPass;
+
+  assert(image != (Image *) NULL);
+  assert(image->signature == MagickSignature);
+
+  /*
+    The pixel message depends on the matte channel and CMYK colorspace.
+  */
+  variant=(image->matte ? 1UL : 0UL) |
+    (image->colorspace == CMYKColorspace ? 2UL : 0UL);
+  bands=AccessCacheBandDigests(image,TreeSignatureBandRows,variant,&digests,
+                               &dirty);
+  messages=AllocateThreadViewDataArray(image,&image->exception,image->columns,
+                                       20);
+  if ((bands == 0) || (messages == (ThreadViewDataSet *) NULL))
+    {
+      DestroyThreadViewDataSet(messages);
+      ThrowBinaryException3(ResourceLimitError,MemoryAllocationFailed,
+                            UnableToComputeImageSignature);
+    }
+  for (i=0; i < bands; i++)
+    if (dirty[i])
+      dirty_bands++;
+
+  /*
+    Compute digests of modified bands.
+  */
+#if defined(HAVE_OPENMP)
+#  pragma omp parallel for schedule(dynamic,1) shared(band_count, status)
+#endif
+  for (band=0; band < (long) bands; band++)
+    {
+      const PixelPacket
+        *p;
+
+      SignatureInfo
+        band_info;
+
+      unsigned char
+        *message;
+
+      long
+        y;
+
+      MagickPassFail
+        thread_status;
+
+      if (!dirty[band])
+        continue;
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_TreeSignatureImage)
+#endif
+      thread_status=status;
+      if (thread_status == MagickFail)
+        continue;
+
+      message=AccessThreadViewData(messages);
+      GetSignatureInfo(&band_info);
+      for (y=band*TreeSignatureBandRows;
+           (y < (band+1)*TreeSignatureBandRows) && (y < (long) image->rows);
+           y++)
+        {
+          p=AcquireImagePixels(image,0,y,image->columns,1,&image->exception);
+          if (p == (const PixelPacket *) NULL)
+            {
+              thread_status=MagickFail;
+              break;
+            }
+          UpdateSignature(&band_info,message,
+                          SignatureImageRow(image,p,
+                                            AccessImmutableIndexes(image),
+                                            message));
+        }
+      if (thread_status != MagickFail)
+        {
+          FinalizeSignature(&band_info);
+          (void) memcpy(&digests[8*band],band_info.digest,
+                        sizeof(band_info.digest));
+          dirty[band]=0;
+        }
+
+#if defined(HAVE_OPENMP)
+#  pragma omp critical (GM_TreeSignatureImage)
+#endif
+      {
+        band_count++;
+        if (QuantumTick(band_count,dirty_bands))
+          if (!MagickMonitorFormatted(band_count,dirty_bands,&image->exception,
+                                      TreeSignatureImageText,image->filename))
+            thread_status=MagickFail;
+        if (thread_status == MagickFail)
+          status=MagickFail;
+      }
+    }
+  DestroyThreadViewDataSet(messages);
+  if (status == MagickFail)
+    return(False);
+  (void) LogMagickEvent(CacheEvent,GetMagickModule(),
+                        "Tree signature rehashed %lu of %lu bands",
+                        dirty_bands,bands);
+
+  /*
+    Combine the band digests.
+  */
+  header[0]=(unsigned char) (image->columns >> 24);
+  header[1]=(unsigned char) (image->columns >> 16);
+  header[2]=(unsigned char) (image->columns >> 8);
+  header[3]=(unsigned char) image->columns;
+  header[4]=(unsigned char) (image->rows >> 24);
+  header[5]=(unsigned char) (image->rows >> 16);
+  header[6]=(unsigned char) (image->rows >> 8);
+  header[7]=(unsigned char) image->rows;
+  header[8]=0;
+  header[9]=0;
+  header[10]=0;
+  header[11]=TreeSignatureBandRows;
+  GetSignatureInfo(&signature_info);
+  UpdateSignature(&signature_info,header,sizeof(header));
+  for (i=0; i < 8*bands; i++)
+    {
+      unsigned char
+        word[4];
+
+      word[0]=(unsigned char) (digests[i] >> 24);
+      word[1]=(unsigned char) (digests[i] >> 16);
+      word[2]=(unsigned char) (digests[i] >> 8);
+      word[3]=(unsigned char) digests[i];
+      UpdateSignature(&signature_info,word,sizeof(word));
+    }
+  FinalizeSignature(&signature_info);
+  FormatString(signature,"%08lx%08lx%08lx%08lx%08lx%08lx%08lx%08lx",
+    signature_info.digest[0],signature_info.digest[1],signature_info.digest[2],
+    signature_info.digest[3],signature_info.digest[4],signature_info.digest[5],
+    signature_info.digest[6],signature_info.digest[7]);
+  (void) SetImageAttribute(image,"tree-signature",(char *) NULL);
+  (void) SetImageAttribute(image,"tree-signature",signature);
+  return(True);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -41,7 +41,8 @@ typedef struct _SignatureInfo
   Method declarations.
 */
 extern MagickExport unsigned int
-  SignatureImage(Image *);
+  SignatureImage(Image *),
+  TreeSignatureImage(Image *);
 
 extern MagickExport void
   FinalizeSignature(SignatureInfo *),
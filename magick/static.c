@@ -36,7 +36,10 @@
   Include declarations.
 */
 #include "magick/studio.h"
+#include "magick/log.h"
+#include "magick/magick.h"
 #include "magick/module.h"
+#include "magick/module_aliases.h"
 #include "magick/static.h"
 #include "magick/utility.h"
 
@@ -109,164 +112,276 @@ MagickExport unsigned int ExecuteModuleProcess(const char *tag,
   return(status);
 }
 
+#if !defined(BuildMagickModules)
 /*
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%   R e g i s t e r S t a t i c M o d u l e s                                 %
-%                                                                             %
-%                                                                             %
-%                                                                             %
-%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-%
-%  
-RegisterStaticModules() statically registers all the available module
-%  handlers.
-%
-%  The format of the RegisterStaticModules method is:
-%
-%      RegisterStaticModules(void)
-%
-%
+  Table of the static coder modules, and their registration functions.
 */
-MagickExport void RegisterStaticModules(void)
+typedef struct _StaticModuleInfo
 {
-#if !defined(BuildMagickModules)
-  RegisterARTImage();
-  RegisterAVSImage();
-  RegisterBMPImage();
-  RegisterCALSImage();
-  RegisterCAPTIONImage();
-  RegisterCINEONImage();
+  const char
+    *name;
+
+  void
+    (*register_function)(void),
+    (*unregister_function)(void);
+} StaticModuleInfo;
+
+static const StaticModuleInfo
+StaticModules[] =
+{
+#define STATICMODULE(name) {#name,Register##name##Image,Unregister##name##Image}
+  STATICMODULE(ART),
+  STATICMODULE(AVS),
+  STATICMODULE(BMP),
+  STATICMODULE(CALS),
+  STATICMODULE(CAPTION),
+  STATICMODULE(CINEON),
 #if defined(HasWINGDI32)
-  RegisterCLIPBOARDImage();
+  STATICMODULE(CLIPBOARD),
 #endif
-  RegisterCMYKImage();
-  RegisterCUTImage();
-  RegisterDCMImage();
-  RegisterDCRAWImage();
-  RegisterDIBImage();
+  STATICMODULE(CMYK),
+  STATICMODULE(CUT),
+  STATICMODULE(DCM),
+  STATICMODULE(DCRAW),
+  STATICMODULE(DIB),
 #if defined(HasDPS)
-  RegisterDPSImage();
+  STATICMODULE(DPS),
 #endif
-  RegisterDPXImage();
+  STATICMODULE(DPX),
 #if defined(HasWINGDI32)
-  RegisterEMFImage();
+  STATICMODULE(EMF),
 #endif
 #if defined(HasTIFF)
-  RegisterEPTImage();
+  STATICMODULE(EPT),
 #endif
-  RegisterFAXImage();
-  RegisterFITSImage();
+  STATICMODULE(FAX),
+  STATICMODULE(FITS),
 #if defined(HasFPX)
-  RegisterFPXImage();
+  STATICMODULE(FPX),
 #endif
-  RegisterGIFImage();
-  RegisterGRAYImage();
-  RegisterGRADIENTImage();
-  RegisterHISTOGRAMImage();
-  RegisterHRZImage();
-  RegisterHTMLImage();
-  RegisterICONImage();
-  RegisterIDENTITYImage();
-  RegisterINFOImage();
+  STATICMODULE(GIF),
+  STATICMODULE(GRAY),
+  STATICMODULE(GRADIENT),
+  STATICMODULE(HISTOGRAM),
+  STATICMODULE(HRZ),
+  STATICMODULE(HTML),
+  STATICMODULE(ICON),
+  STATICMODULE(IDENTITY),
+  STATICMODULE(INFO),
 #if defined(HasJBIG)
-  RegisterJBIGImage();
+  STATICMODULE(JBIG),
 #endif
 #if defined(HasJPEG)
-  RegisterJNXImage();
+  STATICMODULE(JNX),
 #endif
 #if defined(HasJPEG)
-  RegisterJPEGImage();
+  STATICMODULE(JPEG),
 #endif
 #if defined(HasJP2)
-  RegisterJP2Image();
+  STATICMODULE(JP2),
 #endif
-  RegisterLABELImage();
-  RegisterLOCALEImage();
-  RegisterLOGOImage();
-  RegisterMACImage();
-  RegisterMAPImage();
-  RegisterMATImage();
-  RegisterMATTEImage();
-  RegisterMETAImage();
-  RegisterMIFFImage();
-  RegisterMONOImage();
-  RegisterMPCImage();
-  RegisterMPEGImage();
-  RegisterMPRImage();
-  RegisterMSLImage();
-  RegisterMTVImage();
-  RegisterMVGImage();
-  RegisterNULLImage();
-  RegisterOTBImage();
-  RegisterPALMImage();
-  RegisterPCDImage();
-  RegisterPCLImage();
-  RegisterPCXImage();
-  RegisterPDBImage();
-  RegisterPDFImage();
-  RegisterPICTImage();
-  RegisterPIXImage();
-  RegisterPLASMAImage();
+  STATICMODULE(LABEL),
+  STATICMODULE(LOCALE),
+  STATICMODULE(LOGO),
+  STATICMODULE(MAC),
+  STATICMODULE(MAP),
+  STATICMODULE(MAT),
+  STATICMODULE(MATTE),
+  STATICMODULE(META),
+  STATICMODULE(MIFF),
+  STATICMODULE(MONO),
+  STATICMODULE(MPC),
+  STATICMODULE(MPEG),
+  STATICMODULE(MPR),
+  STATICMODULE(MSL),
+  STATICMODULE(MTV),
+  STATICMODULE(MVG),
+  STATICMODULE(NULL),
+  STATICMODULE(OTB),
+  STATICMODULE(PALM),
+  STATICMODULE(PCD),
+  STATICMODULE(PCL),
+  STATICMODULE(PCX),
+  STATICMODULE(PDB),
+  STATICMODULE(PDF),
+  STATICMODULE(PICT),
+  STATICMODULE(PIX),
+  STATICMODULE(PLASMA),
 #if defined(HasPNG)
-  RegisterPNGImage();
+  STATICMODULE(PNG),
 #endif
-  RegisterPNMImage();
-  RegisterPREVIEWImage();
-  RegisterPSImage();
-  RegisterPS2Image();
-  RegisterPS3Image();
-  RegisterPSDImage();
-  RegisterPWPImage();
-  RegisterRGBImage();
-  RegisterRLAImage();
-  RegisterRLEImage();
-  RegisterSCTImage();
-  RegisterSFWImage();
-  RegisterSGIImage();
-  RegisterSTEGANOImage();
-  RegisterSUNImage();
-  RegisterSVGImage();
-  RegisterTGAImage();
+  STATICMODULE(PNM),
+  STATICMODULE(PREVIEW),
+  STATICMODULE(PS),
+  STATICMODULE(PS2),
+  STATICMODULE(PS3),
+  STATICMODULE(PSD),
+  STATICMODULE(PWP),
+  STATICMODULE(RGB),
+  STATICMODULE(RLA),
+  STATICMODULE(RLE),
+  STATICMODULE(SCT),
+  STATICMODULE(SFW),
+  STATICMODULE(SGI),
+  STATICMODULE(STEGANO),
+  STATICMODULE(SUN),
+  STATICMODULE(SVG),
+  STATICMODULE(TGA),
 #if defined(HasTIFF)
-  RegisterTIFFImage();
+  STATICMODULE(TIFF),
 #endif
-  RegisterTILEImage();
-  RegisterTIMImage();
-  RegisterTOPOLImage();
-  RegisterTTFImage();
-  RegisterTXTImage();
-  RegisterUILImage();
-  RegisterURLImage();
-  RegisterUYVYImage();
-  RegisterVICARImage();
-  RegisterVIDImage();
-  RegisterVIFFImage();
-  RegisterWBMPImage();
+  STATICMODULE(TILE),
+  STATICMODULE(TIM),
+  STATICMODULE(TOPOL),
+  STATICMODULE(TTF),
+  STATICMODULE(TXT),
+  STATICMODULE(UIL),
+  STATICMODULE(URL),
+  STATICMODULE(UYVY),
+  STATICMODULE(VICAR),
+  STATICMODULE(VID),
+  STATICMODULE(VIFF),
+  STATICMODULE(WBMP),
 #if defined(HasWEBP)
-  RegisterWEBPImage();
+  STATICMODULE(WEBP),
 #endif
-  RegisterWMFImage();
-  RegisterWPGImage();
+  STATICMODULE(WMF),
+  STATICMODULE(WPG),
 #if defined(HasX11)
-  RegisterXImage();
+  STATICMODULE(X),
 #endif /* defined(HasX11) */
-  RegisterXBMImage();
-  RegisterXCImage();
-  RegisterXCFImage();
-  RegisterXPMImage();
+  STATICMODULE(XBM),
+  STATICMODULE(XC),
+  STATICMODULE(XCF),
+  STATICMODULE(XPM),
 #if defined(_VISUALC_)
-  RegisterXTRNImage();
+  STATICMODULE(XTRN),
 #endif /* defined(_VISUALC_) */
 #if defined(HasX11)
-  RegisterXWDImage();
+  STATICMODULE(XWD),
 #endif /* defined(HasX11) */
-  RegisterYUVImage();
+  STATICMODULE(YUV)
+};
+
+#define StaticModulesCount (sizeof(StaticModules)/sizeof(StaticModules[0]))
+
+/*
+  Set for each module which is registered.
+*/
+static MagickBool
+  static_modules_registered[StaticModulesCount];
+
+/*
+  Register a static module given its index in the table.
+*/
+static void RegisterStaticModuleIndex(const size_t index)
+{
+  double
+    start;
+
+  start=MagickStartupClock();
+  (StaticModules[index].register_function)();
+  static_modules_registered[index]=MagickTrue;
+  MagickRecordStartupTime("coder registration",start);
+}
 #endif /* !defined(BuildMagickModules) */
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   R e g i s t e r S t a t i c M o d u l e                                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  RegisterStaticModule() registers the static module which supports the
+%  specified image format, if it is not already registered.  The module is
+%  found using the module alias table, or else has the same name as the
+%  format.  Static modules are registered on demand by GetMagickInfo() so
+%  that startup does not pay for registering every coder.  Calls must be
+%  serialized by the caller.
+%
+%  The format of the RegisterStaticModule method is:
+%
+%      MagickPassFail RegisterStaticModule(const char *magick)
+%
+%  A description of each parameter follows:
+%
+%    o magick: The image format name.
+%
+*/
+MagickExport MagickPassFail RegisterStaticModule(const char *magick)
+{
+#if !defined(BuildMagickModules)
+  const char
+    *name;
+
+  size_t
+    i;
+#endif /* !defined(BuildMagickModules) */
+
+  assert(magick != (const char *) NULL);
+#if !defined(BuildMagickModules)
+  name=magick;
+  for (i=0; i < sizeof(ModuleAliases)/sizeof(ModuleAliases[0]); i++)
+    if (LocaleCompare(ModuleAliases[i].magick,magick) == 0)
+      {
+        name=ModuleAliases[i].name;
+        break;
+      }
+  for (i=0; i < StaticModulesCount; i++)
+    if (LocaleCompare(StaticModules[i].name,name) == 0)
+      {
+        if (!static_modules_registered[i])
+          {
+            (void) LogMagickEvent(ConfigureEvent,GetMagickModule(),
+                                  "Registering static coder module \"%s\""
+                                  " for format \"%s\"",
+                                  StaticModules[i].name,magick);
+            RegisterStaticModuleIndex(i);
+          }
+        return(MagickPass);
+      }
+#endif /* !defined(BuildMagickModules) */
+  return(MagickFail);
 }
-
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   R e g i s t e r S t a t i c M o d u l e s                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  RegisterStaticModules() statically registers all the available module
+%  handlers which are not already registered.  Calls must be serialized
+%  by the caller.
+%
+%  The format of the RegisterStaticModules method is:
+%
+%      RegisterStaticModules(void)
+%
+%
+*/
+MagickExport void RegisterStaticModules(void)
+{
+#if !defined(BuildMagickModules)
+  size_t
+    i;
+
+  for (i=0; i < StaticModulesCount; i++)
+    if (!static_modules_registered[i])
+      RegisterStaticModuleIndex(i);
+#endif /* !defined(BuildMagickModules) */
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -278,8 +393,8 @@ MagickExport void RegisterStaticModules(void)
 %                                                                             %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
-%  UnregisterStaticModules() statically unregisters all the available module
-%  handlers. This allows allocated resources to be freed.
+%  UnregisterStaticModules() statically unregisters the module handlers
+%  which were registered. This allows allocated resources to be freed.
 %
 %  The format of the UnRegisterStaticModules method is:
 %
@@ -290,136 +405,14 @@ MagickExport void RegisterStaticModules(void)
 MagickExport void UnregisterStaticModules(void)
 {
 #if !defined(BuildMagickModules)
-  UnregisterARTImage();
-  UnregisterAVSImage();
-  UnregisterBMPImage();
-  UnregisterCALSImage();
-  UnregisterCAPTIONImage();
-  UnregisterCINEONImage();
-#if defined(HasWINGDI32)
-  UnregisterCLIPBOARDImage();
-#endif
-  UnregisterCMYKImage();
-  UnregisterCUTImage();
-  UnregisterDCMImage();
-  UnregisterDCRAWImage();
-  UnregisterDIBImage();
-#if defined(HasDPS)
-  UnregisterDPSImage();
-#endif
-  UnregisterDPXImage();
-#if defined(HasWINGDI32)
-  UnregisterEMFImage();
-#endif
-#if defined(HasTIFF)
-  UnregisterEPTImage();
-#endif
-  UnregisterFAXImage();
-  UnregisterFITSImage();
-#if defined(HasFPX)
-  UnregisterFPXImage();
-#endif
-  UnregisterGIFImage();
-  UnregisterGRAYImage();
-  UnregisterGRADIENTImage();
-  UnregisterHISTOGRAMImage();
-  UnregisterHRZImage();
-  UnregisterHTMLImage();
-  UnregisterICONImage();
-  UnregisterIDENTITYImage();
-  UnregisterINFOImage();
-#if defined(HasJBIG)
-  UnregisterJBIGImage();
-#endif
-#if defined(HasJPEG)
-  UnregisterJNXImage();
-#endif
-#if defined(HasJPEG)
-  UnregisterJPEGImage();
-#endif
-#if defined(HasJP2)
-  UnregisterJP2Image();
-#endif
-  UnregisterLABELImage();
-  UnregisterLOCALEImage();
-  UnregisterLOGOImage();
-  UnregisterMACImage();
-  UnregisterMAPImage();
-  UnregisterMATImage();
-  UnregisterMATTEImage();
-  UnregisterMETAImage();
-  UnregisterMIFFImage();
-  UnregisterMONOImage();
-  UnregisterMPCImage();
-  UnregisterMPEGImage();
-  UnregisterMPRImage();
-  UnregisterMSLImage();
-  UnregisterMTVImage();
-  UnregisterMVGImage();
-  UnregisterNULLImage();
-  UnregisterOTBImage();
-  UnregisterPALMImage();
-  UnregisterPCDImage();
-  UnregisterPCLImage();
-  UnregisterPCXImage();
-  UnregisterPDBImage();
-  UnregisterPDFImage();
-  UnregisterPICTImage();
-  UnregisterPIXImage();
-  UnregisterPLASMAImage();
-#if defined(HasPNG)
-  UnregisterPNGImage();
-#endif
-  UnregisterPNMImage();
-  UnregisterPREVIEWImage();
-  UnregisterPSImage();
-  UnregisterPS2Image();
-  UnregisterPS3Image();
-  UnregisterPSDImage();
-  UnregisterPWPImage();
-  UnregisterRGBImage();
-  UnregisterRLAImage();
-  UnregisterRLEImage();
-  UnregisterSCTImage();
-  UnregisterSFWImage();
-  UnregisterSGIImage();
-  UnregisterSTEGANOImage();
-  UnregisterSUNImage();
-  UnregisterSVGImage();
-  UnregisterTGAImage();
-#if defined(HasTIFF)
-  UnregisterTIFFImage();
-#endif
-  UnregisterTILEImage();
-  UnregisterTIMImage();
-  UnregisterTOPOLImage();
-  UnregisterTTFImage();
-  UnregisterTXTImage();
-  UnregisterUILImage();
-  UnregisterURLImage();
-  UnregisterUYVYImage();
-  UnregisterVICARImage();
-  UnregisterVIDImage();
-  UnregisterVIFFImage();
-  UnregisterWBMPImage();
-#if defined(HasWEBP)
-  UnregisterWEBPImage();
-#endif
-  UnregisterWMFImage();
-  UnregisterWPGImage();
-#if defined(HasX11)
-  UnregisterXImage();
-#endif /* defined(HasX11) */
-  UnregisterXBMImage();
-  UnregisterXCImage();
-  UnregisterXCFImage();
-  UnregisterXPMImage();
-#if defined(_VISUALC_)
-  UnregisterXTRNImage();
-#endif /* defined(_VISUALC_) */
-#if defined(HasX11)
-  UnregisterXWDImage();
-#endif /* defined(HasX11) */
-  UnregisterYUVImage();
+  size_t
+    i;
+
+  for (i=0; i < StaticModulesCount; i++)
+    if (static_modules_registered[i])
+      {
+        (StaticModules[i].unregister_function)();
+        static_modules_registered[i]=MagickFalse;
+      }
 #endif /* !defined(BuildMagickModules) */
 }
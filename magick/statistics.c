@@ -52,244 +52,200 @@
 %    o exception: Any errors are reported here.
 %
 */
-typedef struct _StatisticsContext {
-  double samples;
-  double variance_divisor;
-} StatisticsContext;
-static MagickPassFail GetImageStatisticsMean(void *mutable_data,
-                                             const void *immutable_data,
-                                             const Image *image,
-                                             const PixelPacket *pixel,
-                                             const IndexPacket *indexes,
-                                             const long npixels,
-                                             ExceptionInfo *exception)
+static MagickPassFail GetImageStatisticsRow(void *mutable_data,
+                                            const void *immutable_data,
+                                            const Image *image,
+                                            const PixelPacket *pixel,
+                                            const IndexPacket *indexes,
+                                            const long npixels,
+                                            ExceptionInfo *exception)
 {
-  ImageStatistics
-    lstatistics,
-    *statistics=(ImageStatistics *) mutable_data;
-
-  const StatisticsContext
-    *context=(const StatisticsContext *) immutable_data;
-
-  double
-    normalized;
-
-  register long
-    i;
-
-  const MagickBool
-    process_opacity=((image->matte) ||
-                     (image->colorspace == CMYKColorspace));
+  StatisticsAccumulator
+    laccumulator,
+    *accumulator=(StatisticsAccumulator *) mutable_data;
 
+  ARG_NOT_USED(immutable_data);
+  ARG_NOT_USED(image);
   ARG_NOT_USED(indexes);
   ARG_NOT_USED(exception);
 
-  (void) memset(&lstatistics, 0, sizeof(ImageStatistics));
-  lstatistics.red.minimum=1.0;
-  lstatistics.green.minimum=1.0;
-  lstatistics.blue.minimum=1.0;
-  if (process_opacity)
-    lstatistics.opacity.minimum=1.0;
-
-  for (i=0; i < npixels; i++)
-    {
-      normalized=(double) pixel[i].red/MaxRGB;
-      lstatistics.red.mean += normalized/context->samples;
-      if (normalized > lstatistics.red.maximum)
-        lstatistics.red.maximum=normalized;
-      if (normalized <  lstatistics.red.minimum)
-        lstatistics.red.minimum=normalized;
-
-      normalized=(double) pixel[i].green/MaxRGB;
-      lstatistics.green.mean += normalized/context->samples;
-      if (normalized > lstatistics.green.maximum)
-        lstatistics.green.maximum=normalized;
-      if (normalized <  lstatistics.green.minimum)
-        lstatistics.green.minimum=normalized;
-
-      normalized=(double) pixel[i].blue/MaxRGB;
-      lstatistics.blue.mean += normalized/context->samples;
-      if (normalized > lstatistics.blue.maximum)
-        lstatistics.blue.maximum=normalized;
-      if (normalized <  lstatistics.blue.minimum)
-        lstatistics.blue.minimum=normalized;
-
-      if (process_opacity)
-        {
-          normalized=(double) pixel[i].opacity/MaxRGB;
-          lstatistics.opacity.mean += normalized/context->samples;
-          if (normalized > lstatistics.opacity.maximum)
-            lstatistics.opacity.maximum=normalized;
-          if (normalized <  lstatistics.opacity.minimum)
-            lstatistics.opacity.minimum=normalized;
-        }
-    }
+  InitializeStatisticsAccumulator(&laccumulator,
+                                  accumulator->process_opacity);
+  AccumulateImageStatistics(&laccumulator,pixel,npixels);
 
 #if defined(HAVE_OPENMP)
-#  pragma omp critical (GM_GetImageStatisticsMean)
+#  pragma omp critical (GM_GetImageStatisticsRow)
 #endif
-  {
-    statistics->red.mean += lstatistics.red.mean;
-    if (lstatistics.red.maximum > statistics->red.maximum)
-      statistics->red.maximum=lstatistics.red.maximum;
-    if (lstatistics.red.minimum < statistics->red.minimum)
-      statistics->red.minimum=lstatistics.red.minimum;
-
-    statistics->green.mean += lstatistics.green.mean;
-    if (lstatistics.green.maximum > statistics->green.maximum)
-      statistics->green.maximum=lstatistics.green.maximum;
-    if (lstatistics.green.minimum < statistics->green.minimum)
-      statistics->green.minimum=lstatistics.green.minimum;
-
-    statistics->blue.mean += lstatistics.blue.mean;
-    if (lstatistics.blue.maximum > statistics->blue.maximum)
-      statistics->blue.maximum=lstatistics.blue.maximum;
-    if (lstatistics.blue.minimum < statistics->blue.minimum)
-      statistics->blue.minimum=lstatistics.blue.minimum;
-
-    if (process_opacity)
-      {
-        statistics->opacity.mean += lstatistics.opacity.mean;
-        if (lstatistics.opacity.maximum > statistics->opacity.maximum)
-          statistics->opacity.maximum=lstatistics.opacity.maximum;
-        if (lstatistics.opacity.minimum < statistics->opacity.minimum)
-          statistics->opacity.minimum=lstatistics.opacity.minimum;
-      }
-  }
+  MergeStatisticsAccumulators(accumulator,&laccumulator);
 
   return MagickPass;
 }
-#define Square(x)  ((x)*(x))
-static MagickPassFail GetImageStatisticsVariance(void *mutable_data,
-                                                 const void *immutable_data,
-                                                 const Image *image,
-                                                 const PixelPacket *pixel,
-                                                 const IndexPacket *indexes,
-                                                 const long npixels,
-                                                 ExceptionInfo *exception)
-{
-  ImageStatistics
-    lstatistics,
-    *statistics=(ImageStatistics *) mutable_data;
-
-  const StatisticsContext
-    *context=(const StatisticsContext *) immutable_data;
 
-  double
-    normalized;
+MagickExport MagickPassFail GetImageStatistics(const Image *image,
+                                               ImageStatistics *statistics,
+                                               ExceptionInfo *exception)
+{
+  StatisticsAccumulator
+    accumulator;
 
-  register long
-    i;
+  MagickPassFail
+    status=MagickPass;
 
-  const MagickBool
-    process_opacity=((image->matte) ||
-                     (image->colorspace == CMYKColorspace));
+  /*
+    Compute mean, max, min, and variance in one pass.
+  */
+  InitializeStatisticsAccumulator(&accumulator,
+                                  ((image->matte) ||
+                                   (image->colorspace == CMYKColorspace)));
+  status = PixelIterateMonoRead(GetImageStatisticsRow,
+                                NULL,
+                                "[%s] Compute image statistics...",
+                                &accumulator,NULL,0,0,image->columns,
+                                image->rows,image,exception);
+  FinalizeStatisticsAccumulator(&accumulator,statistics);
 
-  ARG_NOT_USED(indexes);
-  ARG_NOT_USED(exception);
+  return status;
+}
 
-  (void) memset(&lstatistics, 0, sizeof(ImageStatistics));
-#if defined(HAVE_OPENMP)
-#  pragma omp critical (GM_GetImageStatisticsVariance)
-#endif
-  {
-    lstatistics.red.mean=statistics->red.mean;
-    lstatistics.green.mean=statistics->green.mean;
-    lstatistics.blue.mean=statistics->blue.mean;
-    lstatistics.opacity.mean=statistics->opacity.mean;
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   S t a t i s t i c s A c c u m u l a t o r                                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  The statistics accumulator gathers the count, mean, sum of squared
+%  deviations from the mean, minimum, and maximum of each channel.  Each
+%  row is reduced on its own (mean first, then the squared deviations
+%  about that mean), and partial results are combined using the pairwise
+%  update of Chan, Golub, and LeVeque.  Unlike accumulating sums of
+%  squares, this does not lose the variance to cancellation for large or
+%  nearly constant images, and partial results may be merged in any
+%  order by parallel loops.
+%
+%  InitializeStatisticsAccumulator() prepares an empty accumulator.
+%  AccumulateImageStatistics() adds a row of pixels.
+%  MergeStatisticsAccumulators() adds the partial result in one
+%  accumulator to another.  FinalizeStatisticsAccumulator() converts the
+%  result to normalized ImageStatistics.
+%
+*/
+#define AccumulateChannelRow(channel,member)                            \
+  {                                                                     \
+    double                                                              \
+      sum=0.0,                                                          \
+      m2=0.0,                                                           \
+      minimum=MaxRGBDouble,                                             \
+      maximum=0.0,                                                      \
+      mean,                                                             \
+      value;                                                            \
+                                                                        \
+    for (i=0; i < npixels; i++)                                         \
+      {                                                                 \
+        value=(double) pixels[i].member;                                \
+        sum+=value;                                                     \
+        if (value < minimum)                                            \
+          minimum=value;                                                \
+        if (value > maximum)                                            \
+          maximum=value;                                                \
+      }                                                                 \
+    mean=sum/npixels;                                                   \
+    for (i=0; i < npixels; i++)                                         \
+      {                                                                 \
+        value=(double) pixels[i].member-mean;                           \
+        m2+=value*value;                                                \
+      }                                                                 \
+    row.count=(double) npixels;                                         \
+    row.mean=mean;                                                      \
+    row.m2=m2;                                                          \
+    row.minimum=minimum;                                                \
+    row.maximum=maximum;                                                \
+    MergeChannelAccumulators(&accumulator->channel,&row);               \
   }
 
-  for (i=0; i < npixels; i++)
+static void MergeChannelAccumulators(ChannelAccumulator *total,
+                                     const ChannelAccumulator *part)
+{
+  double
+    count,
+    delta;
+
+  if (part->count == 0.0)
+    return;
+  if (total->count == 0.0)
     {
-      normalized=(double) pixel[i].red/MaxRGB;
-      lstatistics.red.variance +=
-        Square(normalized-lstatistics.red.mean)/context->variance_divisor;
-      
-      normalized=(double) pixel[i].green/MaxRGB;
-      lstatistics.green.variance +=
-        Square(normalized-lstatistics.green.mean)/context->variance_divisor;
-      
-      normalized=(double) pixel[i].blue/MaxRGB;
-      lstatistics.blue.variance +=
-        Square(normalized-lstatistics.blue.mean)/context->variance_divisor;
-      
-      if (process_opacity)
-        {
-          normalized=(double) pixel[i].opacity/MaxRGB;
-          lstatistics.opacity.variance +=
-            Square(normalized-lstatistics.opacity.mean)/context->variance_divisor;
-        }
+      *total=*part;
+      return;
     }
-
-#if defined(HAVE_OPENMP)
-#  pragma omp critical (GM_GetImageStatisticsVariance)
-#endif
-  {
-    statistics->red.variance += lstatistics.red.variance;
-    statistics->green.variance += lstatistics.green.variance;
-    statistics->blue.variance += lstatistics.blue.variance;
-    statistics->opacity.variance += lstatistics.opacity.variance;
-  }
-
-  return MagickPass;
+  count=total->count+part->count;
+  delta=part->mean-total->mean;
+  total->mean+=delta*part->count/count;
+  total->m2+=part->m2+delta*delta*total->count*part->count/count;
+  total->count=count;
+  if (part->minimum < total->minimum)
+    total->minimum=part->minimum;
+  if (part->maximum > total->maximum)
+    total->maximum=part->maximum;
 }
-MagickExport MagickPassFail GetImageStatistics(const Image *image,
-                                               ImageStatistics *statistics,
-                                               ExceptionInfo *exception)
+
+static void FinalizeChannelAccumulator(const ChannelAccumulator *accumulator,
+                                       ImageChannelStatistics *statistics)
 {
-  StatisticsContext
-    context;
-  
-  MagickPassFail
-    status=MagickPass;
+  (void) memset(statistics,0,sizeof(ImageChannelStatistics));
+  if (accumulator->count == 0.0)
+    return;
+  statistics->minimum=accumulator->minimum/MaxRGBDouble;
+  statistics->maximum=accumulator->maximum/MaxRGBDouble;
+  statistics->mean=accumulator->mean/MaxRGBDouble;
+  if (accumulator->count > 1.0)
+    statistics->variance=accumulator->m2/(accumulator->count-1.0)/
+      (MaxRGBDouble*MaxRGBDouble);
+  statistics->standard_deviation=sqrt(statistics->variance);
+}
 
-  double
-    samples;
+void InitializeStatisticsAccumulator(StatisticsAccumulator *accumulator,
+                                     const MagickBool process_opacity)
+{
+  (void) memset(accumulator,0,sizeof(StatisticsAccumulator));
+  accumulator->process_opacity=process_opacity;
+}
 
-  const MagickBool
-    process_opacity=((image->matte) ||
-                     (image->colorspace == CMYKColorspace));
+void AccumulateImageStatistics(StatisticsAccumulator *accumulator,
+                               const PixelPacket *pixels,const long npixels)
+{
+  ChannelAccumulator
+    row;
 
-  (void) memset((void *) statistics, 0, sizeof(ImageStatistics));
-  statistics->red.minimum=1.0;
-  statistics->green.minimum=1.0;
-  statistics->blue.minimum=1.0;
-  if (process_opacity)
-    statistics->opacity.minimum=1.0;
+  register long
+    i;
 
-  samples=(double) image->rows*image->columns;
-  context.samples=samples;
-  context.variance_divisor=samples-1;
-  
-  /*
-    Compute Mean, Max, and Min
-  */
-  status = PixelIterateMonoRead(GetImageStatisticsMean,
-                                NULL,
-                                "[%s] Compute image mean, max, min...",
-                                statistics,&context,0,0,image->columns,
-                                image->rows,image,exception);
-  /*
-    Compute Variance
-  */
-  if (status == MagickPass)
-    status = PixelIterateMonoRead(GetImageStatisticsVariance,
-                                  NULL,
-                                  "[%s] Compute image variance...",
-                                  statistics,&context,0,0,image->columns,
-                                  image->rows,image,exception);
-  /*
-    Compute Standard Deviation
-  */
-  if (status == MagickPass)
-    {
-      statistics->red.standard_deviation=sqrt(statistics->red.variance);
-      statistics->green.standard_deviation=sqrt(statistics->green.variance);
-      statistics->blue.standard_deviation=sqrt(statistics->blue.variance);
-      if (process_opacity)
-        statistics->opacity.standard_deviation=sqrt(statistics->opacity.variance);
-    }
+  if (npixels <= 0)
+    return;
+  AccumulateChannelRow(red,red);
+  AccumulateChannelRow(green,green);
+  AccumulateChannelRow(blue,blue);
+  if (accumulator->process_opacity)
+    AccumulateChannelRow(opacity,opacity);
+}
 
-  return status;
+void MergeStatisticsAccumulators(StatisticsAccumulator *total,
+                                 const StatisticsAccumulator *part)
+{
+  MergeChannelAccumulators(&total->red,&part->red);
+  MergeChannelAccumulators(&total->green,&part->green);
+  MergeChannelAccumulators(&total->blue,&part->blue);
+  MergeChannelAccumulators(&total->opacity,&part->opacity);
 }
 
+void FinalizeStatisticsAccumulator(const StatisticsAccumulator *accumulator,
+                                   ImageStatistics *statistics)
+{
+  FinalizeChannelAccumulator(&accumulator->red,&statistics->red);
+  FinalizeChannelAccumulator(&accumulator->green,&statistics->green);
+  FinalizeChannelAccumulator(&accumulator->blue,&statistics->blue);
+  FinalizeChannelAccumulator(&accumulator->opacity,&statistics->opacity);
+}
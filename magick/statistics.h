@@ -48,6 +48,48 @@ extern MagickExport MagickPassFail
   GetImageStatistics(const Image *image,ImageStatistics *statistics,
 		     ExceptionInfo *exception);
 
+#if defined(MAGICK_IMPLEMENTATION)
+
+/*
+  Single pass statistics accumulation (see GetImageStatistics()).
+  Values are in quantum units until finalized.
+*/
+typedef struct _ChannelAccumulator
+ {
+   /* Number of samples */
+   double count;
+   /* Mean of samples */
+   double mean;
+   /* Sum of squared deviations from the mean */
+   double m2;
+   /* Minimum sample */
+   double minimum;
+   /* Maximum sample */
+   double maximum;
+ } ChannelAccumulator;
+
+typedef struct _StatisticsAccumulator
+ {
+   ChannelAccumulator red;
+   ChannelAccumulator green;
+   ChannelAccumulator blue;
+   ChannelAccumulator opacity;
+   /* Accumulate the opacity (or CMYK black) channel */
+   MagickBool process_opacity;
+ } StatisticsAccumulator;
+
+extern void
+  AccumulateImageStatistics(StatisticsAccumulator *accumulator,
+                            const PixelPacket *pixels,const long npixels),
+  FinalizeStatisticsAccumulator(const StatisticsAccumulator *accumulator,
+                                ImageStatistics *statistics),
+  InitializeStatisticsAccumulator(StatisticsAccumulator *accumulator,
+                                  const MagickBool process_opacity),
+  MergeStatisticsAccumulators(StatisticsAccumulator *total,
+                              const StatisticsAccumulator *part);
+
+#endif /* defined(MAGICK_IMPLEMENTATION) */
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif
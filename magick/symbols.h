@@ -20,6 +20,7 @@
 
 #if defined(PREFIX_MAGICK_SYMBOLS)
 
+#define AccessCacheBandDigests GmAccessCacheBandDigests
 #define AccessCacheViewPixels GmAccessCacheViewPixels
 #define AccessDefaultCacheView GmAccessDefaultCacheView
 #define AccessDefinition GmAccessDefinition
@@ -28,6 +29,7 @@
 #define AccessMutablePixels GmAccessMutablePixels
 #define AccessThreadViewData GmAccessThreadViewData
 #define AccessThreadViewDataById GmAccessThreadViewDataById
+#define AccumulateImageStatistics GmAccumulateImageStatistics
 #define AcquireCacheView GmAcquireCacheView
 #define AcquireCacheViewIndexes GmAcquireCacheViewIndexes
 #define AcquireCacheViewPixels GmAcquireCacheViewPixels
@@ -43,15 +45,21 @@
 #define AcquireTemporaryFileDescriptor GmAcquireTemporaryFileDescriptor
 #define AcquireTemporaryFileName GmAcquireTemporaryFileName
 #define AcquireTemporaryFileStream GmAcquireTemporaryFileStream
+#define AcquireTemporaryMemoryFile GmAcquireTemporaryMemoryFile
 #define AdaptiveThresholdImage GmAdaptiveThresholdImage
+#define AddConfigureSnapshotSource GmAddConfigureSnapshotSource
+#define AddConfigureSnapshotString GmAddConfigureSnapshotString
+#define AddConfigureSnapshotValue GmAddConfigureSnapshotValue
 #define AddDefinition GmAddDefinition
 #define AddDefinitions GmAddDefinitions
 #define AddNoiseImage GmAddNoiseImage
 #define AddNoiseImageChannel GmAddNoiseImageChannel
 #define AffineTransformImage GmAffineTransformImage
+#define AllocateConditionInfo GmAllocateConditionInfo
 #define AllocateImage GmAllocateImage
 #define AllocateImageColormap GmAllocateImageColormap
 #define AllocateImageProfileIterator GmAllocateImageProfileIterator
+#define AllocateIntegralImage GmAllocateIntegralImage
 #define AllocateNextImage GmAllocateNextImage
 #define AllocateSemaphoreInfo GmAllocateSemaphoreInfo
 #define AllocateString GmAllocateString
@@ -96,6 +104,7 @@
 #define ChannelThresholdImage GmChannelThresholdImage
 #define ChannelTypeToString GmChannelTypeToString
 #define CharcoalImage GmCharcoalImage
+#define CheckImageDifference GmCheckImageDifference
 #define CheckImagePixelLimits GmCheckImagePixelLimits
 #define ChopImage GmChopImage
 #define ClassTypeToString GmClassTypeToString
@@ -113,6 +122,8 @@
 #define CloneString GmCloneString
 #define CloseBlob GmCloseBlob
 #define CloseCacheView GmCloseCacheView
+#define CloseImageRowEncoder GmCloseImageRowEncoder
+#define ClosePixelRowIterator GmClosePixelRowIterator
 #define CoalesceImages GmCoalesceImages
 #define ColorFloodfillImage GmColorFloodfillImage
 #define ColorMatrixImage GmColorMatrixImage
@@ -153,8 +164,12 @@
 #define DespeckleImage GmDespeckleImage
 #define DestroyBlob GmDestroyBlob
 #define DestroyBlobInfo GmDestroyBlobInfo
+#define DestroyBlobSegments GmDestroyBlobSegments
 #define DestroyCacheInfo GmDestroyCacheInfo
 #define DestroyColorInfo GmDestroyColorInfo
+#define DestroyColorTransformCache GmDestroyColorTransformCache
+#define DestroyConditionInfo GmDestroyConditionInfo
+#define DestroyConfigureSnapshot GmDestroyConfigureSnapshot
 #define DestroyConstitute GmDestroyConstitute
 #define DestroyDelegateInfo GmDestroyDelegateInfo
 #define DestroyDrawInfo GmDestroyDrawInfo
@@ -164,6 +179,7 @@
 #define DestroyImageInfo GmDestroyImageInfo
 #define DestroyImageList GmDestroyImageList
 #define DestroyImagePixels GmDestroyImagePixels
+#define DestroyIntegralImage GmDestroyIntegralImage
 #define DestroyLogInfo GmDestroyLogInfo
 #define DestroyMagicInfo GmDestroyMagicInfo
 #define DestroyMagick GmDestroyMagick
@@ -307,6 +323,7 @@
 #define EqualizeImage GmEqualizeImage
 #define EscapeString GmEscapeString
 #define ExecuteModuleProcess GmExecuteModuleProcess
+#define ExecuteParallelTasks GmExecuteParallelTasks
 #define ExpandAffine GmExpandAffine
 #define ExpandFilename GmExpandFilename
 #define ExpandFilenames GmExpandFilenames
@@ -317,6 +334,7 @@
 #define ExtentImage GmExtentImage
 #define FileToBlob GmFileToBlob
 #define FinalizeSignature GmFinalizeSignature
+#define FinalizeStatisticsAccumulator GmFinalizeStatisticsAccumulator
 #define FlattenImages GmFlattenImages
 #define FlipImage GmFlipImage
 #define FlopImage GmFlopImage
@@ -354,6 +372,9 @@
 #define GetColorList GmGetColorList
 #define GetColorTuple GmGetColorTuple
 #define GetConfigureBlob GmGetConfigureBlob
+#define GetConfigureSnapshotEntries GmGetConfigureSnapshotEntries
+#define GetConfigureSnapshotString GmGetConfigureSnapshotString
+#define GetConfigureSnapshotValue GmGetConfigureSnapshotValue
 #define GetDelegateCommand GmGetDelegateCommand
 #define GetDelegateInfo GmGetDelegateInfo
 #define GetDrawInfo GmGetDrawInfo
@@ -371,6 +392,7 @@
 #define GetImageCharacteristics GmGetImageCharacteristics
 #define GetImageClipMask GmGetImageClipMask
 #define GetImageClippingPathAttribute GmGetImageClippingPathAttribute
+#define GetImageComparisonStatistics GmGetImageComparisonStatistics
 #define GetImageDepth GmGetImageDepth
 #define GetImageDistortion GmGetImageDistortion
 #define GetImageException GmGetImageException
@@ -390,6 +412,7 @@
 #define GetImageType GmGetImageType
 #define GetImageVirtualPixelMethod GmGetImageVirtualPixelMethod
 #define GetIndexes GmGetIndexes
+#define GetIntegralImageSums GmGetIntegralImageSums
 #define GetLastImageInList GmGetLastImageInList
 #define GetLocaleExceptionMessage GmGetLocaleExceptionMessage
 #define GetLocaleMessage GmGetLocaleMessage
@@ -413,10 +436,13 @@
 #define GetOptimalKernelWidth1D GmGetOptimalKernelWidth1D
 #define GetOptimalKernelWidth2D GmGetOptimalKernelWidth2D
 #define GetPageGeometry GmGetPageGeometry
+#define GetParallelTaskThreads GmGetParallelTaskThreads
 #define GetPathComponent GmGetPathComponent
 #define GetPixelCacheArea GmGetPixelCacheArea
 #define GetPixelCacheInCore GmGetPixelCacheInCore
 #define GetPixelCachePresent GmGetPixelCachePresent
+#define GetPixelRowIteratorStatus GmGetPixelRowIteratorStatus
+#define GetPixelRowIteratorStride GmGetPixelRowIteratorStride
 #define GetPixels GmGetPixels
 #define GetPostscriptDelegateInfo GmGetPostscriptDelegateInfo
 #define GetPreviousImageInList GmGetPreviousImageInList
@@ -446,6 +472,7 @@
 #define IdentityAffine GmIdentityAffine
 #define ImageListToArray GmImageListToArray
 #define ImageToBlob GmImageToBlob
+#define ImageToBlobSegments GmImageToBlobSegments
 #define ImageToFile GmImageToFile
 #define ImageToHuffman2DBlob GmImageToHuffman2DBlob
 #define ImageToJPEGBlob GmImageToJPEGBlob
@@ -458,6 +485,7 @@
 #define ImportPixelAreaOptionsInit GmImportPixelAreaOptionsInit
 #define ImportViewPixelArea GmImportViewPixelArea
 #define InitializeColorInfo GmInitializeColorInfo
+#define InitializeColorTransformCache GmInitializeColorTransformCache
 #define InitializeConstitute GmInitializeConstitute
 #define InitializeDelegateInfo GmInitializeDelegateInfo
 #define InitializeDifferenceImageOptions GmInitializeDifferenceImageOptions
@@ -473,6 +501,7 @@
 #define InitializeMagickSignalHandlers GmInitializeMagickSignalHandlers
 #define InitializePixelIteratorOptions GmInitializePixelIteratorOptions
 #define InitializeSemaphore GmInitializeSemaphore
+#define InitializeStatisticsAccumulator GmInitializeStatisticsAccumulator
 #define InitializeTemporaryFiles GmInitializeTemporaryFiles
 #define InitializeTypeInfo GmInitializeTypeInfo
 #define InsertImageInList GmInsertImageInList
@@ -505,6 +534,7 @@
 #define LiberateMemory GmLiberateMemory
 #define LiberateSemaphoreInfo GmLiberateSemaphoreInfo
 #define LiberateTemporaryFile GmLiberateTemporaryFile
+#define LiberateTemporaryMemoryFile GmLiberateTemporaryMemoryFile
 #define ListColorInfo GmListColorInfo
 #define ListDelegateInfo GmListDelegateInfo
 #define ListFiles GmListFiles
@@ -517,9 +547,12 @@
 #define LocaleLower GmLocaleLower
 #define LocaleNCompare GmLocaleNCompare
 #define LocaleUpper GmLocaleUpper
+#define LockMagickCoder GmLockMagickCoder
 #define LockSemaphoreInfo GmLockSemaphoreInfo
 #define LogMagickEvent GmLogMagickEvent
 #define LogMagickEventList GmLogMagickEventList
+#define MagickRecordStartupTime GmMagickRecordStartupTime
+#define MagickStartupClock GmMagickStartupClock
 #define MatteColor GmMatteColor
 #define MSBOrderLong GmMSBOrderLong
 #define MSBOrderShort GmMSBOrderShort
@@ -687,6 +720,7 @@
 #define MapModeToString GmMapModeToString
 #define MatteFloodfillImage GmMatteFloodfillImage
 #define MedianFilterImage GmMedianFilterImage
+#define MergeStatisticsAccumulators GmMergeStatisticsAccumulators
 #define MetricTypeToString GmMetricTypeToString
 #define MinifyImage GmMinifyImage
 #define ModifyCache GmModifyCache
@@ -705,12 +739,16 @@
 #define NegateImage GmNegateImage
 #define NewImageList GmNewImageList
 #define NextImageProfile GmNextImageProfile
+#define NextPixelRowIteratorRow GmNextPixelRowIteratorRow
 #define NoiseTypeToString GmNoiseTypeToString
 #define NormalizeImage GmNormalizeImage
 #define OilPaintImage GmOilPaintImage
 #define OpaqueImage GmOpaqueImage
 #define OpenBlob GmOpenBlob
 #define OpenCacheView GmOpenCacheView
+#define OpenConfigureSnapshot GmOpenConfigureSnapshot
+#define OpenImageRowEncoder GmOpenImageRowEncoder
+#define OpenPixelRowIterator GmOpenPixelRowIterator
 #define OrderedDitherImage GmOrderedDitherImage
 #define OrientationTypeToString GmOrientationTypeToString
 #define PackbitsEncode2Image GmPackbitsEncode2Image
@@ -771,6 +809,7 @@
 #define ReadBlobMSBShorts GmReadBlobMSBShorts
 #define ReadBlobString GmReadBlobString
 #define ReadBlobZC GmReadBlobZC
+#define ReadBlobZCBuffer GmReadBlobZCBuffer
 #define ReadImage GmReadImage
 #define ReadInlineImage GmReadInlineImage
 #define ReduceNoiseImage GmReduceNoiseImage
@@ -850,6 +889,7 @@
 #define RegisterSTEGANOImage GmRegisterSTEGANOImage
 #define RegisterSUNImage GmRegisterSUNImage
 #define RegisterSVGImage GmRegisterSVGImage
+#define RegisterStaticModule GmRegisterStaticModule
 #define RegisterStaticModules GmRegisterStaticModules
 #define RegisterTGAImage GmRegisterTGAImage
 #define RegisterTIFFImage GmRegisterTIFFImage
@@ -916,6 +956,7 @@
 #define SetImagePixels GmSetImagePixels
 #define SetImagePixelsEx GmSetImagePixelsEx
 #define SetImageProfile GmSetImageProfile
+#define SetImageRowEncoderPixels GmSetImageRowEncoderPixels
 #define SetImageType GmSetImageType
 #define SetImageVirtualPixelMethod GmSetImageVirtualPixelMethod
 #define SetLogEventMask GmSetLogEventMask
@@ -925,12 +966,14 @@
 #define SetMagickRegistry GmSetMagickRegistry
 #define SetMagickResourceLimit GmSetMagickResourceLimit
 #define SetMonitorHandler GmSetMonitorHandler
+#define SetPixelRowIteratorRegion GmSetPixelRowIteratorRegion
 #define SetWarningHandler GmSetWarningHandler
 #define ShadeImage GmShadeImage
 #define SharpenImage GmSharpenImage
 #define SharpenImageChannel GmSharpenImageChannel
 #define ShaveImage GmShaveImage
 #define ShearImage GmShearImage
+#define SignalConditionInfo GmSignalConditionInfo
 #define SignatureImage GmSignatureImage
 #define SolarizeImage GmSolarizeImage
 #define SortColormapByIntensity GmSortColormapByIntensity
@@ -971,7 +1014,9 @@
 #define SyncImage GmSyncImage
 #define SyncImagePixels GmSyncImagePixels
 #define SyncImagePixelsEx GmSyncImagePixelsEx
+#define SyncImageRowEncoderPixels GmSyncImageRowEncoderPixels
 #define SyncNextImageInList GmSyncNextImageInList
+#define SyncPixelRowIteratorRow GmSyncPixelRowIteratorRow
 #define SystemCommand GmSystemCommand
 #define TellBlob GmTellBlob
 #define TextureImage GmTextureImage
@@ -989,6 +1034,8 @@
 #define TranslateText GmTranslateText
 #define TranslateTextEx GmTranslateTextEx
 #define TransparentImage GmTransparentImage
+#define TreeSignatureImage GmTreeSignatureImage
+#define UnlockMagickCoder GmUnlockMagickCoder
 #define UnlockSemaphoreInfo GmUnlockSemaphoreInfo
 #define UnmapBlob GmUnmapBlob
 #define UnregisterARTImage GmUnregisterARTImage
@@ -1091,6 +1138,7 @@
 #define UnsharpMaskImage GmUnsharpMaskImage
 #define UnsharpMaskImageChannel GmUnsharpMaskImageChannel
 #define UpdateSignature GmUpdateSignature
+#define WaitConditionInfo GmWaitConditionInfo
 #define WaveImage GmWaveImage
 #define WhiteThresholdImage GmWhiteThresholdImage
 #define WriteBlob GmWriteBlob
@@ -1103,6 +1151,7 @@
 #define WriteBlobString GmWriteBlobString
 #define WriteBlobStringEOL GmWriteBlobStringEOL
 #define WriteBlobStringWithEOL GmWriteBlobStringWithEOL
+#define WriteConfigureSnapshot GmWriteConfigureSnapshot
 #define WriteImage GmWriteImage
 #define WriteImages GmWriteImages
 #define WriteImagesFile GmWriteImagesFile
@@ -390,6 +390,68 @@ MagickExport FILE *AcquireTemporaryFileStream(char *filename,
   return (FILE *) NULL;
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   A c q u i r e T e m p o r a r y M e m o r y F i l e                       %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  AcquireTemporaryMemoryFile creates an anonymous file which resides in
+%  memory rather than in the filesystem, and replaces the contents of the
+%  string buffer pointed to by filename with a name which may be used to
+%  open it (like any other file) in this process.  The file is not
+%  inherited by programs started by this process, so delegate programs
+%  must be passed a temporary file instead.  A read/write file descriptor
+%  is returned on success, or -1 is returned if memory files are not
+%  supported on this system, in which case a temporary file should be
+%  used instead.  The memory file must be deallocated via
+%  LiberateTemporaryMemoryFile() once it is no longer required.
+%
+%  The format of the AcquireTemporaryMemoryFile method is:
+%
+%      int AcquireTemporaryMemoryFile(char *filename)
+%
+%  A description of each parameter follows.
+%
+%   o status: The file descriptor for the memory file on success, or -1
+%             on failure.
+%
+%   o filename: Specifies a pointer to an array of characters with an
+%             allocated length of at least MaxTextExtent.  The name of the
+%             memory file is returned in this array.
+%
+*/
+MagickExport int AcquireTemporaryMemoryFile(char *filename)
+{
+  int
+    fd=-1;
+
+  assert(filename != (char *) NULL);
+  filename[0]='\0';
+#if defined(HAVE_SYS_MMAN_H) && defined(MFD_CLOEXEC)
+  fd=memfd_create("GraphicsMagick",MFD_CLOEXEC);
+  if (fd != -1)
+    {
+      FormatString(filename,"/proc/self/fd/%d",fd);
+      if (access(filename,R_OK | W_OK) != 0)
+        {
+          (void) close(fd);
+          fd=-1;
+          filename[0]='\0';
+        }
+    }
+#endif /* defined(HAVE_SYS_MMAN_H) && defined(MFD_CLOEXEC) */
+  if (fd != -1)
+    (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+      "Allocating memory file \"%s\"",filename);
+  return fd;
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -489,6 +551,45 @@ MagickExport MagickPassFail LiberateTemporaryFile(char *filename)
   return (status);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
++   L i b e r a t e T e m p o r a r y M e m o r y F i l e                     %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  LiberateTemporaryMemoryFile deallocates a memory file allocated by
+%  AcquireTemporaryMemoryFile(), releasing its memory.  The first position
+%  in the filename string buffer is set to null in order to avoid
+%  accidental continued use.
+%
+%      MagickPassFail LiberateTemporaryMemoryFile(int fd,char *filename)
+%
+%  A description of each parameter follows.
+%
+%   o fd: The file descriptor returned by AcquireTemporaryMemoryFile().
+%
+%   o filename: Specifies a pointer to an array of characters representing
+%               the memory file to reclaim.
+%
+*/
+MagickExport MagickPassFail LiberateTemporaryMemoryFile(int fd,char *filename)
+{
+  MagickPassFail
+    status = MagickFail;
+
+  (void) LogMagickEvent(TemporaryFileEvent,GetMagickModule(),
+    "Deallocating memory file \"%s\"",filename);
+  if (close(fd) == 0)
+    status=MagickPass;
+  filename[0]='\0';
+  return (status);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -27,7 +27,11 @@ MagickExport MagickPassFail
   LiberateTemporaryFile(char *filename);
 
 MagickExport int
-  AcquireTemporaryFileDescriptor(char *filename);
+  AcquireTemporaryFileDescriptor(char *filename),
+  AcquireTemporaryMemoryFile(char *filename);
+
+MagickExport MagickPassFail
+  LiberateTemporaryMemoryFile(int fd,char *filename);
 
 MagickExport FILE *
   AcquireTemporaryFileStream(char *filename,FileIOMode mode);
@@ -39,8 +39,10 @@
 # include "magick/nt_feature.h"
 #endif
 #include "magick/blob.h"
+#include "magick/config_snapshot.h"
 #include "magick/enum_strings.h"
 #include "magick/log.h"
+#include "magick/magick.h"
 #include "magick/render.h"
 #include "magick/semaphore.h"
 #include "magick/type.h"
@@ -50,6 +52,25 @@
   Define declarations.
 */
 #define TypeFilename  "type.mgk"
+
+/*
+  Fields of a type snapshot entry.
+*/
+#define TypeSnapshotPath         0U
+#define TypeSnapshotName         1U
+#define TypeSnapshotDescription  2U
+#define TypeSnapshotFamily       3U
+#define TypeSnapshotStyle        4U
+#define TypeSnapshotStretch      5U
+#define TypeSnapshotWeight       6U
+#define TypeSnapshotEncoding     7U
+#define TypeSnapshotFoundry      8U
+#define TypeSnapshotFormat       9U
+#define TypeSnapshotMetrics      10U
+#define TypeSnapshotGlyphs       11U
+#define TypeSnapshotStealth      12U
+#define TypeSnapshotFields       13U
+#define TypeSnapshotVersion      1U
 
 /*
   Declare type map.
@@ -69,6 +90,19 @@ static SemaphoreInfo
 
 static TypeInfo
   *type_list = (TypeInfo *) NULL;
+
+/*
+  Types loaded from a snapshot are allocated as one block, and their
+  strings are in the snapshot.
+*/
+static TypeInfo
+  *type_block = (TypeInfo *) NULL;
+
+static unsigned long
+  type_block_length = 0;
+
+static ConfigureSnapshot
+  type_snapshot;
 
 /*
   Forward declarations.
@@ -107,6 +141,9 @@ MagickExport void DestroyTypeInfo(void)
   {
     type_info=p;
     p=p->next;
+    if ((type_info >= type_block) &&
+        (type_info < type_block+type_block_length))
+      continue;
     if (type_info->path != (char *) NULL)
       MagickFreeMemory(type_info->path);
     if (type_info->name != (char *) NULL)
@@ -128,6 +165,9 @@ MagickExport void DestroyTypeInfo(void)
     MagickFreeMemory(type_info);
   }
   type_list=(TypeInfo *) NULL;
+  MagickFreeMemory(type_block);
+  type_block_length=0;
+  DestroyConfigureSnapshot(&type_snapshot);
   DestroySemaphoreInfo(&type_semaphore);
 }
 
@@ -171,6 +211,10 @@ MagickExport const TypeInfo *GetTypeInfo(const char *name,
       LockSemaphoreInfo(type_semaphore);
       if (type_list == (TypeInfo *) NULL)
         {
+          double
+            start;
+
+          start=MagickStartupClock();
           (void) ReadTypeConfigureFile(TypeFilename,0,exception);
 #if defined(MSWINDOWS) || defined(__CYGWIN__)
           {
@@ -194,6 +238,7 @@ MagickExport const TypeInfo *GetTypeInfo(const char *name,
               }
           }
 #endif
+          MagickRecordStartupTime(TypeFilename,start);
         }
       UnlockSemaphoreInfo(type_semaphore);
     }
@@ -579,6 +624,99 @@ MagickExport unsigned int ListTypeInfo(FILE *file,ExceptionInfo *exception)
   return(True);
 }
 
+/*
+  Build the type list from the snapshot of the type configuration file
+  (found at path) if it is up to date.
+*/
+static MagickPassFail ReadTypeSnapshot(const char *path)
+{
+  unsigned long
+    entries,
+    i;
+
+  if (!OpenConfigureSnapshot(&type_snapshot,TypeFilename,path,
+                             TypeSnapshotVersion,TypeSnapshotFields))
+    return(MagickFail);
+  entries=GetConfigureSnapshotEntries(&type_snapshot);
+  type_block=MagickAllocateArray(TypeInfo *,entries,sizeof(TypeInfo));
+  if ((entries == 0) || (type_block == (TypeInfo *) NULL))
+    {
+      MagickFreeMemory(type_block);
+      DestroyConfigureSnapshot(&type_snapshot);
+      return(MagickFail);
+    }
+  type_block_length=entries;
+  for (i=0; i < entries; i++)
+  {
+    TypeInfo
+      *type_info;
+
+    type_info=type_block+i;
+    type_info->path=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotPath);
+    type_info->name=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotName);
+    type_info->description=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotDescription);
+    type_info->family=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotFamily);
+    type_info->style=(StyleType)
+      GetConfigureSnapshotValue(&type_snapshot,i,TypeSnapshotStyle);
+    type_info->stretch=(StretchType)
+      GetConfigureSnapshotValue(&type_snapshot,i,TypeSnapshotStretch);
+    type_info->weight=
+      GetConfigureSnapshotValue(&type_snapshot,i,TypeSnapshotWeight);
+    type_info->encoding=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotEncoding);
+    type_info->foundry=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotFoundry);
+    type_info->format=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotFormat);
+    type_info->metrics=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotMetrics);
+    type_info->glyphs=(char *)
+      GetConfigureSnapshotString(&type_snapshot,i,TypeSnapshotGlyphs);
+    type_info->stealth=
+      GetConfigureSnapshotValue(&type_snapshot,i,TypeSnapshotStealth);
+    type_info->signature=MagickSignature;
+    type_info->previous=(i == 0 ? (TypeInfo *) NULL : type_info-1);
+    type_info->next=(i+1 == entries ? (TypeInfo *) NULL : type_info+1);
+  }
+  type_list=type_block;
+  return(MagickPass);
+}
+
+/*
+  Write a snapshot of the type list once the type configuration file has
+  been read.
+*/
+static void WriteTypeSnapshot(void)
+{
+  register const TypeInfo
+    *p;
+
+  if (!type_snapshot.enabled)
+    return;
+  for (p=type_list; p != (const TypeInfo *) NULL; p=p->next)
+  {
+    AddConfigureSnapshotString(&type_snapshot,p->path);
+    AddConfigureSnapshotString(&type_snapshot,p->name);
+    AddConfigureSnapshotString(&type_snapshot,p->description);
+    AddConfigureSnapshotString(&type_snapshot,p->family);
+    AddConfigureSnapshotValue(&type_snapshot,p->style);
+    AddConfigureSnapshotValue(&type_snapshot,p->stretch);
+    AddConfigureSnapshotValue(&type_snapshot,(magick_uint32_t) p->weight);
+    AddConfigureSnapshotString(&type_snapshot,p->encoding);
+    AddConfigureSnapshotString(&type_snapshot,p->foundry);
+    AddConfigureSnapshotString(&type_snapshot,p->format);
+    AddConfigureSnapshotString(&type_snapshot,p->metrics);
+    AddConfigureSnapshotString(&type_snapshot,p->glyphs);
+    AddConfigureSnapshotValue(&type_snapshot,p->stealth);
+  }
+  (void) WriteConfigureSnapshot(&type_snapshot,TypeFilename);
+  DestroyConfigureSnapshot(&type_snapshot);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -591,7 +729,10 @@ MagickExport unsigned int ListTypeInfo(FILE *file,ExceptionInfo *exception)
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %
 %  ReadTypeConfigureFile() reads the type configuration file which provides
-%  a mapping between type attributes and font files.
+%  a mapping between type attributes and font files.  If configuration
+%  snapshots are enabled, the type list is loaded from the snapshot of the
+%  file if it is up to date, and otherwise the snapshot is written once
+%  the file has been read.
 %
 %  The format of the ReadTypeConfigureFile method is:
 %
@@ -652,6 +793,13 @@ static unsigned int ReadTypeConfigureFile(const char *basename,
       xml=(char *) GetConfigureBlob(basename,path,&length,exception);
       if (xml == (char *) NULL)
         xml=AllocateString(TypeMap);
+      else if (ReadTypeSnapshot(path))
+        {
+          MagickFreeMemory(xml);
+          return(True);
+        }
+      else
+        AddConfigureSnapshotSource(&type_snapshot,path);
     }
   else
     {
@@ -660,11 +808,17 @@ static unsigned int ReadTypeConfigureFile(const char *basename,
         by parent configuration file.
       */
       if (IsAccessibleAndNotEmpty(basename))
-        xml=(char *) FileToBlob(basename,&length,exception);
+        {
+          xml=(char *) FileToBlob(basename,&length,exception);
+          if (xml != (char *) NULL)
+            AddConfigureSnapshotSource(&type_snapshot,basename);
+        }
       else
         {
           GetPathComponent(basename,TailPath,path);
           xml=(char *) GetConfigureBlob(path,keyword,&length,exception);
+          if (xml != (char *) NULL)
+            AddConfigureSnapshotSource(&type_snapshot,keyword);
         }
       if (xml == (char *) NULL)
         return (False);
@@ -910,5 +1064,7 @@ static unsigned int ReadTypeConfigureFile(const char *basename,
     return(False);
   while (type_list->previous != (TypeInfo *) NULL)
     type_list=type_list->previous;
+  if (depth == 0)
+    WriteTypeSnapshot();
   return(True);
 }
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Benchmark and test for decoders which read their input a byte at a
+ * time.
+ *
+ * The input image, and a 256 color version of it, are encoded using
+ * each of the run-length (BMP, PCX, TGA), LZW (GIF), and ASCII (PNM)
+ * encoded formats, and then decoded repeatedly from an in-memory BLOB,
+ * or with -file, from a file.  The input may be resized with -size so
+ * that decoding takes long enough to be timed.  The decode throughput of
+ * each format is reported along with the signature of the decoded image.
+ *
+ * Setting MAGICK_BLOB_READ_AHEAD=FALSE in the environment disables the
+ * blob read-ahead buffer so that the per-byte cost of ReadBlobByte()
+ * may be timed.  With -verify, only the signatures are printed, so that
+ * the output with and without read-ahead may be compared directly.
+ *
+ */
+
+#include <magick/api.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _BlobReadCase
+{
+  const char
+    *magick;
+
+  CompressionType
+    compression;
+
+  MagickBool
+    palette,                    /* Encode a 256 color version of the image */
+    ascii;                      /* Request ASCII PNM (quality 0) */
+} BlobReadCase;
+
+static const BlobReadCase cases[] =
+  {
+    { "BMP", RLECompression, MagickTrue,  MagickFalse },
+    { "GIF", LZWCompression, MagickTrue,  MagickFalse },
+    { "PCX", RLECompression, MagickTrue,  MagickFalse },
+    { "PCX", RLECompression, MagickFalse, MagickFalse },
+    { "PGM", NoCompression,  MagickFalse, MagickTrue  },
+    { "PPM", NoCompression,  MagickFalse, MagickTrue  },
+    { "TGA", RLECompression, MagickTrue,  MagickFalse },
+    { "TGA", RLECompression, MagickFalse, MagickFalse }
+  };
+
+int main ( int argc, char **argv )
+{
+  Image
+    *image = (Image *) NULL,
+    *palette_image = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  const char
+    *infile = (const char *) NULL;
+
+  unsigned long
+    columns = 0,
+    iterations = 100,
+    rows = 0;
+
+  MagickBool
+    from_file = MagickFalse,
+    verify = MagickFalse;
+
+  int
+    arg,
+    exit_status = 0;
+
+  unsigned int
+    i;
+
+  if (LocaleNCompare("blobread",argv[0],8) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  for (arg=1; arg < argc; arg++)
+    {
+      char
+        *option = argv[arg];
+
+      if ((LocaleCompare("-iterations",option) == 0) && (arg+1 < argc))
+        iterations=strtoul(argv[++arg],(char **) NULL,10);
+      else if ((LocaleCompare("-size",option) == 0) && (arg+1 < argc))
+        {
+          if (sscanf(argv[++arg],"%lux%lu",&columns,&rows) != 2)
+            iterations=0;
+        }
+      else if (LocaleCompare("-file",option) == 0)
+        from_file=MagickTrue;
+      else if (LocaleCompare("-verify",option) == 0)
+        verify=MagickTrue;
+      else if ((*option != '-') && (arg+1 == argc))
+        infile=option;
+      else
+        break;
+    }
+  if ((infile == (const char *) NULL) || (iterations == 0))
+    {
+      (void) printf("Usage: %s [-iterations count] [-size columnsxrows] "
+                    "[-file] [-verify] infile\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (verify)
+    iterations=1;
+
+  (void) strncpy(imageInfo->filename, infile, MaxTextExtent-1 );
+  image=ReadImage(imageInfo,&exception);
+  if (image == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read image %s\n",infile);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if ((columns != 0) && (rows != 0))
+    {
+      Image
+        *resize_image;
+
+      resize_image=SampleImage(image,columns,rows,&exception);
+      if (resize_image == (Image *) NULL)
+        {
+          CatchException(&exception);
+          exit_status = 1;
+          goto program_exit;
+        }
+      DestroyImageList(image);
+      image=resize_image;
+    }
+  palette_image=CloneImage(image,0,0,MagickTrue,&exception);
+  if (palette_image != (Image *) NULL)
+    {
+      QuantizeInfo
+        quantize_info;
+
+      GetQuantizeInfo(&quantize_info);
+      quantize_info.number_colors=256;
+      if (!QuantizeImage(&quantize_info,palette_image))
+        CopyException(&exception,&palette_image->exception);
+    }
+  if ((palette_image == (Image *) NULL) ||
+      (exception.severity != UndefinedException))
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  for (i=0; i < sizeof(cases)/sizeof(cases[0]); i++)
+    {
+      const BlobReadCase
+        *c = &cases[i];
+
+      const ImageAttribute
+        *attribute;
+
+      Image
+        *decoded = (Image *) NULL,
+        *encode_image;
+
+      ImageInfo
+        *clone_info;
+
+      TimerInfo
+        timer;
+
+      char
+        filename[MaxTextExtent];
+
+      double
+        elapsed;
+
+      size_t
+        length = 0;
+
+      unsigned long
+        iteration;
+
+      void
+        *blob;
+
+      /*
+        Encode the image in the format under test.
+      */
+      encode_image=(c->palette ? palette_image : image);
+      clone_info=CloneImageInfo(imageInfo);
+      (void) strncpy(clone_info->magick,c->magick,MaxTextExtent-1);
+      clone_info->compression=c->compression;
+      if (c->ascii)
+        clone_info->quality=0;
+      encode_image->compression=c->compression;
+      (void) strncpy(encode_image->magick,c->magick,MaxTextExtent-1);
+      blob=ImageToBlob(clone_info,encode_image,&length,&exception);
+      if (blob == (void *) NULL)
+        {
+          CatchException(&exception);
+          (void) printf("Failed to encode %s\n",c->magick);
+          DestroyImageInfo(clone_info);
+          exit_status = 1;
+          goto program_exit;
+        }
+      FormatString(filename,"out_blobread.%s",c->magick);
+      if (from_file && !BlobToFile(filename,blob,length,&exception))
+        {
+          CatchException(&exception);
+          MagickFree(blob);
+          DestroyImageInfo(clone_info);
+          exit_status = 1;
+          goto program_exit;
+        }
+
+      /*
+        Decode it repeatedly.
+      */
+      GetTimerInfo(&timer);
+      for (iteration=0; iteration < iterations; iteration++)
+        {
+          if (decoded)
+            DestroyImageList(decoded);
+          if (from_file)
+            {
+              FormatString(clone_info->filename,"%s:%s",c->magick,filename);
+              decoded=ReadImage(clone_info,&exception);
+            }
+          else
+            {
+              FormatString(clone_info->filename,"%s:",c->magick);
+              decoded=BlobToImage(clone_info,blob,length,&exception);
+            }
+          if (decoded == (Image *) NULL)
+            break;
+        }
+      elapsed=GetElapsedTime(&timer);
+      MagickFree(blob);
+      DestroyImageInfo(clone_info);
+      if (from_file)
+        (void) remove(filename);
+      if (decoded == (Image *) NULL)
+        {
+          CatchException(&exception);
+          (void) printf("Failed to decode %s\n",c->magick);
+          exit_status = 1;
+          goto program_exit;
+        }
+
+      (void) SignatureImage(decoded);
+      attribute=GetImageAttribute(decoded,"signature");
+      (void) printf("%-4s %-9s: ",c->magick,
+                    c->palette ? "palette" : c->ascii ? "ascii" : "truecolor");
+      if (!verify)
+        (void) printf("%8.1f MB/s, ",
+                      elapsed > 0.0 ?
+                      ((double) length*iterations)/(1.0e6*elapsed) : 0.0);
+      (void) printf("signature %s\n",
+                    attribute != (const ImageAttribute *) NULL ?
+                    attribute->value : "(none)");
+      DestroyImageList(decoded);
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  if (palette_image)
+    DestroyImageList(palette_image);
+  if (image)
+    DestroyImageList(image);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Test GetImageStatistics() and GetImageComparisonStatistics().  The
+ * single pass image statistics are checked against a straightforward
+ * two pass computation, and the statistics returned by
+ * GetImageComparisonStatistics() for an image and a blurred copy of it
+ * must match those returned by GetImageStatistics() and
+ * GetImageChannelDifference() for each metric.  CheckImageDifference()
+ * must agree with GetImageChannelDifference() when given limits just
+ * above and just below the difference for each metric.
+ *
+ */
+
+#include <magick/api.h>
+#include <magick/enum_strings.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int CompareValue(const char *what,const double expected,
+                        const double value)
+{
+  if (fabs(expected-value) > 1.0e-9*(fabs(expected)+1.0))
+    {
+      (void) printf("%s: expected %.15g, got %.15g\n",what,expected,value);
+      return 0;
+    }
+  return 1;
+}
+
+static int CompareChannelStatistics(const char *what,
+                                    const ImageChannelStatistics *expected,
+                                    const ImageChannelStatistics *value)
+{
+  char
+    description[MaxTextExtent];
+
+  int
+    status = 1;
+
+  FormatString(description,"%s maximum",what);
+  status &= CompareValue(description,expected->maximum,value->maximum);
+  FormatString(description,"%s minimum",what);
+  status &= CompareValue(description,expected->minimum,value->minimum);
+  FormatString(description,"%s mean",what);
+  status &= CompareValue(description,expected->mean,value->mean);
+  FormatString(description,"%s variance",what);
+  status &= CompareValue(description,expected->variance,value->variance);
+  FormatString(description,"%s standard deviation",what);
+  status &= CompareValue(description,expected->standard_deviation,
+                         value->standard_deviation);
+  return status;
+}
+
+static int CompareImageStatistics(const char *what,
+                                  const ImageStatistics *expected,
+                                  const ImageStatistics *value)
+{
+  char
+    description[MaxTextExtent];
+
+  int
+    status = 1;
+
+  FormatString(description,"%s red",what);
+  status &= CompareChannelStatistics(description,&expected->red,&value->red);
+  FormatString(description,"%s green",what);
+  status &= CompareChannelStatistics(description,&expected->green,
+                                     &value->green);
+  FormatString(description,"%s blue",what);
+  status &= CompareChannelStatistics(description,&expected->blue,
+                                     &value->blue);
+  FormatString(description,"%s opacity",what);
+  status &= CompareChannelStatistics(description,&expected->opacity,
+                                     &value->opacity);
+  return status;
+}
+
+static int CompareDifference(const char *what,
+                             const DifferenceStatistics *expected,
+                             const DifferenceStatistics *value)
+{
+  char
+    description[MaxTextExtent];
+
+  int
+    status = 1;
+
+  FormatString(description,"%s red",what);
+  status &= CompareValue(description,expected->red,value->red);
+  FormatString(description,"%s green",what);
+  status &= CompareValue(description,expected->green,value->green);
+  FormatString(description,"%s blue",what);
+  status &= CompareValue(description,expected->blue,value->blue);
+  FormatString(description,"%s opacity",what);
+  status &= CompareValue(description,expected->opacity,value->opacity);
+  FormatString(description,"%s combined",what);
+  status &= CompareValue(description,expected->combined,value->combined);
+  return status;
+}
+
+/*
+  Check CheckImageDifference() for limits just above and below a
+  metric value.
+*/
+static int CheckLimit(const Image *image,const Image *compare,
+                      const MetricType metric,const double value,
+                      ExceptionInfo *exception)
+{
+  MagickBool
+    above_exceeded,
+    below_exceeded,
+    lower_is_better;
+
+  lower_is_better=!((metric == PeakSignalToNoiseRatioMetric) ||
+                    (metric == StructuralSimilarityMetric) ||
+                    (metric == MultiScaleStructuralSimilarityMetric));
+  if (!CheckImageDifference(image,compare,metric,value*1.01+1.0e-9,
+                            &above_exceeded,exception) ||
+      !CheckImageDifference(image,compare,metric,value*0.99-1.0e-9,
+                            &below_exceeded,exception))
+    {
+      CatchException(exception);
+      return 0;
+    }
+  if ((above_exceeded == lower_is_better) ||
+      (below_exceeded != lower_is_better))
+    {
+      (void) printf("%s limit check failed for %g\n",
+                    MetricTypeToString(metric),value);
+      return 0;
+    }
+  return 1;
+}
+
+/*
+  Compute the statistics of the red channel using two passes.
+*/
+static int TwoPassRedStatistics(const Image *image,
+                                ImageChannelStatistics *statistics)
+{
+  const PixelPacket
+    *pixels;
+
+  double
+    number_pixels,
+    sum,
+    value;
+
+  long
+    i;
+
+  number_pixels=(double) image->columns*image->rows;
+  pixels=AcquireImagePixels(image,0,0,image->columns,image->rows,
+                            (ExceptionInfo *) &image->exception);
+  if (pixels == (const PixelPacket *) NULL)
+    return 0;
+  statistics->minimum=1.0;
+  statistics->maximum=0.0;
+  sum=0.0;
+  for (i=0; i < (long) number_pixels; i++)
+    {
+      value=pixels[i].red/MaxRGBDouble;
+      sum+=value;
+      if (value < statistics->minimum)
+        statistics->minimum=value;
+      if (value > statistics->maximum)
+        statistics->maximum=value;
+    }
+  statistics->mean=sum/number_pixels;
+  sum=0.0;
+  for (i=0; i < (long) number_pixels; i++)
+    {
+      value=pixels[i].red/MaxRGBDouble-statistics->mean;
+      sum+=value*value;
+    }
+  statistics->variance=sum/(number_pixels-1.0);
+  statistics->standard_deviation=sqrt(statistics->variance);
+  return 1;
+}
+
+int main ( int argc, char **argv )
+{
+  Image
+    *compare = (Image *) NULL,
+    *image = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  ImageChannelStatistics
+    red_statistics;
+
+  ImageComparisonStatistics
+    comparison;
+
+  ImageStatistics
+    statistics;
+
+  DifferenceStatistics
+    difference;
+
+  int
+    exit_status = 0;
+
+  if (LocaleNCompare("comparestats",argv[0],12) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  if (argc != 2)
+    {
+      (void) printf ("Usage: %s infile\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(imageInfo->filename, argv[1], MaxTextExtent-1 );
+  image=ReadImage(imageInfo,&exception);
+  if (image == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read image %s\n",argv[1]);
+      exit_status = 1;
+      goto program_exit;
+    }
+  compare=BlurImage(image,0.0,2.0,&exception);
+  if (compare == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to blur image\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  if (!GetImageStatistics(image,&statistics,&exception) ||
+      !TwoPassRedStatistics(image,&red_statistics))
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (!CompareChannelStatistics("Two pass red",&red_statistics,
+                                &statistics.red))
+    exit_status = 1;
+
+  if (!GetImageComparisonStatistics(image,compare,&comparison,&exception))
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (!CompareImageStatistics("Reference",&statistics,&comparison.reference))
+    exit_status = 1;
+  if (!GetImageStatistics(compare,&statistics,&exception))
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (!CompareImageStatistics("Compare",&statistics,&comparison.compare))
+    exit_status = 1;
+
+#define CheckMetric(metric,member)                                      \
+  if (!GetImageChannelDifference(image,compare,metric,&difference,      \
+                                 &exception))                           \
+    {                                                                   \
+      CatchException(&exception);                                       \
+      exit_status = 1;                                                  \
+      goto program_exit;                                                \
+    }                                                                   \
+  if (!CompareDifference(MetricTypeToString(metric),&difference,        \
+                         &comparison.member))                           \
+    exit_status = 1;                                                    \
+  if (!CheckLimit(image,compare,metric,difference.combined,&exception)) \
+    exit_status = 1;
+
+  CheckMetric(MeanAbsoluteErrorMetric,mean_absolute_error);
+  CheckMetric(MeanSquaredErrorMetric,mean_squared_error);
+  CheckMetric(PeakAbsoluteErrorMetric,peak_absolute_error);
+  CheckMetric(PeakSignalToNoiseRatioMetric,peak_signal_to_noise_ratio);
+  CheckMetric(RootMeanSquaredErrorMetric,root_mean_squared_error);
+
+  {
+    MagickBool
+      exceeded;
+
+    if (!CheckImageDifference(image,image,PeakAbsoluteErrorMetric,0.0,
+                              &exceeded,&exception) || exceeded)
+      {
+        CatchException(&exception);
+        (void) printf("Identical images exceed zero error limit\n");
+        exit_status = 1;
+      }
+  }
+
+  (void) printf("PSNR %g, RMSE %g\n",
+                comparison.peak_signal_to_noise_ratio.combined,
+                comparison.root_mean_squared_error.combined);
+
+ program_exit:
+  (void) fflush(stdout);
+  if (compare)
+    DestroyImageList(compare);
+  if (image)
+    DestroyImageList(image);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
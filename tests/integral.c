@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Test AllocateIntegralImage() and AdaptiveThresholdImage().  The sums
+ * (and sums of squares) returned by GetIntegralImageSums() for a region
+ * extending beyond the image bounds are checked against sums computed
+ * directly from the pixels, for each supported number of channels.  The
+ * result of AdaptiveThresholdImage() for a crop of the image is checked
+ * against a direct computation of each neighborhood mean, as is the
+ * result for the whole image.  Eight threads are used (even if there are
+ * fewer processors) so that bands of the image are thresholded
+ * concurrently.
+ *
+ */
+
+#include <magick/api.h>
+#include <magick/integral.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define Margin 5
+
+static Quantum ChannelSample(const PixelPacket *pixel,
+                             const unsigned int channels,
+                             const unsigned int c)
+{
+  if (c == 0)
+    return pixel->red;
+  if ((channels == 2) || (c == 3))
+    return pixel->opacity;
+  if (c == 1)
+    return pixel->green;
+  return pixel->blue;
+}
+
+static int CheckIntegralImage(Image *image,const unsigned int channels,
+                              ExceptionInfo *exception)
+{
+  IntegralImage
+    *integral;
+
+  unsigned long
+    seed = 1;
+
+  int
+    i,
+    status = 1;
+
+  integral=AllocateIntegralImage(image,-Margin,-Margin,
+                                 image->columns+2*Margin,
+                                 image->rows+2*Margin,
+                                 channels,MagickTrue,exception);
+  if (integral == (IntegralImage *) NULL)
+    {
+      CatchException(exception);
+      (void) printf("Failed to allocate integral image (%u channels)\n",
+                    channels);
+      return 0;
+    }
+  for (i=0; (i < 200) && status; i++)
+    {
+      const PixelPacket
+        *p;
+
+      magick_uint64_t
+        expected[4],
+        sums[4];
+
+      double
+        expected_squares[4],
+        squared_sums[4];
+
+      long
+        x,
+        y;
+
+      unsigned long
+        columns,
+        rows,
+        j;
+
+      unsigned int
+        c;
+
+      seed=seed*1103515245UL+12345UL;
+      x=(long) ((seed >> 8) % (image->columns+Margin))-Margin;
+      seed=seed*1103515245UL+12345UL;
+      y=(long) ((seed >> 8) % (image->rows+Margin))-Margin;
+      seed=seed*1103515245UL+12345UL;
+      columns=(seed >> 8) % (image->columns+Margin-x)+1;
+      seed=seed*1103515245UL+12345UL;
+      rows=(seed >> 8) % (image->rows+Margin-y)+1;
+
+      p=AcquireImagePixels(image,x,y,columns,rows,exception);
+      if (p == (const PixelPacket *) NULL)
+        {
+          CatchException(exception);
+          status=0;
+          break;
+        }
+      for (c=0; c < channels; c++)
+        {
+          expected[c]=0;
+          expected_squares[c]=0.0;
+        }
+      for (j=0; j < columns*rows; j++)
+        for (c=0; c < channels; c++)
+          {
+            double
+              sample;
+
+            sample=(double) ChannelSample(&p[j],channels,c);
+            expected[c]+=ChannelSample(&p[j],channels,c);
+            expected_squares[c]+=sample*sample;
+          }
+      if (!GetIntegralImageSums(integral,x,y,columns,rows,sums,
+                                squared_sums))
+        {
+          (void) printf("GetIntegralImageSums failed for %lux%lu%+ld%+ld\n",
+                        columns,rows,x,y);
+          status=0;
+          break;
+        }
+      for (c=0; c < channels; c++)
+        if ((sums[c] != expected[c]) ||
+            (squared_sums[c] != expected_squares[c]))
+          {
+            (void) printf("Channel %u of %u: sums of %lux%lu%+ld%+ld are "
+                          "%.15g/%.15g, expected %.15g/%.15g\n",
+                          c,channels,columns,rows,x,y,(double) sums[c],
+                          squared_sums[c],(double) expected[c],
+                          expected_squares[c]);
+            status=0;
+          }
+    }
+  if (status)
+    {
+      magick_uint64_t
+        sums[4];
+
+      if (GetIntegralImageSums(integral,-Margin-1,0,1,1,sums,(double *) NULL))
+        {
+          (void) printf("GetIntegralImageSums accepted rectangle outside "
+                        "region\n");
+          status=0;
+        }
+    }
+  DestroyIntegralImage(integral);
+  return status;
+}
+
+static int CheckAdaptiveThreshold(const Image *image,
+                                  const unsigned long width,
+                                  const unsigned long height,
+                                  const double offset,
+                                  ExceptionInfo *exception)
+{
+  Image
+    *threshold_image;
+
+  const long
+    long_offset = (long) (offset*MaxMap/MaxRGB + 0.5);
+
+  long
+    x,
+    y;
+
+  int
+    status = 1;
+
+  threshold_image=AdaptiveThresholdImage(image,width,height,offset,exception);
+  if (threshold_image == (Image *) NULL)
+    {
+      CatchException(exception);
+      (void) printf("AdaptiveThresholdImage failed\n");
+      return 0;
+    }
+  for (y=0; (y < (long) image->rows) && status; y++)
+    for (x=0; (x < (long) image->columns) && status; x++)
+      {
+        const PixelPacket
+          *p,
+          *q;
+
+        PixelPacket
+          pixel;
+
+        unsigned long
+          i,
+          sums[3] = { 0, 0, 0 };
+
+        unsigned int
+          c;
+
+        p=AcquireImagePixels(image,x-(long) (width-1-width/2),
+                             y-(long) (height-1-height/2),width,height,
+                             exception);
+        q=AcquireImagePixels(threshold_image,x,y,1,1,exception);
+        if ((p == (const PixelPacket *) NULL) ||
+            (q == (const PixelPacket *) NULL))
+          {
+            CatchException(exception);
+            status=0;
+            break;
+          }
+        for (i=0; i < width*height; i++)
+          {
+            sums[0]+=ScaleQuantumToMap(p[i].red);
+            sums[1]+=ScaleQuantumToMap(p[i].green);
+            sums[2]+=ScaleQuantumToMap(p[i].blue);
+          }
+        p=AcquireImagePixels(image,x,y,1,1,exception);
+        if (p == (const PixelPacket *) NULL)
+          {
+            CatchException(exception);
+            status=0;
+            break;
+          }
+        pixel=*p;
+        for (c=0; c < 3; c++)
+          {
+            long
+              threshold;
+
+            Quantum
+              *sample,
+              expected;
+
+            sample=(c == 0 ? &pixel.red : c == 1 ? &pixel.green : &pixel.blue);
+            threshold=(long) (sums[c]/(width*height))+long_offset;
+            if (threshold > (long) MaxMap)
+              threshold=(long) MaxMap;
+            else if (threshold < 0)
+              threshold=0;
+            expected=((long) ScaleQuantumToMap(*sample) <= threshold ?
+                      0U : MaxRGB);
+            *sample=expected;
+          }
+        if ((q->red != pixel.red) || (q->green != pixel.green) ||
+            (q->blue != pixel.blue))
+          {
+            (void) printf("Adaptive threshold %lux%lu%+g differs at "
+                          "(%ld,%ld)\n",width,height,offset,x,y);
+            status=0;
+          }
+      }
+  DestroyImage(threshold_image);
+  return status;
+}
+
+int main ( int argc, char **argv )
+{
+  Image
+    *crop = (Image *) NULL,
+    *image = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  RectangleInfo
+    geometry;
+
+  unsigned int
+    channels;
+
+  int
+    exit_status = 0;
+
+  if (LocaleNCompare("integral",argv[0],8) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  /*
+    Set the thread limit before any image is allocated, since each image
+    has a default cache view per thread.
+  */
+  (void) SetMagickResourceLimit(ThreadsResource,8);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  if (argc != 2)
+    {
+      (void) printf ("Usage: %s infile\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(imageInfo->filename, argv[1], MaxTextExtent-1 );
+  image=ReadImage(imageInfo,&exception);
+  if (image == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read image %s\n",argv[1]);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  for (channels=1; channels <= 4; channels++)
+    if (!CheckIntegralImage(image,channels,&exception))
+      {
+        exit_status = 1;
+        goto program_exit;
+      }
+
+  /*
+    Adaptive threshold of a crop, with odd and even neighborhoods.
+  */
+  geometry.width=(image->columns < 80 ? image->columns : 80);
+  geometry.height=(image->rows < 150 ? image->rows : 150);
+  geometry.x=(long) (image->columns-geometry.width)/2;
+  geometry.y=(long) (image->rows-geometry.height)/2;
+  crop=CropImage(image,&geometry,&exception);
+  if (crop == (Image *) NULL)
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  crop->is_grayscale=MagickFalse;
+  crop->is_monochrome=MagickFalse;
+  if (!CheckAdaptiveThreshold(crop,7,5,3.0,&exception) ||
+      !CheckAdaptiveThreshold(crop,10,6,-3.0,&exception) ||
+      !CheckAdaptiveThreshold(crop,1,9,0.0,&exception))
+    {
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Adaptive threshold of the whole image, which is processed in several
+    bands at once.  Repeat since a race may not show every time.
+  */
+  image->is_grayscale=MagickFalse;
+  image->is_monochrome=MagickFalse;
+  if (!CheckAdaptiveThreshold(image,25,25,2.0,&exception) ||
+      !CheckAdaptiveThreshold(image,25,25,2.0,&exception) ||
+      !CheckAdaptiveThreshold(image,25,25,2.0,&exception))
+    {
+      exit_status = 1;
+      goto program_exit;
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  if (crop)
+    DestroyImage(crop);
+  if (image)
+    DestroyImageList(image);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
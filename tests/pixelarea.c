@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * ExportImagePixelArea()/ImportImagePixelArea() benchmarks and tests.
+ *
+ * For each of the common sample layouts, all rows of a synthetic image
+ * are exported to a buffer and then imported into a second image.  The
+ * throughput of each direction is reported along with a checksum of the
+ * exported bytes and of the imported pixels.
+ *
+ * Setting MAGICK_PIXEL_AREA_KERNELS=0 in the environment disables the
+ * specialized pixel area kernels so that the generic conversion path
+ * may be timed.  With -verify, only the checksums are printed, so that
+ * the output of the two paths may be compared directly.
+ *
+ */
+
+#include <magick/api.h>
+#include <magick/enum_strings.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _PixelAreaCase
+{
+  QuantumType
+    quantum_type;
+
+  unsigned int
+    quantum_size;
+
+  QuantumSampleType
+    sample_type;
+
+  EndianType
+    endian;
+
+  MagickBool
+    miniswhite;
+} PixelAreaCase;
+
+static const PixelAreaCase cases[] =
+  {
+    { RGBQuantum,   8, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { RGBQuantum,  16, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { RGBQuantum,  16, UnsignedQuantumSampleType, LSBEndian, MagickFalse },
+    { RGBQuantum,  16, FloatQuantumSampleType,    MSBEndian, MagickFalse },
+    { RGBQuantum,  16, FloatQuantumSampleType,    LSBEndian, MagickFalse },
+    { RGBQuantum,  32, FloatQuantumSampleType,    MSBEndian, MagickFalse },
+    { RGBQuantum,  32, FloatQuantumSampleType,    LSBEndian, MagickFalse },
+    { RGBAQuantum,  8, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { RGBAQuantum, 16, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { RGBAQuantum, 16, UnsignedQuantumSampleType, LSBEndian, MagickFalse },
+    { RGBAQuantum, 16, FloatQuantumSampleType,    LSBEndian, MagickFalse },
+    { RGBAQuantum, 32, FloatQuantumSampleType,    LSBEndian, MagickFalse },
+    { CMYKQuantum,  8, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { CMYKQuantum, 16, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { CMYKQuantum, 16, UnsignedQuantumSampleType, LSBEndian, MagickFalse },
+    { GrayQuantum,  8, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { GrayQuantum,  8, UnsignedQuantumSampleType, MSBEndian, MagickTrue  },
+    { GrayQuantum, 16, UnsignedQuantumSampleType, MSBEndian, MagickFalse },
+    { GrayQuantum, 16, UnsignedQuantumSampleType, LSBEndian, MagickFalse },
+    { GrayQuantum, 16, FloatQuantumSampleType,    LSBEndian, MagickFalse },
+    { GrayQuantum, 32, FloatQuantumSampleType,    MSBEndian, MagickFalse },
+    { GrayQuantum, 32, FloatQuantumSampleType,    LSBEndian, MagickFalse }
+  };
+
+/*
+  FNV-1a hash used as a checksum.
+*/
+static unsigned long HashBytes(unsigned long hash,const unsigned char *p,
+                               size_t length)
+{
+  while (length-- != 0)
+    {
+      hash ^= *p++;
+      hash *= 16777619UL;
+      hash &= 0xffffffffUL;
+    }
+  return hash;
+}
+
+static unsigned long HashPixels(unsigned long hash,const PixelPacket *p,
+                                unsigned long length)
+{
+  unsigned char
+    values[4*sizeof(unsigned long)];
+
+  unsigned int
+    i;
+
+  unsigned long
+    samples[4];
+
+  for ( ; length != 0; length--, p++)
+    {
+      samples[0]=p->red;
+      samples[1]=p->green;
+      samples[2]=p->blue;
+      samples[3]=p->opacity;
+      for (i=0; i < 4; i++)
+        {
+          values[4*i]=(unsigned char) samples[i];
+          values[4*i+1]=(unsigned char) (samples[i] >> 8);
+          values[4*i+2]=(unsigned char) (samples[i] >> 16);
+          values[4*i+3]=(unsigned char) (samples[i] >> 24);
+        }
+      hash=HashBytes(hash,values,16);
+    }
+  return hash;
+}
+
+/*
+  Fill an image with a deterministic pattern which exercises the full
+  Quantum range.  If gray is set, the image is filled with gray pixels.
+*/
+static MagickPassFail FillImage(Image *image,const MagickBool gray)
+{
+  unsigned long
+    seed=12345UL,
+    x,
+    y;
+
+  PixelPacket
+    *q;
+
+  for (y=0; y < image->rows; y++)
+    {
+      q=SetImagePixels(image,0,y,image->columns,1);
+      if (q == (PixelPacket *) NULL)
+        return MagickFail;
+      for (x=0; x < image->columns; x++)
+        {
+          seed=(seed*1103515245UL+12345UL) & 0xffffffffUL;
+          q->red=ScaleShortToQuantum((seed >> 8) & 0xffff);
+          seed=(seed*1103515245UL+12345UL) & 0xffffffffUL;
+          q->green=ScaleShortToQuantum((seed >> 8) & 0xffff);
+          seed=(seed*1103515245UL+12345UL) & 0xffffffffUL;
+          q->blue=ScaleShortToQuantum((seed >> 8) & 0xffff);
+          seed=(seed*1103515245UL+12345UL) & 0xffffffffUL;
+          q->opacity=ScaleShortToQuantum((seed >> 8) & 0xffff);
+          if (gray)
+            q->green=q->blue=q->red;
+          q++;
+        }
+      if (!SyncImagePixels(image))
+        return MagickFail;
+    }
+  image->is_grayscale=gray;
+  return MagickPass;
+}
+
+int main ( int argc, char **argv )
+{
+  Image
+    *color_image = (Image *) NULL,
+    *gray_image = (Image *) NULL,
+    *import_image = (Image *) NULL;
+
+  ExceptionInfo
+    exception;
+
+  unsigned char
+    *buffer = (unsigned char *) NULL;
+
+  unsigned long
+    columns = 1024,
+    iterations = 100,
+    rows = 256;
+
+  MagickBool
+    verify = MagickFalse;
+
+  size_t
+    row_bytes;
+
+  int
+    arg,
+    exit_status = 0;
+
+  unsigned int
+    i;
+
+  if (LocaleNCompare("pixelarea",argv[0],9) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  GetExceptionInfo(&exception);
+
+  for (arg=1; arg < argc; arg++)
+    {
+      char
+        *option = argv[arg];
+
+      if ((LocaleCompare("-iterations",option) == 0) && (arg+1 < argc))
+        iterations=strtoul(argv[++arg],(char **) NULL,10);
+      else if ((LocaleCompare("-size",option) == 0) && (arg+1 < argc))
+        {
+          if (sscanf(argv[++arg],"%lux%lu",&columns,&rows) != 2)
+            columns=rows=0;
+        }
+      else if (LocaleCompare("-verify",option) == 0)
+        verify=MagickTrue;
+      else
+        {
+          columns=rows=0;
+          break;
+        }
+    }
+  if ((columns == 0) || (rows == 0) || (iterations == 0))
+    {
+      (void) printf("Usage: %s [-iterations count] [-size columnsxrows] "
+                    "[-verify]\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (verify)
+    iterations=1;
+
+  color_image=AllocateImage((ImageInfo *) NULL);
+  gray_image=AllocateImage((ImageInfo *) NULL);
+  import_image=AllocateImage((ImageInfo *) NULL);
+  if ((color_image == (Image *) NULL) || (gray_image == (Image *) NULL) ||
+      (import_image == (Image *) NULL))
+    {
+      (void) printf("Failed to allocate images\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+  color_image->columns=gray_image->columns=import_image->columns=columns;
+  color_image->rows=gray_image->rows=import_image->rows=rows;
+  color_image->matte=import_image->matte=MagickTrue;
+  if (!FillImage(color_image,MagickFalse) || !FillImage(gray_image,MagickTrue))
+    {
+      CatchException(&color_image->exception);
+      CatchException(&gray_image->exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  row_bytes=(size_t) columns*4*sizeof(double);
+  buffer=(unsigned char *) malloc(rows*row_bytes);
+  if (buffer == (unsigned char *) NULL)
+    {
+      (void) printf("Failed to allocate %lu bytes\n",
+                    (unsigned long) (rows*row_bytes));
+      exit_status = 1;
+      goto program_exit;
+    }
+  (void) memset(buffer,0,rows*row_bytes);
+
+  for (i=0; i < sizeof(cases)/sizeof(cases[0]); i++)
+    {
+      const PixelAreaCase
+        *c = &cases[i];
+
+      const Image
+        *image;
+
+      ExportPixelAreaOptions
+        export_options;
+
+      ImportPixelAreaOptions
+        import_options;
+
+      TimerInfo
+        timer;
+
+      double
+        export_time,
+        import_time;
+
+      unsigned long
+        export_hash=2166136261UL,
+        import_hash=2166136261UL,
+        iteration,
+        y;
+
+      image=(c->quantum_type == GrayQuantum ? gray_image : color_image);
+
+      ExportPixelAreaOptionsInit(&export_options);
+      export_options.sample_type=c->sample_type;
+      export_options.endian=c->endian;
+      export_options.grayscale_miniswhite=c->miniswhite;
+      ImportPixelAreaOptionsInit(&import_options);
+      import_options.sample_type=c->sample_type;
+      import_options.endian=c->endian;
+      import_options.grayscale_miniswhite=c->miniswhite;
+
+      GetTimerInfo(&timer);
+      for (iteration=0; iteration < iterations; iteration++)
+        for (y=0; y < rows; y++)
+          {
+            if ((AcquireImagePixels(image,0,y,columns,1,&exception) ==
+                 (const PixelPacket *) NULL) ||
+                (ExportImagePixelArea(image,c->quantum_type,c->quantum_size,
+                                      buffer+y*row_bytes,&export_options,
+                                      (ExportPixelAreaInfo *) NULL)
+                 == MagickFail))
+              {
+                CatchException(&exception);
+                (void) printf("Export failed!\n");
+                exit_status = 1;
+                goto program_exit;
+              }
+          }
+      export_time=GetElapsedTime(&timer);
+
+      GetTimerInfo(&timer);
+      for (iteration=0; iteration < iterations; iteration++)
+        for (y=0; y < rows; y++)
+          {
+            if ((SetImagePixels(import_image,0,y,columns,1) ==
+                 (PixelPacket *) NULL) ||
+                (ImportImagePixelArea(import_image,c->quantum_type,
+                                      c->quantum_size,buffer+y*row_bytes,
+                                      &import_options,
+                                      (ImportPixelAreaInfo *) NULL)
+                 == MagickFail) ||
+                !SyncImagePixels(import_image))
+              {
+                CatchException(&import_image->exception);
+                (void) printf("Import failed!\n");
+                exit_status = 1;
+                goto program_exit;
+              }
+          }
+      import_time=GetElapsedTime(&timer);
+
+      for (y=0; y < rows; y++)
+        {
+          const PixelPacket
+            *p;
+
+          export_hash=HashBytes(export_hash,buffer+y*row_bytes,
+                                (size_t) columns*
+                                MagickGetQuantumSamplesPerPixel(c->quantum_type)*
+                                c->quantum_size/8);
+          p=AcquireImagePixels(import_image,0,y,columns,1,&exception);
+          if (p == (const PixelPacket *) NULL)
+            {
+              CatchException(&exception);
+              exit_status = 1;
+              goto program_exit;
+            }
+          import_hash=HashPixels(import_hash,p,columns);
+        }
+
+      (void) printf("%-6s %2u %-8s %s%s: ",
+                    QuantumTypeToString(c->quantum_type),c->quantum_size,
+                    QuantumSampleTypeToString(c->sample_type),
+                    EndianTypeToString(c->endian),
+                    c->miniswhite ? " miniswhite" : "");
+      if (!verify)
+        {
+          double
+            mpixels=((double) columns*rows*iterations)/1.0e6;
+
+          (void) printf("export %8.1f Mpixel/s, import %8.1f Mpixel/s, ",
+                        export_time > 0.0 ? mpixels/export_time : 0.0,
+                        import_time > 0.0 ? mpixels/import_time : 0.0);
+        }
+      (void) printf("checksum %08lx/%08lx\n",export_hash,import_hash);
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  free(buffer);
+  if (color_image)
+    DestroyImage(color_image);
+  if (gray_image)
+    DestroyImage(gray_image);
+  if (import_image)
+    DestroyImage(import_image);
+  DestroyExceptionInfo(&exception);
+  DestroyMagick();
+  return exit_status;
+}
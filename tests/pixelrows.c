@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Test the typed pixel row iterator (OpenPixelRowIterator()).  For each
+ * map and storage type, the rows of many small regions (some extending
+ * beyond the image bounds) are read via one iterator and compared with
+ * DispatchImage().  Rows are then inverted via a writable iterator, and
+ * the result is compared with DispatchImage() of the original image.
+ *
+ */
+
+#include <magick/api.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char
+  *maps[] =
+  {
+    "RGB", "BGR", "BGRO", "BGRA", "RGBP", "I", "R", "GR", "BG"
+  };
+
+static const StorageType
+  types[] =
+  {
+    CharPixel, ShortPixel, IntegerPixel, LongPixel, FloatPixel, DoublePixel
+  };
+
+static size_t SampleSize(const StorageType type)
+{
+  switch (type)
+    {
+    case CharPixel:
+      return sizeof(unsigned char);
+    case ShortPixel:
+      return sizeof(unsigned short);
+    case IntegerPixel:
+      return sizeof(unsigned int);
+    case LongPixel:
+      return sizeof(unsigned long);
+    case FloatPixel:
+      return sizeof(float);
+    case DoublePixel:
+      return sizeof(double);
+    }
+  return 0;
+}
+
+/*
+  Invert one sample.
+*/
+static void InvertSample(const StorageType type,unsigned char *sample)
+{
+  switch (type)
+    {
+    case CharPixel:
+      *sample=(unsigned char) (255U-*sample);
+      break;
+    case ShortPixel:
+      *((unsigned short *) sample)=(unsigned short)
+        (65535U-*((unsigned short *) sample));
+      break;
+    case IntegerPixel:
+      *((unsigned int *) sample)=4294967295U-*((unsigned int *) sample);
+      break;
+    case LongPixel:
+      *((unsigned long *) sample)=4294967295UL-*((unsigned long *) sample);
+      break;
+    case FloatPixel:
+      *((float *) sample)=1.0f-*((float *) sample);
+      break;
+    case DoublePixel:
+      *((double *) sample)=1.0-*((double *) sample);
+      break;
+    }
+}
+
+/*
+  Compare an iterator row with the same pixels as returned by
+  DispatchImage().  If invert is true, then the iterator samples are
+  inverted before they are compared.
+*/
+static int CompareRow(const unsigned char *row,const unsigned int stride,
+                      const unsigned char *expected,
+                      const unsigned long columns,const size_t length,
+                      const StorageType type,const MagickBool invert)
+{
+  size_t
+    c,
+    sample_size;
+
+  unsigned long
+    x;
+
+  unsigned char
+    sample[sizeof(double)];
+
+  sample_size=SampleSize(type);
+  for (x=0; x < columns; x++)
+    for (c=0; c < length; c++)
+      {
+        (void) memcpy(sample,row+(x*stride+c)*sample_size,sample_size);
+        if (invert)
+          InvertSample(type,sample);
+        if (memcmp(sample,expected+(x*length+c)*sample_size,sample_size) != 0)
+          {
+            if ((type == FloatPixel) || (type == DoublePixel))
+              {
+                double
+                  a,
+                  b;
+
+                a=(type == FloatPixel ? *((float *) sample) :
+                   *((double *) sample));
+                b=(type == FloatPixel ?
+                   ((const float *) expected)[x*length+c] :
+                   ((const double *) expected)[x*length+c]);
+                if ((a-b < 1.0/MaxRGB) && (b-a < 1.0/MaxRGB))
+                  continue;
+              }
+            return 0;
+          }
+      }
+  return 1;
+}
+
+static int CheckPixelRows(Image *image,const char *map,
+                          const StorageType type,ExceptionInfo *exception)
+{
+  PixelRowIterator
+    *iterator;
+
+  unsigned char
+    *expected;
+
+  const size_t
+    length = strlen(map);
+
+  unsigned long
+    seed = 1;
+
+  int
+    i,
+    status = 1;
+
+  expected=(unsigned char *) malloc(20*length*SampleSize(type));
+  iterator=OpenPixelRowIterator(image,map,type,MagickFalse,exception);
+  if ((iterator == (PixelRowIterator *) NULL) ||
+      (expected == (unsigned char *) NULL))
+    {
+      CatchException(exception);
+      (void) printf("Failed to open \"%s\" %s iterator\n",map,
+                    StorageTypeToString(type));
+      free(expected);
+      return 0;
+    }
+  for (i=0; (i < 100) && status; i++)
+    {
+      const unsigned char
+        *row;
+
+      long
+        x,
+        y;
+
+      unsigned long
+        columns,
+        rows,
+        j;
+
+      seed=seed*1103515245UL+12345UL;
+      x=(long) ((seed >> 8) % (image->columns+10))-10;
+      seed=seed*1103515245UL+12345UL;
+      y=(long) ((seed >> 8) % (image->rows+10))-10;
+      seed=seed*1103515245UL+12345UL;
+      columns=(seed >> 8) % 20+1;
+      seed=seed*1103515245UL+12345UL;
+      rows=(seed >> 8) % 20+1;
+
+      if (!SetPixelRowIteratorRegion(iterator,x,y,columns,rows))
+        {
+          CatchException(&image->exception);
+          status=0;
+          break;
+        }
+      for (j=0; (row=NextPixelRowIteratorRow(iterator)) != NULL; j++)
+        {
+          if (!DispatchImage(image,x,y+(long) j,columns,1,map,type,expected,
+                             exception))
+            {
+              CatchException(exception);
+              status=0;
+              break;
+            }
+          if (!CompareRow(row,GetPixelRowIteratorStride(iterator),expected,
+                          columns,length,type,MagickFalse))
+            {
+              (void) printf("\"%s\" %s row %ld of %lux%lu%+ld%+ld differs\n",
+                            map,StorageTypeToString(type),(long) j,
+                            columns,rows,x,y);
+              status=0;
+              break;
+            }
+        }
+      if (status && (j != rows))
+        {
+          (void) printf("\"%s\" %s iterator returned %lu of %lu rows\n",
+                        map,StorageTypeToString(type),j,rows);
+          status=0;
+        }
+    }
+  ClosePixelRowIterator(iterator);
+  free(expected);
+  return status;
+}
+
+static int CheckWritablePixelRows(const Image *image,const char *map,
+                                  const StorageType type,
+                                  ExceptionInfo *exception)
+{
+  Image
+    *clone;
+
+  PixelRowIterator
+    *iterator;
+
+  unsigned char
+    *expected,
+    *row;
+
+  const size_t
+    length = strlen(map),
+    sample_size = SampleSize(type);
+
+  unsigned int
+    stride;
+
+  unsigned long
+    x,
+    y;
+
+  size_t
+    c;
+
+  int
+    status = 1;
+
+  clone=CloneImage(image,0,0,MagickTrue,exception);
+  if (clone == (Image *) NULL)
+    {
+      CatchException(exception);
+      return 0;
+    }
+  expected=(unsigned char *) malloc(image->columns*length*sample_size);
+  iterator=OpenPixelRowIterator(clone,map,type,MagickTrue,exception);
+  if ((iterator == (PixelRowIterator *) NULL) ||
+      (expected == (unsigned char *) NULL) ||
+      !SetPixelRowIteratorRegion(iterator,0,0,clone->columns,clone->rows))
+    {
+      CatchException(exception);
+      (void) printf("Failed to open writable \"%s\" %s iterator\n",map,
+                    StorageTypeToString(type));
+      ClosePixelRowIterator(iterator);
+      free(expected);
+      DestroyImage(clone);
+      return 0;
+    }
+  stride=GetPixelRowIteratorStride(iterator);
+  while ((row=NextPixelRowIteratorRow(iterator)) != NULL)
+    {
+      for (x=0; x < clone->columns; x++)
+        for (c=0; c < length; c++)
+          InvertSample(type,row+(x*stride+c)*sample_size);
+      if (!SyncPixelRowIteratorRow(iterator))
+        {
+          CatchException(&clone->exception);
+          status=0;
+          break;
+        }
+    }
+  ClosePixelRowIterator(iterator);
+  /*
+    Compare the inverted clone with the original, row by row.
+  */
+  for (y=0; (y < image->rows) && status; y++)
+    {
+      unsigned char
+        *original;
+
+      original=(unsigned char *) malloc(image->columns*length*sample_size);
+      if ((original == (unsigned char *) NULL) ||
+          !DispatchImage(image,0,(long) y,image->columns,1,map,type,original,
+                         exception) ||
+          !DispatchImage(clone,0,(long) y,clone->columns,1,map,type,expected,
+                         exception))
+        {
+          CatchException(exception);
+          free(original);
+          status=0;
+          break;
+        }
+      if (!CompareRow(expected,(unsigned int) length,original,image->columns,
+                      length,type,MagickTrue))
+        {
+          (void) printf("Writable \"%s\" %s row %lu differs\n",map,
+                        StorageTypeToString(type),y);
+          status=0;
+        }
+      free(original);
+    }
+  free(expected);
+  DestroyImage(clone);
+  return status;
+}
+
+int main ( int argc, char **argv )
+{
+  Image
+    *image = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  unsigned int
+    i,
+    j;
+
+  int
+    exit_status = 0;
+
+  if (LocaleNCompare("pixelrows",argv[0],9) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  if (argc != 2)
+    {
+      (void) printf ("Usage: %s infile\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(imageInfo->filename, argv[1], MaxTextExtent-1 );
+  image=ReadImage(imageInfo,&exception);
+  if (image == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read image %s\n",argv[1]);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (!image->matte)
+    SetImageOpacity(image,OpaqueOpacity/2+TransparentOpacity/2);
+
+  for (i=0; i < sizeof(maps)/sizeof(maps[0]); i++)
+    for (j=0; j < sizeof(types)/sizeof(types[0]); j++)
+      {
+        if (!CheckPixelRows(image,maps[i],types[j],&exception))
+          {
+            exit_status = 1;
+            goto program_exit;
+          }
+        if ((strpbrk(maps[i],"IP") == (char *) NULL) &&
+            !CheckWritablePixelRows(image,maps[i],types[j],&exception))
+          {
+            exit_status = 1;
+            goto program_exit;
+          }
+      }
+
+ program_exit:
+  (void) fflush(stdout);
+  if (image)
+    DestroyImageList(image);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
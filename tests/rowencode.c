@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Test the row-streaming encoder (OpenImageRowEncoder()) by pushing
+ * the rows of an input image through it one at a time, and verifying
+ * that the result reads back the same as the output of WriteImage()
+ * for the same format.
+ *
+ */
+
+#include <magick/api.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main ( int argc, char **argv )
+{
+  Image
+    *header = (Image *) NULL,
+    *original = (Image *) NULL,
+    *streamed = (Image *) NULL,
+    *written = (Image *) NULL;
+
+  ImageRowEncoder
+    *encoder;
+
+  char
+    format[MaxTextExtent],
+    infile[MaxTextExtent],
+    stream_filename[MaxTextExtent],
+    write_filename[MaxTextExtent];
+
+  int
+    arg = 1,
+    exit_status = 0;
+
+  unsigned long
+    y;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  if (LocaleNCompare("rowencode",argv[0],9) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  for (arg=1; arg < argc; arg++)
+    {
+      char
+        *option = argv[arg];
+
+      if (*option == '-')
+        {
+          if (LocaleCompare("debug",option+1) == 0)
+            {
+              (void) SetLogEventMask(argv[++arg]);
+            }
+          else if (LocaleCompare("define",option+1) == 0)
+            {
+              if (AddDefinitions(imageInfo,argv[++arg],&exception)
+                  == MagickFail)
+                {
+                  CatchException(&exception);
+                  exit_status = 1;
+                  goto program_exit;
+                }
+            }
+          else if (LocaleCompare("depth",option+1) == 0)
+            {
+              imageInfo->depth=atol(argv[++arg]);
+            }
+        }
+      else
+        break;
+    }
+  if (arg != argc-2)
+    {
+      (void) printf ("Usage: %s [-debug events] [-define value] "
+                     "[-depth integer] infile format\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(infile, argv[arg], MaxTextExtent-1 );
+  arg++;
+  (void) strncpy(format, argv[arg], MaxTextExtent-1 );
+  FormatString(stream_filename,"%s:out_rowencode_stream.%s",format,format);
+  FormatString(write_filename,"%s:out_rowencode_write.%s",format,format);
+
+  /*
+    Read original image.
+  */
+  (void) strncpy(imageInfo->filename, infile, MaxTextExtent-1 );
+  original=ReadImage(imageInfo,&exception);
+  if (exception.severity != UndefinedException)
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (original == (Image *) NULL)
+    {
+      (void) printf("Failed to read original image %s\n",infile);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (imageInfo->depth != 0)
+    original->depth=imageInfo->depth;
+
+  /*
+    Write the image using the row encoder.  The header image carries
+    the image attributes, but no pixels.
+  */
+  header=CloneImage(original,original->columns,original->rows,MagickTrue,
+                    &exception);
+  if (header == (Image *) NULL)
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  (void) strncpy(header->filename,stream_filename,MaxTextExtent-1);
+  imageInfo->filename[0]='\0';
+  encoder=OpenImageRowEncoder(imageInfo,header,&exception);
+  if (encoder == (ImageRowEncoder *) NULL)
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  for (y=0; y < original->rows; y++)
+    {
+      const PixelPacket
+        *p;
+
+      PixelPacket
+        *q;
+
+      p=AcquireImagePixels(original,0,y,original->columns,1,&exception);
+      q=SetImageRowEncoderPixels(encoder);
+      if ((p == (const PixelPacket *) NULL) || (q == (PixelPacket *) NULL))
+        break;
+      (void) memcpy(q,p,original->columns*sizeof(PixelPacket));
+      if (!SyncImageRowEncoderPixels(encoder))
+        break;
+    }
+  if (!CloseImageRowEncoder(encoder) || (y != original->rows))
+    {
+      CatchException(&header->exception);
+      CatchException(&exception);
+      (void) printf("Failed to stream image to %s\n",stream_filename);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Write the image the traditional way.
+  */
+  (void) strncpy(original->filename,write_filename,MaxTextExtent-1);
+  if (!WriteImage(imageInfo,original))
+    {
+      CatchException(&original->exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Read back both files and compare.
+  */
+  (void) strncpy(imageInfo->filename,stream_filename,MaxTextExtent-1);
+  streamed=ReadImage(imageInfo,&exception);
+  (void) strncpy(imageInfo->filename,write_filename,MaxTextExtent-1);
+  written=ReadImage(imageInfo,&exception);
+  if (exception.severity != UndefinedException)
+    {
+      CatchException(&exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if ((streamed == (Image *) NULL) || (written == (Image *) NULL))
+    {
+      (void) printf("Failed to read back images in format %s\n",format);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (!IsImagesEqual(streamed,written) &&
+      (streamed->error.normalized_mean_error > 0.0))
+    {
+      (void) printf("Row encoder check for format \"%s\" failed: "
+                    "%.6f/%.6f/%.6fe\n",format,
+                    streamed->error.mean_error_per_pixel,
+                    streamed->error.normalized_mean_error,
+                    streamed->error.normalized_maximum_error);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  if (header)
+    DestroyImage(header);
+  if (original)
+    DestroyImageList(original);
+  if (streamed)
+    DestroyImageList(streamed);
+  if (written)
+    DestroyImageList(written);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
@@ -16,6 +16,9 @@
  * The image returned by both reads must be identical in order for the
  * test to pass.
  *
+ * If -segments is specified, then the image is written using
+ * ImageToBlobSegments() and the segments are assembled into a BLOB.
+ *
  */
 
 #include <magick/api.h>
@@ -24,6 +27,48 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+  Write image using ImageToBlobSegments() and return the segments
+  assembled into one BLOB.
+*/
+static void *SegmentedImageToBlob(const ImageInfo *image_info,Image *image,
+                                  size_t *length,ExceptionInfo *exception)
+{
+  BlobSegment
+    *segments;
+
+  unsigned char
+    *blob = (unsigned char *) NULL;
+
+  size_t
+    count,
+    i;
+
+  *length=0;
+  segments=ImageToBlobSegments(image_info,image,&count,exception);
+  if (segments == (BlobSegment *) NULL)
+    return (void *) NULL;
+  for (i=0; i < count; i++)
+    *length+=segments[i].length;
+  (void) LogMagickEvent(CoderEvent,GetMagickModule(),
+                        "Wrote %lu bytes in %lu segments",
+                        (unsigned long) *length,(unsigned long) count);
+  blob=MagickMalloc(*length+1);
+  if (blob != (unsigned char *) NULL)
+    {
+      size_t
+        offset = 0;
+
+      for (i=0; i < count; i++)
+        {
+          (void) memcpy(blob+offset,segments[i].data,segments[i].length);
+          offset+=segments[i].length;
+        }
+    }
+  DestroyBlobSegments(segments,count);
+  return blob;
+}
+
 int main ( int argc, char **argv )
 {
   Image
@@ -54,7 +99,8 @@ int main ( int argc, char **argv )
 
   MagickBool
     check = MagickTrue,
-    check_for_added_frames = MagickTrue;
+    check_for_added_frames = MagickTrue,
+    segmented = MagickFalse;
 
   ImageInfo
     *imageInfo;
@@ -158,6 +204,10 @@ int main ( int argc, char **argv )
             {
               imageInfo->quality=atol(argv[++arg]);
             }
+          else if (LocaleCompare("segments",option+1) == 0)
+            {
+              segmented=MagickTrue;
+            }
           else if (LocaleCompare("size",option+1) == 0)
             {
               arg++;
@@ -185,7 +235,7 @@ int main ( int argc, char **argv )
       (void) printf("arg=%d, argc=%d\n", arg, argc);
       (void) printf ( "Usage: %s [-compress algorithm -debug events -depth "
 		      "integer -define value -log format -nocheck -quality quality "
-                      "-size geometry -verbose] "
+                      "-segments -size geometry -verbose] "
 		      "infile format\n", argv[0] );
       (void) fflush(stdout);
       exit_status = 1;
@@ -267,7 +317,11 @@ int main ( int argc, char **argv )
   original->delay = 10;
   (void) LogMagickEvent(CoderEvent,GetMagickModule(),
                         "Writing image to BLOB");
-  blob =(char *) ImageToBlob ( imageInfo, original, &blob_length, &exception );
+  if (segmented)
+    blob = (char *) SegmentedImageToBlob ( imageInfo, original, &blob_length,
+                                           &exception );
+  else
+    blob =(char *) ImageToBlob ( imageInfo, original, &blob_length, &exception );
   if (exception.severity != UndefinedException)
     {
       CatchException(&exception);
@@ -360,8 +414,12 @@ int main ( int argc, char **argv )
   (void) strncpy( original->magick, format, MaxTextExtent-1 );
   (void) strcpy( imageInfo->filename, "" );
   original->delay = 10;
-  blob = (char *) ImageToBlob ( imageInfo, original, &blob_length,
-				&exception );
+  if (segmented)
+    blob = (char *) SegmentedImageToBlob ( imageInfo, original, &blob_length,
+                                           &exception );
+  else
+    blob = (char *) ImageToBlob ( imageInfo, original, &blob_length,
+                                  &exception );
   if (exception.severity != UndefinedException)
     {
       CatchException(&exception);
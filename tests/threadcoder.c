@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Stress test concurrent use of a coder which claims thread support.
+ * An input image is encoded once to a reference blob in the requested
+ * format, which is also decoded to a reference image.  Many threads
+ * then repeatedly encode the input image and decode the reference
+ * blob at the same time.  Every decoded image (including the decoded
+ * result of each encode) must match the reference image exactly.  The
+ * encoded bytes are not compared since some formats embed the time.
+ *
+ */
+
+#include <magick/api.h>
+#include <magick/enum_strings.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+
+int main ( int argc, char **argv )
+{
+  Image
+    *original = (Image *) NULL,
+    *reference = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  char
+    format[MaxTextExtent],
+    infile[MaxTextExtent];
+
+  unsigned char
+    *reference_blob = (unsigned char *) NULL;
+
+  size_t
+    reference_length = 0;
+
+  long
+    iterations = 100,
+    i;
+
+  int
+    arg = 1,
+    exit_status = 0,
+    threads = 0;
+
+  unsigned long
+    failures = 0;
+
+  if (LocaleNCompare("threadcoder",argv[0],11) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  for (arg=1; arg < argc; arg++)
+    {
+      char
+        *option = argv[arg];
+
+      if (*option == '-')
+        {
+          if (LocaleCompare("compress",option+1) == 0)
+            {
+              imageInfo->compression=StringToCompressionType(argv[++arg]);
+              if (imageInfo->compression == UndefinedCompression)
+                {
+                  (void) printf("Unrecognized compression %s\n",argv[arg]);
+                  exit_status = 1;
+                  goto program_exit;
+                }
+            }
+          else if (LocaleCompare("debug",option+1) == 0)
+            {
+              (void) SetLogEventMask(argv[++arg]);
+            }
+          else if (LocaleCompare("iterations",option+1) == 0)
+            {
+              iterations=atol(argv[++arg]);
+            }
+          else if (LocaleCompare("threads",option+1) == 0)
+            {
+              threads=atoi(argv[++arg]);
+            }
+        }
+      else
+        break;
+    }
+  if (arg != argc-2)
+    {
+      (void) printf ("Usage: %s [-compress type] [-debug events] "
+                     "[-iterations integer] [-threads integer] "
+                     "infile format\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(infile, argv[arg], MaxTextExtent-1 );
+  arg++;
+  (void) strncpy(format, argv[arg], MaxTextExtent-1 );
+
+  {
+    const MagickInfo
+      *magick_info;
+
+    magick_info=GetMagickInfo(format,&exception);
+    if ((magick_info == (const MagickInfo *) NULL) ||
+        (magick_info->decoder == (DecoderHandler) NULL) ||
+        (magick_info->encoder == (EncoderHandler) NULL))
+      {
+        CatchException(&exception);
+        (void) printf("Format %s is not supported\n",format);
+        exit_status = 1;
+        goto program_exit;
+      }
+    if (!magick_info->thread_support)
+      (void) printf("Format %s does not claim thread support\n",format);
+  }
+
+#if defined(_OPENMP)
+  if (threads > 0)
+    omp_set_num_threads(threads);
+  (void) printf("Using %d threads, %ld iterations\n",omp_get_max_threads(),
+                iterations);
+#else
+  (void) threads;
+  (void) printf("Built without OpenMP, %ld iterations\n",iterations);
+#endif
+  (void) fflush(stdout);
+
+  /*
+    Read original image and encode/decode the reference results.
+  */
+  (void) strncpy(imageInfo->filename, infile, MaxTextExtent-1 );
+  original=ReadImage(imageInfo,&exception);
+  if (original == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read original image %s\n",infile);
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (original->next != (Image *) NULL)
+    {
+      /*
+        Only the first frame is used.
+      */
+      Image
+        *frames = original->next;
+
+      original->next=(Image *) NULL;
+      frames->previous=(Image *) NULL;
+      DestroyImageList(frames);
+    }
+  (void) strncpy(imageInfo->magick,format,MaxTextExtent-1);
+  (void) strncpy(original->magick,format,MaxTextExtent-1);
+  reference_blob=ImageToBlob(imageInfo,original,&reference_length,&exception);
+  if (reference_blob == (unsigned char *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to write reference blob in format %s\n",format);
+      exit_status = 1;
+      goto program_exit;
+    }
+  reference=BlobToImage(imageInfo,reference_blob,reference_length,&exception);
+  if (reference == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read reference blob in format %s\n",format);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Encode and decode concurrently.  Even iterations decode the
+    reference blob, and odd iterations encode the original image and
+    decode the result.
+  */
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic,1) reduction(+:failures)
+#endif
+  for (i=0; i < iterations; i++)
+    {
+      ExceptionInfo
+        thread_exception;
+
+      Image
+        *image = (Image *) NULL;
+
+      GetExceptionInfo(&thread_exception);
+      if ((i % 2) == 0)
+        {
+          image=BlobToImage(imageInfo,reference_blob,reference_length,
+                            &thread_exception);
+        }
+      else
+        {
+          Image
+            *clone;
+
+          unsigned char
+            *blob = (unsigned char *) NULL;
+
+          size_t
+            length = 0;
+
+          clone=CloneImage(original,0,0,MagickTrue,&thread_exception);
+          if (clone != (Image *) NULL)
+            {
+              blob=ImageToBlob(imageInfo,clone,&length,&thread_exception);
+              DestroyImage(clone);
+            }
+          if (blob != (unsigned char *) NULL)
+            {
+              image=BlobToImage(imageInfo,blob,length,&thread_exception);
+              MagickFree(blob);
+            }
+        }
+      if (image == (Image *) NULL)
+        {
+          failures++;
+        }
+      else
+        {
+          if (!IsImagesEqual(image,reference) &&
+              (image->error.normalized_maximum_error > 0.0))
+            failures++;
+          DestroyImageList(image);
+        }
+      if (thread_exception.severity >= ErrorException)
+        {
+#if defined(_OPENMP)
+#  pragma omp critical (threadcoder_report)
+#endif
+          CatchException(&thread_exception);
+        }
+      DestroyExceptionInfo(&thread_exception);
+    }
+
+  if (failures != 0)
+    {
+      (void) printf("%lu of %ld concurrent %s operations failed\n",
+                    failures,iterations,format);
+      exit_status = 1;
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  MagickFree(reference_blob);
+  if (original)
+    DestroyImageList(original);
+  if (reference)
+    DestroyImageList(reference);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 GraphicsMagick Group
+ *
+ * This program is covered by multiple licenses, which are described in
+ * Copyright.txt. You should have received a copy of Copyright.txt with this
+ * package; otherwise see http://www.graphicsmagick.org/www/Copyright.html.
+ *
+ * Test TreeSignatureImage().  The tree signature of an image is computed
+ * using one thread and using several threads, which must agree.  One
+ * pixel is then modified and the (incrementally updated) tree signature
+ * must change, and must match the tree signature of an unrelated copy
+ * of the modified image which is computed from scratch.  The same check
+ * is then made after modifying every row using several threads.
+ *
+ */
+
+#include <magick/api.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+
+static int GetTreeSignature(Image *image,char *signature)
+{
+  const ImageAttribute
+    *attribute;
+
+  if (!TreeSignatureImage(image))
+    {
+      CatchException(&image->exception);
+      return 0;
+    }
+  attribute=GetImageAttribute(image,"tree-signature");
+  if (attribute == (const ImageAttribute *) NULL)
+    return 0;
+  (void) strncpy(signature,attribute->value,MaxTextExtent-1);
+  signature[MaxTextExtent-1]='\0';
+  return 1;
+}
+
+/*
+  Copy an image with its own pixel cache (so without band digests).
+*/
+static Image *PrivateCopy(const Image *image,ExceptionInfo *exception)
+{
+  Image
+    *copy;
+
+  copy=CloneImage(image,0,0,MagickTrue,exception);
+  if (copy != (Image *) NULL)
+    {
+      if ((GetImagePixels(copy,0,0,1,1) == (PixelPacket *) NULL) ||
+          !SyncImagePixels(copy))
+        {
+          CopyException(exception,&copy->exception);
+          DestroyImage(copy);
+          copy=(Image *) NULL;
+        }
+    }
+  return copy;
+}
+
+int main ( int argc, char **argv )
+{
+  Image
+    *copy = (Image *) NULL,
+    *image = (Image *) NULL;
+
+  ImageInfo
+    *imageInfo;
+
+  ExceptionInfo
+    exception;
+
+  char
+    copy_signature[MaxTextExtent],
+    modified_signature[MaxTextExtent],
+    parallel_signature[MaxTextExtent],
+    serial_signature[MaxTextExtent];
+
+  PixelPacket
+    *pixel;
+
+  int
+    exit_status = 0;
+
+  if (LocaleNCompare("treesignature",argv[0],13) == 0)
+    InitializeMagick((char *) NULL);
+  else
+    InitializeMagick(*argv);
+
+  /*
+    Images must be allocated using the largest number of threads used.
+  */
+#if defined(_OPENMP)
+  omp_set_num_threads(4);
+#endif
+  imageInfo=CloneImageInfo(0);
+  GetExceptionInfo(&exception);
+
+  if (argc != 2)
+    {
+      (void) printf ("Usage: %s infile\n", argv[0]);
+      (void) fflush(stdout);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  (void) strncpy(imageInfo->filename, argv[1], MaxTextExtent-1 );
+  image=ReadImage(imageInfo,&exception);
+  if (image == (Image *) NULL)
+    {
+      CatchException(&exception);
+      (void) printf("Failed to read image %s\n",argv[1]);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Compute the signature serially, then in parallel from scratch using
+    a separate pixel cache.
+  */
+#if defined(_OPENMP)
+  omp_set_num_threads(1);
+#endif
+  copy=PrivateCopy(image,&exception);
+  if ((copy == (Image *) NULL) || !GetTreeSignature(copy,serial_signature))
+    {
+      (void) printf("Failed to compute serial tree signature\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+  DestroyImage(copy);
+  copy=(Image *) NULL;
+#if defined(_OPENMP)
+  omp_set_num_threads(4);
+#endif
+  if (!GetTreeSignature(image,parallel_signature))
+    {
+      (void) printf("Failed to compute parallel tree signature\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+  (void) printf("Tree signature %s\n",parallel_signature);
+  if (strcmp(serial_signature,parallel_signature) != 0)
+    {
+      (void) printf("Serial tree signature %s differs\n",serial_signature);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  /*
+    Modify one pixel near the bottom of the image and recompute.
+  */
+  pixel=GetImagePixels(image,image->columns/2,image->rows-1,1,1);
+  if (pixel == (PixelPacket *) NULL)
+    {
+      CatchException(&image->exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  pixel->red=(Quantum) (MaxRGB-pixel->red);
+  if (!SyncImagePixels(image) ||
+      !GetTreeSignature(image,modified_signature))
+    {
+      CatchException(&image->exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  (void) printf("Modified tree signature %s\n",modified_signature);
+  if (strcmp(modified_signature,parallel_signature) == 0)
+    {
+      (void) printf("Tree signature did not change after modification\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+
+  copy=PrivateCopy(image,&exception);
+  if ((copy == (Image *) NULL) || !GetTreeSignature(copy,copy_signature))
+    {
+      (void) printf("Failed to compute tree signature of copy\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (strcmp(copy_signature,modified_signature) != 0)
+    {
+      (void) printf("Incremental tree signature differs from %s\n",
+                    copy_signature);
+      exit_status = 1;
+      goto program_exit;
+    }
+  DestroyImage(copy);
+  copy=(Image *) NULL;
+
+  /*
+    Modify all rows in parallel and recompute.
+  */
+  if (!NegateImage(image,MagickFalse) ||
+      !GetTreeSignature(image,modified_signature))
+    {
+      CatchException(&image->exception);
+      exit_status = 1;
+      goto program_exit;
+    }
+  copy=PrivateCopy(image,&exception);
+  if ((copy == (Image *) NULL) || !GetTreeSignature(copy,copy_signature))
+    {
+      (void) printf("Failed to compute tree signature of negated copy\n");
+      exit_status = 1;
+      goto program_exit;
+    }
+  if (strcmp(copy_signature,modified_signature) != 0)
+    {
+      (void) printf("Tree signature after negation differs from %s\n",
+                    copy_signature);
+      exit_status = 1;
+      goto program_exit;
+    }
+
+ program_exit:
+  (void) fflush(stdout);
+  if (copy)
+    DestroyImage(copy);
+  if (image)
+    DestroyImageList(image);
+  DestroyExceptionInfo(&exception);
+  DestroyImageInfo(imageInfo);
+  DestroyMagick();
+  return exit_status;
+}
@@ -1059,6 +1059,41 @@ WandExport unsigned int MagickClipPathImage(MagickWand *wand,
   return(status);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k C l o s e I m a g e P i x e l R o w s                         %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickCloseImagePixelRows() destroys a pixel row iterator returned by
+%  MagickOpenImagePixelRows().  A modified row which has not been synced
+%  is discarded.
+%
+%  The format of the MagickCloseImagePixelRows method is:
+%
+%      void MagickCloseImagePixelRows(MagickWand *wand,
+%        PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o iterator: The pixel row iterator.
+%
+*/
+WandExport void MagickCloseImagePixelRows(MagickWand *wand,
+  PixelRowIterator *iterator)
+{
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  ClosePixelRowIterator(iterator);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -5878,6 +5913,58 @@ WandExport unsigned int MagickNextImage(MagickWand *wand)
   return(True);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k N e x t I m a g e P i x e l R o w                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickNextImagePixelRow() returns the samples of the next row of the
+%  region selected by MagickSetImagePixelRowsRegion(), as an array of the
+%  storage type passed to MagickOpenImagePixelRows().  The first sample
+%  of pixel x is at offset x*stride.  The row remains valid until the
+%  next row is requested or the region is changed.  A null pointer is
+%  returned after the last row of the region, or if an error occurs.
+%
+%  The format of the MagickNextImagePixelRow method is:
+%
+%      void *MagickNextImagePixelRow(MagickWand *wand,
+%        PixelRowIterator *iterator,unsigned int *stride)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o iterator: The pixel row iterator.
+%
+%    o stride: The distance between successive pixels, in samples, is
+%      returned here if it is not NULL.
+%
+*/
+WandExport void *MagickNextImagePixelRow(MagickWand *wand,
+  PixelRowIterator *iterator,unsigned int *stride)
+{
+  void
+    *row;
+
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  if (wand->images == (Image *) NULL)
+    ThrowWandException(WandError,WandContainsNoImages,wand->id);
+  if (stride != (unsigned int *) NULL)
+    *stride=GetPixelRowIteratorStride(iterator);
+  row=NextPixelRowIteratorRow(iterator);
+  if ((row == (void *) NULL) &&
+      (GetPixelRowIteratorStatus(iterator) == MagickFail))
+    CopyException(&wand->exception,&wand->image->exception);
+  return(row);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -6086,6 +6173,62 @@ MagickOperatorImageChannel(MagickWand *wand,
                               rvalue,&wand->exception);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k O p e n I m a g e P i x e l R o w s                           %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickOpenImagePixelRows() opens an iterator which returns rows of the
+%  current image as arrays of typed samples ordered as specified by a map
+%  (as for MagickGetImagePixels()).  The map is parsed once, so that many
+%  regions may be accessed via MagickSetImagePixelRowsRegion() and
+%  MagickNextImagePixelRow() without further overhead.  Where the map
+%  and storage type match the pixel cache layout, the rows are returned
+%  directly from the pixel cache without being copied.  The current
+%  image must not be changed while the iterator is open.  Close the
+%  iterator with MagickCloseImagePixelRows().
+%
+%  The format of the MagickOpenImagePixelRows method is:
+%
+%      PixelRowIterator *MagickOpenImagePixelRows(MagickWand *wand,
+%        const char *map,const StorageType storage,
+%        const unsigned int writable)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o map: This string reflects the expected ordering of the pixel array.
+%      It can be any combination or order of R = red, G = green, B = blue,
+%      A = alpha, C = cyan, Y = yellow, M = magenta, K = black, I = intensity
+%      (for grayscale), or P = pad.
+%
+%    o storage: Define the data type of the pixels.  Float and double types
+%      are expected to be normalized [0..1] otherwise [0..MaxRGB].  Choose
+%      from these types: CharPixel, ShortPixel, IntegerPixel, LongPixel,
+%      FloatPixel, or DoublePixel.
+%
+%    o writable: If True, rows may be modified and committed to the image
+%      with MagickSyncImagePixelRow().
+%
+*/
+WandExport PixelRowIterator *MagickOpenImagePixelRows(MagickWand *wand,
+  const char *map,const StorageType storage,const unsigned int writable)
+{
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  if (wand->images == (Image *) NULL)
+    ThrowWandException(WandError,WandContainsNoImages,wand->id);
+  return(OpenPixelRowIterator(wand->image,map,storage,writable,
+                              &wand->exception));
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -8797,6 +8940,55 @@ WandExport unsigned int MagickSetImagePixels(MagickWand *wand,
   return(status);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k S e t I m a g e P i x e l R o w s R e g i o n                 %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickSetImagePixelRowsRegion() selects the region of the image whose
+%  rows are returned by subsequent calls to MagickNextImagePixelRow(),
+%  starting with the top row.
+%
+%  The format of the MagickSetImagePixelRowsRegion method is:
+%
+%      unsigned int MagickSetImagePixelRowsRegion(MagickWand *wand,
+%        PixelRowIterator *iterator,const long x_offset,
+%        const long y_offset,const unsigned long columns,
+%        const unsigned long rows)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o iterator: The pixel row iterator.
+%
+%    o x_offset, y_offset, columns, rows:  These values define the perimeter
+%      of a region of pixels.
+%
+*/
+WandExport unsigned int MagickSetImagePixelRowsRegion(MagickWand *wand,
+  PixelRowIterator *iterator,const long x_offset,const long y_offset,
+  const unsigned long columns,const unsigned long rows)
+{
+  unsigned int
+    status;
+
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  if (wand->images == (Image *) NULL)
+    ThrowWandException(WandError,WandContainsNoImages,wand->id);
+  status=SetPixelRowIteratorRegion(iterator,x_offset,y_offset,columns,rows);
+  if (status == False)
+    CopyException(&wand->exception,&wand->image->exception);
+  return(status);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -9897,6 +10089,49 @@ WandExport unsigned int MagickSwirlImage(MagickWand *wand,const double degrees)
   return(True);
 }
 
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k S y n c I m a g e P i x e l R o w                             %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickSyncImagePixelRow() commits the row most recently returned by
+%  MagickNextImagePixelRow() to the image.  The iterator must have been
+%  opened as writable.
+%
+%  The format of the MagickSyncImagePixelRow method is:
+%
+%      unsigned int MagickSyncImagePixelRow(MagickWand *wand,
+%        PixelRowIterator *iterator)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o iterator: The pixel row iterator.
+%
+*/
+WandExport unsigned int MagickSyncImagePixelRow(MagickWand *wand,
+  PixelRowIterator *iterator)
+{
+  unsigned int
+    status;
+
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  if (wand->images == (Image *) NULL)
+    ThrowWandException(WandError,WandContainsNoImages,wand->id);
+  status=SyncPixelRowIteratorRow(iterator);
+  if (status == False)
+    CopyException(&wand->exception,&wand->image->exception);
+  return(status);
+}
+
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %                                                                             %
@@ -10547,6 +10782,48 @@ WandExport unsigned char *MagickWriteImageBlob(MagickWand *wand,size_t *length)
     ThrowWandException(WandError,WandContainsNoImages,wand->id);
   return(ImageToBlob(wand->image_info,wand->image,length,&wand->exception));
 }
+
+/*
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%   M a g i c k W r i t e I m a g e B l o b S e g m e n t s                   %
+%                                                                             %
+%                                                                             %
+%                                                                             %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%
+%  MagickWriteImageBlobSegments() is like MagickWriteImageBlob() except
+%  that the image is returned as a list of memory segments rather than as
+%  one contiguous blob.  The segments may be passed directly to writev()
+%  without first copying them into one buffer.  Free the segments with
+%  DestroyBlobSegments() when they are no longer needed.
+%
+%  The format of the MagickWriteImageBlobSegments method is:
+%
+%      BlobSegment *MagickWriteImageBlobSegments(MagickWand *wand,
+%        size_t *count)
+%
+%  A description of each parameter follows:
+%
+%    o wand: The magick wand.
+%
+%    o count: The number of segments.
+%
+*/
+WandExport BlobSegment *MagickWriteImageBlobSegments(MagickWand *wand,
+                                                     size_t *count)
+{
+  assert(wand != (MagickWand *) NULL);
+  assert(wand->signature == MagickSignature);
+  assert(count != (size_t *) NULL);
+  *count=0;
+  if (wand->images == (Image *) NULL)
+    ThrowWandException(WandError,WandContainsNoImages,wand->id);
+  return(ImageToBlobSegments(wand->image_info,wand->image,count,
+                             &wand->exception));
+}
 
 /*
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
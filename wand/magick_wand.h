@@ -358,7 +358,21 @@ extern WandExport unsigned char
   *MagickRemoveImageProfile(MagickWand *,const char *,unsigned long *),
   *MagickWriteImageBlob(MagickWand *,size_t *);
 
+extern WandExport BlobSegment
+  *MagickWriteImageBlobSegments(MagickWand *,size_t *);
+
+extern WandExport PixelRowIterator
+  *MagickOpenImagePixelRows(MagickWand *,const char *,const StorageType,
+    const unsigned int);
+
+extern WandExport unsigned int
+  MagickSetImagePixelRowsRegion(MagickWand *,PixelRowIterator *,const long,
+    const long,const unsigned long,const unsigned long),
+  MagickSyncImagePixelRow(MagickWand *,PixelRowIterator *);
+
 extern WandExport void
+  *MagickNextImagePixelRow(MagickWand *,PixelRowIterator *,unsigned int *),
+  MagickCloseImagePixelRows(MagickWand *,PixelRowIterator *),
   MagickResetIterator(MagickWand *);
 
 #if defined(__cplusplus) || defined(c_plusplus)
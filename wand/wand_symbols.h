@@ -44,6 +44,7 @@
 #define MagickClipImage GmMagickClipImage
 #define MagickClipPathImage GmMagickClipPathImage
 #define MagickCloneDrawingWand GmMagickCloneDrawingWand
+#define MagickCloseImagePixelRows GmMagickCloseImagePixelRows
 #define MagickCoalesceImages GmMagickCoalesceImages
 #define MagickColorFloodfillImage GmMagickColorFloodfillImage
 #define MagickColorizeImage GmMagickColorizeImage
@@ -266,9 +267,11 @@
 #define MagickNegateImage GmMagickNegateImage
 #define MagickNewDrawingWand GmMagickNewDrawingWand
 #define MagickNextImage GmMagickNextImage
+#define MagickNextImagePixelRow GmMagickNextImagePixelRow
 #define MagickNormalizeImage GmMagickNormalizeImage
 #define MagickOilPaintImage GmMagickOilPaintImage
 #define MagickOpaqueImage GmMagickOpaqueImage
+#define MagickOpenImagePixelRows GmMagickOpenImagePixelRows
 #define MagickPingImage GmMagickPingImage
 #define MagickPreviewImages GmMagickPreviewImages
 #define MagickPreviousImage GmMagickPreviousImage
@@ -326,6 +329,7 @@
 #define MagickSetImageOption GmMagickSetImageOption
 #define MagickSetImagePage GmMagickSetImagePage
 #define MagickSetImagePixels GmMagickSetImagePixels
+#define MagickSetImagePixelRowsRegion GmMagickSetImagePixelRowsRegion
 #define MagickSetImageProfile GmMagickSetImageProfile
 #define MagickSetImageRedPrimary GmMagickSetImageRedPrimary
 #define MagickSetImageRenderingIntent GmMagickSetImageRenderingIntent
@@ -352,6 +356,7 @@
 #define MagickStereoImage GmMagickStereoImage
 #define MagickStripImage GmMagickStripImage
 #define MagickSwirlImage GmMagickSwirlImage
+#define MagickSyncImagePixelRow GmMagickSyncImagePixelRow
 #define MagickTextureImage GmMagickTextureImage
 #define MagickThresholdImageChannel GmMagickThresholdImageChannel
 #define MagickThresholdImage GmMagickThresholdImage
@@ -363,6 +368,7 @@
 #define MagickWaveImage GmMagickWaveImage
 #define MagickWhiteThresholdImage GmMagickWhiteThresholdImage
 #define MagickWriteImageBlob GmMagickWriteImageBlob
+#define MagickWriteImageBlobSegments GmMagickWriteImageBlobSegments
 #define MagickWriteImageFile GmMagickWriteImageFile
 #define MagickWriteImage GmMagickWriteImage
 #define MagickWriteImagesFile GmMagickWriteImagesFile
@@ -244,6 +244,94 @@ int main(int argc,char **argv)
           (void) fprintf(stderr,"Get pixels does not match set pixels\n");
           exit(1);
         }
+    /*
+      Read the same region via pixel row iterators, using sample orders
+      which are (BGR) and are not (RGB) returned directly from the cache.
+    */
+    for (i=0; i < 2; i++)
+      {
+        PixelRowIterator
+          *iterator;
+
+        unsigned char
+          *row;
+
+        unsigned int
+          stride;
+
+        long
+          c,
+          x,
+          y;
+
+        iterator=MagickOpenImagePixelRows(magick_wand,i == 0 ? "RGB" : "BGR",
+          CharPixel,False);
+        if (iterator == (PixelRowIterator *) NULL)
+          ThrowAPIException(magick_wand);
+        status=MagickSetImagePixelRowsRegion(magick_wand,iterator,10,10,3,3);
+        if (status == False)
+          ThrowAPIException(magick_wand);
+        for (y=0; (row=(unsigned char *)
+                     MagickNextImagePixelRow(magick_wand,iterator,&stride))
+               != (unsigned char *) NULL; y++)
+          for (x=0; x < 3; x++)
+            for (c=0; c < 3; c++)
+              if (row[x*stride+c] !=
+                  primary_colors[(y*3+x)*3+(i == 0 ? c : 2-c)])
+                {
+                  (void) fprintf(stderr,"Pixel row does not match set "
+                    "pixels\n");
+                  exit(1);
+                }
+        if (y != 3)
+          {
+            (void) fprintf(stderr,"Pixel row iterator returned %ld rows\n",y);
+            exit(1);
+          }
+        MagickCloseImagePixelRows(magick_wand,iterator);
+      }
+    /*
+      Invert the first row of the region via a writable iterator.
+    */
+    {
+      PixelRowIterator
+        *iterator;
+
+      float
+        *row;
+
+      unsigned int
+        stride;
+
+      long
+        x;
+
+      iterator=MagickOpenImagePixelRows(magick_wand,"RGB",FloatPixel,True);
+      if (iterator == (PixelRowIterator *) NULL)
+        ThrowAPIException(magick_wand);
+      status=MagickSetImagePixelRowsRegion(magick_wand,iterator,10,10,3,1);
+      if (status == False)
+        ThrowAPIException(magick_wand);
+      row=(float *) MagickNextImagePixelRow(magick_wand,iterator,&stride);
+      if (row == (float *) NULL)
+        ThrowAPIException(magick_wand);
+      for (x=0; x < 3*(long) stride; x++)
+        row[x]=1.0f-row[x];
+      status=MagickSyncImagePixelRow(magick_wand,iterator);
+      if (status == False)
+        ThrowAPIException(magick_wand);
+      MagickCloseImagePixelRows(magick_wand,iterator);
+      status=MagickGetImagePixels(magick_wand,10,10,3,1,"RGB",CharPixel,
+        pixels);
+      if (status == False)
+        ThrowAPIException(magick_wand);
+      for (x=0; x < 9; x++)
+        if (pixels[x] != 255-primary_colors[x])
+          {
+            (void) fprintf(stderr,"Synced pixel row does not match\n");
+            exit(1);
+          }
+    }
   }
   (void) MagickSetImageIndex(magick_wand,3);
   status=MagickResizeImage(magick_wand,50,50,UndefinedFilter,1.0);